@@ -83,6 +83,8 @@ set buildtype_def=/DIIR4_WIDGET_BUILDTYPE=%buildtype_internal%
 set debuglevel_def=/DIIR4_WIDGET_DEBUGLEVEL=%debuglevel_expensive_checks%
 set grid_orientation_horizontal_def=/DGRID_ORIENTATION_HORIZONTAL=0
 set grid_orientation_vertical_def=/DGRID_ORIENTATION_VERTICAL=1
+set grid_scale_linear_def=/DGRID_SCALE_LINEAR=0
+set grid_scale_logarithmic_def=/DGRID_SCALE_LOGARITHMIC=1
 
 set defs=^
     /DIIR4_WIDGET_BUILDTYPE_RELEASE=%buildtype_release%^
@@ -90,7 +92,9 @@ set defs=^
     /DIIR4_WIDGET_PERFORMANCE_SPAM_LEVEL=%performance_spam_level%^
     /DIIR4_WIDGET_DEBUGLEVEL_EXPENSIVE_CHECKS=%debuglevel_expensive_checks%^
     %grid_orientation_horizontal_def%^
-    %grid_orientation_vertical_def%
+    %grid_orientation_vertical_def%^
+    %grid_scale_linear_def%^
+    %grid_scale_logarithmic_def%
     
 REM make sure that the output direcotry exists
 IF NOT EXIST %builds_path% mkdir %builds_path%
@@ -133,13 +137,17 @@ set fxc_debug_flags=^
     %fxc_generate_pdb_debug_info_flag%^
     %fxc_warnings_are_errors_flag%^
     %grid_orientation_horizontal_def%^
-    %grid_orientation_vertical_def%
+    %grid_orientation_vertical_def%^
+    %grid_scale_linear_def%^
+    %grid_scale_logarithmic_def%
 set fxc_release_flags=^
     /nologo^
     %fxc_optimization_level_flag%^
     %fxc_warnings_are_errors_flag%^
     %grid_orientation_horizontal_def%^
-    %grid_orientation_vertical_def%
+    %grid_orientation_vertical_def%^
+    %grid_scale_linear_def%^
+    %grid_scale_logarithmic_def%
 if %build_type% == debug (
    set fxc_flags=%fxc_debug_flags%
 )
@@ -169,6 +177,10 @@ call fxc %fxc_flags% %source_path%\shaders.hlsl /T vs_5_0 /E dynamic_transform /
 if %ERRORLEVEL% gtr 0 (exit /b %ERRORLEVEL% )
 call fxc %fxc_flags% %source_path%\shaders.hlsl /T vs_5_0 /E plot_transform /Fo %builds_path%\plot_vs.cso
 if %ERRORLEVEL% gtr 0 (exit /b %ERRORLEVEL% )
+call fxc %fxc_flags% %source_path%\shaders.hlsl /T vs_5_0 /E locus_transform /Fo %builds_path%\locus_vs.cso
+if %ERRORLEVEL% gtr 0 (exit /b %ERRORLEVEL% )
+call fxc %fxc_flags% %source_path%\shaders.hlsl /T vs_5_0 /E contour_transform /Fo %builds_path%\contour_vs.cso
+if %ERRORLEVEL% gtr 0 (exit /b %ERRORLEVEL% )
 call fxc %fxc_flags% %source_path%\shaders.hlsl /T vs_5_0 /E ttf_font_vertex_shader /Fo %builds_path%\ttf_font_vs.cso
 if %ERRORLEVEL% gtr 0 (exit /b %ERRORLEVEL% )
 call fxc %fxc_flags% %source_path%\shaders.hlsl /T ps_5_0 /E solid /Fo %builds_path%\solid_ps.cso
@@ -0,0 +1,58 @@
+#!/bin/sh
+# NOTE:
+# Builds the command line modes without D3D or a window (source/iir4_headless.cpp), with g++ or clang,
+# see build.bat for the whole widget on Windows.
+# usage: build.sh <source_path> <builds_path> <debug|release>, set CXX to pick the compiler
+
+# === arguments =======
+source_path=$1
+builds_path=$2
+build_type=$3
+
+# === constants =======
+if [ "$build_type" = debug ]; then
+   buildtype_release=0
+   buildtype_internal=1
+   debuglevel_expensive_checks=1
+   performance_spam_level=0
+   build_type_specific_flags="-O0 -g"
+elif [ "$build_type" = release ]; then
+   buildtype_release=1
+   buildtype_internal=0
+   debuglevel_expensive_checks=0
+   performance_spam_level=0
+   build_type_specific_flags="-O2"
+else
+   echo "usage: build.sh <source_path> <builds_path> <debug|release>"
+   exit 1
+fi
+
+compiler=${CXX:-c++}
+
+# NOTE: no exceptions and no RTTI, like /EHa- on Windows
+common_compiler_flags="-std=c++14 -Wall -fno-exceptions -fno-rtti -msse2"
+
+libs="-pthread -lm"
+
+defs="\
+    -DIIR4_WIDGET_BUILDTYPE_RELEASE=$buildtype_release \
+    -DIIR4_WIDGET_BUILDTYPE_INTERNAL=$buildtype_internal \
+    -DIIR4_WIDGET_PERFORMANCE_SPAM_LEVEL=$performance_spam_level \
+    -DIIR4_WIDGET_DEBUGLEVEL_EXPENSIVE_CHECKS=$debuglevel_expensive_checks \
+    -DIIR4_WIDGET_BUILDTYPE=$buildtype_internal \
+    -DIIR4_WIDGET_DEBUGLEVEL=$debuglevel_expensive_checks \
+    -DGRID_ORIENTATION_HORIZONTAL=0 \
+    -DGRID_ORIENTATION_VERTICAL=1 \
+    -DGRID_SCALE_LINEAR=0 \
+    -DGRID_SCALE_LOGARITHMIC=1"
+
+# make sure that the output directory exists
+mkdir -p "$builds_path" || exit 1
+
+$compiler \
+    $common_compiler_flags \
+    $build_type_specific_flags \
+    $defs \
+    "$source_path/iir4_headless.cpp" \
+    -o "$builds_path/iir4_headless_$build_type" \
+    $libs
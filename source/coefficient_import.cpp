@@ -0,0 +1,369 @@
+// NOTE:
+// Turns fourth order transfer functions given as coefficients,
+//   H(z) = (b[0] + b[1]/z + ... + b[4]/z^4) / (a[0] + a[1]/z + ... + a[4]/z^4),
+// into the zero/pole parameters of the widget.
+// The widget can only show filters whose zeros and poles come in conjugate pairs (a real root counts as its own
+// conjugate only if it is a double root), so every imported transfer function is also checked for that.
+namespace CoefficientImport
+{
+
+    uint const ORDER = 4;
+
+    struct TransferFunction
+    {
+        float numerator[ORDER+1];
+        float denominator[ORDER+1];
+    };
+
+    struct Result
+    {
+        Parameters parameters;
+        bool representable;
+        // NOTE: the leading coefficient vanished, so the numerator or denominator is of lower order
+        bool degenerate;
+        // NOTE: the largest distance between a root and the conjugate of the root it was paired with
+        float pairing_error;
+    };
+
+    struct Statistics
+    {
+        uint num_transfer_functions;
+        uint num_representable;
+        uint num_degenerate;
+        float pairing_error_max;
+        Polynomial::Statistics roots;
+    };
+
+    // NOTE: relative to the root magnitude (or absolute, for roots smaller than one).
+    // Double roots only come out of the root finder to about the square root of the float precision,
+    // and worse when other roots are close by.
+    float const PAIRING_TOLERANCE = 1.0E-2f;
+
+    // NOTE:
+    // Splits four roots into two pairs, each represented by one of the pair (the one with non-negative imaginary part).
+    // Returns false if the roots can't be paired into conjugates.
+    bool
+    pair_conjugates(
+        float const*const roots_real,
+        float const*const roots_imaginary,
+        Complex::C *const factors,
+        float *const pairing_error
+        )
+    {
+        bool taken[ORDER] = {};
+        bool representable = true;
+        *pairing_error = 0.0f;
+
+        for(uint pair_idx=0; pair_idx < ORDER/2; pair_idx++)
+        {
+            // NOTE: start from the root furthest from the real axis, so that complex pairs are matched before real ones
+            int u_idx = -1;
+            for(uint i=0; i < ORDER; i++)
+            {
+                if(taken[i])
+                    continue;
+                if(u_idx == -1 ||
+                   Numerics::absolute_value(roots_imaginary[i]) > Numerics::absolute_value(roots_imaginary[u_idx]))
+                    u_idx = int(i);
+            }
+            assert(u_idx != -1);
+            taken[u_idx] = true;
+
+            float const u_real = roots_real[u_idx];
+            float const u_imaginary = roots_imaginary[u_idx];
+
+            int v_idx = -1;
+            float distance_min = POSITIVE_INFINITY_FLOAT;
+            for(uint i=0; i < ORDER; i++)
+            {
+                if(taken[i])
+                    continue;
+                float const distance =
+                    Numerics::square_root(
+                        Numerics::square(roots_real[i] - u_real) + Numerics::square(roots_imaginary[i] + u_imaginary)
+                        );
+                if(distance < distance_min)
+                {
+                    distance_min = distance;
+                    v_idx = int(i);
+                }
+            }
+            assert(v_idx != -1);
+            taken[v_idx] = true;
+
+            float const scale =
+                Numerics::maximum(1.0f, Numerics::square_root(Numerics::square(u_real) + Numerics::square(u_imaginary)));
+            if(distance_min > PAIRING_TOLERANCE*scale)
+                representable = false;
+            *pairing_error = Numerics::maximum(*pairing_error, distance_min);
+
+            // NOTE: average the pair, so the factor sits between the root and the conjugate of its partner
+            factors[pair_idx].component.real = 0.5f*(u_real + roots_real[v_idx]);
+            factors[pair_idx].component.imaginary =
+                Numerics::absolute_value(0.5f*(u_imaginary - roots_imaginary[v_idx]));
+        }
+
+        return representable;
+    }
+
+    // NOTE:
+    // Finds the zeros and poles of all transfer functions at once.
+    // The numerators and denominators go through the root finder as one batch of 2*num_transfer_functions polynomials.
+    bool
+    import(
+        uint const num_transfer_functions,
+        TransferFunction const*const transfer_functions,
+        Result *const results,
+        Statistics *const stats
+        )
+    {
+        stats->num_transfer_functions = num_transfer_functions;
+        stats->num_representable = 0;
+        stats->num_degenerate = 0;
+        stats->pairing_error_max = 0.0f;
+        Polynomial::reset(&stats->roots);
+
+        if(num_transfer_functions == 0)
+            return true;
+
+        uint const num_polynomials = 2*num_transfer_functions;
+        size_t const num_coefficients = size_t(num_polynomials)*(ORDER+1);
+        size_t const num_roots = size_t(num_polynomials)*ORDER;
+
+        float *const memory =
+            (float*)Platform::allocate_memory(sizeof(float)*(num_coefficients + 2*num_roots));
+        if(memory == 0)
+        {
+            Platform::log_line_string("error: failed to allocate memory for coefficient import");
+            return false;
+        }
+        float *const coefficients = memory;
+        float *const roots_real = coefficients + num_coefficients;
+        float *const roots_imaginary = roots_real + num_roots;
+
+        // NOTE:
+        // Multiplying through by z^4 gives the polynomials b[0]z^4 + b[1]z^3 + ... + b[4],
+        // which the root finder wants lowest power first.
+        // A vanishing leading coefficient means roots at infinity, which the widget can't show,
+        // so those are replaced by z^4 to keep the batch well behaved.
+        for(uint tf_idx=0; tf_idx < num_transfer_functions; tf_idx++)
+        {
+            TransferFunction const*const tf = &transfer_functions[tf_idx];
+            results[tf_idx].degenerate = false;
+            for(uint side_idx=0; side_idx < 2; side_idx++)
+            {
+                float const*const c = side_idx == 0 ? tf->numerator : tf->denominator;
+                float *const p = &coefficients[(2*tf_idx + side_idx)*(ORDER+1)];
+
+                float c_max = 0.0f;
+                for(uint k=0; k <= ORDER; k++)
+                {
+                    c_max = Numerics::maximum(c_max, Numerics::absolute_value(c[k]));
+                }
+
+                if(Numerics::absolute_value(c[0]) <= 1.0E-6f*c_max || c_max == 0.0f)
+                {
+                    results[tf_idx].degenerate = true;
+                    for(uint k=0; k < ORDER; k++)
+                    {
+                        p[k] = 0.0f;
+                    }
+                    p[ORDER] = 1.0f;
+                }
+                else
+                {
+                    for(uint k=0; k <= ORDER; k++)
+                    {
+                        p[k] = c[ORDER - k];
+                    }
+                }
+            }
+        }
+
+        Polynomial::Settings const settings = Polynomial::default_settings();
+        Polynomial::find_roots(
+            ORDER, num_polynomials, coefficients, &settings, false, roots_real, roots_imaginary, &stats->roots
+            );
+
+        for(uint tf_idx=0; tf_idx < num_transfer_functions; tf_idx++)
+        {
+            Result *const result = &results[tf_idx];
+            result->parameters = {};
+            result->pairing_error = 0.0f;
+            bool representable = !result->degenerate;
+
+            for(uint side_idx=0; side_idx < 2; side_idx++)
+            {
+                uint const polynomial_idx = 2*tf_idx + side_idx;
+                float pairing_error = 0.0f;
+                bool const paired =
+                    pair_conjugates(
+                        &roots_real[polynomial_idx*ORDER],
+                        &roots_imaginary[polynomial_idx*ORDER],
+                        result->parameters.ator_factors[side_idx],
+                        &pairing_error
+                        );
+                representable = representable && paired;
+                result->pairing_error = Numerics::maximum(result->pairing_error, pairing_error);
+            }
+
+            result->representable = representable;
+            if(representable)
+                stats->num_representable++;
+            if(result->degenerate)
+                stats->num_degenerate++;
+            stats->pairing_error_max = Numerics::maximum(stats->pairing_error_max, result->pairing_error);
+        }
+
+        Platform::free_memory(memory);
+        return true;
+    }
+
+    inline bool
+    is_separator(char const c)
+    {
+        return c == ' ' || c == '\t' || c == ',' || c == '\r' || c == '\n';
+    }
+
+    // NOTE:
+    // Text format: ten numbers per transfer function, b0 b1 b2 b3 b4 a0 a1 a2 a3 a4,
+    // separated by whitespace or commas. Everything from a '#' to the end of the line is ignored.
+    // Counts the transfer functions in the text, only writing them out if transfer_functions is non-zero.
+    // A trailing incomplete transfer function is ignored. Returns false on malformed numbers.
+    bool
+    parse_transfer_functions(
+        char const*const text,
+        uint const text_size,
+        TransferFunction *const transfer_functions,
+        uint *const num_transfer_functions
+        )
+    {
+        uint const num_numbers_per_transfer_function = 2*(ORDER+1);
+        uint num_numbers = 0;
+        uint idx = 0;
+
+        while(idx < text_size)
+        {
+            char const c = text[idx];
+
+            if(c == '#')
+            {
+                while(idx < text_size && text[idx] != '\n')
+                    idx++;
+                continue;
+            }
+
+            if(is_separator(c))
+            {
+                idx++;
+                continue;
+            }
+
+            // NOTE: copy the token, since the text isn't null terminated
+            char token[64];
+            uint token_length = 0;
+            while(idx < text_size && !is_separator(text[idx]) && text[idx] != '#')
+            {
+                if(token_length + 1 >= ARRAY_LENGTH(token))
+                {
+                    Platform::log_line_string("error: number too long in coefficient file");
+                    return false;
+                }
+                token[token_length++] = text[idx++];
+            }
+            token[token_length] = 0;
+
+            char* token_end = 0;
+            float const x = strtof(token, &token_end);
+            if(token_end != token + token_length)
+            {
+                Platform::log_string("error: could not parse '");
+                Platform::log_string(token);
+                Platform::log_line_string("' in coefficient file");
+                return false;
+            }
+
+            if(transfer_functions != 0)
+            {
+                TransferFunction *const tf = &transfer_functions[num_numbers/num_numbers_per_transfer_function];
+                uint const k = num_numbers % num_numbers_per_transfer_function;
+                if(k <= ORDER)
+                    tf->numerator[k] = x;
+                else
+                    tf->denominator[k - (ORDER+1)] = x;
+            }
+            num_numbers++;
+        }
+
+        *num_transfer_functions = num_numbers/num_numbers_per_transfer_function;
+        return true;
+    }
+
+    // NOTE: the caller frees the transfer functions with Platform::free_memory
+    bool
+    load_transfer_functions(
+        char *const file_name,
+        TransferFunction* *const transfer_functions,
+        uint *const num_transfer_functions
+        )
+    {
+        Platform::ReadFileResult const file = Platform::read_file(file_name);
+        if(file.contents == 0)
+        {
+            Platform::log_string("error: could not read coefficient file ");
+            Platform::log_line_string(file_name);
+            return false;
+        }
+
+        char const*const text = (char*)file.contents;
+        uint num = 0;
+        bool ok = parse_transfer_functions(text, file.contents_size, 0, &num);
+
+        TransferFunction* tfs = 0;
+        if(ok && num > 0)
+        {
+            tfs = (TransferFunction*)Platform::allocate_memory(sizeof(TransferFunction)*num);
+            ok = tfs != 0 && parse_transfer_functions(text, file.contents_size, tfs, &num);
+        }
+
+        Platform::free_file_memory(file.contents);
+
+        if(!ok)
+        {
+            if(tfs != 0)
+                Platform::free_memory(tfs);
+            return false;
+        }
+
+        *transfer_functions = tfs;
+        *num_transfer_functions = num;
+        return true;
+    }
+
+    void
+    log_statistics(Statistics const*const stats)
+    {
+        Platform::log_string("imported transfer functions: ");
+        Platform::log_uint32(stats->num_transfer_functions);
+        Platform::log_string(", representable: ");
+        Platform::log_uint32(stats->num_representable);
+        Platform::log_string(", degenerate: ");
+        Platform::log_uint32(stats->num_degenerate);
+        Platform::log_string(", max pairing error: ");
+        Platform::log_float(stats->pairing_error_max);
+        Platform::log_line();
+
+        Platform::log_string("root finder: polynomials: ");
+        Platform::log_uint32(stats->roots.num_polynomials);
+        Platform::log_string(", converged: ");
+        Platform::log_uint32(stats->roots.num_converged);
+        Platform::log_string(", iterations (total/max): ");
+        Platform::log_uint32(stats->roots.num_iterations_total);
+        Platform::log_string("/");
+        Platform::log_uint32(stats->roots.num_iterations_max);
+        Platform::log_string(", max backward error: ");
+        Platform::log_float(stats->roots.residual_max);
+        Platform::log_line();
+    }
+
+}
@@ -0,0 +1,187 @@
+// NOTE:
+// The command line modes, which run without a window and quit. They only use the CPU side of the renderer, so both
+// entry points share them: WinMain runs them before it opens the window, and main in iir4_headless.cpp is just them.
+
+// NOTE:
+// Looks for "option argument" on the command line and copies the argument (which can't contain spaces).
+// Returns false if the option isn't there, or has no argument, or the argument doesn't fit.
+bool
+try_get_command_line_argument(
+    char const*const command_line,
+    char const*const option,
+    char *const argument,
+    uint const argument_size
+    )
+{
+    size_t const option_length = strlen(option);
+    char const* c = command_line;
+    while((c = strstr(c, option)) != 0)
+    {
+        bool const starts_token = c == command_line || c[-1] == ' ';
+        bool const ends_token = c[option_length] == ' ';
+        c += option_length;
+        if(!starts_token || !ends_token)
+            continue;
+
+        while(*c == ' ')
+            c++;
+
+        uint length = 0;
+        while(c[length] != 0 && c[length] != ' ')
+            length++;
+
+        if(length == 0 || length + 1 > argument_size)
+            return false;
+
+        memcpy(argument, c, length);
+        argument[length] = 0;
+        return true;
+    }
+    return false;
+}
+
+// NOTE: runs the mode given on the command line, if any, returns false if there is none
+bool
+run_command_line_mode(char const*const cmd_line, int *const exit_code)
+{
+    uint const grid_base = FramePasses::GRID_BASE;
+
+    // NOTE: "-benchmark_labels <num_rounds>" only times the grid label generation, and quits
+    {
+        char num_rounds_string[16];
+        if(try_get_command_line_argument(cmd_line, "-benchmark_labels", num_rounds_string, (uint)ARRAY_LENGTH(num_rounds_string)))
+        {
+            uint const num_rounds = (uint)strtoul(num_rounds_string, 0, 10);
+            GridBenchmark::Result result;
+            GridBenchmark::run(grid_base, num_rounds, 0, &result);
+            GridBenchmark::log_result(&result);
+
+            Grid::LabelCache::Cache *const label_cache =
+                (Grid::LabelCache::Cache*)Platform::allocate_memory(sizeof(Grid::LabelCache::Cache));
+            if(label_cache != 0)
+            {
+                Grid::LabelCache::initialize(label_cache);
+                GridBenchmark::run(grid_base, num_rounds, label_cache, &result);
+                GridBenchmark::log_result(&result);
+                GridBenchmark::log_label_cache_statistics(&label_cache->stats);
+                Platform::free_memory(label_cache);
+            }
+            *exit_code = 0;
+            return true;
+        }
+    }
+    
+    // NOTE: "-verify_labels <num_ranges>" only checks the grid labels against the reference formatter, and quits
+    {
+        char num_ranges_string[16];
+        if(try_get_command_line_argument(cmd_line, "-verify_labels", num_ranges_string, (uint)ARRAY_LENGTH(num_ranges_string)))
+        {
+            uint const num_ranges = (uint)strtoul(num_ranges_string, 0, 10);
+            GridLabelVerifier::Result result;
+            GridLabelVerifier::run(num_ranges, &result);
+            GridLabelVerifier::log_result(&result);
+            *exit_code = 0;
+            return true;
+        }
+    }
+
+    // NOTE: "-verify_font_sdf <max_glyph_scale>" only checks that the font distance field draws the bitmap font, and quits
+    {
+        char max_glyph_scale_string[16];
+        if(try_get_command_line_argument(cmd_line, "-verify_font_sdf", max_glyph_scale_string, (uint)ARRAY_LENGTH(max_glyph_scale_string)))
+        {
+            uint const max_glyph_scale = (uint)strtoul(max_glyph_scale_string, 0, 10);
+            GridLabelVerifier::FontSdfResult result;
+            GridLabelVerifier::verify_font_sdf(max_glyph_scale, &result);
+            GridLabelVerifier::log_font_sdf_result(&result);
+            *exit_code = 0;
+            return true;
+        }
+    }
+
+    // NOTE: "-verify_glyph_batch <num_labels>" only checks the glyph batch against the old per-label glyph placement, and quits
+    {
+        char num_labels_string[16];
+        if(try_get_command_line_argument(cmd_line, "-verify_glyph_batch", num_labels_string, (uint)ARRAY_LENGTH(num_labels_string)))
+        {
+            uint const num_labels = (uint)strtoul(num_labels_string, 0, 10);
+            GridLabelVerifier::GlyphBatchResult result;
+            GridLabelVerifier::verify_glyph_batch(num_labels, &result);
+            GridLabelVerifier::log_glyph_batch_result(&result);
+            *exit_code = 0;
+            return true;
+        }
+    }
+
+    // NOTE: "-benchmark_software_render <num_frames>" only times drawing the widgets on the CPU, and quits
+    {
+        char num_frames_string[16];
+        if(try_get_command_line_argument(cmd_line, "-benchmark_software_render", num_frames_string, (uint)ARRAY_LENGTH(num_frames_string)))
+        {
+            uint const num_frames = (uint)strtoul(num_frames_string, 0, 10);
+            SoftwareRender::BenchmarkResult result;
+            SoftwareRender::run_benchmark(num_frames, &result);
+            SoftwareRender::log_benchmark_result("software render", &result);
+            SoftwareRender::run_drag_benchmark(num_frames, false, &result);
+            SoftwareRender::log_benchmark_result("software render drag", &result);
+            SoftwareRender::run_drag_benchmark(num_frames, true, &result);
+            SoftwareRender::log_benchmark_result("software render drag, cached", &result);
+            SoftwareRender::ProgressiveBenchmarkResult progressive_result;
+            SoftwareRender::run_progressive_benchmark(num_frames, &progressive_result);
+            SoftwareRender::log_progressive_benchmark_result(&progressive_result);
+            SoftwareRender::PolylineBenchmarkResult polyline_result;
+            SoftwareRender::run_polyline_benchmark(num_frames, &polyline_result);
+            SoftwareRender::log_polyline_benchmark_result(&polyline_result);
+            *exit_code = 0;
+            return true;
+        }
+    }
+
+    // NOTE: "-benchmark_contours <num_frames>" only times rebuilding the contours while dragging a pole, and quits
+    {
+        char num_frames_string[16];
+        if(try_get_command_line_argument(cmd_line, "-benchmark_contours", num_frames_string, (uint)ARRAY_LENGTH(num_frames_string)))
+        {
+            uint const num_frames = (uint)strtoul(num_frames_string, 0, 10);
+            Contour::BenchmarkResult result;
+            Contour::run_benchmark(num_frames, &result);
+            Contour::log_benchmark_result(&result);
+            *exit_code = 0;
+            return true;
+        }
+    }
+
+    // NOTE: "-benchmark_frame_recording <num_frames>" only times sampling and recording frames of more and more plots, and quits
+    {
+        char num_frames_string[16];
+        if(try_get_command_line_argument(cmd_line, "-benchmark_frame_recording", num_frames_string, (uint)ARRAY_LENGTH(num_frames_string)))
+        {
+            uint const num_frames = (uint)strtoul(num_frames_string, 0, 10);
+            uint const num_plots[] = {2, 16, Snapshot::MAX_NUM_PLOTS};
+            bool ok = true;
+            for(uint run_idx=0; run_idx < ARRAY_LENGTH(num_plots); run_idx++)
+            {
+                Snapshot::FrameBenchmarkResult result;
+                ok = Snapshot::run_frame_benchmark(num_frames, num_plots[run_idx], &result) && ok;
+                Snapshot::log_frame_benchmark_result(&result);
+            }
+            *exit_code = ok ? 0 : 1;
+            return true;
+        }
+    }
+
+    // NOTE: "-snapshot <view_file>" only renders the view file's snapshots on the CPU, and quits
+    {
+        char view_file_name[MAX_PATH];
+        if(try_get_command_line_argument(cmd_line, "-snapshot", view_file_name, (uint)ARRAY_LENGTH(view_file_name)))
+        {
+            Snapshot::Statistics stats;
+            bool const ok = Snapshot::run_view_file(view_file_name, &stats);
+            Snapshot::log_statistics(&stats);
+            *exit_code = ok ? 0 : 1;
+            return true;
+        }
+    }
+
+    return false;
+}
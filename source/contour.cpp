@@ -0,0 +1,681 @@
+// NOTE:
+// Contour lines of the magnitude response at a handful of levels in decibels, drawn over the magnitude density.
+// The magnitude is sampled on a square grid over the unit disk, in the log domain like Response does it, and then
+// every cell of the grid is classified against every level (marching squares). Both passes are split into bands of
+// grid rows that run on the worker threads.
+// A segment goes from one crossed grid edge to another, and both cells next to an edge compute the crossing from the
+// same two samples, so the segments are stitched into polylines by following the edges they share.
+// The contours are only rebuilt when the parameters or the levels change.
+// "-benchmark_contours <num_frames>" times rebuilding them while dragging a pole.
+namespace Contour
+{
+
+    uint const NUM_CELLS_PER_SIDE = 256;
+    uint const NUM_SAMPLES_PER_SIDE = NUM_CELLS_PER_SIDE + 1;
+    uint const NUM_SAMPLES = NUM_SAMPLES_PER_SIDE*NUM_SAMPLES_PER_SIDE;
+    uint const NUM_ROWS_PER_TASK = 8;
+    uint const NUM_TASKS = NUM_CELLS_PER_SIDE/NUM_ROWS_PER_TASK;
+    // NOTE: the horizontal edges are numbered first, row by row, then the vertical ones
+    uint const NUM_HORIZONTAL_EDGES = NUM_SAMPLES_PER_SIDE*NUM_CELLS_PER_SIDE;
+    uint const NUM_EDGES = 2*NUM_HORIZONTAL_EDGES;
+    uint const MAX_NUM_LEVELS = 16;
+    // NOTE: segments past this are dropped, and counted in the statistics
+    uint const MAX_NUM_SEGMENTS_PER_TASK = 2048;
+    uint const MAX_NUM_SEGMENTS = NUM_TASKS*MAX_NUM_SEGMENTS_PER_TASK;
+    // NOTE: a polyline has one vertex more than it has segments
+    uint const MAX_NUM_VERTICES = 2*MAX_NUM_SEGMENTS;
+    uint32 const NO_SEGMENT = 0xffffffff;
+
+    static_assert(NUM_CELLS_PER_SIDE % NUM_ROWS_PER_TASK == 0, "every task must get the same number of rows");
+
+    struct Levels
+    {
+        float decibels[MAX_NUM_LEVELS];
+        uint num_levels;
+    };
+
+    // NOTE: a segment of a contour line, from where it crosses one grid edge to where it crosses another
+    struct Segment
+    {
+        uint32 edges[2];
+    };
+
+    struct Polyline
+    {
+        uint first_vertex_idx;
+        uint num_vertices;
+        uint level_idx;
+        // NOTE: closed polylines end on their first vertex, open ones end on the rim of the disk
+        bool closed;
+    };
+
+    struct Statistics
+    {
+        uint num_builds;
+        uint num_segments;
+        uint num_dropped_segments;
+        uint num_polylines;
+        uint num_closed_polylines;
+    };
+
+    struct Contours
+    {
+        // NOTE: decibels, y_sample_idx*NUM_SAMPLES_PER_SIDE + x_sample_idx from the corner at (-1, -1)
+        float* samples;
+        // NOTE: task_idx*MAX_NUM_SEGMENTS_PER_TASK + segment_idx, the segments of a task are grouped by level
+        Segment* segments;
+        uint task_level_ends[NUM_TASKS][MAX_NUM_LEVELS];
+        // NOTE: edge_idx*2, the segments on either side of an edge while stitching, NO_SEGMENT everywhere else
+        uint32* edge_segments;
+        uint8* visited;
+        // NOTE: x and y of each vertex in data coordinates, ready for upload
+        float* vertices;
+        uint num_vertices;
+        Polyline* polylines;
+        uint num_polylines;
+        // NOTE: what the contours were last built for
+        bool built;
+        Parameters parameters;
+        Levels levels;
+        Statistics stats;
+    };
+
+    void
+    default_levels(Levels *const levels)
+    {
+        float const decibels[] = {-60.0f, -40.0f, -20.0f, -10.0f, -6.0f, -3.0f, 0.0f, 6.0f, 20.0f};
+        static_assert(ARRAY_LENGTH(decibels) <= MAX_NUM_LEVELS, "too many default levels");
+        for(uint level_idx=0; level_idx < ARRAY_LENGTH(decibels); level_idx++)
+        {
+            levels->decibels[level_idx] = decibels[level_idx];
+        }
+        levels->num_levels = ARRAY_LENGTH(decibels);
+    }
+
+    // NOTE: parses a comma separated list of decibels, like "-40,-20,-3", leaves the levels alone if it can't
+    bool
+    parse_levels(char const*const text, Levels *const levels)
+    {
+        Levels parsed;
+        parsed.num_levels = 0;
+        char const* c = text;
+        while(true)
+        {
+            if(parsed.num_levels == MAX_NUM_LEVELS)
+            {
+                Platform::log_line_string("error: too many contour levels");
+                return false;
+            }
+            char* token_end = 0;
+            parsed.decibels[parsed.num_levels] = strtof(c, &token_end);
+            if(token_end == c || (*token_end != ',' && *token_end != 0))
+            {
+                Platform::log_string("error: could not parse contour levels '");
+                Platform::log_string(text);
+                Platform::log_line_string("'");
+                return false;
+            }
+            parsed.num_levels++;
+            if(*token_end == 0)
+                break;
+            c = token_end + 1;
+        }
+        *levels = parsed;
+        return true;
+    }
+
+    bool
+    levels_equal(Levels const*const a, Levels const*const b)
+    {
+        if(a->num_levels != b->num_levels)
+            return false;
+        for(uint level_idx=0; level_idx < a->num_levels; level_idx++)
+        {
+            if(a->decibels[level_idx] != b->decibels[level_idx])
+                return false;
+        }
+        return true;
+    }
+
+    void
+    reset(Statistics *const stats)
+    {
+        stats->num_builds = 0;
+        stats->num_segments = 0;
+        stats->num_dropped_segments = 0;
+        stats->num_polylines = 0;
+        stats->num_closed_polylines = 0;
+    }
+
+    bool
+    initialize(Contours *const contours)
+    {
+        // NOTE: one allocation, with the bytes last so everything else stays aligned
+        size_t const num_bytes =
+            sizeof(float)*NUM_SAMPLES +
+            sizeof(Segment)*MAX_NUM_SEGMENTS +
+            sizeof(uint32)*2*NUM_EDGES +
+            sizeof(float)*2*MAX_NUM_VERTICES +
+            sizeof(Polyline)*MAX_NUM_SEGMENTS +
+            sizeof(uint8)*MAX_NUM_SEGMENTS;
+        uint8 *const memory = (uint8*)Platform::allocate_memory(num_bytes);
+        if(memory == 0)
+            return false;
+        uint8* next = memory;
+        contours->samples = (float*)next;
+        next += sizeof(float)*NUM_SAMPLES;
+        contours->segments = (Segment*)next;
+        next += sizeof(Segment)*MAX_NUM_SEGMENTS;
+        contours->edge_segments = (uint32*)next;
+        next += sizeof(uint32)*2*NUM_EDGES;
+        contours->vertices = (float*)next;
+        next += sizeof(float)*2*MAX_NUM_VERTICES;
+        contours->polylines = (Polyline*)next;
+        next += sizeof(Polyline)*MAX_NUM_SEGMENTS;
+        contours->visited = next;
+
+        for(uint idx=0; idx < 2*NUM_EDGES; idx++)
+        {
+            contours->edge_segments[idx] = NO_SEGMENT;
+        }
+        memset(contours->visited, 0, sizeof(uint8)*MAX_NUM_SEGMENTS);
+        contours->num_vertices = 0;
+        contours->num_polylines = 0;
+        contours->built = false;
+        reset(&contours->stats);
+        return true;
+    }
+
+    void
+    release(Contours *const contours)
+    {
+        // NOTE: everything shares the allocation of the samples
+        if(contours->samples != 0)
+        {
+            Platform::free_memory(contours->samples);
+        }
+        contours->samples = 0;
+        contours->built = false;
+    }
+
+    inline float
+    data_coordinate(float const grid_coordinate)
+    {
+        return -1.0f + grid_coordinate*(2.0f/float(NUM_CELLS_PER_SIDE));
+    }
+
+    struct Job
+    {
+        Parameters const* parameters;
+        Levels const* levels;
+        Contours* contours;
+        uint task_num_segments[NUM_TASKS];
+        uint task_num_dropped_segments[NUM_TASKS];
+    };
+
+    // NOTE: the magnitude in decibels at the samples of one band of rows, the last task also takes the top row
+    void
+    sample_task(void* data, uint task_idx)
+    {
+        using namespace Simd;
+
+        Job *const job = (Job*)data;
+        Parameters const*const parameters = job->parameters;
+        float *const samples = job->contours->samples;
+
+        Float4 const log2_normalization = set(Response::log2_normalization_constant_highpass(parameters));
+        Float4 const min_product = set(Response::MIN_DISTANCE_SQUARED);
+        Float4 const decibels_per_log2 = set(Response::DECIBELS_PER_LOG2);
+
+        uint const min_y_idx = task_idx*NUM_ROWS_PER_TASK;
+        uint const end_y_idx = task_idx + 1 == NUM_TASKS ? NUM_SAMPLES_PER_SIDE : min_y_idx + NUM_ROWS_PER_TASK;
+        for(uint y_idx=min_y_idx; y_idx < end_y_idx; y_idx++)
+        {
+            float *const row = &samples[y_idx*NUM_SAMPLES_PER_SIDE];
+            Float4 const y = set(data_coordinate(float(y_idx)));
+            for(uint first_x_idx=0; first_x_idx < NUM_SAMPLES_PER_SIDE; first_x_idx += NUM_LANES)
+            {
+                Float4 const x =
+                    set(
+                        data_coordinate(float(first_x_idx + 0)),
+                        data_coordinate(float(first_x_idx + 1)),
+                        data_coordinate(float(first_x_idx + 2)),
+                        data_coordinate(float(first_x_idx + 3))
+                        );
+
+                // NOTE:
+                // Products of squared distances rather than sums of their logarithms, since inside the unit disk
+                // they can't overflow, and clamping them takes care of underflowing right on a zero or pole
+                Float4 product[2] = {set(1.0f), set(1.0f)};
+                for(int i=0; i<2; i++)
+                {
+                    for(int j=0; j<2; j++)
+                    {
+                        Complex::C const*const p = &parameters->ator_factors[i][j];
+                        Float4 const dx = subtract(x, set(p->component.real));
+                        Float4 const dy = subtract(y, set(p->component.imaginary));
+                        Float4 const dy_conjugate = add(y, set(p->component.imaginary));
+                        Float4 const dx_squared = multiply(dx, dx);
+                        product[i] = multiply(product[i], add(dx_squared, multiply(dy, dy)));
+                        product[i] = multiply(product[i], add(dx_squared, multiply(dy_conjugate, dy_conjugate)));
+                    }
+                }
+                Float4 const log2_magnitude =
+                    add(
+                        multiply(
+                            set(0.5f),
+                            subtract(logarithm2(maximum(product[0], min_product)), logarithm2(maximum(product[1], min_product)))
+                            ),
+                        log2_normalization
+                        );
+                Float4 const decibels = multiply(log2_magnitude, decibels_per_log2);
+
+                if(first_x_idx + NUM_LANES <= NUM_SAMPLES_PER_SIDE)
+                {
+                    store(decibels, &row[first_x_idx]);
+                }
+                else
+                {
+                    float tail[NUM_LANES];
+                    store(decibels, tail);
+                    for(uint x_idx=first_x_idx; x_idx < NUM_SAMPLES_PER_SIDE; x_idx++)
+                    {
+                        row[x_idx] = tail[x_idx - first_x_idx];
+                    }
+                }
+            }
+        }
+    }
+
+    // NOTE: the cells of a row that are all inside the unit disk, the contours stop at the last whole cell
+    void
+    cells_inside_disk(uint const y_cell_idx, uint *const min_x_cell_idx, uint *const end_x_cell_idx)
+    {
+        double const step = 2.0/double(NUM_CELLS_PER_SIDE);
+        double const min_y = -1.0 + double(y_cell_idx)*step;
+        double const farthest_y = Numerics::maximum(Numerics::absolute_value(min_y), Numerics::absolute_value(min_y + step));
+        *min_x_cell_idx = 0;
+        *end_x_cell_idx = 0;
+        if(farthest_y >= 1.0)
+            return;
+        double const half_width = Numerics::square_root(1.0 - farthest_y*farthest_y);
+        int const min_x_sample_idx = int(Numerics::ceiling((1.0 - half_width)/step));
+        int const max_x_sample_idx = int(Numerics::floor((1.0 + half_width)/step));
+        if(max_x_sample_idx <= min_x_sample_idx)
+            return;
+        *min_x_cell_idx = uint(min_x_sample_idx);
+        *end_x_cell_idx = uint(Numerics::minimum(max_x_sample_idx, int(NUM_CELLS_PER_SIDE)));
+    }
+
+    // NOTE: the sides of a cell, in the order the corners go around it
+    enum CellEdge
+    {
+        Bottom, Right, Top, Left,
+    };
+
+    // NOTE:
+    // The segments of each marching squares case, the bits of the case being the corners at or above the level,
+    // counter clockwise from the bottom left. The two saddles (5 and 10) are resolved by the middle of the cell.
+    int const CASE_SEGMENTS[16][4] =
+        {
+            {-1, -1, -1, -1},
+            {Left, Bottom, -1, -1},
+            {Bottom, Right, -1, -1},
+            {Left, Right, -1, -1},
+            {Right, Top, -1, -1},
+            {-1, -1, -1, -1},
+            {Bottom, Top, -1, -1},
+            {Left, Top, -1, -1},
+            {Top, Left, -1, -1},
+            {Bottom, Top, -1, -1},
+            {-1, -1, -1, -1},
+            {Right, Top, -1, -1},
+            {Left, Right, -1, -1},
+            {Bottom, Right, -1, -1},
+            {Left, Bottom, -1, -1},
+            {-1, -1, -1, -1},
+        };
+
+    inline uint32
+    edge_of_cell(uint const x_cell_idx, uint const y_cell_idx, int const cell_edge)
+    {
+        switch(cell_edge)
+        {
+        case Bottom: return y_cell_idx*NUM_CELLS_PER_SIDE + x_cell_idx;
+        case Top: return (y_cell_idx + 1)*NUM_CELLS_PER_SIDE + x_cell_idx;
+        case Left: return NUM_HORIZONTAL_EDGES + y_cell_idx*NUM_SAMPLES_PER_SIDE + x_cell_idx;
+        default: return NUM_HORIZONTAL_EDGES + y_cell_idx*NUM_SAMPLES_PER_SIDE + x_cell_idx + 1;
+        }
+    }
+
+    void
+    march_task(void* data, uint task_idx)
+    {
+        Job *const job = (Job*)data;
+        Contours *const contours = job->contours;
+        float const*const samples = contours->samples;
+        Segment *const segments = &contours->segments[task_idx*MAX_NUM_SEGMENTS_PER_TASK];
+
+        uint num_segments = 0;
+        uint num_dropped_segments = 0;
+        for(uint level_idx=0; level_idx < job->levels->num_levels; level_idx++)
+        {
+            float const level = job->levels->decibels[level_idx];
+            for(uint y_cell_idx=task_idx*NUM_ROWS_PER_TASK; y_cell_idx < (task_idx + 1)*NUM_ROWS_PER_TASK; y_cell_idx++)
+            {
+                float const*const bottom_row = &samples[y_cell_idx*NUM_SAMPLES_PER_SIDE];
+                float const*const top_row = bottom_row + NUM_SAMPLES_PER_SIDE;
+                uint min_x_cell_idx;
+                uint end_x_cell_idx;
+                cells_inside_disk(y_cell_idx, &min_x_cell_idx, &end_x_cell_idx);
+                for(uint x_cell_idx=min_x_cell_idx; x_cell_idx < end_x_cell_idx; x_cell_idx++)
+                {
+                    float const corners[4] =
+                        {
+                            bottom_row[x_cell_idx],
+                            bottom_row[x_cell_idx + 1],
+                            top_row[x_cell_idx + 1],
+                            top_row[x_cell_idx],
+                        };
+                    uint cell_case = 0;
+                    for(uint corner_idx=0; corner_idx < 4; corner_idx++)
+                    {
+                        cell_case |= corners[corner_idx] >= level ? (1u << corner_idx) : 0u;
+                    }
+                    if(cell_case == 0 || cell_case == 15)
+                        continue;
+
+                    int cell_segments[4] =
+                        {
+                            CASE_SEGMENTS[cell_case][0],
+                            CASE_SEGMENTS[cell_case][1],
+                            CASE_SEGMENTS[cell_case][2],
+                            CASE_SEGMENTS[cell_case][3],
+                        };
+                    if(cell_case == 5 || cell_case == 10)
+                    {
+                        // NOTE: the corners below the level are cut off if the middle is above it, and vice versa
+                        bool const middle_above = 0.25f*(corners[0] + corners[1] + corners[2] + corners[3]) >= level;
+                        bool const cut_bottom_left_and_top_right = (cell_case == 5) != middle_above;
+                        if(cut_bottom_left_and_top_right)
+                        {
+                            cell_segments[0] = Left;
+                            cell_segments[1] = Bottom;
+                            cell_segments[2] = Right;
+                            cell_segments[3] = Top;
+                        }
+                        else
+                        {
+                            cell_segments[0] = Bottom;
+                            cell_segments[1] = Right;
+                            cell_segments[2] = Top;
+                            cell_segments[3] = Left;
+                        }
+                    }
+
+                    for(uint segment_idx=0; segment_idx < 2 && cell_segments[2*segment_idx] >= 0; segment_idx++)
+                    {
+                        if(num_segments == MAX_NUM_SEGMENTS_PER_TASK)
+                        {
+                            num_dropped_segments++;
+                            continue;
+                        }
+                        Segment *const segment = &segments[num_segments++];
+                        segment->edges[0] = edge_of_cell(x_cell_idx, y_cell_idx, cell_segments[2*segment_idx]);
+                        segment->edges[1] = edge_of_cell(x_cell_idx, y_cell_idx, cell_segments[2*segment_idx + 1]);
+                    }
+                }
+            }
+            contours->task_level_ends[task_idx][level_idx] = num_segments;
+        }
+        job->task_num_segments[task_idx] = num_segments;
+        job->task_num_dropped_segments[task_idx] = num_dropped_segments;
+    }
+
+    // NOTE: where the contour at the level crosses the edge, interpolated between the samples at its ends
+    void
+    edge_crossing(float const*const samples, uint32 const edge_idx, float const level, float *const vertex)
+    {
+        uint x_idx[2];
+        uint y_idx[2];
+        if(edge_idx < NUM_HORIZONTAL_EDGES)
+        {
+            x_idx[0] = edge_idx % NUM_CELLS_PER_SIDE;
+            y_idx[0] = edge_idx / NUM_CELLS_PER_SIDE;
+            x_idx[1] = x_idx[0] + 1;
+            y_idx[1] = y_idx[0];
+        }
+        else
+        {
+            x_idx[0] = (edge_idx - NUM_HORIZONTAL_EDGES) % NUM_SAMPLES_PER_SIDE;
+            y_idx[0] = (edge_idx - NUM_HORIZONTAL_EDGES) / NUM_SAMPLES_PER_SIDE;
+            x_idx[1] = x_idx[0];
+            y_idx[1] = y_idx[0] + 1;
+        }
+        float const a = samples[y_idx[0]*NUM_SAMPLES_PER_SIDE + x_idx[0]];
+        float const b = samples[y_idx[1]*NUM_SAMPLES_PER_SIDE + x_idx[1]];
+        // NOTE: the level is strictly between the samples or on b, so the difference can't be zero
+        float const t = (level - a)/(b - a);
+        vertex[0] = data_coordinate(float(x_idx[0]) + t*float(x_idx[1] - x_idx[0]));
+        vertex[1] = data_coordinate(float(y_idx[0]) + t*float(y_idx[1] - y_idx[0]));
+    }
+
+    inline uint32
+    other_edge(Segment const*const segment, uint32 const edge_idx)
+    {
+        return segment->edges[0] == edge_idx ? segment->edges[1] : segment->edges[0];
+    }
+
+    // NOTE: the segment on the other side of the edge, or NO_SEGMENT if the contour ends there
+    inline uint32
+    other_segment(Contours const*const contours, uint32 const edge_idx, uint32 const segment_idx)
+    {
+        uint32 const*const pair = &contours->edge_segments[2*edge_idx];
+        return pair[0] == segment_idx ? pair[1] : pair[0];
+    }
+
+    // NOTE: stitches the segments of one level into polylines, appending them to the contours
+    void
+    stitch_level(uint const level_idx, float const level, Contours *const contours)
+    {
+        Segment const*const segments = contours->segments;
+
+        for(uint task_idx=0; task_idx < NUM_TASKS; task_idx++)
+        {
+            uint const min_idx = task_idx*MAX_NUM_SEGMENTS_PER_TASK + (level_idx > 0 ? contours->task_level_ends[task_idx][level_idx - 1] : 0);
+            uint const end_idx = task_idx*MAX_NUM_SEGMENTS_PER_TASK + contours->task_level_ends[task_idx][level_idx];
+            for(uint segment_idx=min_idx; segment_idx < end_idx; segment_idx++)
+            {
+                for(uint end=0; end < 2; end++)
+                {
+                    uint32 *const pair = &contours->edge_segments[2*segments[segment_idx].edges[end]];
+                    pair[pair[0] == NO_SEGMENT ? 0 : 1] = segment_idx;
+                }
+            }
+        }
+
+        for(uint task_idx=0; task_idx < NUM_TASKS; task_idx++)
+        {
+            uint const min_idx = task_idx*MAX_NUM_SEGMENTS_PER_TASK + (level_idx > 0 ? contours->task_level_ends[task_idx][level_idx - 1] : 0);
+            uint const end_idx = task_idx*MAX_NUM_SEGMENTS_PER_TASK + contours->task_level_ends[task_idx][level_idx];
+            for(uint segment_idx=min_idx; segment_idx < end_idx; segment_idx++)
+            {
+                if(contours->visited[segment_idx])
+                    continue;
+
+                // NOTE: back up to where the contour ends, or all the way around to this segment if it is closed
+                uint32 first_segment_idx = segment_idx;
+                uint32 first_edge_idx = segments[segment_idx].edges[0];
+                while(true)
+                {
+                    uint32 const previous_segment_idx = other_segment(contours, first_edge_idx, first_segment_idx);
+                    if(previous_segment_idx == NO_SEGMENT || previous_segment_idx == segment_idx)
+                        break;
+                    first_edge_idx = other_edge(&segments[previous_segment_idx], first_edge_idx);
+                    first_segment_idx = previous_segment_idx;
+                }
+
+                Polyline *const polyline = &contours->polylines[contours->num_polylines++];
+                polyline->first_vertex_idx = contours->num_vertices;
+                polyline->level_idx = level_idx;
+                polyline->closed = false;
+
+                edge_crossing(contours->samples, first_edge_idx, level, &contours->vertices[2*contours->num_vertices++]);
+                uint32 current_segment_idx = first_segment_idx;
+                uint32 edge_idx = first_edge_idx;
+                while(true)
+                {
+                    contours->visited[current_segment_idx] = 1;
+                    edge_idx = other_edge(&segments[current_segment_idx], edge_idx);
+                    edge_crossing(contours->samples, edge_idx, level, &contours->vertices[2*contours->num_vertices++]);
+                    uint32 const next_segment_idx = other_segment(contours, edge_idx, current_segment_idx);
+                    if(next_segment_idx == NO_SEGMENT)
+                        break;
+                    if(next_segment_idx == first_segment_idx)
+                    {
+                        polyline->closed = true;
+                        break;
+                    }
+                    current_segment_idx = next_segment_idx;
+                }
+                polyline->num_vertices = contours->num_vertices - polyline->first_vertex_idx;
+                assert(contours->num_vertices <= MAX_NUM_VERTICES);
+            }
+        }
+
+        // NOTE: only the edges of this level were touched, so only they have to be cleared for the next one
+        for(uint task_idx=0; task_idx < NUM_TASKS; task_idx++)
+        {
+            uint const min_idx = task_idx*MAX_NUM_SEGMENTS_PER_TASK + (level_idx > 0 ? contours->task_level_ends[task_idx][level_idx - 1] : 0);
+            uint const end_idx = task_idx*MAX_NUM_SEGMENTS_PER_TASK + contours->task_level_ends[task_idx][level_idx];
+            for(uint segment_idx=min_idx; segment_idx < end_idx; segment_idx++)
+            {
+                contours->edge_segments[2*segments[segment_idx].edges[0]] = NO_SEGMENT;
+                contours->edge_segments[2*segments[segment_idx].edges[0] + 1] = NO_SEGMENT;
+                contours->edge_segments[2*segments[segment_idx].edges[1]] = NO_SEGMENT;
+                contours->edge_segments[2*segments[segment_idx].edges[1] + 1] = NO_SEGMENT;
+                contours->visited[segment_idx] = 0;
+            }
+        }
+    }
+
+    void
+    build(Parameters const*const parameters, Levels const*const levels, Contours *const contours)
+    {
+        Job job;
+        job.parameters = parameters;
+        job.levels = levels;
+        job.contours = contours;
+
+        Platform::parallel_for(NUM_TASKS, sample_task, &job);
+        Platform::parallel_for(NUM_TASKS, march_task, &job);
+
+        contours->num_vertices = 0;
+        contours->num_polylines = 0;
+        for(uint level_idx=0; level_idx < levels->num_levels; level_idx++)
+        {
+            stitch_level(level_idx, levels->decibels[level_idx], contours);
+        }
+
+        Statistics *const stats = &contours->stats;
+        stats->num_builds++;
+        for(uint task_idx=0; task_idx < NUM_TASKS; task_idx++)
+        {
+            stats->num_segments += job.task_num_segments[task_idx];
+            stats->num_dropped_segments += job.task_num_dropped_segments[task_idx];
+        }
+        stats->num_polylines += contours->num_polylines;
+        for(uint polyline_idx=0; polyline_idx < contours->num_polylines; polyline_idx++)
+        {
+            stats->num_closed_polylines += contours->polylines[polyline_idx].closed ? 1 : 0;
+        }
+
+        contours->parameters = *parameters;
+        contours->levels = *levels;
+        contours->built = true;
+    }
+
+    // NOTE: rebuilds the contours unless they are already of these parameters and levels, returns whether it did
+    bool
+    update(Parameters const*const parameters, Levels const*const levels, Contours *const contours)
+    {
+        if(
+            contours->built &&
+            memcmp(&contours->parameters, parameters, sizeof(*parameters)) == 0 &&
+            levels_equal(&contours->levels, levels)
+            )
+        {
+            return false;
+        }
+        build(parameters, levels, contours);
+        return true;
+    }
+
+    struct BenchmarkResult
+    {
+        uint num_frames;
+        float duration_seconds;
+        Statistics stats;
+    };
+
+    // NOTE: rebuilds the default contours every frame while a pole moves, like dragging it around
+    void
+    run_benchmark(uint const num_frames, BenchmarkResult *const result)
+    {
+        result->num_frames = 0;
+        result->duration_seconds = 0.0f;
+        reset(&result->stats);
+
+        Contours contours = {};
+        if(!initialize(&contours))
+        {
+            Platform::log_line_string("failed to allocate memory for the contours");
+            return;
+        }
+        Levels levels;
+        default_levels(&levels);
+
+        Parameters parameters = {};
+        Complex::set_polar(0.25f, PI_FLOAT*0.25f, &parameters.parameter.zero[0]);
+        Complex::set_polar(0.75f, PI_FLOAT*0.5f, &parameters.parameter.zero[1]);
+        Complex::set_polar(0.25f, PI_FLOAT*0.1f, &parameters.parameter.pole[0]);
+        Complex::set_polar(0.75f, PI_FLOAT*0.75f, &parameters.parameter.pole[1]);
+
+        Platform::TimeCount const start = Platform::time_get_count();
+        for(uint frame_idx=0; frame_idx < num_frames; frame_idx++)
+        {
+            float const t = float(frame_idx)/60.0f;
+            Complex::set_polar(0.25f + 0.2f*Numerics::sin(t), PI_FLOAT*0.1f + 1.3f*t, &parameters.parameter.pole[0]);
+            update(&parameters, &levels, &contours);
+            result->num_frames++;
+        }
+        result->duration_seconds = Platform::time_duration_seconds(start, Platform::time_get_count());
+        result->stats = contours.stats;
+
+        release(&contours);
+    }
+
+    void
+    log_benchmark_result(BenchmarkResult const*const result)
+    {
+        uint const num_frames = result->num_frames > 0 ? result->num_frames : 1;
+        Platform::log_string("contours: frames: ");
+        Platform::log_uint32(result->num_frames);
+        Platform::log_string(", seconds: ");
+        Platform::log_float(result->duration_seconds);
+        Platform::log_string(", frames per second: ");
+        Platform::log_float(
+            result->duration_seconds > 0.0f ? float(result->num_frames)/result->duration_seconds : 0.0f
+            );
+        Platform::log_string(", segments per frame: ");
+        Platform::log_uint32(result->stats.num_segments/num_frames);
+        Platform::log_string(", polylines per frame: ");
+        Platform::log_uint32(result->stats.num_polylines/num_frames);
+        Platform::log_string(", closed polylines per frame: ");
+        Platform::log_uint32(result->stats.num_closed_polylines/num_frames);
+        Platform::log_string(", dropped segments: ");
+        Platform::log_uint32(result->stats.num_dropped_segments);
+        Platform::log_line();
+    }
+
+}
@@ -0,0 +1,392 @@
+// NOTE:
+// Fits the zeros and poles to a target magnitude curve drawn on the magnitude plot, with Levenberg-Marquardt.
+// The residuals are taken in the ln magnitude domain, where the factored response is a sum over the factors,
+// so the Jacobian is a sum of simple closed form terms. Each factor (a, b) and its conjugate contribute
+//   sign*0.5*(ln d1^2 + ln d2^2) - sign*ln e^2
+// to ln|H|, with d1^2 = (x - a)^2 + (y - b)^2, d2^2 = (x - a)^2 + (y + b)^2 at the sample point (x, y),
+// e^2 = (1 + a)^2 + b^2 from the highpass normalization, and sign +1 for zeros and -1 for poles.
+// The normal equations are accumulated four frequency samples at a time.
+namespace Fit
+{
+
+    // NOTE: a multiple of the number of SIMD lanes
+    uint const NUM_TARGET_SAMPLES = 256;
+    uint const NUM_PARAMETERS = 8;
+
+    static_assert(NUM_TARGET_SAMPLES % Simd::NUM_LANES == 0, "target samples must fill whole SIMD lanes");
+
+    // NOTE: sampled evenly over the plot x range [0, 1], that is angles [0, pi] on the unit circle
+    struct Target
+    {
+        float sample_real[NUM_TARGET_SAMPLES];
+        float sample_imaginary[NUM_TARGET_SAMPLES];
+        float ln_magnitude[NUM_TARGET_SAMPLES];
+        // NOTE: 1 where the target has been drawn, 0 elsewhere
+        float weight[NUM_TARGET_SAMPLES];
+        uint num_drawn;
+        int last_drawn_idx;
+    };
+
+    struct Solver
+    {
+        float damping;
+        float cost;
+        uint num_iterations;
+        uint num_accepted;
+    };
+
+    // NOTE: poles are kept inside the unit circle so the fitted filter stays stable
+    float const MAX_POLE_RADIUS = 0.99f;
+    float const MAX_ZERO_RADIUS = 4.0f;
+    // NOTE: limits how far a parameter moves in one iteration, so the widget moves smoothly
+    float const MAX_STEP = 0.1f;
+    float const MIN_DISTANCE_SQUARED = 1.0E-12f;
+    float const LN_2 = 0.693147181f;
+
+    void
+    clear_target(Target *const target)
+    {
+        for(uint idx=0; idx < NUM_TARGET_SAMPLES; idx++)
+        {
+            target->ln_magnitude[idx] = 0.0f;
+            target->weight[idx] = 0.0f;
+        }
+        target->num_drawn = 0;
+        target->last_drawn_idx = -1;
+    }
+
+    void
+    initialize_target(Target *const target)
+    {
+        for(uint idx=0; idx < NUM_TARGET_SAMPLES; idx++)
+        {
+            float const angle = PI_FLOAT*float(idx)/float(NUM_TARGET_SAMPLES - 1);
+            target->sample_real[idx] = Numerics::cos(angle);
+            target->sample_imaginary[idx] = Numerics::sin(angle);
+        }
+        clear_target(target);
+    }
+
+    inline void
+    set_target_sample(Target *const target, int const idx, float const ln_magnitude)
+    {
+        if(target->weight[idx] == 0.0f)
+            target->num_drawn++;
+        target->weight[idx] = 1.0f;
+        target->ln_magnitude[idx] = ln_magnitude;
+    }
+
+    // NOTE:
+    // Sets the target at x (in plot data), and if the stroke continues, everything between the previous point and
+    // this one too, so that fast mouse movements don't leave gaps.
+    void
+    draw_target(Target *const target, float const x_plotdata, float const ln_magnitude, bool const continue_stroke)
+    {
+        int const idx =
+            Numerics::clamp(0, int(NUM_TARGET_SAMPLES) - 1, int(x_plotdata*float(NUM_TARGET_SAMPLES - 1) + 0.5f));
+
+        if(continue_stroke && target->last_drawn_idx != -1 && target->last_drawn_idx != idx)
+        {
+            int const from_idx = target->last_drawn_idx;
+            float const from_ln_magnitude = target->ln_magnitude[from_idx];
+            int const step = idx > from_idx ? 1 : -1;
+            for(int i=from_idx + step; i != idx; i += step)
+            {
+                float const t = float(i - from_idx)/float(idx - from_idx);
+                set_target_sample(target, i, Numerics::lerp(from_ln_magnitude, ln_magnitude, t));
+            }
+        }
+
+        set_target_sample(target, idx, ln_magnitude);
+        target->last_drawn_idx = idx;
+    }
+
+    // NOTE: the range of plot x covered by the drawn samples, false if nothing has been drawn
+    bool
+    drawn_interval(Target const*const target, float *const min_x_plotdata, float *const max_x_plotdata)
+    {
+        int first_idx = -1;
+        int last_idx = -1;
+        for(int idx=0; idx < int(NUM_TARGET_SAMPLES); idx++)
+        {
+            if(target->weight[idx] == 0.0f)
+                continue;
+            if(first_idx == -1)
+                first_idx = idx;
+            last_idx = idx;
+        }
+        if(first_idx == -1)
+            return false;
+        *min_x_plotdata = float(first_idx)/float(NUM_TARGET_SAMPLES - 1);
+        *max_x_plotdata = float(last_idx)/float(NUM_TARGET_SAMPLES - 1);
+        return true;
+    }
+
+    // NOTE: linear interpolation between the target samples
+    float
+    target_ln_magnitude(Target const*const target, float const x_plotdata)
+    {
+        float const s = Numerics::clamp(0.0f, float(NUM_TARGET_SAMPLES - 1), x_plotdata*float(NUM_TARGET_SAMPLES - 1));
+        int const idx = Numerics::minimum(int(s), int(NUM_TARGET_SAMPLES) - 2);
+        return Numerics::lerp(target->ln_magnitude[idx], target->ln_magnitude[idx + 1], s - float(idx));
+    }
+
+    void
+    reset_solver(Solver *const solver)
+    {
+        solver->damping = 1.0E-3f;
+        solver->cost = POSITIVE_INFINITY_FLOAT;
+        solver->num_iterations = 0;
+        solver->num_accepted = 0;
+    }
+
+    inline float
+    factor_sign(uint const factor_idx)
+    {
+        // NOTE: Parameters::parameters has the two zeros first, then the two poles
+        return factor_idx < 2 ? 1.0f : -1.0f;
+    }
+
+    // NOTE:
+    // Accumulates the cost sum(w*r^2) and, if jtj is non-zero, the normal equations J^T J and J^T r.
+    // Only the lower triangle of J^T J is written.
+    float
+    accumulate(
+        Parameters const*const parameters,
+        Target const*const target,
+        float (*const jtj)[NUM_PARAMETERS],
+        float *const jtr
+        )
+    {
+        using namespace Simd;
+
+        // NOTE: the normalization terms don't depend on the sample point
+        float ln_normalization = 0.0f;
+        float normalization_gradient[NUM_PARAMETERS];
+        for(uint f=0; f < 4; f++)
+        {
+            float const a = parameters->parameters[f].component.real;
+            float const b = parameters->parameters[f].component.imaginary;
+            float const sign = factor_sign(f);
+            float const e_sq = Numerics::maximum(Numerics::square(1.0f + a) + Numerics::square(b), MIN_DISTANCE_SQUARED);
+            ln_normalization -= sign*Numerics::logarithm(2.0f, e_sq)*LN_2;
+            normalization_gradient[2*f + 0] = -sign*2.0f*(1.0f + a)/e_sq;
+            normalization_gradient[2*f + 1] = -sign*2.0f*b/e_sq;
+        }
+
+        bool const with_jacobian = jtj != 0;
+        Float4 const min_distance_squared = set(MIN_DISTANCE_SQUARED);
+        Float4 const half_ln_2 = set(0.5f*LN_2);
+
+        Float4 cost = zero();
+        Float4 jtr_sum[NUM_PARAMETERS];
+        Float4 jtj_sum[NUM_PARAMETERS][NUM_PARAMETERS];
+        for(uint i=0; i < NUM_PARAMETERS; i++)
+        {
+            jtr_sum[i] = zero();
+            for(uint j=0; j <= i; j++)
+            {
+                jtj_sum[i][j] = zero();
+            }
+        }
+
+        for(uint first_idx=0; first_idx < NUM_TARGET_SAMPLES; first_idx += NUM_LANES)
+        {
+            Float4 const weight = load(&target->weight[first_idx]);
+            if(!any(greater_than(weight, zero())))
+                continue;
+
+            Float4 const x = load(&target->sample_real[first_idx]);
+            Float4 const y = load(&target->sample_imaginary[first_idx]);
+
+            Float4 ln_h = set(ln_normalization);
+            Float4 jacobian[NUM_PARAMETERS];
+
+            for(uint f=0; f < 4; f++)
+            {
+                float const a = parameters->parameters[f].component.real;
+                float const b = parameters->parameters[f].component.imaginary;
+                Float4 const sign = set(factor_sign(f));
+
+                Float4 const dx = subtract(x, set(a));
+                Float4 const dy = subtract(y, set(b));
+                Float4 const dy_conjugate = add(y, set(b));
+                Float4 const dx_sq = multiply(dx, dx);
+                Float4 const d_sq = maximum(add(dx_sq, multiply(dy, dy)), min_distance_squared);
+                Float4 const d_conjugate_sq = maximum(add(dx_sq, multiply(dy_conjugate, dy_conjugate)), min_distance_squared);
+
+                ln_h = add(ln_h, multiply(multiply(sign, half_ln_2), add(logarithm2(d_sq), logarithm2(d_conjugate_sq))));
+
+                if(with_jacobian)
+                {
+                    Float4 const inverse = divide(set(1.0f), d_sq);
+                    Float4 const inverse_conjugate = divide(set(1.0f), d_conjugate_sq);
+                    Float4 const d_a = multiply(subtract(zero(), dx), add(inverse, inverse_conjugate));
+                    Float4 const d_b = subtract(multiply(dy_conjugate, inverse_conjugate), multiply(dy, inverse));
+                    jacobian[2*f + 0] = add(multiply(sign, d_a), set(normalization_gradient[2*f + 0]));
+                    jacobian[2*f + 1] = add(multiply(sign, d_b), set(normalization_gradient[2*f + 1]));
+                }
+            }
+
+            // NOTE: the weights are 0 or 1, so weighting the residual and the Jacobian rows weights the squares
+            Float4 const residual = multiply(weight, subtract(ln_h, load(&target->ln_magnitude[first_idx])));
+            cost = add(cost, multiply(residual, residual));
+
+            if(with_jacobian)
+            {
+                for(uint i=0; i < NUM_PARAMETERS; i++)
+                {
+                    jacobian[i] = multiply(weight, jacobian[i]);
+                    jtr_sum[i] = add(jtr_sum[i], multiply(jacobian[i], residual));
+                    for(uint j=0; j <= i; j++)
+                    {
+                        jtj_sum[i][j] = add(jtj_sum[i][j], multiply(jacobian[i], jacobian[j]));
+                    }
+                }
+            }
+        }
+
+        if(with_jacobian)
+        {
+            for(uint i=0; i < NUM_PARAMETERS; i++)
+            {
+                float lanes[NUM_LANES];
+                store(jtr_sum[i], lanes);
+                jtr[i] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+                for(uint j=0; j <= i; j++)
+                {
+                    store(jtj_sum[i][j], lanes);
+                    jtj[i][j] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+                }
+            }
+        }
+
+        float lanes[NUM_LANES];
+        store(cost, lanes);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    // NOTE: solves A x = b for symmetric positive definite A given by its lower triangle, false if A isn't
+    bool
+    cholesky_solve(float (*const a)[NUM_PARAMETERS], float const*const b, float *const x)
+    {
+        float l[NUM_PARAMETERS][NUM_PARAMETERS] = {};
+        for(uint i=0; i < NUM_PARAMETERS; i++)
+        {
+            for(uint j=0; j <= i; j++)
+            {
+                float sum = a[i][j];
+                for(uint k=0; k < j; k++)
+                {
+                    sum -= l[i][k]*l[j][k];
+                }
+                if(i == j)
+                {
+                    if(sum <= 0.0f)
+                        return false;
+                    l[i][i] = Numerics::square_root(sum);
+                }
+                else
+                {
+                    l[i][j] = sum/l[j][j];
+                }
+            }
+        }
+
+        float y[NUM_PARAMETERS];
+        for(uint i=0; i < NUM_PARAMETERS; i++)
+        {
+            float sum = b[i];
+            for(uint k=0; k < i; k++)
+            {
+                sum -= l[i][k]*y[k];
+            }
+            y[i] = sum/l[i][i];
+        }
+        for(int i=int(NUM_PARAMETERS)-1; i >= 0; i--)
+        {
+            float sum = y[i];
+            for(uint k=uint(i)+1; k < NUM_PARAMETERS; k++)
+            {
+                sum -= l[k][i]*x[k];
+            }
+            x[i] = sum/l[i][i];
+        }
+        return true;
+    }
+
+    inline void
+    clamp_radius(float const max_radius, Complex::C *const z)
+    {
+        float const radius_sq = Complex::magnitude_squared(z);
+        if(radius_sq > max_radius*max_radius)
+        {
+            float const s = max_radius/Numerics::square_root(radius_sq);
+            z->component.real *= s;
+            z->component.imaginary *= s;
+        }
+    }
+
+    // NOTE:
+    // One Levenberg-Marquardt iteration: the step is only taken if it lowers the cost,
+    // otherwise the damping goes up and the next iteration tries a shorter, more gradient-like step.
+    // Returns true if the parameters changed.
+    bool
+    iterate(Target const*const target, Solver *const solver, Parameters *const parameters)
+    {
+        if(target->num_drawn == 0)
+            return false;
+
+        float jtj[NUM_PARAMETERS][NUM_PARAMETERS];
+        float jtr[NUM_PARAMETERS];
+        float const cost = accumulate(parameters, target, jtj, jtr);
+        solver->cost = cost;
+        solver->num_iterations++;
+
+        // NOTE: Marquardt's scaling by the diagonal, plus a little to keep parameters the target doesn't see in check
+        float a[NUM_PARAMETERS][NUM_PARAMETERS];
+        float b[NUM_PARAMETERS];
+        for(uint i=0; i < NUM_PARAMETERS; i++)
+        {
+            for(uint j=0; j < i; j++)
+            {
+                a[i][j] = jtj[i][j];
+            }
+            a[i][i] = jtj[i][i]*(1.0f + solver->damping) + 1.0E-6f;
+            b[i] = -jtr[i];
+        }
+
+        float step[NUM_PARAMETERS];
+        if(!cholesky_solve(a, b, step))
+        {
+            solver->damping = Numerics::minimum(solver->damping*10.0f, 1.0E7f);
+            return false;
+        }
+
+        Parameters candidate = *parameters;
+        for(uint f=0; f < 4; f++)
+        {
+            for(uint k=0; k < 2; k++)
+            {
+                candidate.parameters[f].components[k] += Numerics::clamp(-MAX_STEP, MAX_STEP, step[2*f + k]);
+            }
+            clamp_radius(f < 2 ? MAX_ZERO_RADIUS : MAX_POLE_RADIUS, &candidate.parameters[f]);
+        }
+
+        float const candidate_cost = accumulate(&candidate, target, 0, 0);
+        if(candidate_cost < cost)
+        {
+            *parameters = candidate;
+            solver->cost = candidate_cost;
+            solver->num_accepted++;
+            solver->damping = Numerics::maximum(solver->damping/3.0f, 1.0E-7f);
+            return true;
+        }
+        else
+        {
+            solver->damping = Numerics::minimum(solver->damping*4.0f, 1.0E7f);
+            return false;
+        }
+    }
+
+}
@@ -0,0 +1,483 @@
+// NOTE: the one recorder of a frame, for WinMain and the snapshots alike, so both executors run the same commands.
+// The curves are nearly all the work, so they are sampled first, a plot per task on the worker threads, see sample_curves.
+namespace FramePasses
+{
+
+    // NOTE: the layout of the application window, for WinMain and the snapshots alike
+    uint const VIEWPORT_X_DIMENSION_SCREEN = 1024;
+    uint const VIEWPORT_Y_DIMENSION_SCREEN = 800;
+    uint const WIDGETVIEWPORT_X_DIMENSION_SCREEN = 400;
+    uint const WIDGETVIEWPORT_Y_DIMENSION_SCREEN = 400;
+    uint const PLOTVIEWPORTMARGIN_DIMENSION_CHARACTERS = 8;
+    uint const CHARACTER_SPACING_SCREEN = 1;
+    uint const GRID_BASE = 10;
+    // NOTE: the response curves are decimated to their minimum and maximum in each slice, see Response::curve_vertices
+    uint const NUM_CURVE_SLICES = 400;
+    uint const NUM_CURVE_VERTICES = 2*NUM_CURVE_SLICES;
+    float const ZOOM_STEP_SIZE = 0.06f;
+
+    // NOTE:
+    // The extents of the plots before zooming, and where they are centered. On a logarithmic frequency axis x is the
+    // logarithm of the frequency in the grid base, and the plots show the top few decades.
+    float const FREQUENCY_PLOT_UNZOOMED_X_DIMENSION_LINEAR[2] = {1.05f, 1.15f};
+    float const FREQUENCY_PLOT_CENTER_X_LINEAR = 0.5f;
+    float const FREQUENCY_PLOT_NUM_DECADES = 3.0f;
+    // NOTE: the curves stop this many decades down, where there is nothing more to see
+    double const FREQUENCY_PLOT_MIN_X_LOGARITHMIC = -9.0;
+    float const MAGNITUDE_PLOT_UNZOOMED_Y_DIMENSION_LINEAR = 1.6f;
+    float const MAGNITUDE_PLOT_UNZOOMED_Y_DIMENSION_DECIBELS = 90.0f;
+    float const MAGNITUDE_PLOT_CENTER_Y_LINEAR = 0.75f;
+    float const MAGNITUDE_PLOT_CENTER_Y_DECIBELS = -30.0f;
+    float const PHASE_PLOT_UNZOOMED_Y_DIMENSION = 1.05f;
+    float const PHASE_PLOT_CENTER_Y = 0.0f;
+
+    // NOTE: a plot of a frame, where it is in the window, what it shows and where that is panned and zoomed to
+    struct Plot
+    {
+        float min_x_viewport;
+        float max_x_viewport;
+        float min_y_viewport;
+        float max_y_viewport;
+        // NOTE: the color bar goes in this much room left of the plot
+        float margin_x_dimension_viewport;
+        Grid::Transform x_transform;
+        Grid::Transform y_transform;
+        Response::Curve curve;
+        // NOTE: drawn over the curve, in the curve's units, when it is not 0 and something has been drawn in it
+        Fit::Target const* fit_target_or_0;
+        // NOTE: the caches of the plot, which nothing else touches
+        Response::DenseCurve* dense_curve;
+        Grid::Layout::Axis* grid_layouts;
+        // NOTE: room for the 2*num_curve_slices vertices of the curve, filled by sample_curves
+        float* curve_vertices;
+    };
+
+    struct Frame
+    {
+        uint viewport_x_dimension_screen;
+        uint viewport_y_dimension_screen;
+        Parameters const* parameters;
+
+        // NOTE: the magnitude density on top and the domain coloring below, the contours and the locus are 0 when hidden
+        WidgetLayoutConstants widget_layouts[2];
+        Contour::Contours const* contours_or_0;
+        bool contours_changed;
+        RootLocus::Locus const* locus_or_0;
+        bool locus_changed;
+
+        uint character_spacing_screen;
+        // NOTE: the width of the margin the labels are written into
+        int max_num_label_characters;
+        uint grid_base;
+        float smallest_visible_horizontal_level_spacing_viewport;
+        float smallest_visible_vertical_level_spacing_viewport;
+        Grid::LabelCache::Cache* label_cache;
+        Grid::GlyphBatch::Batch* glyph_batch;
+
+        Plot* plots;
+        uint num_plots;
+        bool log_frequency_axis;
+        double frequency_plot_min_x_logarithmic;
+        double frequency_log_base_or_0;
+        uint num_curve_slices;
+    };
+
+    // NOTE: the magnitude density, with the contours over it and the markers and the root locus over those, and the domain coloring and its markers
+    void
+    record_widgets(Frame const*const frame, RenderCommands::CommandList *const list)
+    {
+        uint const viewport_scissor_idx =
+            RenderCommands::scissor(0, 0, int(frame->viewport_x_dimension_screen), int(frame->viewport_y_dimension_screen), list);
+
+        {
+            uint const layout_idx = RenderCommands::widget_layout(&frame->widget_layouts[0], list);
+
+            RenderCommands::draw(
+                RenderCommands::TopWidgetLayer,
+                RenderCommands::DensityCircle,
+                layout_idx,
+                viewport_scissor_idx,
+                RenderCommands::CircleVertexBuffer,
+                0, 0, 3*NUM_RADIAL_SEGMENTS, 0,
+                list
+                );
+
+            Contour::Contours const*const contours = frame->contours_or_0;
+            if(contours != 0)
+            {
+                RenderCommands::set_vertex_data(
+                    RenderCommands::ContourVertexBuffer,
+                    contours->vertices,
+                    uint(sizeof(float))*2*contours->num_vertices,
+                    frame->contours_changed,
+                    list
+                    );
+
+                for(uint polyline_idx=0; polyline_idx < contours->num_polylines; polyline_idx++)
+                {
+                    Contour::Polyline const*const polyline = &contours->polylines[polyline_idx];
+                    RenderCommands::draw(
+                        RenderCommands::TopWidgetLayer,
+                        RenderCommands::ContourLines,
+                        layout_idx,
+                        viewport_scissor_idx,
+                        RenderCommands::ContourVertexBuffer,
+                        0, polyline->first_vertex_idx, polyline->num_vertices, 0,
+                        list
+                        );
+                }
+            }
+
+            RenderCommands::draw(
+                RenderCommands::TopWidgetLayer,
+                RenderCommands::MarkerShapes,
+                layout_idx,
+                viewport_scissor_idx,
+                RenderCommands::MarkerVertexBuffer,
+                0, 0, 15, 8,
+                list
+                );
+
+            RootLocus::Locus const*const locus = frame->locus_or_0;
+            if(locus != 0)
+            {
+                RenderCommands::set_vertex_data(
+                    RenderCommands::LocusVertexBuffer,
+                    locus->vertices,
+                    uint(sizeof(float))*2*RootLocus::NUM_VERTICES,
+                    frame->locus_changed,
+                    list
+                    );
+
+                // NOTE: one line strip per root
+                for(uint root_idx=0; root_idx < RootLocus::ORDER; root_idx++)
+                {
+                    RenderCommands::draw(
+                        RenderCommands::TopWidgetLayer,
+                        RenderCommands::LocusLines,
+                        layout_idx,
+                        viewport_scissor_idx,
+                        RenderCommands::LocusVertexBuffer,
+                        0, root_idx*RootLocus::NUM_STEPS, RootLocus::NUM_STEPS, 0,
+                        list
+                        );
+                }
+            }
+        }
+
+        {
+            uint const layout_idx = RenderCommands::widget_layout(&frame->widget_layouts[1], list);
+
+            RenderCommands::draw(
+                RenderCommands::BottomWidgetLayer,
+                RenderCommands::DomainColoringCircle,
+                layout_idx,
+                viewport_scissor_idx,
+                RenderCommands::CircleVertexBuffer,
+                0, 0, 3*NUM_RADIAL_SEGMENTS, 0,
+                list
+                );
+            RenderCommands::draw(
+                RenderCommands::BottomWidgetLayer,
+                RenderCommands::MarkerShapes,
+                layout_idx,
+                viewport_scissor_idx,
+                RenderCommands::MarkerVertexBuffer,
+                0, 0, 15, 8,
+                list
+                );
+        }
+    }
+
+    // NOTE: the grid lines of every plot, and all their labels in one glyph batch
+    void
+    record_grids(Frame const*const frame, RenderCommands::CommandList *const list)
+    {
+        uint const viewport_scissor_idx =
+            RenderCommands::scissor(0, 0, int(frame->viewport_x_dimension_screen), int(frame->viewport_y_dimension_screen), list);
+
+        Grid::GlyphBatch::clear(frame->glyph_batch);
+        for(uint plot_idx=0; plot_idx < frame->num_plots; plot_idx++)
+        {
+            Plot const*const plot = &frame->plots[plot_idx];
+            // NOTE: the labels end at the left and the bottom edge of the plot
+            RenderCommands::record_grid(
+                frame->character_spacing_screen,
+                frame->grid_base,
+                frame->smallest_visible_horizontal_level_spacing_viewport,
+                frame->smallest_visible_vertical_level_spacing_viewport,
+                plot->min_x_viewport,
+                plot->max_x_viewport,
+                plot->min_y_viewport,
+                plot->max_y_viewport,
+                frame->viewport_x_dimension_screen,
+                frame->viewport_y_dimension_screen,
+                plot->min_x_viewport,
+                plot->min_y_viewport,
+                &plot->y_transform,
+                &plot->x_transform,
+                Grid::Scale::Linear,
+                frame->log_frequency_axis ? Grid::Scale::Logarithmic : Grid::Scale::Linear,
+                frame->max_num_label_characters,
+                viewport_scissor_idx,
+                &plot->grid_layouts[Grid::Orientation::Horizontal],
+                &plot->grid_layouts[Grid::Orientation::Vertical],
+                frame->label_cache,
+                frame->glyph_batch,
+                list
+                );
+        }
+
+        RenderCommands::record_glyph_batch(frame->glyph_batch, viewport_scissor_idx, list);
+    }
+
+    // NOTE: where the curve of a plot is, the part of the whole frequency range the plot shows
+    inline void
+    curve_interval(Frame const*const frame, Plot const*const plot, double *const min_x_plotdata, double *const max_x_plotdata)
+    {
+        *min_x_plotdata =
+            Numerics::maximum(
+                frame->log_frequency_axis ? frame->frequency_plot_min_x_logarithmic : 0.0,
+                plot->x_transform.viewport_min_data
+                );
+        *max_x_plotdata =
+            Numerics::minimum(
+                frame->log_frequency_axis ? 0.0 : 1.0,
+                plot->x_transform.viewport_max_data
+                );
+    }
+
+    // NOTE: the fit target from min_x_plotdata to max_x_plotdata, in the units of the plot's curve
+    void
+    fit_target_vertices(
+        Frame const*const frame,
+        Plot const*const plot,
+        double const min_x_plotdata,
+        double const max_x_plotdata,
+        float *const vertices
+        )
+    {
+        uint const num_curve_segments = frame->num_curve_slices - 1;
+        for(uint slice_idx=0; slice_idx < frame->num_curve_slices; slice_idx++)
+        {
+            double const t = double(slice_idx)/double(num_curve_segments);
+            double const x_plotdata = min_x_plotdata + (max_x_plotdata - min_x_plotdata)*t;
+            float const ln_magnitude =
+                Fit::target_ln_magnitude(
+                    plot->fit_target_or_0,
+                    float(Response::sample_x(x_plotdata, frame->frequency_log_base_or_0))
+                    );
+            vertices[slice_idx] =
+                plot->curve == Response::MagnitudeDecibels ?
+                ln_magnitude*Response::DECIBELS_PER_LN :
+                expf(ln_magnitude);
+        }
+    }
+
+    void
+    sample_curve_task(void* data, uint task_idx)
+    {
+        Frame const*const frame = (Frame*)data;
+        Plot const*const plot = &frame->plots[task_idx];
+        double min_x_plotdata;
+        double max_x_plotdata;
+        curve_interval(frame, plot, &min_x_plotdata, &max_x_plotdata);
+        if(min_x_plotdata >= max_x_plotdata)
+        {
+            return;
+        }
+
+        Response::curve_vertices(
+            frame->parameters,
+            plot->curve,
+            frame->log_frequency_axis ? frame->frequency_plot_min_x_logarithmic : 0.0,
+            frame->log_frequency_axis ? 0.0 : 1.0,
+            min_x_plotdata,
+            max_x_plotdata,
+            frame->frequency_log_base_or_0,
+            frame->num_curve_slices,
+            plot->dense_curve,
+            plot->curve_vertices
+            );
+    }
+
+    // NOTE:
+    // Samples the curves of the plots into their curve_vertices, at the same time on the worker threads or else one
+    // after the other, before the frame is recorded, so record only copies them.
+    void
+    sample_curves(Frame const*const frame, bool const parallel)
+    {
+        if(parallel)
+        {
+            Platform::parallel_for(frame->num_plots, sample_curve_task, (void*)frame);
+        }
+        else
+        {
+            for(uint plot_idx=0; plot_idx < frame->num_plots; plot_idx++)
+            {
+                sample_curve_task((void*)frame, plot_idx);
+            }
+        }
+    }
+
+    // NOTE: the color bars and the curves of the plots, and the fit targets over them
+    void
+    record_plots(Frame const*const frame, RenderCommands::CommandList *const list)
+    {
+        uint const num_curve_slices = frame->num_curve_slices;
+        uint const num_curve_vertices = 2*num_curve_slices;
+        double const frequency_log_base_or_0 = frame->frequency_log_base_or_0;
+        uint const viewport_scissor_idx =
+            RenderCommands::scissor(0, 0, int(frame->viewport_x_dimension_screen), int(frame->viewport_y_dimension_screen), list);
+
+        for(uint plot_idx=0; plot_idx < frame->num_plots; plot_idx++)
+        {
+            Plot const*const plot = &frame->plots[plot_idx];
+
+            // NOTE:
+            // The x coordinates that go to the GPU are relative to the left edge of the plot, so they stay small
+            // and precise however far in the plot is zoomed. The y coordinates stay absolute, they are needed as is
+            // for the colors of the phase plot, and the curve values can't be resolved any finer than a float anyway.
+            double const origin_x_plotdata = plot->x_transform.viewport_min_data;
+            double min_x_plotdata;
+            double max_x_plotdata;
+            curve_interval(frame, plot, &min_x_plotdata, &max_x_plotdata);
+
+            PlotConstants constants = {};
+            constants.plotviewport_data[0] = 0.0f;
+            constants.plotviewport_data[1] = float(plot->x_transform.viewport_max_data - origin_x_plotdata);
+            constants.plotviewport_data[2] = float(plot->y_transform.viewport_min_data);
+            constants.plotviewport_data[3] = float(plot->y_transform.viewport_max_data);
+            constants.plotviewport_viewport[0] = plot->min_x_viewport;
+            constants.plotviewport_viewport[1] = plot->max_x_viewport;
+            constants.plotviewport_viewport[2] = plot->min_y_viewport;
+            constants.plotviewport_viewport[3] = plot->max_y_viewport;
+            constants.curve_interval_x_data[0] = float(min_x_plotdata - origin_x_plotdata);
+            constants.curve_interval_x_data[1] = float(max_x_plotdata - origin_x_plotdata);
+            constants.num_curve_slices = num_curve_vertices;
+            constants.margin_x_dimension_viewport = plot->margin_x_dimension_viewport;
+            constants.curve_color[0] = 1.0f;
+            constants.curve_color[1] = 1.0f;
+            constants.curve_color[2] = 0.0f;
+            constants.curve_color[3] = 1.0f;
+            uint const plot_constants_idx = RenderCommands::plot(&constants, list);
+
+            RenderCommands::draw(
+                RenderCommands::PlotLayer,
+                plot->curve == Response::PhaseTurns ? RenderCommands::PhaseColorbar : RenderCommands::MagnitudeColorbar,
+                plot_constants_idx,
+                viewport_scissor_idx,
+                RenderCommands::NoVertexBuffer,
+                0, 0, 4, 0,
+                list
+                );
+
+            // NOTE: panned all the way past either end of the frequencies, there is no curve to draw
+            if(min_x_plotdata >= max_x_plotdata)
+            {
+                continue;
+            }
+
+            // NOTE: the curves are clipped to the plot, truncated to whole pixels
+            uint const plot_scissor_idx =
+                RenderCommands::scissor(
+                    int((plot->min_x_viewport + 1.0f)*0.5f*float(frame->viewport_x_dimension_screen)),
+                    int((1.0f - plot->max_y_viewport)*0.5f*float(frame->viewport_y_dimension_screen)),
+                    int((plot->max_x_viewport + 1.0f)*0.5f*float(frame->viewport_x_dimension_screen)),
+                    int((1.0f - plot->min_y_viewport)*0.5f*float(frame->viewport_y_dimension_screen)),
+                    list
+                    );
+
+            {
+                uint vertex_offset = 0;
+                float *const vertices = RenderCommands::transient_vertices(num_curve_vertices, list, &vertex_offset);
+                if(vertices != 0)
+                {
+                    memcpy(vertices, plot->curve_vertices, sizeof(float)*num_curve_vertices);
+
+                    RenderCommands::draw(
+                        RenderCommands::PlotLayer,
+                        RenderCommands::CurveLines,
+                        plot_constants_idx,
+                        plot_scissor_idx,
+                        RenderCommands::TransientVertexBuffer,
+                        vertex_offset, 0, num_curve_vertices, 0,
+                        list
+                        );
+                }
+            }
+
+            // NOTE: the fit target over the curve, its constants come after the curve's so it's drawn after it
+            float target_min_frequency;
+            float target_max_frequency;
+            if(plot->fit_target_or_0 != 0 && Fit::drawn_interval(plot->fit_target_or_0, &target_min_frequency, &target_max_frequency))
+            {
+                // NOTE: the target is drawn in frequency, which only matches x on a linear axis
+                double target_min_x_plotdata = double(target_min_frequency);
+                double target_max_x_plotdata = double(target_max_frequency);
+                if(frame->log_frequency_axis)
+                {
+                    target_min_x_plotdata =
+                        target_min_frequency > 0.0f ?
+                        Numerics::logarithm(frequency_log_base_or_0, target_min_x_plotdata) :
+                        min_x_plotdata;
+                    target_max_x_plotdata =
+                        target_max_frequency > 0.0f ?
+                        Numerics::logarithm(frequency_log_base_or_0, target_max_x_plotdata) :
+                        min_x_plotdata;
+                }
+                target_min_x_plotdata = Numerics::maximum(target_min_x_plotdata, min_x_plotdata);
+                target_max_x_plotdata = Numerics::minimum(target_max_x_plotdata, max_x_plotdata);
+
+                uint vertex_offset = 0;
+                float *const vertices =
+                    target_min_x_plotdata < target_max_x_plotdata ?
+                    RenderCommands::transient_vertices(num_curve_slices, list, &vertex_offset) :
+                    0;
+                if(vertices != 0)
+                {
+                    fit_target_vertices(frame, plot, target_min_x_plotdata, target_max_x_plotdata, vertices);
+
+                    constants.curve_interval_x_data[0] = float(target_min_x_plotdata - origin_x_plotdata);
+                    constants.curve_interval_x_data[1] = float(target_max_x_plotdata - origin_x_plotdata);
+                    constants.num_curve_slices = num_curve_slices;
+                    constants.curve_color[0] = 1.0f;
+                    constants.curve_color[1] = 0.3f;
+                    constants.curve_color[2] = 0.3f;
+                    constants.curve_color[3] = 1.0f;
+                    uint const target_constants_idx = RenderCommands::plot(&constants, list);
+
+                    RenderCommands::draw(
+                        RenderCommands::PlotLayer,
+                        RenderCommands::CurveLines,
+                        target_constants_idx,
+                        plot_scissor_idx,
+                        RenderCommands::TransientVertexBuffer,
+                        vertex_offset, 0, num_curve_slices, 0,
+                        list
+                        );
+                }
+            }
+        }
+    }
+
+    // NOTE:
+    // Records and sorts the commands of the frame into list. Anything that takes parallel_for itself has to be brought
+    // up to date before, the curves with sample_curves, and the contours and the root locus.
+    void
+    record(Frame const*const frame, RenderCommands::CommandList *const list)
+    {
+        {
+            float const clear_color[4] = {0.0f, 0.2f, 0.3f, 0.0f};
+            float const normalization_factor = normalization_constant_highpass(frame->parameters);
+            RenderCommands::begin(frame->parameters, normalization_factor, clear_color, list);
+        }
+
+        record_widgets(frame, list);
+        record_grids(frame, list);
+        record_plots(frame, list);
+
+        RenderCommands::sort(list);
+    }
+
+}
@@ -12,6 +12,21 @@ namespace Grid
     uint const FONT_TEXTURE_X_DIMENSION_SCREEN = FONT_NUM_CHARACTERS*FONT_CHARACTER_X_DIMENSION_SCREEN;
     uint const FONT_TEXTURE_Y_DIMENSION_SCREEN = FONT_CHARACTER_Y_DIMENSION_SCREEN;
 
+    // NOTE:
+    // The labels are drawn from a signed distance field of the font, so that they stay sharp at any size.
+    // Every glyph gets a cell with a font pixel of padding all around, which keeps filtering from reaching
+    // into the neighbouring glyph, and each font pixel is FONT_SDF_TEXELS_PER_PIXEL texels across.
+    // Keep these in sync with grid_shaders.hlsl.
+    uint const FONT_SDF_TEXELS_PER_PIXEL = 8;
+    uint const FONT_SDF_PADDING_PIXELS = 1;
+    uint const FONT_SDF_CELL_X_DIMENSION_PIXELS = FONT_CHARACTER_X_DIMENSION_SCREEN + 2*FONT_SDF_PADDING_PIXELS;
+    uint const FONT_SDF_CELL_Y_DIMENSION_PIXELS = FONT_CHARACTER_Y_DIMENSION_SCREEN + 2*FONT_SDF_PADDING_PIXELS;
+    uint const FONT_SDF_TEXTURE_X_DIMENSION =
+        FONT_NUM_CHARACTERS*FONT_SDF_CELL_X_DIMENSION_PIXELS*FONT_SDF_TEXELS_PER_PIXEL;
+    uint const FONT_SDF_TEXTURE_Y_DIMENSION = FONT_SDF_CELL_Y_DIMENSION_PIXELS*FONT_SDF_TEXELS_PER_PIXEL;
+    // NOTE: the distance, in font pixels, from the edge to where the field saturates
+    float const FONT_SDF_SPREAD_PIXELS = float(FONT_SDF_PADDING_PIXELS);
+
     // NOTE: width of message in screen space (in pixels)
     uint const
     message_width_screen(uint const character_spacing_screen, uint const num_characters)
@@ -37,11 +52,40 @@ namespace Grid
         "enum needs to match defined constant"
         );
 
+    // NOTE: on a logarithmic scale the data coordinate is the logarithm (in the grid base) of the value
+    enum Scale
+    {
+        Linear,
+        Logarithmic,
+        NumScales
+    };
+
+    static_assert(
+        int(Scale::Linear) == GRID_SCALE_LINEAR,
+        "enum needs to match defined constant"
+        );
+    static_assert(
+        int(Scale::Logarithmic) == GRID_SCALE_LOGARITHMIC,
+        "enum needs to match defined constant"
+        );
+
+    // NOTE:
+    // The lines within a decade of a logarithmic scale, at 1, 2 and 5 times the power of the base.
+    // Only base ten gets the 2 and 5 lines, other bases just have the decades.
+    uint const NUM_LOGARITHMIC_MULTIPLES = 3;
+    uint const LOGARITHMIC_MULTIPLES[NUM_LOGARITHMIC_MULTIPLES] = {1, 2, 5};
+
+    inline uint
+    num_logarithmic_multiples(uint const base)
+    {
+        return base == 10 ? NUM_LOGARITHMIC_MULTIPLES : 1;
+    }
+
     struct GridLinesContext
     {
         uint num_visible_lines;
         int lowest_visible_level_idx;
-        int min_visible_line_idx;
+        int64 min_visible_line_idx;
         float offset;
         float spacing;
         float power_remainder;
@@ -51,13 +95,23 @@ namespace Grid
         uint line_idx_offset;
         uint orientation;
         uint base;
+        // NOTE:
+        // On a logarithmic scale, line_idx runs over the multiples of every decade_step'th decade,
+        // num_multiples of them per decade. offset is the position of the decade of the first line, spacing is the
+        // distance between decade lines, line_idx_offset is the multiple of the first line and power_remainder
+        // is the alpha of the lines between the decades.
+        uint scale;
+        uint num_multiples;
+        int decade_step;
     };
 
-    // NOTE: We specify a viewport <-> data transform by specifying bounds of the viewport in data space.
+    // NOTE:
+    // We specify a viewport <-> data transform by specifying bounds of the viewport in data space.
+    // Doubles, since a float runs out of distinct values a few zoom levels in when far from the origin.
     struct Transform
     {
-        float viewport_min_data;
-        float viewport_max_data;
+        double viewport_min_data;
+        double viewport_max_data;
     };
     
     namespace GridNumberIterator
@@ -66,8 +120,8 @@ namespace Grid
         struct Context
         {
             uint base;
-            int min_line_idx;
-            int max_line_idx;
+            int64 min_line_idx;
+            int64 max_line_idx;
             int decimal_point_idx;
             int num_digits;
             int power_offset;
@@ -77,11 +131,96 @@ namespace Grid
 
         struct State
         {
-            int line_idx;
+            int64 line_idx;
         };
         
     }    
     
+    // NOTE:
+    // Places the lines of the lowest visible level, once it has been picked, in the transform's data coordinates.
+    void
+    place_grid_lines(
+        uint const base,
+        int const lowest_visible_level_idx,
+        float const lowest_visible_level_spacing_viewport,
+        float const power_remainder,
+        uint const max_power,
+        Orientation const orientation,
+        float const viewport_min_viewport,
+        float const viewport_max_viewport,
+        float const min_transverse_viewport,
+        float const max_transverse_viewport,
+        Transform const*const transform,
+        GridLinesContext *const ctx
+        )
+    {
+
+        double const viewport_min_data = transform->viewport_min_data;
+        double const viewport_max_data = transform->viewport_max_data;
+        double const data_unit_viewport =
+            double(viewport_max_viewport - viewport_min_viewport) / (viewport_max_data - viewport_min_data);
+
+        /*
+
+          What is the viewport position of the leftmost visible line?
+          We know the lowest visible level index, so leftmost_visible_line_idx for that level must be the 
+          smallest integer which satisfies
+
+          grid_spacing_data(lowest_visible_level_idx) * leftmost_visible_line_idx >= min_data
+          base^(lowest_visible_level_idx) * leftmost_visible_line_idx >= min_data
+
+          In other words
+
+          leftmost_visible_line_idx = ceil( min_data / pow(base, lowest_visible_level_idx) )
+
+          The offset of this line is 
+
+          offset_data = leftmost_visible_line_idx * base^(lowest_visible_level_idx) - min_data
+          offset_viewport = data_unit_viewport * offset_data
+
+        */
+
+        double const lowest_visible_level_spacing_data = Numerics::power(double(base), double(lowest_visible_level_idx));
+        int64 const leftmost_visible_line_idx =
+            (int64)Numerics::ceiling( viewport_min_data / lowest_visible_level_spacing_data );
+        int64 const rightmost_visible_line_idx =
+            (int64)Numerics::floor( viewport_max_data / lowest_visible_level_spacing_data );
+
+        uint const num_visible_lines = (uint)(rightmost_visible_line_idx - leftmost_visible_line_idx) + 1;
+    
+        // NOTE: relative to the viewport minimum, which is what keeps this precise far away from the origin
+        double const offset_data =
+            double(leftmost_visible_line_idx) * lowest_visible_level_spacing_data - viewport_min_data;
+        float const offset_viewport =
+            viewport_min_viewport + float(data_unit_viewport * offset_data);
+    
+        /*
+
+          We need to calculate where in the repeating grid pattern (of length base^max_power) our leftmost
+          grid line falls
+
+        */
+
+        uint const pattern_length = Numerics::power(base, max_power);
+        uint const line_idx_offset = (uint)Numerics::remainder((int64)pattern_length, leftmost_visible_line_idx);
+    
+        ctx->line_idx_offset = line_idx_offset;
+        ctx->offset = offset_viewport;
+        ctx->power_remainder = power_remainder;
+        ctx->spacing = lowest_visible_level_spacing_viewport;
+        ctx->max_power = max_power;
+        ctx->lo = min_transverse_viewport;
+        ctx->hi = max_transverse_viewport;
+        ctx->orientation = int(orientation);
+        ctx->num_visible_lines = num_visible_lines;
+        ctx->lowest_visible_level_idx = lowest_visible_level_idx;
+        ctx->min_visible_line_idx = leftmost_visible_line_idx;
+		ctx->base = base;
+        ctx->scale = Scale::Linear;
+        ctx->num_multiples = 1;
+        ctx->decade_step = 1;
+    }
+
     void
     grid_lines(
         uint const base,
@@ -96,17 +235,17 @@ namespace Grid
         )
     {
         
-        float const viewport_min_data = transform->viewport_min_data;
-        float const viewport_max_data = transform->viewport_max_data;
-        float const viewport_center_data = (viewport_min_data + viewport_max_data)/2.0f;
+        // NOTE:
+        // The data bounds are doubles, so that deep zooms still have distinct lines. Everything that ends up in
+        // viewport units (offset, spacing) is small again, so the context stays in floats.
+        double const viewport_min_data = transform->viewport_min_data;
+        double const viewport_max_data = transform->viewport_max_data;
         float const viewport_length_viewport = viewport_max_viewport - viewport_min_viewport;
-        float const viewport_length_data = viewport_max_data - viewport_min_data;
-        float const data_unit_viewport =
-            viewport_length_viewport / viewport_length_data;
+        double const viewport_length_data = viewport_max_data - viewport_min_data;
+        double const data_unit_viewport =
+            double(viewport_length_viewport) / viewport_length_data;
 
-        // NOTE: smallest/largest visible level spacing in pixels
         assert(viewport_min_viewport < viewport_max_viewport);
-        float const largest_visible_level_spacing_viewport = viewport_length_viewport;
     
         /*
 
@@ -123,8 +262,8 @@ namespace Grid
 
         */
 
-        float const beta =
-            Numerics::logarithm(float(base), data_unit_viewport);
+        double const beta =
+            Numerics::logarithm(double(base), data_unit_viewport);
 
         /*
 
@@ -143,81 +282,213 @@ namespace Grid
 
         */
 
-        float const lowest_visible_power =
-            Numerics::logarithm(float(base), smallest_visible_level_spacing_viewport) - beta;
-        float const highest_visible_power =
-            Numerics::logarithm(float(base), largest_visible_level_spacing_viewport) - beta;
-        float const lowest_visible_level_idx =
+        double const lowest_visible_power =
+            Numerics::logarithm(double(base), double(smallest_visible_level_spacing_viewport)) - beta;
+        double const lowest_visible_level_idx =
             Numerics::ceiling(lowest_visible_power);
 
         // NOTE: the lines have to be spaced by the following distance
         float const lowest_visible_level_spacing_viewport =
-            Numerics::power(float(base), lowest_visible_level_idx + beta);
+            float(Numerics::power(double(base), lowest_visible_level_idx + beta));
 
-        /*
-
-          What is the viewport position of the leftmost visible line?
-          We know the lowest visible level index, so leftmost_visible_line_idx for that level must be the 
-          smallest integer which satisfies
+        // NOTE: only depends on the viewport, not the transform, but Layout keeps the whole result between frames
+        uint const max_power =
+            (uint)Numerics::ceiling(
+                Numerics::logarithm(float(base), viewport_length_viewport/smallest_visible_level_spacing_viewport)
+                );
 
-          grid_spacing_data(lowest_visible_level_idx) * leftmost_visible_line_idx >= min_data
-          base^(lowest_visible_level_idx) * leftmost_visible_line_idx >= min_data
+        double const power_remainder = lowest_visible_level_idx - lowest_visible_power;
+        assert(power_remainder >= 0.0);
+        assert(power_remainder < 1.0);
 
-          In other words
-
-          leftmost_visible_line_idx = ceil( min_data / pow(base, lowest_visible_level_idx) )
+        place_grid_lines(
+            base,
+            int(lowest_visible_level_idx),
+            lowest_visible_level_spacing_viewport,
+            float(power_remainder),
+            max_power,
+            orientation,
+            viewport_min_viewport,
+            viewport_max_viewport,
+            min_transverse_viewport,
+            max_transverse_viewport,
+            transform,
+            ctx
+            );
+    }
 
-          The offset of this line is 
+    inline int64
+    floor_divide(int64 const x, int64 const divisor)
+    {
+        return (x - Numerics::remainder(divisor, x))/divisor;
+    }
 
-          offset_data = leftmost_visible_line_idx * base^(lowest_visible_level_idx) - min_data
-          offset_viewport = data_unit_viewport * offset_data
+    // NOTE: where line line_idx of a logarithmic grid is, in data coordinates
+    inline double
+    logarithmic_line_data(uint const base, uint const num_multiples, int const decade_step, int64 const line_idx)
+    {
+        int64 const decade = floor_divide(line_idx, num_multiples)*decade_step;
+        uint const multiple = LOGARITHMIC_MULTIPLES[Numerics::remainder(int64(num_multiples), line_idx)];
+        return double(decade) + Numerics::logarithm(double(base), double(multiple));
+    }
 
-        */
+    // NOTE:
+    // Grid lines for a logarithmic scale, where the data coordinate is the logarithm of the value.
+    // The lines are at the decades and at 2 and 5 times them, the in-between lines fading out as they get too close,
+    // and when even the decades get too close only every base^k'th decade gets a line.
+    void
+    grid_lines_logarithmic(
+        uint const base,
+        float const smallest_visible_level_spacing_viewport,
+        Orientation const orientation,
+        float const viewport_min_viewport,
+        float const viewport_max_viewport,
+        float const min_transverse_viewport,
+        float const max_transverse_viewport,
+        Transform const*const transform,
+        GridLinesContext *const ctx
+        )
+    {
+        assert(viewport_min_viewport < viewport_max_viewport);
 
-        float const leftmost_visible_line_idx =
-            Numerics::ceiling( viewport_min_data / Numerics::power(float(base), lowest_visible_level_idx) );
-        float const rightmost_visible_line_idx =
-            Numerics::floor( viewport_max_data / Numerics::power(float(base), lowest_visible_level_idx) );
+        double const viewport_min_data = transform->viewport_min_data;
+        double const viewport_max_data = transform->viewport_max_data;
+        float const viewport_length_viewport = viewport_max_viewport - viewport_min_viewport;
+        double const decade_spacing_viewport =
+            double(viewport_length_viewport) / (viewport_max_data - viewport_min_data);
 
-        uint const num_visible_lines = (uint)(rightmost_visible_line_idx - leftmost_visible_line_idx) + 1;
-    
-        float const offset_data =
-            leftmost_visible_line_idx * Numerics::power(float(base), lowest_visible_level_idx) - viewport_min_data;
-        float const offset_viewport =
-            viewport_min_viewport + data_unit_viewport * offset_data;
-    
-        // OPTIMIZE: this is very constant and does not need to be updated all the time
-        uint const max_power =
-            (uint)Numerics::ceiling(
-                Numerics::logarithm(float(base), viewport_length_viewport/smallest_visible_level_spacing_viewport)
-                );
+        // NOTE: the smallest power of the base that spreads the decade lines far enough apart
+        int decade_step = 1;
+        if(decade_spacing_viewport < smallest_visible_level_spacing_viewport)
+        {
+            double const step_power =
+                Numerics::ceiling(
+                    Numerics::logarithm(double(base), smallest_visible_level_spacing_viewport/decade_spacing_viewport)
+                    );
+            decade_step = Numerics::power(int(base), int(step_power));
+        }
 
-        /*
+        // NOTE: the lines within a decade are at least log(2) of a decade apart, and fade in from there
+        uint num_multiples = 1;
+        float multiple_alpha = 0.0f;
+        if(decade_step == 1 && num_logarithmic_multiples(base) > 1)
+        {
+            double const smallest_multiple_spacing_viewport =
+                decade_spacing_viewport*Numerics::logarithm(double(base), 2.0);
+            double const relative_spacing =
+                smallest_multiple_spacing_viewport/double(smallest_visible_level_spacing_viewport);
+            if(relative_spacing >= 1.0)
+            {
+                num_multiples = num_logarithmic_multiples(base);
+                multiple_alpha = 0.5f*Numerics::clamp(0.0f, 1.0f, float(relative_spacing - 1.0));
+            }
+        }
 
-          We need to calculate where in the repeating grid pattern (of length base^max_power) our leftmost
-          grid line falls
+        // NOTE: start from the line of the decade below each end, then step to the first one inside
+        int64 min_visible_line_idx =
+            int64(Numerics::floor(viewport_min_data/double(decade_step)))*int64(num_multiples);
+        while(logarithmic_line_data(base, num_multiples, decade_step, min_visible_line_idx) < viewport_min_data)
+        {
+            min_visible_line_idx++;
+        }
+        int64 max_visible_line_idx =
+            int64(Numerics::floor(viewport_max_data/double(decade_step)))*int64(num_multiples) + (num_multiples - 1);
+        while(logarithmic_line_data(base, num_multiples, decade_step, max_visible_line_idx) > viewport_max_data)
+        {
+            max_visible_line_idx--;
+        }
 
-        */
+        // NOTE: zoomed in between two lines, nothing is visible
+        uint const num_visible_lines =
+            max_visible_line_idx >= min_visible_line_idx ? uint(max_visible_line_idx - min_visible_line_idx + 1) : 0;
 
-        uint const pattern_length = Numerics::power(base, max_power);
-        uint const line_idx_offset = (uint)Numerics::remainder((int)pattern_length, (int)leftmost_visible_line_idx);
-    
-        float const power_remainder = lowest_visible_level_idx - lowest_visible_power;
-        assert(power_remainder >= 0.0f);
-        assert(power_remainder < 1.0f);
+        double const first_decade_data = double(floor_divide(min_visible_line_idx, num_multiples)*decade_step);
 
-        ctx->line_idx_offset = line_idx_offset;
-        ctx->offset = offset_viewport;
-        ctx->power_remainder = power_remainder;
-        ctx->spacing = lowest_visible_level_spacing_viewport;
-        ctx->max_power = max_power;
+        ctx->num_visible_lines = num_visible_lines;
+        ctx->lowest_visible_level_idx = 0;
+        ctx->min_visible_line_idx = min_visible_line_idx;
+        ctx->offset = viewport_min_viewport + float((first_decade_data - viewport_min_data)*decade_spacing_viewport);
+        ctx->spacing = float(decade_spacing_viewport*double(decade_step));
+        ctx->power_remainder = multiple_alpha;
         ctx->lo = min_transverse_viewport;
         ctx->hi = max_transverse_viewport;
-        ctx->orientation = int(orientation);
-        ctx->num_visible_lines = num_visible_lines;
-        ctx->lowest_visible_level_idx = int(lowest_visible_level_idx);
-        ctx->min_visible_line_idx = int(leftmost_visible_line_idx);
-		ctx->base = base;
+        ctx->max_power = 0;
+        ctx->line_idx_offset = uint(Numerics::remainder(int64(num_multiples), min_visible_line_idx));
+        ctx->orientation = uint(orientation);
+        ctx->base = base;
+        ctx->scale = Scale::Logarithmic;
+        ctx->num_multiples = num_multiples;
+        ctx->decade_step = decade_step;
+    }
+
+    // NOTE: position of a visible line, counted from the first visible one, the same as the grid shader does it
+    inline float
+    line_position_viewport(GridLinesContext const*const ctx, int const relative_line_idx)
+    {
+        if(ctx->scale == Scale::Logarithmic)
+        {
+            uint const pattern_idx = uint(relative_line_idx) + ctx->line_idx_offset;
+            uint const decade_idx = pattern_idx / ctx->num_multiples;
+            uint const multiple = LOGARITHMIC_MULTIPLES[pattern_idx % ctx->num_multiples];
+            float const decade_fraction =
+                Numerics::logarithm(float(ctx->base), float(multiple))/float(ctx->decade_step);
+            return ctx->offset + ctx->spacing*(float(decade_idx) + decade_fraction);
+        }
+        return ctx->offset + ctx->spacing*float(relative_line_idx);
+    }
+
+    // NOTE:
+    // The emphasis of each visible line: on a linear grid, the highest power of the base that divides its index
+    // (up to max_power), on a logarithmic grid, 1 for the decades and 0 for the lines in between.
+    // It only depends on which lines are visible, not on how they fade, so it's computed along with the layout
+    // and both the grid shader and the labels read it rather than dividing the indices down for every line.
+    // Rather than taking the power of each line, each power marks the lines it divides: the lines divisible by
+    // base^power are base^power apart.
+    void
+    line_emphasis(GridLinesContext const*const ctx, uint8 *const emphasis)
+    {
+        uint const num_lines = ctx->num_visible_lines;
+        for(uint line_idx=0; line_idx < num_lines; line_idx++)
+        {
+            emphasis[line_idx] = 0;
+        }
+
+        if(ctx->scale == Scale::Logarithmic)
+        {
+            uint const first_decade_line_idx =
+                (ctx->num_multiples - ctx->line_idx_offset % ctx->num_multiples) % ctx->num_multiples;
+            for(uint line_idx=first_decade_line_idx; line_idx < num_lines; line_idx += ctx->num_multiples)
+            {
+                emphasis[line_idx] = 1;
+            }
+            return;
+        }
+
+        assert(ctx->max_power <= 255);
+        uint period = 1;
+        for(uint power=1; power <= ctx->max_power; power++)
+        {
+            period *= ctx->base;
+            uint const first_line_idx = (period - ctx->line_idx_offset % period) % period;
+            for(uint line_idx=first_line_idx; line_idx < num_lines; line_idx += period)
+            {
+                emphasis[line_idx]++;
+            }
+        }
+    }
+
+    // NOTE: alpha of a visible line given its emphasis, the same as the grid shader does it
+    inline float
+    line_alpha(GridLinesContext const*const ctx, uint const emphasis)
+    {
+        if(ctx->scale == Scale::Logarithmic)
+        {
+            return emphasis != 0 ? 1.0f : ctx->power_remainder;
+        }
+
+        return
+            (float(emphasis) + ctx->power_remainder)/
+            float(ctx->max_power+1.0f);
     }
 
     // Convenience function: both horizontal and vertical grid lines in a singgle call
@@ -268,6 +539,13 @@ namespace Grid
     namespace GridNumberIterator
     {
     
+        // NOTE:
+        // The most significant digits a label may have before it is printed with an exponent. The digits are
+        // formed in a uint64, and 15 is about what a double resolves, which is as deep as the zoom goes.
+        int const MAX_NUM_SIGNIFICANT_DIGITS = 15;
+        // NOTE: a double goes down to about base^-324 in base 10
+        int const MAX_NUM_EXPONENT_DIGITS = 3;
+
         // NOTE: This is the longest length that the string can get with the given parameters
         constexpr int
         max_string_length(int const max_num_significant_digits, int const max_num_exponent_digits)
@@ -279,17 +557,65 @@ namespace Grid
                 ;
         }
     
+        // NOTE:
+        // Number of digits of x in the given base (zero has one digit).
+        // Counted in integers, since the float logarithm isn't exact at the powers of the base.
+        inline int
+        count_digits(uint const base, uint64 x)
+        {
+            int n = 1;
+            while(x >= base)
+            {
+                x /= base;
+                n++;
+            }
+            return n;
+        }
+
+        // NOTE: the number of digits and where the decimal point goes, once the power offset has been picked
+        inline void
+        place_digits(int const power_offset, int const level_idx, Context *const ctx)
+        {
+            using namespace Numerics;
+
+            ctx->power_offset = power_offset;
+            ctx->exponent = level_idx - power_offset;
+            ctx->num_digits =
+                ctx->num_significant_digits +
+                maximum(0, power_offset, 1 - power_offset - ctx->num_significant_digits);
+            ctx->decimal_point_idx = ctx->num_digits + minimum(0, power_offset);
+        }
+
+        // NOTE: how long the longest label of the context is, the one of the line furthest from zero
+        inline int
+        max_label_length(Context const*const ctx)
+        {
+            bool const print_sign = ctx->min_line_idx < 0 || ctx->max_line_idx < 0;
+            int const num_fractional_digits = ctx->num_digits - ctx->decimal_point_idx;
+            int const num_exponent_characters =
+                ctx->exponent != 0 ? 2 + count_digits(ctx->base, (uint64)Numerics::absolute_value(ctx->exponent)) : 0;
+            return
+                (print_sign ? 1 : 0) +
+                ctx->num_digits +
+                (num_fractional_digits > 0 ? 1 : 0) +
+                num_exponent_characters;
+        }
+
+        // NOTE:
+        // The context only depends on the grid lines, so it can be kept for as long as they are.
+        // The labels are written out in full as long as they fit in max_num_characters, otherwise they get one digit
+        // in front of the decimal point and the rest of the power in the exponent, if that is any shorter.
         void
-        initialize(
+        initialize_context(
             GridLinesContext const*const grid_ctx,
             int const max_num_significant_digits,
-            Context *const ctx,
-            State *const st
+            int const max_num_characters,
+            Context *const ctx
             )
         {
 
-            int const min_line_idx = grid_ctx->min_visible_line_idx;
-            int const max_line_idx = min_line_idx + grid_ctx->num_visible_lines - 1;
+            int64 const min_line_idx = grid_ctx->min_visible_line_idx;
+            int64 const max_line_idx = min_line_idx + grid_ctx->num_visible_lines - 1;
             int const level_idx = grid_ctx->lowest_visible_level_idx;
         
             using namespace Numerics;
@@ -298,39 +624,86 @@ namespace Grid
                 1 + Numerics::maximum(
                     min_line_idx ==
                     0 ? 1 :
-                    (int)floor(logarithm(float(grid_ctx->base), float(absolute_value(min_line_idx)))),
+                    count_digits(grid_ctx->base, (uint64)absolute_value(min_line_idx)) - 1,
                     max_line_idx ==
                     0 ? 1 :
-                    (int)floor(logarithm(float(grid_ctx->base), float(absolute_value(max_line_idx))))
+                    count_digits(grid_ctx->base, (uint64)absolute_value(max_line_idx)) - 1
                     );
 
             assert(ctx->num_significant_digits > 0);
             assert(ctx->num_significant_digits <= max_num_significant_digits);
+            assert(min_line_idx <= max_line_idx);
 
+            ctx->min_line_idx = min_line_idx;
+            ctx->max_line_idx = max_line_idx;
+            ctx->base = grid_ctx->base;
 
-            ctx->power_offset =
+            place_digits(
                 clamp(
                     1 - max_num_significant_digits,
                     max_num_significant_digits - ctx->num_significant_digits,
                     level_idx
-                    );
-            ctx->exponent = level_idx - ctx->power_offset;
-        
-            ctx->num_digits =
-                ctx->num_significant_digits +
-                maximum(0, ctx->power_offset, 1 - ctx->power_offset - ctx->num_significant_digits);
-        
-            ctx->decimal_point_idx = ctx->num_digits + minimum(0, ctx->power_offset);
+                    ),
+                level_idx,
+                ctx
+                );
+
+            if(max_label_length(ctx) > max_num_characters)
+            {
+                Context scientific = *ctx;
+                place_digits(1 - ctx->num_significant_digits, level_idx, &scientific);
+                if(max_label_length(&scientific) < max_label_length(ctx))
+                {
+                    *ctx = scientific;
+                }
+            }
 
             assert(ctx->decimal_point_idx >= 1);
-            assert(ctx->decimal_point_idx <= ctx->num_digits);    
-            assert(min_line_idx <= max_line_idx);
+            assert(ctx->decimal_point_idx <= ctx->num_digits);
 
-            ctx->min_line_idx = min_line_idx;
-            ctx->max_line_idx = max_line_idx;
-            ctx->base = grid_ctx->base;
-            st->line_idx = max_line_idx;
-        
+        }
+
+        void
+        start(Context const*const ctx, State *const st)
+        {
+            st->line_idx = ctx->max_line_idx;
+        }
+
+        // NOTE:
+        // The labels of a logarithmic grid are multiple*base^decade, which is just the number of a linear grid
+        // line with index multiple at level decade, so each of them gets formatted through a context of its own.
+        // A decade too far from one to be written out in full ends up in the exponent, with the multiple in front.
+        void
+        initialize_logarithmic_context(
+            uint const base,
+            uint const multiple,
+            int const decade,
+            int const max_num_significant_digits,
+            int const max_num_characters,
+            Context *const ctx,
+            State *const st
+            )
+        {
+            GridLinesContext grid_ctx = {};
+            grid_ctx.num_visible_lines = 1;
+            grid_ctx.lowest_visible_level_idx = decade;
+            grid_ctx.min_visible_line_idx = multiple;
+            grid_ctx.base = base;
+            initialize_context(&grid_ctx, max_num_significant_digits, max_num_characters, ctx);
+            start(ctx, st);
+        }
+
+        void
+        initialize(
+            GridLinesContext const*const grid_ctx,
+            int const max_num_significant_digits,
+            int const max_num_characters,
+            Context *const ctx,
+            State *const st
+            )
+        {
+            initialize_context(grid_ctx, max_num_significant_digits, max_num_characters, ctx);
+            start(ctx, st);
         }
 
         void
@@ -360,7 +733,7 @@ namespace Grid
             else
             {
             
-                int const abs_line_idx = absolute_value(st->line_idx);
+                uint64 const abs_line_idx = (uint64)absolute_value(st->line_idx);
                 bool const print_sign = ctx->min_line_idx < 0 || ctx->max_line_idx < 0;
                 bool const skip_leading_zeros = !print_sign && abs_line_idx != 0 && ctx->decimal_point_idx > 1;
                 int const num_fractional_digits = ctx->num_digits - ctx->decimal_point_idx;
@@ -368,13 +741,10 @@ namespace Grid
                 if(skip_leading_zeros)
                 {
                     int const num_leading_zeros =
-                        (int)ceiling(
-                            float(ctx->num_significant_digits) - logarithm(float(ctx->base), float(abs_line_idx))
-                            )
-                        -
-                        1;
+                        ctx->num_significant_digits - count_digits(ctx->base, abs_line_idx);
 
-                    num_skipped_leading_digits = num_leading_zeros;
+                    // NOTE: a number below one still keeps the zero in front of its decimal point
+                    num_skipped_leading_digits = minimum(num_leading_zeros, ctx->decimal_point_idx - 1);
                 }
                 bool const print_exponent = ctx->exponent != 0 && abs_line_idx != 0;
 
@@ -385,19 +755,14 @@ namespace Grid
                 {
             
                     uint const abs_exponent = absolute_value(ctx->exponent);
-                    int const num_exponent_digits =
-                        abs_exponent <= 1.0f ?
-                        1 :
-                        1 + (int)floor(logarithm(float(ctx->base), float(abs_exponent)));
+                    int const num_exponent_digits = count_digits(ctx->base, abs_exponent);
                     assert(num_exponent_digits >= 1);
+                    // NOTE: least significant digit first, so each digit just divides away the previous one
+                    uint exponent_quotient = abs_exponent;
                     for(int exponent_digit_idx=0; exponent_digit_idx < num_exponent_digits; exponent_digit_idx++)
                     {
-                        uint const p = exponent_digit_idx;
-                        uint const r =
-                            remainder(
-                                ctx->base,
-                                abs_exponent / power(ctx->base, p)
-                                );
+                        uint const r = remainder(ctx->base, exponent_quotient);
+                        exponent_quotient /= ctx->base;
                         string[character_idx++] = r;
                     }
 
@@ -417,19 +782,17 @@ namespace Grid
             
                 }
 
+                // NOTE:
+                // The digits are those of base^power_offset*abs_line_idx, least significant first, so rather
+                // than dividing by base^digit_idx for every digit the quotient is divided down as we go.
+                uint64 quotient = power(uint64(ctx->base), (uint)maximum(0, ctx->power_offset)) * abs_line_idx;
+
                 // NOTE: digits after decimal point
 
                 while(digit_idx < num_fractional_digits)
                 {
-                    uint const p = digit_idx;
-                    assert(p >= 0);
-            
-                    uint const r =
-                        remainder(
-                            ctx->base,
-                            (power(ctx->base, (uint)maximum(0, ctx->power_offset)) * abs_line_idx) /
-                            power(ctx->base, p)
-                            );
+                    uint const r = uint(quotient % ctx->base);
+                    quotient /= ctx->base;
 
                     string[character_idx++] = r;
                     digit_idx++;
@@ -444,14 +807,8 @@ namespace Grid
                 // NOTE: digits before decimal point
                 while(digit_idx < ctx->num_digits - num_skipped_leading_digits)
                 {
-                    uint const p = digit_idx;
-                    assert(p >= 0);            
-                    uint const r =
-                        remainder(
-                            ctx->base,
-                            (power(ctx->base, (uint)maximum(0, ctx->power_offset)) * abs_line_idx) /
-                            power(ctx->base, p)
-                            );
+                    uint const r = uint(quotient % ctx->base);
+                    quotient /= ctx->base;
             
                     string[character_idx++] = r;
                     digit_idx++;
@@ -477,6 +834,771 @@ namespace Grid
         }
     
     }
+
+    // NOTE:
+    // The grid lines and the label context of one axis, kept from frame to frame.
+    // They only depend on the transform and on where the plot is in the viewport, so they are only recomputed when
+    // one of those changes, and a frame where nothing moves does no grid math at all.
+    namespace Layout
+    {
+
+        struct Key
+        {
+            Transform transform;
+            float smallest_visible_level_spacing_viewport;
+            float viewport_min_viewport;
+            float viewport_max_viewport;
+            float min_transverse_viewport;
+            float max_transverse_viewport;
+            uint base;
+            Orientation orientation;
+            Scale scale;
+            int max_num_label_characters;
+        };
+
+        struct Statistics
+        {
+            uint num_updates;
+            uint num_recomputes;
+        };
+
+        // NOTE: lines past this many are dropped, at that point they are less than a pixel apart anyway
+        uint const MAX_NUM_LINES = 512;
+
+        struct Axis
+        {
+            Key key;
+            bool valid;
+            GridLinesContext lines;
+            GridNumberIterator::Context labels;
+            // NOTE: with offset_labels the labels are of the line indices less offset_line_idx, see offset_line
+            bool offset_labels;
+            int64 offset_line_idx;
+            GridNumberIterator::Context offset_label;
+            // NOTE: see line_emphasis, one per visible line
+            uint8 emphasis[MAX_NUM_LINES];
+            Statistics stats;
+        };
+
+        void
+        reset_statistics(Statistics *const stats)
+        {
+            stats->num_updates = 0;
+            stats->num_recomputes = 0;
+        }
+
+        void
+        merge(Statistics const*const from, Statistics *const to)
+        {
+            to->num_updates += from->num_updates;
+            to->num_recomputes += from->num_recomputes;
+        }
+
+        void
+        initialize(Axis *const axis)
+        {
+            axis->valid = false;
+            reset_statistics(&axis->stats);
+        }
+
+        inline bool
+        keys_equal(Key const*const a, Key const*const b)
+        {
+            return
+                a->transform.viewport_min_data == b->transform.viewport_min_data &&
+                a->transform.viewport_max_data == b->transform.viewport_max_data &&
+                a->smallest_visible_level_spacing_viewport == b->smallest_visible_level_spacing_viewport &&
+                a->viewport_min_viewport == b->viewport_min_viewport &&
+                a->viewport_max_viewport == b->viewport_max_viewport &&
+                a->min_transverse_viewport == b->min_transverse_viewport &&
+                a->max_transverse_viewport == b->max_transverse_viewport &&
+                a->base == b->base &&
+                a->orientation == b->orientation &&
+                a->scale == b->scale &&
+                a->max_num_label_characters == b->max_num_label_characters;
+        }
+
+        // NOTE:
+        // Deep in a zoom the visible lines differ only in their last few digits, and no way of writing them out
+        // fits in the margin. Then the line of the most emphasis gets a label of its own, and the other lines are
+        // labeled with how far they are from it. That is the line at the largest power of the base.
+        inline int64
+        offset_line(GridLinesContext const*const lines)
+        {
+            int64 const min_line_idx = lines->min_visible_line_idx;
+            int64 const max_line_idx = min_line_idx + int64(lines->num_visible_lines) - 1;
+            int64 const abs_min_line_idx = Numerics::absolute_value(min_line_idx);
+            int64 const abs_max_line_idx = Numerics::absolute_value(max_line_idx);
+            int64 const max_abs_line_idx = abs_min_line_idx > abs_max_line_idx ? abs_min_line_idx : abs_max_line_idx;
+
+            int64 offset_line_idx = min_line_idx;
+            for(int64 spacing=int64(lines->base); spacing <= max_abs_line_idx; spacing *= int64(lines->base))
+            {
+                int64 const first_multiple_line_idx = -floor_divide(-min_line_idx, spacing)*spacing;
+                if(first_multiple_line_idx > max_line_idx)
+                    break;
+                offset_line_idx = first_multiple_line_idx;
+            }
+            return offset_line_idx;
+        }
+
+        // NOTE: returns whether the layout had to be recomputed, the labels are kept to max_num_label_characters if they can be
+        bool
+        update(
+            uint const base,
+            float const smallest_visible_level_spacing_viewport,
+            Orientation const orientation,
+            Scale const scale,
+            float const viewport_min_viewport,
+            float const viewport_max_viewport,
+            float const min_transverse_viewport,
+            float const max_transverse_viewport,
+            Transform const*const transform,
+            int const max_num_label_characters,
+            Axis *const axis
+            )
+        {
+            Key key;
+            key.transform = *transform;
+            key.smallest_visible_level_spacing_viewport = smallest_visible_level_spacing_viewport;
+            key.viewport_min_viewport = viewport_min_viewport;
+            key.viewport_max_viewport = viewport_max_viewport;
+            key.min_transverse_viewport = min_transverse_viewport;
+            key.max_transverse_viewport = max_transverse_viewport;
+            key.base = base;
+            key.orientation = orientation;
+            key.scale = scale;
+            key.max_num_label_characters = max_num_label_characters;
+
+            axis->stats.num_updates++;
+            if(axis->valid && keys_equal(&axis->key, &key))
+                return false;
+
+            if(scale == Scale::Logarithmic)
+            {
+                // NOTE: every label of a logarithmic grid has a context of its own, see add_grid_labels
+                grid_lines_logarithmic(
+                    base,
+                    smallest_visible_level_spacing_viewport,
+                    orientation,
+                    viewport_min_viewport,
+                    viewport_max_viewport,
+                    min_transverse_viewport,
+                    max_transverse_viewport,
+                    transform,
+                    &axis->lines
+                    );
+            }
+            else
+            {
+                grid_lines(
+                    base,
+                    smallest_visible_level_spacing_viewport,
+                    orientation,
+                    viewport_min_viewport,
+                    viewport_max_viewport,
+                    min_transverse_viewport,
+                    max_transverse_viewport,
+                    transform,
+                    &axis->lines
+                    );
+            }
+
+            axis->lines.num_visible_lines = Numerics::minimum(int(axis->lines.num_visible_lines), int(MAX_NUM_LINES));
+            axis->offset_labels = false;
+            axis->offset_line_idx = 0;
+            // NOTE: a small plot can fall between two lines of the lowest level it has room for, and have none
+            if(scale == Scale::Linear && axis->lines.num_visible_lines > 0)
+            {
+                using namespace GridNumberIterator;
+
+                initialize_context(&axis->lines, MAX_NUM_SIGNIFICANT_DIGITS, max_num_label_characters, &axis->labels);
+
+                int const label_length = max_label_length(&axis->labels);
+                if(label_length > max_num_label_characters)
+                {
+                    int64 const offset_line_idx = offset_line(&axis->lines);
+                    GridLinesContext differences = axis->lines;
+                    differences.min_visible_line_idx -= offset_line_idx;
+                    Context difference_labels;
+                    initialize_context(
+                        &differences, MAX_NUM_SIGNIFICANT_DIGITS, max_num_label_characters, &difference_labels
+                        );
+                    if(max_label_length(&difference_labels) < label_length)
+                    {
+                        // NOTE: the offset label is inside the plot, where it has the room to be written out in full
+                        GridLinesContext offset = axis->lines;
+                        offset.num_visible_lines = 1;
+                        offset.min_visible_line_idx = offset_line_idx;
+                        initialize_context(
+                            &offset,
+                            MAX_NUM_SIGNIFICANT_DIGITS,
+                            max_string_length(MAX_NUM_SIGNIFICANT_DIGITS, MAX_NUM_EXPONENT_DIGITS),
+                            &axis->offset_label
+                            );
+                        axis->labels = difference_labels;
+                        axis->offset_labels = true;
+                        axis->offset_line_idx = offset_line_idx;
+                    }
+                }
+            }
+            line_emphasis(&axis->lines, axis->emphasis);
+
+            axis->key = key;
+            axis->valid = true;
+            axis->stats.num_recomputes++;
+            return true;
+        }
+
+    }
+
+    // NOTE:
+    // The labels only change when the view does, so the formatted strings are kept in a least recently used cache.
+    // Panning keeps the labels that stay on screen, so only the newly exposed ones get formatted.
+    // The string of a label depends on its line index, the level and exponent, the base, and, through the
+    // number of significant digits and whether signs are printed, on the range of visible lines,
+    // so all of these make up the key.
+    namespace LabelCache
+    {
+
+        uint const NUM_ENTRIES = 512;
+        // NOTE: power of two, a bit more than the number of entries to keep the chains short
+        uint const NUM_BUCKETS = 1024;
+        uint const NO_ENTRY = 0xFFFFFFFF;
+        int const MAX_LABEL_LENGTH = 24;
+
+        static_assert((NUM_BUCKETS & (NUM_BUCKETS - 1)) == 0, "bucket count must be a power of two");
+
+        struct Key
+        {
+            int64 line_idx;
+            int level_idx;
+            int exponent;
+            int num_significant_digits;
+            uint base;
+            bool print_sign;
+        };
+
+        struct Entry
+        {
+            Key key;
+            uint characters[MAX_LABEL_LENGTH];
+            int length;
+            // NOTE: the least recently used list, from the head (most recent) towards the tail
+            uint more_recent_idx;
+            uint less_recent_idx;
+            uint next_in_bucket_idx;
+        };
+
+        struct Statistics
+        {
+            uint num_lookups;
+            uint num_hits;
+            uint num_evictions;
+        };
+
+        struct Cache
+        {
+            Entry entries[NUM_ENTRIES];
+            uint buckets[NUM_BUCKETS];
+            uint num_used_entries;
+            uint most_recent_idx;
+            uint least_recent_idx;
+            Statistics stats;
+        };
+
+        void
+        reset_statistics(Statistics *const stats)
+        {
+            stats->num_lookups = 0;
+            stats->num_hits = 0;
+            stats->num_evictions = 0;
+        }
+
+        void
+        initialize(Cache *const cache)
+        {
+            for(uint bucket_idx=0; bucket_idx < NUM_BUCKETS; bucket_idx++)
+            {
+                cache->buckets[bucket_idx] = NO_ENTRY;
+            }
+            cache->num_used_entries = 0;
+            cache->most_recent_idx = NO_ENTRY;
+            cache->least_recent_idx = NO_ENTRY;
+            reset_statistics(&cache->stats);
+        }
+
+        inline float
+        hit_rate(Statistics const*const stats)
+        {
+            return stats->num_lookups > 0 ? float(stats->num_hits)/float(stats->num_lookups) : 0.0f;
+        }
+
+        inline bool
+        keys_equal(Key const*const a, Key const*const b)
+        {
+            return
+                a->line_idx == b->line_idx &&
+                a->level_idx == b->level_idx &&
+                a->exponent == b->exponent &&
+                a->num_significant_digits == b->num_significant_digits &&
+                a->base == b->base &&
+                a->print_sign == b->print_sign;
+        }
+
+        inline uint
+        bucket(Key const*const key)
+        {
+            uint h = uint(key->line_idx)*0x9E3779B1u;
+            h ^= uint(uint64(key->line_idx) >> 32)*0x94D049BBu;
+            h ^= uint(key->level_idx)*0x85EBCA77u;
+            h ^= uint(key->exponent)*0xC2B2AE3Du;
+            h ^= uint(key->num_significant_digits)*0x27D4EB2Fu;
+            h ^= key->base*0x165667B1u;
+            h ^= key->print_sign ? 0x5BD1E995u : 0u;
+            h ^= h >> 15;
+            return h & (NUM_BUCKETS - 1);
+        }
+
+        void
+        unlink_recency(Cache *const cache, uint const entry_idx)
+        {
+            Entry *const entry = &cache->entries[entry_idx];
+            if(entry->more_recent_idx != NO_ENTRY)
+                cache->entries[entry->more_recent_idx].less_recent_idx = entry->less_recent_idx;
+            else
+                cache->most_recent_idx = entry->less_recent_idx;
+            if(entry->less_recent_idx != NO_ENTRY)
+                cache->entries[entry->less_recent_idx].more_recent_idx = entry->more_recent_idx;
+            else
+                cache->least_recent_idx = entry->more_recent_idx;
+        }
+
+        void
+        link_most_recent(Cache *const cache, uint const entry_idx)
+        {
+            Entry *const entry = &cache->entries[entry_idx];
+            entry->more_recent_idx = NO_ENTRY;
+            entry->less_recent_idx = cache->most_recent_idx;
+            if(cache->most_recent_idx != NO_ENTRY)
+                cache->entries[cache->most_recent_idx].more_recent_idx = entry_idx;
+            else
+                cache->least_recent_idx = entry_idx;
+            cache->most_recent_idx = entry_idx;
+        }
+
+        void
+        unlink_bucket(Cache *const cache, uint const entry_idx)
+        {
+            uint *link = &cache->buckets[bucket(&cache->entries[entry_idx].key)];
+            while(*link != entry_idx)
+            {
+                assert(*link != NO_ENTRY);
+                link = &cache->entries[*link].next_in_bucket_idx;
+            }
+            *link = cache->entries[entry_idx].next_in_bucket_idx;
+        }
+
+        // NOTE:
+        // Returns the string of the current label of the iterator, formatting it (and evicting the least recently
+        // used label if the cache is full) only if it isn't in the cache.
+        // The string stays valid until the next call.
+        uint const*
+        label(
+            Cache *const cache,
+            GridNumberIterator::Context const*const ctx,
+            GridNumberIterator::State const*const st,
+            int *const length
+            )
+        {
+            Key key;
+            key.line_idx = st->line_idx;
+            key.level_idx = ctx->exponent + ctx->power_offset;
+            key.exponent = ctx->exponent;
+            key.num_significant_digits = ctx->num_significant_digits;
+            key.base = ctx->base;
+            key.print_sign = ctx->min_line_idx < 0 || ctx->max_line_idx < 0;
+
+            cache->stats.num_lookups++;
+
+            uint const bucket_idx = bucket(&key);
+            for(uint entry_idx = cache->buckets[bucket_idx];
+                entry_idx != NO_ENTRY;
+                entry_idx = cache->entries[entry_idx].next_in_bucket_idx)
+            {
+                Entry *const entry = &cache->entries[entry_idx];
+                if(keys_equal(&entry->key, &key))
+                {
+                    cache->stats.num_hits++;
+                    if(cache->most_recent_idx != entry_idx)
+                    {
+                        unlink_recency(cache, entry_idx);
+                        link_most_recent(cache, entry_idx);
+                    }
+                    *length = entry->length;
+                    return entry->characters;
+                }
+            }
+
+            uint entry_idx;
+            if(cache->num_used_entries < NUM_ENTRIES)
+            {
+                entry_idx = cache->num_used_entries++;
+            }
+            else
+            {
+                entry_idx = cache->least_recent_idx;
+                unlink_recency(cache, entry_idx);
+                unlink_bucket(cache, entry_idx);
+                cache->stats.num_evictions++;
+            }
+
+            Entry *const entry = &cache->entries[entry_idx];
+            entry->key = key;
+            GridNumberIterator::number(ctx, st, entry->characters, &entry->length);
+            assert(entry->length <= MAX_LABEL_LENGTH);
+            entry->next_in_bucket_idx = cache->buckets[bucket_idx];
+            cache->buckets[bucket_idx] = entry_idx;
+            link_most_recent(cache, entry_idx);
+
+            *length = entry->length;
+            return entry->characters;
+        }
+
+    }
+
+    // NOTE:
+    // All grid labels of a frame, of all plots, as one flat array of glyph instances,
+    // so that a renderer can draw them with a single instanced draw call.
+    // The glyphs are placed exactly where the per-label shader used to place them.
+    namespace GlyphBatch
+    {
+
+        uint const MAX_NUM_GLYPHS = 8192;
+
+        // NOTE: this is read by the shaders as a structured buffer, so keep it in sync with grid_shaders.hlsl
+#pragma pack(push, 4)
+        struct GlyphInstance
+        {
+            // NOTE: the anchor of the glyph quad, in viewport space
+            float position[2];
+            // NOTE: how far the quad reaches from the anchor, in viewport space
+            float extent[2];
+            uint glyph_idx;
+            uint orientation;
+            float alpha;
+            float __padding;
+        };
+#pragma pack(pop)
+
+        static_assert(sizeof(GlyphInstance) % 16 == 0, "structured buffer stride should be a multiple of 16");
+
+        struct Batch
+        {
+            GlyphInstance glyphs[MAX_NUM_GLYPHS];
+            uint num_glyphs;
+            uint num_labels;
+            // NOTE: glyphs that didn't fit, they are not drawn
+            uint num_dropped_glyphs;
+            // NOTE: labels left out because they would have overlapped a label of more emphasis
+            uint num_culled_labels;
+            // NOTE: screen pixels per font pixel, the glyphs are drawn from the distance field so any size works
+            float glyph_scale;
+        };
+
+        void
+        clear(Batch *const batch)
+        {
+            batch->num_glyphs = 0;
+            batch->num_labels = 0;
+            batch->num_dropped_glyphs = 0;
+            batch->num_culled_labels = 0;
+        }
+
+        void
+        initialize(float const glyph_scale, Batch *const batch)
+        {
+            assert(glyph_scale > 0.0f);
+            batch->glyph_scale = glyph_scale;
+            clear(batch);
+        }
+
+        // NOTE:
+        // The characters are laid out backwards from text_end_position, the last character first,
+        // since that is the order the number strings come in.
+        void
+        add_label(
+            uint const*const characters,
+            int const length,
+            Orientation const orientation,
+            float const text_end_position_viewport,
+            float const text_middle_transverse_position_viewport,
+            float const alpha,
+            uint const end_margin_pixels,
+            uint const character_spacing_pixels,
+            uint const viewport_width_pixels,
+            uint const viewport_height_pixels,
+            Batch *const batch
+            )
+        {
+            float const pixel_width_viewport = 2.0f/float(viewport_width_pixels);
+            float const pixel_height_viewport = 2.0f/float(viewport_height_pixels);
+            float const character_width_pixels = batch->glyph_scale*float(FONT_CHARACTER_X_DIMENSION_SCREEN);
+            float const character_height_pixels = batch->glyph_scale*float(FONT_CHARACTER_Y_DIMENSION_SCREEN);
+            float const character_spacing_scaled_pixels = batch->glyph_scale*float(character_spacing_pixels);
+
+            batch->num_labels++;
+            for(int character_idx=0; character_idx < length; character_idx++)
+            {
+                if(batch->num_glyphs == MAX_NUM_GLYPHS)
+                {
+                    batch->num_dropped_glyphs += length - character_idx;
+                    return;
+                }
+
+                float const offset_pixels =
+                    -(character_width_pixels*float(character_idx+1) +
+                      character_spacing_scaled_pixels*float(character_idx)) -
+                    float(end_margin_pixels);
+
+                GlyphInstance *const glyph = &batch->glyphs[batch->num_glyphs++];
+                if(orientation == Orientation::Vertical)
+                {
+                    glyph->position[0] = text_middle_transverse_position_viewport;
+                    glyph->position[1] = text_end_position_viewport + offset_pixels*pixel_height_viewport;
+                    glyph->extent[0] = character_width_pixels*pixel_height_viewport/2.0f;
+                    glyph->extent[1] = character_height_pixels*pixel_width_viewport;
+                }
+                else
+                {
+                    glyph->position[0] = text_end_position_viewport + offset_pixels*pixel_width_viewport;
+                    glyph->position[1] = text_middle_transverse_position_viewport;
+                    glyph->extent[0] = character_width_pixels*pixel_width_viewport;
+                    glyph->extent[1] = character_height_pixels*pixel_height_viewport/2.0f;
+                }
+                glyph->glyph_idx = characters[character_idx];
+                glyph->orientation = uint(orientation);
+                glyph->alpha = alpha;
+                glyph->__padding = 0.0f;
+            }
+        }
+
+        // NOTE:
+        // The least emphasis (see line_emphasis) a label needs to be drawn, for the labels that are drawn not to overlap.
+        // The labels sit side by side across their text, so it's the height of the glyphs that has to fit between
+        // two lines. Which lines have an emphasis only depends on their indices, so the same labels stay while
+        // panning, and only the zoom changes which are drawn.
+        uint
+        min_label_emphasis(
+            GridLinesContext const*const grid_ctx,
+            float const transverse_screen_unit_viewport,
+            uint const character_spacing_pixels,
+            float const glyph_scale
+            )
+        {
+            float const label_pitch_pixels =
+                glyph_scale*float(FONT_CHARACTER_Y_DIMENSION_SCREEN + character_spacing_pixels);
+            float const spacing_pixels = grid_ctx->spacing/transverse_screen_unit_viewport;
+
+            if(grid_ctx->scale == Scale::Logarithmic)
+            {
+                // NOTE: the closest lines within a decade are those of 1 and 2, log(2) of a decade apart
+                float const closest_spacing_pixels =
+                    grid_ctx->num_multiples > 1 ?
+                    spacing_pixels*Numerics::logarithm(float(grid_ctx->base), 2.0f)/float(grid_ctx->decade_step) :
+                    spacing_pixels;
+                return closest_spacing_pixels >= label_pitch_pixels ? 0 : 1;
+            }
+
+            // NOTE: the lines of emphasis e are base^e lines apart
+            uint emphasis = 0;
+            float emphasized_spacing_pixels = spacing_pixels;
+            while(emphasized_spacing_pixels < label_pitch_pixels && emphasis < grid_ctx->max_power)
+            {
+                emphasized_spacing_pixels *= float(grid_ctx->base);
+                emphasis++;
+            }
+            return emphasis;
+        }
+
+        // NOTE: the labels of all visible lines of a grid, faded like the lines themselves
+        void
+        add_grid_labels(
+            uint const character_spacing_pixels,
+            uint const viewport_width_pixels,
+            uint const viewport_height_pixels,
+            Orientation const orientation,
+            Layout::Axis const*const layout,
+            float const text_end_position_viewport,
+            LabelCache::Cache *const label_cache,
+            Batch *const batch
+            )
+        {
+            using namespace GridNumberIterator;
+
+            GridLinesContext const*const grid_ctx = &layout->lines;
+            Context const*const ctx = &layout->labels;
+            if(grid_ctx->num_visible_lines == 0)
+                return;
+
+            static_assert(
+                max_string_length(MAX_NUM_SIGNIFICANT_DIGITS, MAX_NUM_EXPONENT_DIGITS) <= LabelCache::MAX_LABEL_LENGTH,
+                "the longest label needs to fit in the cache"
+                );
+
+            uint const end_margin_pixels = 3;
+            float const transverse_screen_unit_viewport =
+                orientation == Orientation::Horizontal ?
+                2.0f/float(viewport_height_pixels) : 2.0f/float(viewport_width_pixels);
+
+            uint const min_emphasis =
+                min_label_emphasis(
+                    grid_ctx, transverse_screen_unit_viewport, character_spacing_pixels, batch->glyph_scale
+                    );
+
+            if(grid_ctx->scale == Scale::Logarithmic)
+            {
+                for(uint line_idx=0; line_idx < grid_ctx->num_visible_lines; line_idx++)
+                {
+                    if(layout->emphasis[line_idx] < min_emphasis)
+                    {
+                        batch->num_culled_labels++;
+                        continue;
+                    }
+
+                    int64 const absolute_line_idx = grid_ctx->min_visible_line_idx + line_idx;
+                    int const decade =
+                        int(floor_divide(absolute_line_idx, grid_ctx->num_multiples)*grid_ctx->decade_step);
+                    uint const multiple =
+                        LOGARITHMIC_MULTIPLES[Numerics::remainder(int64(grid_ctx->num_multiples), absolute_line_idx)];
+
+                    Context log_ctx;
+                    State st;
+                    initialize_logarithmic_context(
+                        grid_ctx->base,
+                        multiple,
+                        decade,
+                        MAX_NUM_SIGNIFICANT_DIGITS,
+                        layout->key.max_num_label_characters,
+                        &log_ctx,
+                        &st
+                        );
+
+                    float const text_middle_transverse_position_viewport =
+                        Numerics::floor(
+                            line_position_viewport(grid_ctx, int(line_idx))
+                            /transverse_screen_unit_viewport
+                            ) * transverse_screen_unit_viewport;
+
+                    int length;
+                    uint const*const characters = LabelCache::label(label_cache, &log_ctx, &st, &length);
+
+                    add_label(
+                        characters,
+                        length,
+                        orientation,
+                        text_end_position_viewport,
+                        text_middle_transverse_position_viewport,
+                        line_alpha(grid_ctx, layout->emphasis[line_idx]),
+                        end_margin_pixels,
+                        character_spacing_pixels,
+                        viewport_width_pixels,
+                        viewport_height_pixels,
+                        batch
+                        );
+                }
+                return;
+            }
+
+            State st = {};
+            for(
+                start(ctx, &st);
+                !done(ctx, &st);
+                step(&st)
+                )
+            {
+                // NOTE: the line indices can be huge when zoomed in, but only a screenful of them are visible
+                int const relative_grid_line_idx =
+                    int(st.line_idx + layout->offset_line_idx - grid_ctx->min_visible_line_idx);
+
+                uint const emphasis = layout->emphasis[relative_grid_line_idx];
+                if(emphasis < min_emphasis)
+                {
+                    batch->num_culled_labels++;
+                    continue;
+                }
+
+                float const alpha = line_alpha(grid_ctx, emphasis);
+
+                // NOTE: we clamp to integer-multiples of pixels because we cannot render font with sub-pixel
+                // precision
+                // TODO: get rid of this constraint, makes "crawling" effect when animating
+                float const text_middle_transverse_position_viewport =
+                    Numerics::floor(
+                        line_position_viewport(grid_ctx, relative_grid_line_idx)
+                        /transverse_screen_unit_viewport
+                        ) * transverse_screen_unit_viewport;
+
+                int length;
+                uint const*const characters = LabelCache::label(label_cache, ctx, &st, &length);
+
+                add_label(
+                    characters,
+                    length,
+                    orientation,
+                    text_end_position_viewport,
+                    text_middle_transverse_position_viewport,
+                    alpha,
+                    end_margin_pixels,
+                    character_spacing_pixels,
+                    viewport_width_pixels,
+                    viewport_height_pixels,
+                    batch
+                    );
+            }
+
+            if(layout->offset_labels)
+            {
+                // NOTE:
+                // The offset label goes inside the plot, horizontally at the end of its axis: in the top right
+                // corner for the labels on the left, in the bottom right corner for the labels underneath.
+                Layout::Key const*const key = &layout->key;
+                float const pixel_height_viewport = 2.0f/float(viewport_height_pixels);
+                float const corner_distance_viewport =
+                    (0.5f*batch->glyph_scale*float(FONT_CHARACTER_Y_DIMENSION_SCREEN) + float(end_margin_pixels))*
+                    pixel_height_viewport;
+                float const offset_text_end_position_viewport =
+                    orientation == Orientation::Horizontal ? key->max_transverse_viewport : key->viewport_max_viewport;
+                float const offset_text_middle_position_viewport =
+                    Numerics::floor(
+                        (orientation == Orientation::Horizontal ?
+                         key->viewport_max_viewport - corner_distance_viewport :
+                         key->min_transverse_viewport + corner_distance_viewport)
+                        /pixel_height_viewport
+                        ) * pixel_height_viewport;
+
+                State offset_st;
+                start(&layout->offset_label, &offset_st);
+                int length;
+                uint const*const characters = LabelCache::label(label_cache, &layout->offset_label, &offset_st, &length);
+
+                add_label(
+                    characters,
+                    length,
+                    Orientation::Horizontal,
+                    offset_text_end_position_viewport,
+                    offset_text_middle_position_viewport,
+                    line_alpha(grid_ctx, layout->emphasis[layout->offset_line_idx - grid_ctx->min_visible_line_idx]),
+                    end_margin_pixels,
+                    character_spacing_pixels,
+                    viewport_width_pixels,
+                    viewport_height_pixels,
+                    batch
+                    );
+            }
+        }
+
+    }
     
     inline void
     font_texture(uint32 pixels[FONT_TEXTURE_X_DIMENSION_SCREEN*FONT_TEXTURE_Y_DIMENSION_SCREEN])
@@ -499,5 +1621,74 @@ namespace Grid
         memcpy(pixels, p, sizeof(p));
         
     }
+
+    // NOTE: whether font pixel (x, y) of a character is lit, anything outside of the character is not
+    inline bool
+    font_pixel_lit(uint32 const*const pixels, uint const character_idx, int const x, int const y)
+    {
+        if(
+            x < 0 || x >= int(FONT_CHARACTER_X_DIMENSION_SCREEN) ||
+            y < 0 || y >= int(FONT_CHARACTER_Y_DIMENSION_SCREEN)
+            )
+        {
+            return false;
+        }
+        return pixels[
+            uint(y)*FONT_TEXTURE_X_DIMENSION_SCREEN + character_idx*FONT_CHARACTER_X_DIMENSION_SCREEN + uint(x)
+            ] != 0;
+    }
+
+    // NOTE:
+    // The signed distance field of the bitmap font, with 0.5 on the edges, more inside and less outside.
+    // The glyphs are made of whole pixels, so the distance is exact: it's the distance to the nearest pixel
+    // of the other kind (unlit for texels inside, lit for texels outside), out of the few dozen pixels of the cell.
+    // That is cheap enough to do at startup rather than baking the texture offline.
+    void
+    font_sdf_texture(uint8 texels[FONT_SDF_TEXTURE_X_DIMENSION*FONT_SDF_TEXTURE_Y_DIMENSION])
+    {
+        uint32 pixels[FONT_TEXTURE_X_DIMENSION_SCREEN*FONT_TEXTURE_Y_DIMENSION_SCREEN];
+        font_texture(pixels);
+
+        int const padding = int(FONT_SDF_PADDING_PIXELS);
+        uint const cell_x_dimension_texels = FONT_SDF_CELL_X_DIMENSION_PIXELS*FONT_SDF_TEXELS_PER_PIXEL;
+
+        for(uint texel_y=0; texel_y < FONT_SDF_TEXTURE_Y_DIMENSION; texel_y++)
+        {
+            for(uint texel_x=0; texel_x < FONT_SDF_TEXTURE_X_DIMENSION; texel_x++)
+            {
+                uint const character_idx = texel_x / cell_x_dimension_texels;
+                // NOTE: the texel center in font pixels, from the top left corner of the glyph
+                float const x =
+                    (float(texel_x - character_idx*cell_x_dimension_texels) + 0.5f)/float(FONT_SDF_TEXELS_PER_PIXEL) -
+                    float(padding);
+                float const y = (float(texel_y) + 0.5f)/float(FONT_SDF_TEXELS_PER_PIXEL) - float(padding);
+
+                bool const inside =
+                    font_pixel_lit(pixels, character_idx, int(Numerics::floor(x)), int(Numerics::floor(y)));
+
+                // NOTE: the padding pixels are never lit, and are all it takes to find the edge of an inside texel
+                float nearest_distance_squared = Numerics::square(FONT_SDF_SPREAD_PIXELS);
+                for(int pixel_y=-padding; pixel_y < int(FONT_CHARACTER_Y_DIMENSION_SCREEN) + padding; pixel_y++)
+                {
+                    for(int pixel_x=-padding; pixel_x < int(FONT_CHARACTER_X_DIMENSION_SCREEN) + padding; pixel_x++)
+                    {
+                        if(font_pixel_lit(pixels, character_idx, pixel_x, pixel_y) == inside)
+                        {
+                            continue;
+                        }
+                        float const dx = Numerics::maximum(0.0f, Numerics::maximum(float(pixel_x) - x, x - float(pixel_x + 1)));
+                        float const dy = Numerics::maximum(0.0f, Numerics::maximum(float(pixel_y) - y, y - float(pixel_y + 1)));
+                        nearest_distance_squared = Numerics::minimum(nearest_distance_squared, dx*dx + dy*dy);
+                    }
+                }
+
+                float const distance_pixels = Numerics::square_root(nearest_distance_squared);
+                float const signed_distance_pixels = inside ? -distance_pixels : distance_pixels;
+                float const value =
+                    Numerics::clamp(0.0f, 1.0f, 0.5f - 0.5f*signed_distance_pixels/FONT_SDF_SPREAD_PIXELS);
+                texels[texel_y*FONT_SDF_TEXTURE_X_DIMENSION + texel_x] = uint8(value*255.0f + 0.5f);
+            }
+        }
+    }
     
 }
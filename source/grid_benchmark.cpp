@@ -0,0 +1,146 @@
+// NOTE:
+// Times grid line layout and label generation, which is the CPU side of drawing the grid numbers every frame,
+// over a spread of zoom levels and pans. Run with "-benchmark_labels <num_rounds>".
+// The checksum of all generated characters is logged too, so that changes to the label code can be checked
+// against the previous output.
+// Each zoom level is panned across in small steps, like dragging the plot, so that a run through the label cache
+// shows how much of the formatting it saves.
+namespace GridBenchmark
+{
+
+    uint const NUM_ZOOM_LEVELS = 48;
+    uint const NUM_PANS = 64;
+    uint const NUM_PANS_PER_VIEWPORT = 16;
+
+    struct Result
+    {
+        uint num_labels;
+        uint num_characters;
+        uint checksum;
+        float duration_seconds;
+    };
+
+    void
+    run(uint const base, uint const num_rounds, Grid::LabelCache::Cache *const label_cache_or_0, Result *const result)
+    {
+        using namespace Grid;
+        using namespace Grid::GridNumberIterator;
+
+        uint string[max_string_length(MAX_NUM_SIGNIFICANT_DIGITS, MAX_NUM_EXPONENT_DIGITS)];
+
+        // NOTE: roughly the plot viewport and minimum line spacing of the application
+        float const viewport_min_viewport = -1.0f;
+        float const viewport_max_viewport = +0.5f;
+        float const smallest_visible_level_spacing_viewport = 0.025f;
+
+        result->num_labels = 0;
+        result->num_characters = 0;
+        result->checksum = 0;
+
+        Platform::TimeCount const start = Platform::time_get_count();
+        for(uint round_idx=0; round_idx < num_rounds; round_idx++)
+        {
+            for(uint zoom_idx=0; zoom_idx < NUM_ZOOM_LEVELS; zoom_idx++)
+            {
+                // NOTE: from a thousandth of a unit to a thousand units
+                float const viewport_length_data =
+                    Numerics::power(10.0f, -3.0f + 6.0f*float(zoom_idx)/float(NUM_ZOOM_LEVELS - 1));
+                for(uint pan_idx=0; pan_idx < NUM_PANS; pan_idx++)
+                {
+                    float const center_data =
+                        viewport_length_data*(float(pan_idx) - 0.5f*float(NUM_PANS))/float(NUM_PANS_PER_VIEWPORT);
+
+                    Transform transform;
+                    transform.viewport_min_data = center_data - 0.5f*viewport_length_data;
+                    transform.viewport_max_data = center_data + 0.5f*viewport_length_data;
+
+                    GridLinesContext grid_ctx;
+                    grid_lines(
+                        base,
+                        smallest_visible_level_spacing_viewport,
+                        Orientation::Horizontal,
+                        viewport_min_viewport,
+                        viewport_max_viewport,
+                        0.0f,
+                        1.0f,
+                        &transform,
+                        &grid_ctx
+                        );
+
+                    Context ctx = {};
+                    State st = {};
+                    for(
+                        initialize(
+                            &grid_ctx,
+                            MAX_NUM_SIGNIFICANT_DIGITS,
+                            max_string_length(MAX_NUM_SIGNIFICANT_DIGITS, MAX_NUM_EXPONENT_DIGITS),
+                            &ctx,
+                            &st
+                            );
+                        !done(&ctx, &st);
+                        step(&st)
+                        )
+                    {
+                        int length;
+                        uint const* characters = string;
+                        if(label_cache_or_0 != 0)
+                            characters = LabelCache::label(label_cache_or_0, &ctx, &st, &length);
+                        else
+                            number(&ctx, &st, string, &length);
+                        result->num_labels++;
+                        result->num_characters += length;
+                        for(int character_idx=0; character_idx < length; character_idx++)
+                        {
+                            // NOTE: kept below 2^31, so it logs the same everywhere
+                            result->checksum = uint((uint64(result->checksum)*31 + characters[character_idx]) % 2147483647u);
+                        }
+                    }
+                }
+            }
+        }
+        result->duration_seconds = Platform::time_duration_seconds(start, Platform::time_get_count());
+    }
+
+    void
+    log_result(Result const*const result)
+    {
+        Platform::log_string("grid labels: ");
+        Platform::log_uint32(result->num_labels);
+        Platform::log_string(", characters: ");
+        Platform::log_uint32(result->num_characters);
+        Platform::log_string(", seconds: ");
+        Platform::log_float(result->duration_seconds);
+        Platform::log_string(", labels per second: ");
+        Platform::log_float(
+            result->duration_seconds > 0.0f ? float(result->num_labels)/result->duration_seconds : 0.0f
+            );
+        Platform::log_string(", checksum: ");
+        Platform::log_uint32(result->checksum);
+        Platform::log_line();
+    }
+
+    void
+    log_label_cache_statistics(Grid::LabelCache::Statistics const*const stats)
+    {
+        Platform::log_string("grid label cache: lookups: ");
+        Platform::log_uint32(stats->num_lookups);
+        Platform::log_string(", hits: ");
+        Platform::log_uint32(stats->num_hits);
+        Platform::log_string(", evictions: ");
+        Platform::log_uint32(stats->num_evictions);
+        Platform::log_string(", hit rate: ");
+        Platform::log_float(Grid::LabelCache::hit_rate(stats));
+        Platform::log_line();
+    }
+
+    void
+    log_layout_statistics(Grid::Layout::Statistics const*const stats)
+    {
+        Platform::log_string("grid layout: updates: ");
+        Platform::log_uint32(stats->num_updates);
+        Platform::log_string(", recomputes: ");
+        Platform::log_uint32(stats->num_recomputes);
+        Platform::log_line();
+    }
+
+}
@@ -0,0 +1,821 @@
+// NOTE:
+// Checks the grid labels from GridNumberIterator::number against a reference formatter, over a sweep of line ranges,
+// levels and bases. Run with "-verify_labels <num_ranges>".
+// The reference writes the same label the plain way, most significant digit first, from the exact value of the line.
+// It takes the layout decisions (exponent, number of digits, decimal point) from the context, so on top of comparing
+// the glyphs, each label is also read back and checked to be exactly line_idx*base^level, and all labels of a range
+// are checked to share their exponent and number of fractional digits, which is what checks the context itself.
+// Both formatters are timed too, so a faster label path can be checked against the old output and speed in one go.
+// "-verify_font_sdf <max_glyph_scale>" checks the font distance field instead: the glyphs are drawn from it on the CPU,
+// filtered and blended like font_pixel_shader does, at every whole scale up to max_glyph_scale, and compared with
+// the bitmap font pixel by pixel.
+// "-verify_glyph_batch <num_labels>" checks the glyph batch: random labels in both orientations are added to it, and
+// the corners of every glyph are compared with where the per-label font_vertex_shader used to put them. The batch is
+// filled past MAX_NUM_GLYPHS over and over, to check that what doesn't fit is dropped and counted.
+namespace GridLabelVerifier
+{
+
+    // NOTE: more lines than any plot shows, with room to spare
+    uint const MAX_NUM_RANGE_LINES = 128;
+    int const MIN_LEVEL_IDX = -24;
+    int const MAX_LEVEL_IDX = +24;
+    // NOTE: one less than MAX_NUM_SIGNIFICANT_DIGITS, since a range starting at zero counts one more digit
+    int const MAX_NUM_LINE_IDX_DIGITS = Grid::GridNumberIterator::MAX_NUM_SIGNIFICANT_DIGITS - 1;
+    // NOTE: generous, so a label that is too long shows up as a mismatch rather than overwriting the stack
+    int const MAX_STRING_LENGTH = 64;
+    // NOTE: only the first few mismatches are logged in full
+    uint const MAX_NUM_LOGGED_MISMATCHES = 8;
+
+    struct Result
+    {
+        uint num_ranges;
+        uint num_labels;
+        uint num_mismatches;
+        uint num_wrong_values;
+        uint num_inconsistent_ranges;
+        float number_duration_seconds;
+        float reference_duration_seconds;
+    };
+
+    // NOTE: xorshift, so the sweep is the same on every run
+    inline uint64
+    next_random(uint64 *const state)
+    {
+        uint64 x = *state;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        *state = x;
+        return x;
+    }
+
+    // NOTE: a*b, or false if that doesn't fit in an int64
+    inline bool
+    try_multiply(uint64 const a, uint64 const b, uint64 *const product)
+    {
+        if(a != 0 && b > uint64(INT64_MAX)/a)
+        {
+            return false;
+        }
+        *product = a*b;
+        return true;
+    }
+
+    // NOTE:
+    // The label of line_idx, in reading order, which is the reverse of the order number writes in.
+    // Returns the length.
+    int
+    reference_label(Grid::GridNumberIterator::Context const*const ctx, int64 const line_idx, uint *const string)
+    {
+        int length = 0;
+
+        if(line_idx == 0)
+        {
+            string[length++] = 0;
+            return length;
+        }
+
+        uint64 const abs_line_idx = uint64(line_idx < 0 ? -line_idx : line_idx);
+        bool const print_sign = ctx->min_line_idx < 0 || ctx->max_line_idx < 0;
+        int const num_fractional_digits = ctx->num_digits - ctx->decimal_point_idx;
+
+        // NOTE: the digits of the line index, then the zeros of the power offset and the fractional digits
+        uint digits[MAX_STRING_LENGTH];
+        int num_digits = 0;
+        {
+            uint64 highest_power = 1;
+            while(abs_line_idx/highest_power >= ctx->base)
+            {
+                highest_power *= ctx->base;
+            }
+            for(uint64 p = highest_power; p > 0; p /= ctx->base)
+            {
+                digits[num_digits++] = uint((abs_line_idx/p) % ctx->base);
+            }
+            for(int zero_idx=0; zero_idx < ctx->power_offset + num_fractional_digits; zero_idx++)
+            {
+                digits[num_digits++] = 0;
+            }
+        }
+
+        // NOTE: signed labels are padded to the width of the range, the others only get a zero in front of the point
+        int const min_num_integer_digits = print_sign ? ctx->decimal_point_idx : 1;
+        int const num_padding_zeros = Numerics::maximum(0, min_num_integer_digits + num_fractional_digits - num_digits);
+        int const num_integer_digits = num_padding_zeros + num_digits - num_fractional_digits;
+
+        if(print_sign)
+        {
+            string[length++] = line_idx < 0 ? GRID_NUMBER_FONT_MINUS : GRID_NUMBER_FONT_PLUS;
+        }
+        for(int digit_idx=0; digit_idx < num_padding_zeros + num_digits; digit_idx++)
+        {
+            if(digit_idx == num_integer_digits)
+            {
+                string[length++] = GRID_NUMBER_FONT_DECIMAL_POINT;
+            }
+            string[length++] = digit_idx < num_padding_zeros ? 0 : digits[digit_idx - num_padding_zeros];
+        }
+
+        if(ctx->exponent != 0)
+        {
+            string[length++] = GRID_NUMBER_FONT_EXPONENTIAL_MARKER;
+            string[length++] = ctx->exponent < 0 ? GRID_NUMBER_FONT_MINUS : GRID_NUMBER_FONT_PLUS;
+            uint const abs_exponent = uint(ctx->exponent < 0 ? -ctx->exponent : ctx->exponent);
+            uint highest_power = 1;
+            while(abs_exponent/highest_power >= ctx->base)
+            {
+                highest_power *= ctx->base;
+            }
+            for(uint p = highest_power; p > 0; p /= ctx->base)
+            {
+                string[length++] = (abs_exponent/p) % ctx->base;
+            }
+        }
+
+        return length;
+    }
+
+    struct Reading
+    {
+        bool negative;
+        uint64 mantissa;
+        int num_fractional_digits;
+        int exponent;
+    };
+
+    // NOTE: reads a label as written by number (least significant first), false if it isn't a well formed number
+    bool
+    try_read_label(uint const base, uint const*const string, int const length, Reading *const reading)
+    {
+        reading->negative = false;
+        reading->mantissa = 0;
+        reading->num_fractional_digits = 0;
+        reading->exponent = 0;
+
+        int idx = length - 1;
+        if(idx >= 0 && (string[idx] == GRID_NUMBER_FONT_MINUS || string[idx] == GRID_NUMBER_FONT_PLUS))
+        {
+            reading->negative = string[idx] == GRID_NUMBER_FONT_MINUS;
+            idx--;
+        }
+
+        int num_integer_digits = 0;
+        bool seen_point = false;
+        for(; idx >= 0 && string[idx] != GRID_NUMBER_FONT_EXPONENTIAL_MARKER; idx--)
+        {
+            uint const c = string[idx];
+            if(c == GRID_NUMBER_FONT_DECIMAL_POINT)
+            {
+                if(seen_point)
+                {
+                    return false;
+                }
+                seen_point = true;
+                continue;
+            }
+            if(c >= base)
+            {
+                return false;
+            }
+            if(!try_multiply(reading->mantissa, base, &reading->mantissa))
+            {
+                return false;
+            }
+            reading->mantissa += c;
+            if(seen_point)
+            {
+                reading->num_fractional_digits++;
+            }
+            else
+            {
+                num_integer_digits++;
+            }
+        }
+        // NOTE: a digit on both sides of the point
+        if(num_integer_digits == 0 || (seen_point && reading->num_fractional_digits == 0))
+        {
+            return false;
+        }
+
+        if(idx >= 0)
+        {
+            // NOTE: the exponent always has its sign
+            idx--;
+            if(idx < 0 || (string[idx] != GRID_NUMBER_FONT_MINUS && string[idx] != GRID_NUMBER_FONT_PLUS))
+            {
+                return false;
+            }
+            bool const negative_exponent = string[idx] == GRID_NUMBER_FONT_MINUS;
+            idx--;
+            if(idx < 0)
+            {
+                return false;
+            }
+            for(; idx >= 0; idx--)
+            {
+                if(string[idx] >= base)
+                {
+                    return false;
+                }
+                reading->exponent = reading->exponent*int(base) + int(string[idx]);
+            }
+            if(negative_exponent)
+            {
+                reading->exponent = -reading->exponent;
+            }
+        }
+
+        return true;
+    }
+
+    // NOTE: whether the reading is exactly line_idx*base^level_idx
+    bool
+    reads_as(Reading const*const reading, uint const base, int64 const line_idx, int const level_idx)
+    {
+        if(line_idx == 0 || reading->mantissa == 0)
+        {
+            return line_idx == 0 && reading->mantissa == 0;
+        }
+        if(reading->negative != (line_idx < 0))
+        {
+            return false;
+        }
+
+        uint64 const abs_line_idx = uint64(line_idx < 0 ? -line_idx : line_idx);
+        // NOTE: mantissa*base^(exponent - num_fractional_digits) == abs_line_idx*base^level_idx
+        int const power = reading->exponent - reading->num_fractional_digits - level_idx;
+        uint64 scaled = power >= 0 ? reading->mantissa : abs_line_idx;
+        for(int power_idx=0; power_idx < Numerics::absolute_value(power); power_idx++)
+        {
+            if(!try_multiply(scaled, base, &scaled))
+            {
+                return false;
+            }
+        }
+        return scaled == (power >= 0 ? abs_line_idx : reading->mantissa);
+    }
+
+    void
+    log_label(uint const*const string, int const length)
+    {
+        char const GLYPH_CHARACTERS[] = "0123456789.+-e";
+        char characters[MAX_STRING_LENGTH + 1];
+        int num_characters = 0;
+        for(int idx=length-1; idx >= 0 && num_characters < MAX_STRING_LENGTH; idx--)
+        {
+            characters[num_characters++] =
+                string[idx] < ARRAY_LENGTH(GLYPH_CHARACTERS) - 1 ? GLYPH_CHARACTERS[string[idx]] : '?';
+        }
+        characters[num_characters] = 0;
+        Platform::log_string(characters);
+    }
+
+    void
+    log_mismatch(
+        uint const base,
+        int const level_idx,
+        int64 const line_idx,
+        uint const*const label,
+        int const label_length,
+        uint const*const reference,
+        int const reference_length
+        )
+    {
+        Platform::log_string("label mismatch: base: ");
+        Platform::log_uint32(base);
+        Platform::log_string(", level: ");
+        Platform::log_int(level_idx);
+        Platform::log_string(", line: ");
+        Platform::log_float(float(line_idx));
+        Platform::log_string(", label: ");
+        log_label(label, label_length);
+        Platform::log_string(", reference: ");
+        // NOTE: the reference is in reading order, so reverse it for log_label
+        uint reversed[MAX_STRING_LENGTH];
+        for(int idx=0; idx < reference_length; idx++)
+        {
+            reversed[idx] = reference[reference_length - 1 - idx];
+        }
+        log_label(reversed, reference_length);
+        Platform::log_line();
+    }
+
+    void
+    run(uint const num_ranges, Result *const result)
+    {
+        using namespace Grid;
+        using namespace Grid::GridNumberIterator;
+
+        static uint labels[MAX_NUM_RANGE_LINES][MAX_STRING_LENGTH];
+        static int label_lengths[MAX_NUM_RANGE_LINES];
+        static uint references[MAX_NUM_RANGE_LINES][MAX_STRING_LENGTH];
+        static int reference_lengths[MAX_NUM_RANGE_LINES];
+
+        *result = {};
+        uint64 random_state = 0x9E3779B97F4A7C15ull;
+
+        for(uint range_idx=0; range_idx < num_ranges; range_idx++)
+        {
+            // NOTE: the glyphs only have the digits up to nine
+            uint const base = 2 + uint(next_random(&random_state) % 9);
+            int const level_idx = MIN_LEVEL_IDX + int(next_random(&random_state) % uint64(MAX_LEVEL_IDX - MIN_LEVEL_IDX + 1));
+            uint const num_lines = 1 + uint(next_random(&random_state) % MAX_NUM_RANGE_LINES);
+            // NOTE: half the ranges are as long as they get, the other half squeezed into a margin of 6 to 13 characters
+            int const max_num_characters =
+                range_idx % 2 == 0 ?
+                max_string_length(MAX_NUM_SIGNIFICANT_DIGITS, MAX_NUM_EXPONENT_DIGITS) :
+                6 + int(next_random(&random_state) % 8);
+
+            // NOTE: anywhere from a single digit to the most digits, and a quarter of the ranges cross zero
+            int64 const max_abs_line_idx = int64(Numerics::power(uint64(base), uint(MAX_NUM_LINE_IDX_DIGITS))) - 1;
+            uint const num_magnitude_digits = 1 + uint(next_random(&random_state) % MAX_NUM_LINE_IDX_DIGITS);
+            int64 const magnitude = int64(next_random(&random_state) % Numerics::power(uint64(base), num_magnitude_digits));
+            uint64 const kind = next_random(&random_state) % 4;
+            int64 min_line_idx =
+                kind == 0 ? -int64(next_random(&random_state) % num_lines) :
+                kind == 1 ? -magnitude :
+                magnitude;
+            if(min_line_idx < -max_abs_line_idx)
+            {
+                min_line_idx = -max_abs_line_idx;
+            }
+            if(min_line_idx > max_abs_line_idx - int64(num_lines - 1))
+            {
+                min_line_idx = max_abs_line_idx - int64(num_lines - 1);
+            }
+
+            GridLinesContext grid_ctx = {};
+            grid_ctx.num_visible_lines = num_lines;
+            grid_ctx.lowest_visible_level_idx = level_idx;
+            grid_ctx.min_visible_line_idx = min_line_idx;
+            grid_ctx.base = base;
+
+            Context ctx;
+            State st;
+
+            Platform::TimeCount const number_start = Platform::time_get_count();
+            uint num_range_labels = 0;
+            for(initialize(&grid_ctx, MAX_NUM_SIGNIFICANT_DIGITS, max_num_characters, &ctx, &st); !done(&ctx, &st); step(&st))
+            {
+                number(&ctx, &st, labels[num_range_labels], &label_lengths[num_range_labels]);
+                num_range_labels++;
+            }
+            Platform::TimeCount const reference_start = Platform::time_get_count();
+            for(uint label_idx=0; label_idx < num_range_labels; label_idx++)
+            {
+                reference_lengths[label_idx] =
+                    reference_label(&ctx, ctx.max_line_idx - int64(label_idx), references[label_idx]);
+            }
+            Platform::TimeCount const reference_end = Platform::time_get_count();
+
+            result->number_duration_seconds += Platform::time_duration_seconds(number_start, reference_start);
+            result->reference_duration_seconds += Platform::time_duration_seconds(reference_start, reference_end);
+            result->num_ranges++;
+            result->num_labels += num_range_labels;
+
+            bool consistent = true;
+            bool have_first_reading = false;
+            Reading first_reading = {};
+            for(uint label_idx=0; label_idx < num_range_labels; label_idx++)
+            {
+                int64 const line_idx = ctx.max_line_idx - int64(label_idx);
+                uint const*const label = labels[label_idx];
+                int const length = label_lengths[label_idx];
+                uint const*const reference = references[label_idx];
+                int const reference_length = reference_lengths[label_idx];
+
+                bool same = length == reference_length && length <= LabelCache::MAX_LABEL_LENGTH;
+                for(int idx=0; same && idx < length; idx++)
+                {
+                    same = label[idx] == reference[length - 1 - idx];
+                }
+                if(!same)
+                {
+                    if(result->num_mismatches < MAX_NUM_LOGGED_MISMATCHES)
+                    {
+                        log_mismatch(base, level_idx, line_idx, label, length, reference, reference_length);
+                    }
+                    result->num_mismatches++;
+                }
+
+                Reading reading;
+                if(!try_read_label(base, label, length, &reading) || !reads_as(&reading, base, line_idx, level_idx))
+                {
+                    result->num_wrong_values++;
+                }
+                else if(line_idx != 0)
+                {
+                    if(!have_first_reading)
+                    {
+                        first_reading = reading;
+                        have_first_reading = true;
+                    }
+                    consistent =
+                        consistent &&
+                        reading.exponent == first_reading.exponent &&
+                        reading.num_fractional_digits == first_reading.num_fractional_digits;
+                }
+            }
+            if(!consistent)
+            {
+                result->num_inconsistent_ranges++;
+            }
+        }
+    }
+
+    void
+    log_result(Result const*const result)
+    {
+        Platform::log_string("grid label verifier: ranges: ");
+        Platform::log_uint32(result->num_ranges);
+        Platform::log_string(", labels: ");
+        Platform::log_uint32(result->num_labels);
+        Platform::log_string(", mismatches: ");
+        Platform::log_uint32(result->num_mismatches);
+        Platform::log_string(", wrong values: ");
+        Platform::log_uint32(result->num_wrong_values);
+        Platform::log_string(", inconsistent ranges: ");
+        Platform::log_uint32(result->num_inconsistent_ranges);
+        Platform::log_line();
+        Platform::log_string("labels per second: ");
+        Platform::log_float(
+            result->number_duration_seconds > 0.0f ? float(result->num_labels)/result->number_duration_seconds : 0.0f
+            );
+        Platform::log_string(", reference labels per second: ");
+        Platform::log_float(
+            result->reference_duration_seconds > 0.0f ? float(result->num_labels)/result->reference_duration_seconds : 0.0f
+            );
+        Platform::log_line();
+    }
+
+    uint const MAX_FONT_SDF_GLYPH_SCALE = 16;
+
+    struct FontSdfResult
+    {
+        uint max_glyph_scale;
+        uint num_pixels[MAX_FONT_SDF_GLYPH_SCALE + 1];
+        uint num_mismatches[MAX_FONT_SDF_GLYPH_SCALE + 1];
+        float mean_coverage_error[MAX_FONT_SDF_GLYPH_SCALE + 1];
+    };
+
+    // NOTE: bilinear filtering with clamping, like the font sampler, at a point given in texels
+    float
+    sample_font_sdf(uint8 const*const texels, float const x, float const y)
+    {
+        float const fx = x - 0.5f;
+        float const fy = y - 0.5f;
+        int const x0 = int(Numerics::floor(fx));
+        int const y0 = int(Numerics::floor(fy));
+        float const tx = fx - float(x0);
+        float const ty = fy - float(y0);
+        float values[2][2];
+        for(int j=0; j<2; j++)
+        {
+            for(int i=0; i<2; i++)
+            {
+                int const cx = Numerics::clamp(0, int(Grid::FONT_SDF_TEXTURE_X_DIMENSION) - 1, x0 + i);
+                int const cy = Numerics::clamp(0, int(Grid::FONT_SDF_TEXTURE_Y_DIMENSION) - 1, y0 + j);
+                values[j][i] = float(texels[cy*int(Grid::FONT_SDF_TEXTURE_X_DIMENSION) + cx])/255.0f;
+            }
+        }
+        return
+            (1.0f - ty)*((1.0f - tx)*values[0][0] + tx*values[0][1]) +
+            ty*((1.0f - tx)*values[1][0] + tx*values[1][1]);
+    }
+
+    // NOTE: the field at the center of a screen pixel of a glyph drawn glyph_scale screen pixels per font pixel
+    inline float
+    font_sdf_at_screen_pixel(
+        uint8 const*const texels,
+        uint const character_idx,
+        uint const glyph_scale,
+        int const x,
+        int const y
+        )
+    {
+        using namespace Grid;
+        float const texels_per_screen_pixel = float(FONT_SDF_TEXELS_PER_PIXEL)/float(glyph_scale);
+        float const cell_min_x_texels =
+            float(character_idx*FONT_SDF_CELL_X_DIMENSION_PIXELS*FONT_SDF_TEXELS_PER_PIXEL);
+        float const padding_texels = float(FONT_SDF_PADDING_PIXELS*FONT_SDF_TEXELS_PER_PIXEL);
+        return sample_font_sdf(
+            texels,
+            cell_min_x_texels + padding_texels + (float(x) + 0.5f)*texels_per_screen_pixel,
+            padding_texels + (float(y) + 0.5f)*texels_per_screen_pixel
+            );
+    }
+
+    void
+    verify_font_sdf(uint const max_glyph_scale, FontSdfResult *const result)
+    {
+        using namespace Grid;
+
+        *result = {};
+        result->max_glyph_scale = Numerics::minimum(int(max_glyph_scale), int(MAX_FONT_SDF_GLYPH_SCALE));
+
+        uint8 *const texels =
+            (uint8*)Platform::allocate_memory(sizeof(uint8)*FONT_SDF_TEXTURE_X_DIMENSION*FONT_SDF_TEXTURE_Y_DIMENSION);
+        if(texels == 0)
+        {
+            Platform::log_line_string("failed to allocate memory for the font distance field");
+            return;
+        }
+        font_sdf_texture(texels);
+
+        uint32 pixels[FONT_TEXTURE_X_DIMENSION_SCREEN*FONT_TEXTURE_Y_DIMENSION_SCREEN];
+        font_texture(pixels);
+
+        for(uint glyph_scale=1; glyph_scale <= result->max_glyph_scale; glyph_scale++)
+        {
+            float coverage_error = 0.0f;
+            for(uint character_idx=0; character_idx < FONT_NUM_CHARACTERS; character_idx++)
+            {
+                for(int y=0; y < int(glyph_scale*FONT_CHARACTER_Y_DIMENSION_SCREEN); y++)
+                {
+                    for(int x=0; x < int(glyph_scale*FONT_CHARACTER_X_DIMENSION_SCREEN); x++)
+                    {
+                        // NOTE: as font_pixel_shader, with fwidth from the neighbouring screen pixels
+                        float const d = font_sdf_at_screen_pixel(texels, character_idx, glyph_scale, x, y);
+                        float const d_per_screen_pixel =
+                            Numerics::maximum(
+                                Numerics::absolute_value(font_sdf_at_screen_pixel(texels, character_idx, glyph_scale, x + 1, y) - d) +
+                                Numerics::absolute_value(font_sdf_at_screen_pixel(texels, character_idx, glyph_scale, x, y + 1) - d),
+                                1.0e-4f
+                                );
+                        float const coverage = Numerics::clamp(0.0f, 1.0f, (d - 0.5f)/d_per_screen_pixel + 0.5f);
+
+                        bool const lit =
+                            font_pixel_lit(pixels, character_idx, x/int(glyph_scale), y/int(glyph_scale));
+                        float const expected_coverage = lit ? 1.0f : 0.0f;
+
+                        result->num_pixels[glyph_scale]++;
+                        if((coverage >= 0.5f) != lit)
+                        {
+                            result->num_mismatches[glyph_scale]++;
+                        }
+                        coverage_error += Numerics::absolute_value(coverage - expected_coverage);
+                    }
+                }
+            }
+            result->mean_coverage_error[glyph_scale] = coverage_error/float(result->num_pixels[glyph_scale]);
+        }
+
+        Platform::free_memory(texels);
+    }
+
+    void
+    log_font_sdf_result(FontSdfResult const*const result)
+    {
+        for(uint glyph_scale=1; glyph_scale <= result->max_glyph_scale; glyph_scale++)
+        {
+            Platform::log_string("font distance field: scale: ");
+            Platform::log_uint32(glyph_scale);
+            Platform::log_string(", pixels: ");
+            Platform::log_uint32(result->num_pixels[glyph_scale]);
+            Platform::log_string(", mismatches: ");
+            Platform::log_uint32(result->num_mismatches[glyph_scale]);
+            Platform::log_string(", mean coverage error: ");
+            Platform::log_float(result->mean_coverage_error[glyph_scale]);
+            Platform::log_line();
+        }
+    }
+
+    struct GlyphBatchResult
+    {
+        uint num_labels;
+        uint num_glyphs;
+        uint num_dropped_glyphs;
+        uint num_full_batches;
+        uint num_wrong_counts;
+        uint num_wrong_glyphs;
+        uint num_corner_mismatches;
+        float max_corner_error_viewport;
+    };
+
+    // NOTE: a float in [0, 1]
+    inline float
+    next_random_unit(uint64 *const state)
+    {
+        return float(next_random(state) % 1000001)/1000000.0f;
+    }
+
+    // NOTE:
+    // The corners of glyph character_idx of a label, in the order of the quad's vertices, computed the way the
+    // per-label font_vertex_shader did before the glyph batch. That shader only drew at one screen pixel per font
+    // pixel, the sizes here are that times glyph_scale.
+    void
+    reference_glyph_corners(
+        Grid::Orientation const orientation,
+        float const text_end_position_viewport,
+        float const text_middle_transverse_position_viewport,
+        uint const end_margin_pixels,
+        uint const character_spacing_pixels,
+        uint const viewport_width_pixels,
+        uint const viewport_height_pixels,
+        float const glyph_scale,
+        int const character_idx,
+        float corners[4][2]
+        )
+    {
+        float const pixel_width_viewport = 2.0f/float(viewport_width_pixels);
+        float const pixel_height_viewport = 2.0f/float(viewport_height_pixels);
+        float const character_width_pixels = glyph_scale*float(Grid::FONT_CHARACTER_X_DIMENSION_SCREEN);
+        float const character_height_pixels = glyph_scale*float(Grid::FONT_CHARACTER_Y_DIMENSION_SCREEN);
+        float const character_spacing_scaled_pixels = glyph_scale*float(character_spacing_pixels);
+
+        float const advance_pixels =
+            -(character_width_pixels*float(character_idx+1) + character_spacing_scaled_pixels*float(character_idx));
+
+        if(orientation == Grid::Orientation::Vertical)
+        {
+            float const character_center_viewport[2] =
+                {
+                    text_middle_transverse_position_viewport,
+                    text_end_position_viewport + (advance_pixels - float(end_margin_pixels))*pixel_height_viewport
+                };
+            float const xy[4][2] = {{+1.0f, 1.0f}, {-1.0f, 1.0f}, {+1.0f, 0.0f}, {-1.0f, 0.0f}};
+            for(int vertex_idx=0; vertex_idx < 4; vertex_idx++)
+            {
+                corners[vertex_idx][0] =
+                    character_center_viewport[0] + character_width_pixels*pixel_height_viewport/2.0f*xy[vertex_idx][0];
+                corners[vertex_idx][1] =
+                    character_center_viewport[1] + character_height_pixels*pixel_width_viewport*xy[vertex_idx][1];
+            }
+        }
+        else
+        {
+            float const character_center_viewport[2] =
+                {
+                    text_end_position_viewport + (advance_pixels - float(end_margin_pixels))*pixel_width_viewport,
+                    text_middle_transverse_position_viewport
+                };
+            float const xy[4][2] = {{1.0f, -1.0f}, {1.0f, +1.0f}, {0.0f, -1.0f}, {0.0f, +1.0f}};
+            for(int vertex_idx=0; vertex_idx < 4; vertex_idx++)
+            {
+                corners[vertex_idx][0] =
+                    character_center_viewport[0] + character_width_pixels*pixel_width_viewport*xy[vertex_idx][0];
+                corners[vertex_idx][1] =
+                    character_center_viewport[1] + character_height_pixels*pixel_height_viewport/2.0f*xy[vertex_idx][1];
+            }
+        }
+    }
+
+    // NOTE: the corners of a glyph of the batch, as the current font_vertex_shader expands the instance
+    void
+    batch_glyph_corners(Grid::GlyphBatch::GlyphInstance const*const glyph, float corners[4][2])
+    {
+        float const xy_vertical[4][2] = {{+1.0f, 1.0f}, {-1.0f, 1.0f}, {+1.0f, 0.0f}, {-1.0f, 0.0f}};
+        float const xy_horizontal[4][2] = {{1.0f, -1.0f}, {1.0f, +1.0f}, {0.0f, -1.0f}, {0.0f, +1.0f}};
+        for(int vertex_idx=0; vertex_idx < 4; vertex_idx++)
+        {
+            float const*const xy =
+                glyph->orientation == uint(Grid::Orientation::Vertical) ? xy_vertical[vertex_idx] : xy_horizontal[vertex_idx];
+            corners[vertex_idx][0] = glyph->position[0] + glyph->extent[0]*xy[0];
+            corners[vertex_idx][1] = glyph->position[1] + glyph->extent[1]*xy[1];
+        }
+    }
+
+    void
+    verify_glyph_batch(uint const num_labels, GlyphBatchResult *const result)
+    {
+        using namespace Grid;
+
+        *result = {};
+        uint64 random_state = 0x9E3779B97F4A7C15ull;
+
+        GlyphBatch::Batch *const batch = (GlyphBatch::Batch*)Platform::allocate_memory(sizeof(GlyphBatch::Batch));
+        if(batch == 0)
+        {
+            Platform::log_line_string("failed to allocate memory for the glyph batch");
+            return;
+        }
+        // NOTE: the old shader only had scale 1, so that's where the batch starts
+        GlyphBatch::initialize(1.0f, batch);
+
+        uint characters[LabelCache::MAX_LABEL_LENGTH];
+        for(uint label_idx=0; label_idx < num_labels; label_idx++)
+        {
+            int const length = 1 + int(next_random(&random_state) % LabelCache::MAX_LABEL_LENGTH);
+            for(int character_idx=0; character_idx < length; character_idx++)
+            {
+                characters[character_idx] = uint(next_random(&random_state) % FONT_NUM_CHARACTERS);
+            }
+            Orientation const orientation =
+                next_random(&random_state) % 2 == 0 ? Orientation::Horizontal : Orientation::Vertical;
+            float const text_end_position_viewport = 2.0f*next_random_unit(&random_state) - 1.0f;
+            float const text_middle_transverse_position_viewport = 2.0f*next_random_unit(&random_state) - 1.0f;
+            float const alpha = next_random_unit(&random_state);
+            uint const end_margin_pixels = uint(next_random(&random_state) % 6);
+            uint const character_spacing_pixels = uint(next_random(&random_state) % 4);
+            uint const viewport_width_pixels = 200 + uint(next_random(&random_state) % 1800);
+            uint const viewport_height_pixels = 200 + uint(next_random(&random_state) % 1800);
+
+            uint const first_glyph_idx = batch->num_glyphs;
+            uint const num_dropped_glyphs = batch->num_dropped_glyphs;
+            GlyphBatch::add_label(
+                characters,
+                length,
+                orientation,
+                text_end_position_viewport,
+                text_middle_transverse_position_viewport,
+                alpha,
+                end_margin_pixels,
+                character_spacing_pixels,
+                viewport_width_pixels,
+                viewport_height_pixels,
+                batch
+                );
+
+            uint const num_kept_glyphs =
+                uint(Numerics::minimum(length, int(GlyphBatch::MAX_NUM_GLYPHS - first_glyph_idx)));
+            result->num_labels++;
+            result->num_glyphs += num_kept_glyphs;
+            result->num_dropped_glyphs += uint(length) - num_kept_glyphs;
+            if(
+                batch->num_glyphs != first_glyph_idx + num_kept_glyphs ||
+                batch->num_dropped_glyphs != num_dropped_glyphs + (uint(length) - num_kept_glyphs)
+                )
+            {
+                result->num_wrong_counts++;
+            }
+
+            for(uint character_idx=0; character_idx < num_kept_glyphs; character_idx++)
+            {
+                GlyphBatch::GlyphInstance const*const glyph = &batch->glyphs[first_glyph_idx + character_idx];
+                if(
+                    glyph->glyph_idx != characters[character_idx] ||
+                    glyph->orientation != uint(orientation) ||
+                    glyph->alpha != alpha
+                    )
+                {
+                    result->num_wrong_glyphs++;
+                }
+
+                float corners[4][2];
+                float reference_corners[4][2];
+                batch_glyph_corners(glyph, corners);
+                reference_glyph_corners(
+                    orientation,
+                    text_end_position_viewport,
+                    text_middle_transverse_position_viewport,
+                    end_margin_pixels,
+                    character_spacing_pixels,
+                    viewport_width_pixels,
+                    viewport_height_pixels,
+                    batch->glyph_scale,
+                    int(character_idx),
+                    reference_corners
+                    );
+                bool same = true;
+                for(int vertex_idx=0; vertex_idx < 4; vertex_idx++)
+                {
+                    for(int axis=0; axis < 2; axis++)
+                    {
+                        float const error = Numerics::absolute_value(corners[vertex_idx][axis] - reference_corners[vertex_idx][axis]);
+                        result->max_corner_error_viewport = Numerics::maximum(result->max_corner_error_viewport, error);
+                        same = same && error == 0.0f;
+                    }
+                }
+                if(!same)
+                {
+                    result->num_corner_mismatches++;
+                }
+            }
+
+            // NOTE:
+            // Once a whole label has been dropped into the full batch, it starts over, at another scale, since the
+            // placement shouldn't depend on it
+            if(first_glyph_idx == GlyphBatch::MAX_NUM_GLYPHS)
+            {
+                result->num_full_batches++;
+                GlyphBatch::initialize(float(1 + next_random(&random_state) % 4), batch);
+            }
+        }
+
+        Platform::free_memory(batch);
+    }
+
+    void
+    log_glyph_batch_result(GlyphBatchResult const*const result)
+    {
+        Platform::log_string("glyph batch verifier: labels: ");
+        Platform::log_uint32(result->num_labels);
+        Platform::log_string(", glyphs: ");
+        Platform::log_uint32(result->num_glyphs);
+        Platform::log_string(", dropped glyphs: ");
+        Platform::log_uint32(result->num_dropped_glyphs);
+        Platform::log_string(", full batches: ");
+        Platform::log_uint32(result->num_full_batches);
+        Platform::log_line();
+        Platform::log_string("wrong counts: ");
+        Platform::log_uint32(result->num_wrong_counts);
+        Platform::log_string(", wrong glyphs: ");
+        Platform::log_uint32(result->num_wrong_glyphs);
+        Platform::log_string(", corner mismatches: ");
+        Platform::log_uint32(result->num_corner_mismatches);
+        Platform::log_string(", max corner error: ");
+        Platform::log_float(result->max_corner_error_viewport);
+        Platform::log_line();
+    }
+
+}
@@ -3,24 +3,37 @@ cbuffer Grid : register(b0)
     float4 offset_spacing_premainder_lo;
     uint4 max_power_line_idx_offset_orientation_base;
     float hi;
+    uint scale;
+    uint num_multiples;
 };
 
-cbuffer GridText : register(b1)
+// NOTE: log10 of 1, 2 and 5, where the lines within a decade of a logarithmic grid go (only base ten has them)
+static const float LOGARITHMIC_MULTIPLE_FRACTIONS[3] = {0.0f, 0.30103f, 0.69897f};
+
+// NOTE: has to match Grid::GlyphBatch::GlyphInstance
+struct GlyphInstance
 {
-    uint4 number_characters[5];
-    float text_end_position_viewport;
-    float text_middle_transverse_position_viewport;
-    float text_alpha;
-    uint text_orientation;
-    uint2 viewport_dimensions_pixels;
-    uint end_margin_pixels;
-    uint character_spacing_pixels;
+    float2 position_viewport;
+    float2 extent_viewport;
+    uint glyph_idx;
+    uint orientation;
+    float alpha;
+    float padding;
 };
 
+StructuredBuffer<GlyphInstance> glyph_instances : register(t1);
+
+// NOTE: the emphasis of each visible grid line, see Grid::line_emphasis
+Buffer<uint> line_emphasis : register(t2);
+
 #define FONT_NUM_CHARACTERS 14
 #define FONT_CHARACTER_WIDTH_PIXELS 5
 // IMPORTANT: assumed to be even
 #define FONT_CHARACTER_HEIGHT_PIXELS 6
+// NOTE: the layout of the distance field texture, has to match the FONT_SDF_ constants of Grid
+#define FONT_SDF_PADDING_PIXELS 1
+#define FONT_SDF_CELL_WIDTH_PIXELS (FONT_CHARACTER_WIDTH_PIXELS + 2*FONT_SDF_PADDING_PIXELS)
+#define FONT_SDF_CELL_HEIGHT_PIXELS (FONT_CHARACTER_HEIGHT_PIXELS + 2*FONT_SDF_PADDING_PIXELS)
 
 Texture2D font_texture : register(t0);
 SamplerState font_sampler : register(s0);
@@ -35,6 +48,7 @@ struct FontScreenVertex
 {
     float4 position_screen : SV_POSITION;
     float2 position_texture : TEXCOORD2;
+    float alpha : COLOR;
 };
 
 GridScreenVertex
@@ -53,17 +67,22 @@ grid_vertex_shader(uint instance_idx : SV_InstanceID, uint vertex_idx: SV_Vertex
     uint base = max_power_line_idx_offset_orientation_base[3];
     
 
-    // NOTE: calculate the highest power by which this grid line is divisible
-    uint power = 0;
+    uint emphasis = line_emphasis[instance_idx];
+
+    float position;
+    float alpha;
+    if(scale == GRID_SCALE_LOGARITHMIC)
     {
-        uint n = instance_idx + line_idx_offset;
-        while( (n % base) == 0)
-        {
-            n /= base;
-            power++;
-            if(power == max_power)
-                break;
-        }
+        // NOTE: the decade lines are solid, the ones in between use the fade in power_remainder
+        uint pattern_idx = instance_idx + line_idx_offset;
+        uint multiple_idx = pattern_idx % num_multiples;
+        position = offset + (float(pattern_idx / num_multiples) + LOGARITHMIC_MULTIPLE_FRACTIONS[multiple_idx])*spacing;
+        alpha = emphasis != 0 ? 1.0f : power_remainder;
+    }
+    else
+    {
+        position = offset + float(instance_idx)*spacing;
+        alpha = (float(emphasis) + power_remainder)/float(max_power+1.0f);
     }
 
     if(orientation == GRID_ORIENTATION_HORIZONTAL)
@@ -72,7 +91,7 @@ grid_vertex_shader(uint instance_idx : SV_InstanceID, uint vertex_idx: SV_Vertex
         vs.position_screen.xy =         
             float2(
                 lerp(lo, hi, float(vertex_idx)),
-                offset + float(instance_idx)*spacing
+                position
                 );
 
     }
@@ -81,7 +100,7 @@ grid_vertex_shader(uint instance_idx : SV_InstanceID, uint vertex_idx: SV_Vertex
 
         vs.position_screen.xy = 
             float2(
-                offset + float(instance_idx)*spacing,
+                position,
                 lerp(lo, hi, float(vertex_idx))
                 );
 
@@ -89,150 +108,74 @@ grid_vertex_shader(uint instance_idx : SV_InstanceID, uint vertex_idx: SV_Vertex
     vs.position_screen.z = 0.0f;
     vs.position_screen.w = 1.0f;
 
-    float alpha = (float(power) + power_remainder)/float(max_power+1.0f);
     vs.color = float4(1.0f, 1.0f, 1.0f, alpha);
     return vs;
 }
 
+// NOTE: one instance per glyph, the placement was done when the glyph batch was built
 FontScreenVertex
 font_vertex_shader(uint instance_idx : SV_InstanceID, uint vertex_idx: SV_VertexID)
 {
     
     FontScreenVertex sv;
 
-    float character_idx = float(number_characters[instance_idx/4][instance_idx%4]);
-    
-    float character_width_texture = 1.0f/float(FONT_NUM_CHARACTERS);
-    float character_height_texture = 1.0f;
-
-    // TODO: pass as shader constants!
-    float pixel_width_viewport = 2.0f/viewport_dimensions_pixels.x;
-    float pixel_height_viewport = 2.0f/viewport_dimensions_pixels.y;
-
-    float character_width_pixels = float(FONT_CHARACTER_WIDTH_PIXELS);
-    float character_height_pixels = float(FONT_CHARACTER_HEIGHT_PIXELS); 
-    
-    if(text_orientation == GRID_ORIENTATION_VERTICAL)
-    {
-
-        float2 offset_pixels =
-            float2(
-                0.0f,
-                -(character_width_pixels*float(instance_idx+1) + float(character_spacing_pixels)*float(instance_idx))
-                )
-            +
-            float2(0.0f, -float(end_margin_pixels));
-        
-
-        float2 start_position_viewport =
-            float2(text_middle_transverse_position_viewport, text_end_position_viewport);
-    
-        float2 character_center_viewport =
-            start_position_viewport +
-            offset_pixels*float2(pixel_width_viewport, pixel_height_viewport);
-    
-        float2 xy[4] =
-            {
-                float2(+1.0f, 1.0f),
-                float2(-1.0f, 1.0f),
-                float2(+1.0f, 0.0f),
-                float2(-1.0f, 0.0f),
-            };
-            
-        float2 position_screen =
-            character_center_viewport +
-            float2(
-                character_width_pixels*pixel_height_viewport/2.0f,
-                character_height_pixels * pixel_width_viewport
-                )*xy[vertex_idx]
-            ;
-        sv.position_screen = float4(position_screen, 0.0f, 1.0f);
-
-        float2 uv[4] =
-            {
-                float2(
-                    (character_idx + 1.0f)*character_width_texture,
-                    1.0f
-                    ),
-                float2(
-                    (character_idx + 1.0f)*character_width_texture,
-                    0.0f
-                    ),
-                float2(
-                    (character_idx + 0.0f)*character_width_texture,
-                    1.0f
-                    ),
-                float2(
-                    (character_idx + 0.0f)*character_width_texture,
-                    0.0f
-                    ),
-            };
-        sv.position_texture = uv[vertex_idx];
-        return sv;
-    }
-    else
-    {
-        
-        float2 offset_pixels =
-            float2(
-                -(character_width_pixels*float(instance_idx+1) + float(character_spacing_pixels)*float(instance_idx)),
-                0.0f
-                )
-            +
-            float2(-float(end_margin_pixels), 0.0f);
-
-        float2 start_position_viewport =
-            float2(text_end_position_viewport, text_middle_transverse_position_viewport);
-    
-        float2 character_center_viewport =
-            start_position_viewport +
-            offset_pixels*float2(pixel_width_viewport, pixel_height_viewport);
-    
-        float2 xy[4] =
+    GlyphInstance glyph = glyph_instances[instance_idx];
+    float character_idx = float(glyph.glyph_idx);
+    // NOTE: the glyph sits inside its padded cell of the distance field
+    float cell_width_texture = 1.0f/float(FONT_NUM_CHARACTERS);
+    float2 glyph_min_texture =
+        float2(
+            (character_idx + float(FONT_SDF_PADDING_PIXELS)/float(FONT_SDF_CELL_WIDTH_PIXELS))*cell_width_texture,
+            float(FONT_SDF_PADDING_PIXELS)/float(FONT_SDF_CELL_HEIGHT_PIXELS)
+            );
+    float2 glyph_extent_texture =
+        float2(
+            float(FONT_CHARACTER_WIDTH_PIXELS)/float(FONT_SDF_CELL_WIDTH_PIXELS)*cell_width_texture,
+            float(FONT_CHARACTER_HEIGHT_PIXELS)/float(FONT_SDF_CELL_HEIGHT_PIXELS)
+            );
+
+    // NOTE: vertical text is rotated, so the quad is laid out differently
+    float2 xy_vertical[4] =
+        {
+            float2(+1.0f, 1.0f),
+            float2(-1.0f, 1.0f),
+            float2(+1.0f, 0.0f),
+            float2(-1.0f, 0.0f),
+        };
+    float2 xy_horizontal[4] =
         {
             float2(1.0f, -1.0f),
             float2(1.0f, +1.0f),
             float2(0.0f, -1.0f),
             float2(0.0f, +1.0f),
         };
-        
-        float2 position_screen =
-            character_center_viewport +
-            float2(
-                character_width_pixels * pixel_width_viewport,
-                character_height_pixels*pixel_height_viewport/2.0f
-                ) * xy[vertex_idx];
-        sv.position_screen = float4(position_screen, 0.0f, 1.0f);
-
-        float2 uv[4] =
-            {
-                float2(
-                    (character_idx + 1.0f)*character_width_texture,
-                    1.0f
-                    ),
-                float2(
-                    (character_idx + 1.0f)*character_width_texture,
-                    0.0f
-                    ),
-                float2(
-                    (character_idx + 0.0f)*character_width_texture,
-                    1.0f
-                    ),
-                float2(
-                    (character_idx + 0.0f)*character_width_texture,
-                    0.0f
-                    ),
-            };
-        sv.position_texture = uv[vertex_idx];
-        return sv;        
-        
-    }
+    float2 xy =
+        glyph.orientation == GRID_ORIENTATION_VERTICAL ? xy_vertical[vertex_idx] : xy_horizontal[vertex_idx];
+
+    float2 position_screen = glyph.position_viewport + glyph.extent_viewport*xy;
+    sv.position_screen = float4(position_screen, 0.0f, 1.0f);
+
+    float2 uv[4] =
+        {
+            float2(1.0f, 1.0f),
+            float2(1.0f, 0.0f),
+            float2(0.0f, 1.0f),
+            float2(0.0f, 0.0f),
+        };
+    sv.position_texture = glyph_min_texture + glyph_extent_texture*uv[vertex_idx];
+    sv.alpha = glyph.alpha;
+    return sv;
     
 }
 
 float4
 font_pixel_shader(FontScreenVertex sv) : SV_TARGET
 {
-    float4 s = font_texture.Sample(font_sampler, sv.position_texture);
-    return float4(s.r, s.r, s.r, text_alpha*s.r);
+    // NOTE:
+    // The field is 0.5 on the glyph edges and changes by 0.5 per font pixel, so blending over the distance it
+    // changes within a screen pixel gives the coverage, at whatever size the glyph is drawn.
+    float d = font_texture.Sample(font_sampler, sv.position_texture).r;
+    float d_per_screen_pixel = max(fwidth(d), 1.0e-4f);
+    float c = saturate((d - 0.5f)/d_per_screen_pixel + 0.5f);
+    return float4(c, c, c, sv.alpha*c);
 }
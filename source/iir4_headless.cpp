@@ -0,0 +1,98 @@
+// NOTE:
+// The command line modes on their own, without D3D or a window, so the software renderer, the snapshots and the
+// benchmarks build and run with g++ or clang away from Windows. See build.sh, and command_line.cpp for the modes.
+#define _USE_MATH_DEFINES
+#include <math.h>
+#undef _USE_MATH_DEFINES
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <emmintrin.h>
+
+#include "ifdef_sanity_checks.h"
+#include "integer.h"
+#include "numbers.cpp"
+#include "numerics.cpp"
+#include "simd.cpp"
+#include "linalg.cpp"
+#include "platform.hpp"
+#include "array.h"
+#include "complex.cpp"
+#include "geometry_2.cpp"
+
+#include "posix_platform.cpp"
+
+#define GRID_LOG_ERROR(msg) Platform::log_line_string(msg)
+#include "grid.cpp"
+#include "grid_benchmark.cpp"
+#include "grid_label_verifier.cpp"
+#include "polynomial.cpp"
+
+#include "widget_types.cpp"
+
+#include "coefficient_import.cpp"
+#include "min_max_pyramid.cpp"
+#include "response.cpp"
+#include "fit.cpp"
+#include "root_locus.cpp"
+#include "contour.cpp"
+#include "software_render.cpp"
+#include "render_commands.cpp"
+#include "frame_passes.cpp"
+#include "snapshot.cpp"
+#include "command_line.cpp"
+
+int
+main(int argc, char** argv)
+{
+
+    // NOTE: the arguments go back into one line, the way WinMain gets them
+    char cmd_line[4096];
+    {
+        size_t length = 0;
+        for(int argument_idx=1; argument_idx < argc; argument_idx++)
+        {
+            size_t const argument_length = strlen(argv[argument_idx]);
+            if(length + argument_length + 2 > sizeof(cmd_line))
+            {
+                Platform::log_line_string("the command line is too long");
+                return 1;
+            }
+            if(length > 0)
+            {
+                cmd_line[length++] = ' ';
+            }
+            memcpy(&cmd_line[length], argv[argument_idx], argument_length);
+            length += argument_length;
+        }
+        cmd_line[length] = 0;
+    }
+
+    {
+        bool success = Platform::init_headless();
+        if( !success )
+        {
+            Platform::log_line_string("platform initialization failed");
+            return 1;
+        }
+    }
+
+    int exit_code;
+    if(run_command_line_mode(cmd_line, &exit_code))
+        return exit_code;
+
+    Platform::log_line_string(
+        "usage: iir4_headless -snapshot <view_file> | -benchmark_software_render <num_frames> | "
+        "-benchmark_contours <num_frames> | -benchmark_frame_recording <num_frames> | "
+        "-benchmark_labels <num_rounds> | -verify_labels <num_ranges> | -verify_font_sdf <max_glyph_scale> | "
+        "-verify_glyph_batch <num_labels>"
+        );
+    return 1;
+}
@@ -6,12 +6,15 @@
 #undef _USE_MATH_DEFINES
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
+#include <emmintrin.h>
 
 #include "ifdef_sanity_checks.h"
 #include "integer.h"
 #include "numbers.cpp"
 #include "numerics.cpp"
+#include "simd.cpp"
 #include "linalg.cpp"
 #include "platform.hpp"
 #include "array.h"
@@ -27,35 +30,18 @@ window_callback(
     LPARAM lparam);
 
 static HWND g_window_handle;
+// NOTE: draw calls issued in the current frame
+static uint g_num_draw_calls;
 #include "win32_platform.cpp"
 
 #define GRID_LOG_ERROR(msg) Platform::log_line_string(msg)
 #include "grid.cpp"
 #include "grid_render_d3d11.cpp"
+#include "grid_benchmark.cpp"
+#include "grid_label_verifier.cpp"
+#include "polynomial.cpp"
 
-int const NUM_RADIAL_SEGMENTS = 100;
-
-// NOTE: This is must match vertex input layout
-struct ShapeVertex
-{
-    Vec2::Vec2 position;
-};
-
-// NOTE: This is must match vertex input layout
-// NOTE: This is the type of vertex used for triangles displaying the widget.
-struct WidgetVertex
-{
-    Vec2::Vec2 position_screen;
-    Vec2::Vec2 position_data;
-};
-
-struct WidgetLayoutConstants
-{
-    float center_x_position_viewport;
-    float center_y_position_viewport;
-    float data_x_unit_viewport; 
-    float data_y_unit_viewport;
-};
+#include "widget_types.cpp"
 
 // NOTE: This must match the constant buffer in the shader, be careful about padding!
 struct DynamicConstants
@@ -66,78 +52,17 @@ struct DynamicConstants
     float __padding[3];
 };
 
-// NOTE: This must match the constant buffer in the shader, be careful about padding!
-struct PlotConstants
-{
-    float plotviewport_data[4]; // x lo, x hi, y lo, y hi
-    float plotviewport_viewport[4]; // x lo, x hi, y lo, y hi
-    float curve_interval_x_data[2]; float margin_x_dimension_viewport; float __padding_1[1];
-    uint num_curve_slices; float __padding_2[3];
-};
-static_assert(sizeof(PlotConstants) == sizeof(float[4])*4, "stuff");
-
-union Parameters
-{
-    struct
-    {
-        Complex::C zero[2];
-        Complex::C pole[2];
-    } parameter;
-
-    Complex::C parameters[4];
-
-    // Cheesy name: numerATOR, denumiarATOR -- these are the 'factors' of the 'ators' of the transfer function!
-    Complex::C ator_factors[2][2];
-    
-};
-
-// NOTE: normalization constant suitable for lowpass filters
-inline float
-normalization_constant_lowpass(Parameters const*const parameters)
-{
-    using namespace Complex;
-
-    C unit;
-    unit.component.real = 1.0f;
-    unit.component.imaginary = 0.0f;
-
-    C d[2][2];
-    for(int i=0; i<2; i++)
-    {
-        for(int j=0; j<2; j++)
-        {
-            difference(&unit, &parameters->ator_factors[i][j], &d[i][j]);
-        }
-    }
-    
-    return
-        (magnitude_squared(&d[1][0])*magnitude_squared(&d[1][1]))/
-        (magnitude_squared(&d[0][0])*magnitude_squared(&d[0][1]));
-}
-
-// NOTE: normalization constant suitable for highpass
-inline float
-normalization_constant_highpass(Parameters const*const parameters)
-{
-    using namespace Complex;
-
-    C negative_unit;
-    negative_unit.component.real = -1.0f;
-    negative_unit.component.imaginary = 0.0f;
-
-    C d[2][2];
-    for(int i=0; i<2; i++)
-    {
-        for(int j=0; j<2; j++)
-        {
-            difference(&negative_unit, &parameters->ator_factors[i][j], &d[i][j]);
-        }
-    }
-    
-    return
-        (magnitude_squared(&d[1][0])*magnitude_squared(&d[1][1]))/
-        (magnitude_squared(&d[0][0])*magnitude_squared(&d[0][1]));
-}
+#include "coefficient_import.cpp"
+#include "min_max_pyramid.cpp"
+#include "response.cpp"
+#include "fit.cpp"
+#include "root_locus.cpp"
+#include "contour.cpp"
+#include "software_render.cpp"
+#include "render_commands.cpp"
+#include "frame_passes.cpp"
+#include "snapshot.cpp"
+#include "command_line.cpp"
 
 LRESULT CALLBACK
 window_callback(
@@ -562,166 +487,6 @@ bool update_layout_constants(
     return true;
 }
 
-void draw_circle(
-    ID3D11DeviceContext *const d3d_device_context,
-    ID3D11Buffer *const vertex_buffer,
-    ID3D11Buffer* index_buffer,
-    ID3D11InputLayout *const vertex_input_layout,
-    ID3D11VertexShader *const vertex_shader
-    )
-{
-
-    d3d_device_context->IASetInputLayout(vertex_input_layout);
-                
-    {
-        uint num_class_instances = 0;
-        ID3D11ClassInstance** class_instances = 0;
-        d3d_device_context->VSSetShader(
-            vertex_shader,
-            class_instances,
-            num_class_instances
-            );
-    }
-    
-    
-    {
-        uint input_slot = 0;
-        uint const num_buffers = 1;
-        ID3D11Buffer* buffers[num_buffers] = {vertex_buffer};
-        uint strides[num_buffers] = {sizeof(WidgetVertex)};
-        uint offsets[num_buffers] = {0};
-        d3d_device_context->IASetVertexBuffers(
-            input_slot,
-            num_buffers,
-            buffers,
-            strides,
-            offsets
-            );
-    }
-
-    {
-
-        DXGI_FORMAT const format = DXGI_FORMAT_R32_UINT;
-        uint const offset = 0;
-                
-        d3d_device_context->IASetIndexBuffer(
-            index_buffer,
-            format,
-            offset
-            );
-                
-    }
-            
-            
-    {
-
-        uint index_count = 3*NUM_RADIAL_SEGMENTS;
-        uint start_index_location = 0;
-        int base_vertex_location = 0;
-                
-        d3d_device_context->DrawIndexed(
-            index_count,
-            start_index_location,
-            base_vertex_location
-            );
-                
-    }
-    
-    
-}
-
-
-void draw_markers(
-    ID3D11DeviceContext *const d3d_device_context,
-    ID3D11InputLayout *const dynamic_vertex_input_layout,
-    ID3D11VertexShader *const dynamic_vertex_shader,
-    ID3D11Buffer* marker_vertex_buffer,
-    ID3D11Buffer* marker_index_buffer,
-    ID3D11PixelShader* solid_pixel_shader
-    
-    )
-{
-
-    { // markers
-
-        // NOTE: set the density pixel shader
-        {
-            uint num_class_instances = 0;
-            ID3D11ClassInstance** class_instances = 0;
-            d3d_device_context->PSSetShader(
-                solid_pixel_shader,
-                class_instances,
-                num_class_instances
-                );            
-        }
-            
-            
-        d3d_device_context->IASetInputLayout(dynamic_vertex_input_layout);
-                
-        {
-            uint num_class_instances = 0;
-            ID3D11ClassInstance** class_instances = 0;
-            d3d_device_context->VSSetShader(
-                dynamic_vertex_shader,
-                class_instances,
-                num_class_instances
-                );
-        }            
-            
-        {
-            uint input_slot = 0;
-            uint const num_buffers = 1;
-            ID3D11Buffer* buffers[num_buffers] = {marker_vertex_buffer};
-            uint strides[num_buffers] = {sizeof(ShapeVertex)};
-            uint offsets[num_buffers] = {0};
-            d3d_device_context->IASetVertexBuffers(
-                input_slot,
-                num_buffers,
-                buffers,
-                strides,
-                offsets
-                );
-        }
-
-        {
-
-            DXGI_FORMAT const format = DXGI_FORMAT_R32_UINT;
-            uint const offset = 0;
-                
-            d3d_device_context->IASetIndexBuffer(
-                marker_index_buffer,
-                format,
-                offset
-                );
-                
-        }
-            
-            
-
-        {
-
-            uint const instance_index_count = 15;
-            uint const instance_count = 8;
-            uint const start_index_location = 0;
-            int const base_vertex_location = 0;
-            uint const start_instance_location = 0;
-                
-            d3d_device_context->DrawIndexedInstanced(
-                instance_index_count,
-                instance_count,
-                start_index_location,
-                base_vertex_location,
-                start_instance_location
-                );
-                
-                
-        }
-            
-    }        
-    
-    
-}
-
 struct Interval
 {
     float lo;
@@ -786,20 +551,74 @@ try_upload_curve_vertices(
     
 }
 
+#include "render_commands_d3d11.cpp"
+
+// NOTE: reads transfer function coefficients from a file, and sets the parameters to the first representable one
+bool
+try_import_parameters(char *const file_name, Parameters *const parameters)
+{
+    using namespace CoefficientImport;
+
+    TransferFunction* transfer_functions = 0;
+    uint num_transfer_functions = 0;
+    if(!load_transfer_functions(file_name, &transfer_functions, &num_transfer_functions))
+        return false;
+
+    if(num_transfer_functions == 0)
+    {
+        Platform::log_line_string("warning: no transfer functions in coefficient file");
+        return false;
+    }
+
+    Result *const results = (Result*)Platform::allocate_memory(sizeof(Result)*num_transfer_functions);
+    if(results == 0)
+    {
+        Platform::free_memory(transfer_functions);
+        return false;
+    }
+
+    Statistics stats;
+    bool ok = import(num_transfer_functions, transfer_functions, results, &stats);
+    if(ok)
+    {
+        log_statistics(&stats);
+
+        ok = false;
+        for(uint tf_idx=0; tf_idx < num_transfer_functions; tf_idx++)
+        {
+            if(results[tf_idx].representable)
+            {
+                *parameters = results[tf_idx].parameters;
+                ok = true;
+                break;
+            }
+        }
+        if(!ok)
+        {
+            Platform::log_line_string("warning: none of the imported transfer functions can be shown by the widget");
+        }
+    }
+
+    Platform::free_memory(results);
+    Platform::free_memory(transfer_functions);
+    return ok;
+}
+
 int CALLBACK
 WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd_show)
 {
     num_cmd_show; cmd_line; prev_instance;
     g_instance = instance;
 
-    float const zoom_step_size = 0.06f;
-    uint const widgetviewport_x_dimension_screen = 400;
-    uint const widgetviewport_y_dimension_screen = 400;    
-    uint const viewport_x_dimension_screen = 1024;
-    uint const viewport_y_dimension_screen = widgetviewport_y_dimension_screen*2;
-    uint const plotviewportmargin_x_dimension_characters = 8;
-    uint const plotviewportmargin_y_dimension_characters = 8;
-    uint const character_spacing_screen = 1;
+    // NOTE: the layout is shared with the snapshots, see FramePasses
+    float const zoom_step_size = FramePasses::ZOOM_STEP_SIZE;
+    uint const widgetviewport_x_dimension_screen = FramePasses::WIDGETVIEWPORT_X_DIMENSION_SCREEN;
+    uint const widgetviewport_y_dimension_screen = FramePasses::WIDGETVIEWPORT_Y_DIMENSION_SCREEN;
+    uint const viewport_x_dimension_screen = FramePasses::VIEWPORT_X_DIMENSION_SCREEN;
+    uint const viewport_y_dimension_screen = FramePasses::VIEWPORT_Y_DIMENSION_SCREEN;
+    uint const plotviewportmargin_x_dimension_characters = FramePasses::PLOTVIEWPORTMARGIN_DIMENSION_CHARACTERS;
+    uint const plotviewportmargin_y_dimension_characters = FramePasses::PLOTVIEWPORTMARGIN_DIMENSION_CHARACTERS;
+    uint const character_spacing_screen = FramePasses::CHARACTER_SPACING_SCREEN;
     uint const plotviewportmargin_x_dimension_screen =
         Grid::message_width_screen(character_spacing_screen, plotviewportmargin_x_dimension_characters);
     uint const plotviewportmargin_y_dimension_screen =
@@ -814,7 +633,7 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
         viewport_x_dimension_viewport*float(plotviewport_y_dimension_screen)/float(viewport_y_dimension_screen);
     float const plotviewport_x_dimension_viewport =
         viewport_y_dimension_viewport*float(plotviewport_x_dimension_screen)/float(viewport_x_dimension_screen);
-    uint const grid_base = 10;
+    uint const grid_base = FramePasses::GRID_BASE;
     float const widgetviewport_x_dimension_viewport =
         viewport_x_dimension_viewport*float(widgetviewport_x_dimension_screen)/float(viewport_x_dimension_screen);
     float const widgetviewport_y_dimension_viewport =
@@ -840,8 +659,9 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
         plotviewportmargin_y_dimension_screen * screen_y_unit_viewport;
     
     
-    uint const num_curve_slices = 400; //uint(plotviewport_x_dimension_screen); // NOTE: one sample per pixel
+    uint const num_curve_slices = FramePasses::NUM_CURVE_SLICES;
     uint const num_curve_segments = num_curve_slices - 1;
+    uint const num_curve_vertices = FramePasses::NUM_CURVE_VERTICES;
     
     bool const windowed = true;
     uint const desired_refresh_rate_hz = 60;
@@ -865,9 +685,23 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             +0.0f - plotviewport_y_dimension_viewport,
         };
 
-    float const plotviewport_min_x_screen = (plotviewport_min_x_viewport + 1.0f) * viewport_x_unit_screen;
-    float const plotviewport_max_x_screen = (plotviewport_max_x_viewport + 1.0f) * viewport_x_unit_screen;
-    
+    {
+        bool success = Platform::init_headless();
+        if( !success )
+        {
+            Platform::log_line_string("platform initialization failed");
+            return 0 ;
+        }
+    }
+
+    // NOTE: the command line modes only render and measure on the CPU, see command_line.cpp
+    {
+        int exit_code;
+        if(run_command_line_mode(cmd_line, &exit_code))
+            return exit_code;
+    }
+
+    // NOTE: none of the command line modes above need the window, so it is only opened here
     {
         bool success =
             Platform::init(viewport_x_dimension_screen, viewport_y_dimension_screen, mouse_input_initially_enabled);
@@ -1143,22 +977,94 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
     }
     assert( circle_vertex_buffer != 0 );
 
-    ID3D11Buffer* curve_vertex_buffer = 0;
+    // NOTE: the vertices recorded with the render command list of a frame, the curves and the fit target
+    ID3D11Buffer* transient_vertex_buffer = 0;
     {
-        uint const num_vertices = num_curve_slices;
+        uint const num_vertices = RenderCommands::MAX_NUM_TRANSIENT_FLOATS;
         bool const success = 
             create_curve_vertex_buffer(
                 num_vertices,
                 d3d_device,
-                &curve_vertex_buffer
+                &transient_vertex_buffer
+                );
+        if(!success)
+        {
+            Platform::log_string("failed to create the transient vertex buffer");
+            return 0 ;
+        }
+    }
+    assert( transient_vertex_buffer != 0 );
+
+    ID3D11Buffer* locus_vertex_buffer = 0;
+    {
+        // NOTE: two floats per vertex
+        uint const num_floats = 2*RootLocus::NUM_VERTICES;
+        bool const success = 
+            create_curve_vertex_buffer(
+                num_floats,
+                d3d_device,
+                &locus_vertex_buffer
+                );
+        if(!success)
+        {
+            Platform::log_string("failed to create root locus vertex buffer");
+            return 0 ;
+        }
+    }
+    assert( locus_vertex_buffer != 0 );
+
+    RootLocus::Locus locus = {};
+    if(!RootLocus::initialize(&locus))
+    {
+        Platform::log_line_string("failed to allocate memory for the root locus");
+        return 0;
+    }
+
+    ID3D11Buffer* contour_vertex_buffer = 0;
+    {
+        // NOTE: two floats per vertex
+        uint const num_floats = 2*Contour::MAX_NUM_VERTICES;
+        bool const success = 
+            create_curve_vertex_buffer(
+                num_floats,
+                d3d_device,
+                &contour_vertex_buffer
                 );
         if(!success)
         {
-            Platform::log_string("failed to curve vertex buffer");
+            Platform::log_string("failed to create contour vertex buffer");
             return 0 ;
         }
     }
-    assert( curve_vertex_buffer != 0 );
+    assert( contour_vertex_buffer != 0 );
+
+    Contour::Contours contours = {};
+    if(!Contour::initialize(&contours))
+    {
+        Platform::log_line_string("failed to allocate memory for the contours");
+        return 0;
+    }
+
+    Grid::LabelCache::Cache *const label_cache =
+        (Grid::LabelCache::Cache*)Platform::allocate_memory(sizeof(Grid::LabelCache::Cache));
+    if(label_cache == 0)
+    {
+        Platform::log_line_string("failed to allocate memory for the grid label cache");
+        return 0;
+    }
+    Grid::LabelCache::initialize(label_cache);
+
+    // NOTE: one per plot and orientation, recomputed only when the plot moves
+    Grid::Layout::Axis grid_layouts[2][Grid::Orientation::NumOrientations];
+    for(int plot_idx=0; plot_idx < 2; plot_idx++)
+    {
+        for(int orientation_idx=0; orientation_idx < Grid::Orientation::NumOrientations; orientation_idx++)
+        {
+            Grid::Layout::initialize(&grid_layouts[plot_idx][orientation_idx]);
+        }
+    }
+    Grid::Layout::Statistics grid_layout_stats;
+    Grid::Layout::reset_statistics(&grid_layout_stats);
     
     
     ID3D11Buffer* circle_index_buffer = 0;
@@ -1623,20 +1529,20 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
     assert(dynamic_vertex_shader != 0);
     assert(dynamic_vertex_input_layout != 0);
 
-    ID3D11PixelShader* solid_pixel_shader = 0;
+    // NOTE: takes the same vertices as the dynamic vertex shader, so it shares its input layout
+    ID3D11VertexShader* locus_vertex_shader = 0;
     {
-
-        char* file_name = "solid_ps.cso";
+        char* file_name = "locus_vs.cso";
         void* byte_code = 0;
         size_t byte_code_size = 0;
         {
             Platform::ReadFileResult result = Platform::read_file(file_name);
             if(result.contents == 0)
             {
-                Platform::log_string("failed to read pixel shader file ");
+                Platform::log_string("failed to load vertex shader file ");
                 Platform::log_string(file_name);
                 Platform::log_string("\n");
-				return 0;
+                return 0;
             }
             byte_code = result.contents;
             byte_code_size = result.contents_size;
@@ -1644,45 +1550,43 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
         assert(byte_code != 0);
         assert(byte_code_size != 0);
 
-        // STUDY: what is this?
         ID3D11ClassLinkage* class_linkage = 0;
         
-        HRESULT result = d3d_device->CreatePixelShader(
+        HRESULT result = d3d_device->CreateVertexShader(
             byte_code,
             byte_code_size,
             class_linkage,
-            &solid_pixel_shader
+            &locus_vertex_shader
             );
 
-        Platform::free_file_memory(byte_code);        
-        
+        Platform::free_file_memory(byte_code);
+
         if( FAILED(result) )
         {
-            Platform::log_string("failed to compile solid pixel shader");
-            Platform::log_string("(");
+            Platform::log_string("failed to compile vertex shader");
+            Platform::log_string(" (");
             Platform::log_string(file_name);
             Platform::log_string(")");
             Platform::log_string("\n");
             return 0;
-        }        
-        
+        }            
     }
-    assert(solid_pixel_shader != 0);
+    assert(locus_vertex_shader != 0);
 
-    ID3D11PixelShader* colorbar_magnitude_pixel_shader = 0;
+    // NOTE: like the locus vertex shader, it shares the input layout of the dynamic vertex shader
+    ID3D11VertexShader* contour_vertex_shader = 0;
     {
-
-        char* file_name = "colorbar_magnitude_ps.cso";
+        char* file_name = "contour_vs.cso";
         void* byte_code = 0;
         size_t byte_code_size = 0;
         {
             Platform::ReadFileResult result = Platform::read_file(file_name);
             if(result.contents == 0)
             {
-                Platform::log_string("failed to read pixel shader file ");
+                Platform::log_string("failed to load vertex shader file ");
                 Platform::log_string(file_name);
                 Platform::log_string("\n");
-				return 0;
+                return 0;
             }
             byte_code = result.contents;
             byte_code_size = result.contents_size;
@@ -1690,35 +1594,33 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
         assert(byte_code != 0);
         assert(byte_code_size != 0);
 
-        // STUDY: what is this?
         ID3D11ClassLinkage* class_linkage = 0;
         
-        HRESULT result = d3d_device->CreatePixelShader(
+        HRESULT result = d3d_device->CreateVertexShader(
             byte_code,
             byte_code_size,
             class_linkage,
-            &colorbar_magnitude_pixel_shader
+            &contour_vertex_shader
             );
 
-        Platform::free_file_memory(byte_code);        
-        
+        Platform::free_file_memory(byte_code);
+
         if( FAILED(result) )
         {
-            Platform::log_string("failed to compile pixel shader");
-            Platform::log_string("(");
+            Platform::log_string("failed to compile vertex shader");
+            Platform::log_string(" (");
             Platform::log_string(file_name);
             Platform::log_string(")");
             Platform::log_string("\n");
             return 0;
-        }        
-        
+        }            
     }
-    assert(colorbar_magnitude_pixel_shader != 0);    
+    assert(contour_vertex_shader != 0);
 
-    ID3D11PixelShader* colorbar_colorwheel_pixel_shader = 0;
+    ID3D11PixelShader* solid_pixel_shader = 0;
     {
 
-        char* file_name = "colorbar_colorwheel_ps.cso";
+        char* file_name = "solid_ps.cso";
         void* byte_code = 0;
         size_t byte_code_size = 0;
         {
@@ -1743,14 +1645,14 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             byte_code,
             byte_code_size,
             class_linkage,
-            &colorbar_colorwheel_pixel_shader
+            &solid_pixel_shader
             );
 
         Platform::free_file_memory(byte_code);        
         
         if( FAILED(result) )
         {
-            Platform::log_string("failed to compile pixel shader");
+            Platform::log_string("failed to compile solid pixel shader");
             Platform::log_string("(");
             Platform::log_string(file_name);
             Platform::log_string(")");
@@ -1759,12 +1661,12 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
         }        
         
     }
-    assert(colorbar_colorwheel_pixel_shader != 0);       
-    
-    ID3D11PixelShader* font_pixel_shader = 0;
+    assert(solid_pixel_shader != 0);
+
+    ID3D11PixelShader* colorbar_magnitude_pixel_shader = 0;
     {
 
-        char* file_name = "grid_font_ps.cso";
+        char* file_name = "colorbar_magnitude_ps.cso";
         void* byte_code = 0;
         size_t byte_code_size = 0;
         {
@@ -1789,14 +1691,14 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             byte_code,
             byte_code_size,
             class_linkage,
-            &font_pixel_shader
+            &colorbar_magnitude_pixel_shader
             );
 
         Platform::free_file_memory(byte_code);        
         
         if( FAILED(result) )
         {
-            Platform::log_string("failed to compile font pixel shader");
+            Platform::log_string("failed to compile pixel shader");
             Platform::log_string("(");
             Platform::log_string(file_name);
             Platform::log_string(")");
@@ -1805,12 +1707,12 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
         }        
         
     }
-    assert(font_pixel_shader != 0);
+    assert(colorbar_magnitude_pixel_shader != 0);    
 
-    ID3D11PixelShader* ttf_font_pixel_shader = 0;
+    ID3D11PixelShader* colorbar_colorwheel_pixel_shader = 0;
     {
 
-        char* file_name = "ttf_font_ps.cso";
+        char* file_name = "colorbar_colorwheel_ps.cso";
         void* byte_code = 0;
         size_t byte_code_size = 0;
         {
@@ -1835,7 +1737,99 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             byte_code,
             byte_code_size,
             class_linkage,
-            &ttf_font_pixel_shader
+            &colorbar_colorwheel_pixel_shader
+            );
+
+        Platform::free_file_memory(byte_code);        
+        
+        if( FAILED(result) )
+        {
+            Platform::log_string("failed to compile pixel shader");
+            Platform::log_string("(");
+            Platform::log_string(file_name);
+            Platform::log_string(")");
+            Platform::log_string("\n");
+            return 0;
+        }        
+        
+    }
+    assert(colorbar_colorwheel_pixel_shader != 0);       
+    
+    ID3D11PixelShader* font_pixel_shader = 0;
+    {
+
+        char* file_name = "grid_font_ps.cso";
+        void* byte_code = 0;
+        size_t byte_code_size = 0;
+        {
+            Platform::ReadFileResult result = Platform::read_file(file_name);
+            if(result.contents == 0)
+            {
+                Platform::log_string("failed to read pixel shader file ");
+                Platform::log_string(file_name);
+                Platform::log_string("\n");
+				return 0;
+            }
+            byte_code = result.contents;
+            byte_code_size = result.contents_size;
+        }
+        assert(byte_code != 0);
+        assert(byte_code_size != 0);
+
+        // STUDY: what is this?
+        ID3D11ClassLinkage* class_linkage = 0;
+        
+        HRESULT result = d3d_device->CreatePixelShader(
+            byte_code,
+            byte_code_size,
+            class_linkage,
+            &font_pixel_shader
+            );
+
+        Platform::free_file_memory(byte_code);        
+        
+        if( FAILED(result) )
+        {
+            Platform::log_string("failed to compile font pixel shader");
+            Platform::log_string("(");
+            Platform::log_string(file_name);
+            Platform::log_string(")");
+            Platform::log_string("\n");
+            return 0;
+        }        
+        
+    }
+    assert(font_pixel_shader != 0);
+
+    ID3D11PixelShader* ttf_font_pixel_shader = 0;
+    {
+
+        char* file_name = "ttf_font_ps.cso";
+        void* byte_code = 0;
+        size_t byte_code_size = 0;
+        {
+            Platform::ReadFileResult result = Platform::read_file(file_name);
+            if(result.contents == 0)
+            {
+                Platform::log_string("failed to read pixel shader file ");
+                Platform::log_string(file_name);
+                Platform::log_string("\n");
+				return 0;
+            }
+            byte_code = result.contents;
+            byte_code_size = result.contents_size;
+        }
+        assert(byte_code != 0);
+        assert(byte_code_size != 0);
+
+        // STUDY: what is this?
+        ID3D11ClassLinkage* class_linkage = 0;
+        
+        HRESULT result = d3d_device->CreatePixelShader(
+            byte_code,
+            byte_code_size,
+            class_linkage,
+            &ttf_font_pixel_shader
             );
 
         Platform::free_file_memory(byte_code);        
@@ -2056,39 +2050,39 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
     assert( grid_constant_buffer != 0 );
     
     
-    ID3D11Buffer* grid_numbers_constant_buffer = 0;
+    ID3D11Buffer* glyph_instance_buffer = 0;
+    ID3D11ShaderResourceView* glyph_instance_buffer_srv = 0;
+    if(!Grid::try_create_glyph_instance_buffer(d3d_device, &glyph_instance_buffer, &glyph_instance_buffer_srv))
     {
-        D3D11_BUFFER_DESC description = {};
-        description.ByteWidth = sizeof(Grid::TextShaderConstants);
-        description.Usage = D3D11_USAGE_DYNAMIC;
-        description.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-        description.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-        description.MiscFlags = 0;
-        // STUDY: why not set this to the size of the buffer element? sizeof(MatrixConstants)
-        description.StructureByteStride = 0;
-        
-        D3D11_SUBRESOURCE_DATA* initial_data = 0;
-        
-        HRESULT result = d3d_device->CreateBuffer(
-            &description,
-            initial_data,
-            &grid_numbers_constant_buffer
-            );
-        
-        if(FAILED(result))
-        {
-            Platform::log_line_string("failed to create grid text constant buffer");
-            return 0;
-        }
-        
+        return 0;
     }
-    assert( grid_numbers_constant_buffer != 0 );
+    assert( glyph_instance_buffer != 0 );
+    assert( glyph_instance_buffer_srv != 0 );
+
+    ID3D11Buffer* line_emphasis_buffer = 0;
+    ID3D11ShaderResourceView* line_emphasis_buffer_srv = 0;
+    if(!Grid::try_create_line_emphasis_buffer(d3d_device, &line_emphasis_buffer, &line_emphasis_buffer_srv))
+    {
+        return 0;
+    }
+    assert( line_emphasis_buffer != 0 );
+    assert( line_emphasis_buffer_srv != 0 );
+
+    // NOTE: the labels of all plots, drawn together after the grids
+    Grid::GlyphBatch::Batch *const glyph_batch =
+        (Grid::GlyphBatch::Batch*)Platform::allocate_memory(sizeof(Grid::GlyphBatch::Batch));
+    if(glyph_batch == 0)
+    {
+        Platform::log_line_string("failed to allocate memory for the grid label glyphs");
+        return 0;
+    }
+    Grid::GlyphBatch::initialize(1.0f, glyph_batch);
     
     ID3D11Texture2D* font_texture = 0;
     {
 
-        int const width = Grid::FONT_TEXTURE_X_DIMENSION_SCREEN;
-        int const height = Grid::FONT_TEXTURE_Y_DIMENSION_SCREEN;
+        int const width = Grid::FONT_SDF_TEXTURE_X_DIMENSION;
+        int const height = Grid::FONT_SDF_TEXTURE_Y_DIMENSION;
         
         D3D11_TEXTURE2D_DESC description = {};
         {
@@ -2096,8 +2090,8 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             description.Height = height;
             description.MipLevels = 1;
             description.ArraySize = 1;
-            // OPTIMIZE: use a format that takes less space, we only need 1 bit per pixel
-            description.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            // NOTE: the distance field only needs one channel
+            description.Format = DXGI_FORMAT_R8_UNORM;
             description.SampleDesc.Count = 1;
             description.SampleDesc.Quality = 0;
             description.Usage = D3D11_USAGE_IMMUTABLE;
@@ -2106,13 +2100,18 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             description.MiscFlags = 0;
         }
 
-        uint32 pixels[width*height] = {};
-        Grid::font_texture(pixels);
+        uint8 *const texels = (uint8*)Platform::allocate_memory(sizeof(uint8)*width*height);
+        if(texels == 0)
+        {
+            Platform::log_line_string("failed to allocate memory for the font distance field");
+            return 0;
+        }
+        Grid::font_sdf_texture(texels);
 
         D3D11_SUBRESOURCE_DATA initial_data = {};
         {
-            initial_data.pSysMem = pixels;
-            initial_data.SysMemPitch = sizeof(uint32)*width;
+            initial_data.pSysMem = texels;
+            initial_data.SysMemPitch = sizeof(uint8)*width;
             // NOTE: has no meaning for 2d textures and is ignored
             initial_data.SysMemSlicePitch = 0;
         }
@@ -2123,6 +2122,7 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
                 &initial_data, 
                 &font_texture
                 );
+        Platform::free_memory(texels);
 
         if(FAILED(result))
         {
@@ -2202,7 +2202,7 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
         ID3D11Resource *const resource = font_texture;
         D3D11_SHADER_RESOURCE_VIEW_DESC description = {};
         {
-            description.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            description.Format = DXGI_FORMAT_R8_UNORM;
             description.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
             description.Texture2D.MostDetailedMip = 0;
             description.Texture2D.MipLevels = 1;
@@ -2257,7 +2257,8 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
 
         D3D11_SAMPLER_DESC description = {};
         {
-            description.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
+            // NOTE: the distance field is meant to be interpolated
+            description.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
             description.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
             description.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
             description.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
@@ -2325,20 +2326,137 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
     Complex::set_polar(0.75f, PI_FLOAT*0.5f, &parameters.parameter.zero[1]);
     Complex::set_polar(0.25f, PI_FLOAT*0.1f, &parameters.parameter.pole[0]);
     Complex::set_polar(0.75f, PI_FLOAT*0.75f, &parameters.parameter.pole[1]);
+
+    {
+        char coefficient_file_name[MAX_PATH];
+        if(try_get_command_line_argument(cmd_line, "-import", coefficient_file_name, (uint)ARRAY_LENGTH(coefficient_file_name)))
+        {
+            try_import_parameters(coefficient_file_name, &parameters);
+        }
+    }
     
     int selected_parameter_idx = -1;
     int side_idx = -1;
     int widget_zoom = 0;
 
-    float plotviewport_center_x_plotdata[2] = {0.5f, 0.5f};
-    float plotviewport_center_y_plotdata[2] = {0.75f, 0.0f};
+    // NOTE: doubles, so that zooming far in keeps distinct positions to look at
+    double plotviewport_center_x_plotdata[2] =
+        {
+            FramePasses::FREQUENCY_PLOT_CENTER_X_LINEAR,
+            FramePasses::FREQUENCY_PLOT_CENTER_X_LINEAR,
+        };
+    double plotviewport_center_y_plotdata[2] =
+        {
+            FramePasses::MAGNITUDE_PLOT_CENTER_Y_LINEAR,
+            FramePasses::PHASE_PLOT_CENTER_Y,
+        };
     int x_zoom_level_plotdata[2] = {};
     int y_zoom_level_plotdata[2] = {};
-    float const plotviewport_unzoomed_x_dimension_plotdata[2] = {1.05f, 1.15f};
-    float const plotviewport_unzoomed_y_dimension_plotdata[2] = {1.6f, 1.05f};
+    // NOTE: the horizontal extent depends on whether the frequency axis is logarithmic
+    float plotviewport_unzoomed_x_dimension_plotdata[2] =
+        {
+            FramePasses::FREQUENCY_PLOT_UNZOOMED_X_DIMENSION_LINEAR[0],
+            FramePasses::FREQUENCY_PLOT_UNZOOMED_X_DIMENSION_LINEAR[1],
+        };
+    bool log_frequency_axis = false;
+    // NOTE: the vertical extent of the magnitude plot depends on whether it is in decibels
+    float plotviewport_unzoomed_y_dimension_plotdata[2] =
+        {
+            FramePasses::MAGNITUDE_PLOT_UNZOOMED_Y_DIMENSION_LINEAR,
+            FramePasses::PHASE_PLOT_UNZOOMED_Y_DIMENSION,
+        };
+    bool magnitude_plot_decibels = false;
+    bool show_root_locus = false;
+    // NOTE: the parameters of the last root locus sweep, the locus is only recomputed when they change
+    Parameters locus_parameters = {};
+    bool locus_uploaded = false;
+    Response::DenseCurve dense_curves[2];
+    for(uint plot_idx=0; plot_idx < 2; plot_idx++)
+    {
+        Response::initialize(&dense_curves[plot_idx]);
+    }
+    // NOTE: the curves are sampled into these before the frame is recorded, see FramePasses::sample_curves
+    float curve_vertices[2][num_curve_vertices];
+    bool show_contours = false;
+    bool contours_uploaded = false;
+    Contour::Levels contour_levels;
+    Contour::default_levels(&contour_levels);
+    {
+        char contour_levels_string[256];
+        if(try_get_command_line_argument(cmd_line, "-contour_levels", contour_levels_string, (uint)ARRAY_LENGTH(contour_levels_string)))
+        {
+            Contour::parse_levels(contour_levels_string, &contour_levels);
+        }
+    }
+
+    // NOTE: drawn with the right mouse button on the magnitude plot, the parameters are fitted to it
+    Fit::Target fit_target;
+    Fit::initialize_target(&fit_target);
+    Fit::Solver fit_solver;
+    Fit::reset_solver(&fit_solver);
+    bool drawing_fit_target = false;
     int dragged_plot = -1;
     float plot_drag_start_x_viewport = 0;
     float plot_drag_start_y_viewport = 0;
+
+    // NOTE: the frame is recorded into this, then sorted and drawn by the executor
+    RenderCommands::CommandList commands;
+    if(!RenderCommands::initialize(&commands))
+    {
+        return 0;
+    }
+    RenderCommands::Statistics command_stats;
+    RenderCommands::reset_statistics(&command_stats);
+
+    RenderCommands::D3D11Executor d3d11_executor = {};
+    {
+        using namespace RenderCommands;
+        D3D11Executor *const executor = &d3d11_executor;
+        executor->d3d_device_context = d3d_device_context;
+        executor->render_target_view = render_target_view;
+        executor->vertex_shaders[CircleVertexShader] = circle_vertex_shader;
+        executor->vertex_shaders[MarkerVertexShader] = dynamic_vertex_shader;
+        executor->vertex_shaders[ContourVertexShader] = contour_vertex_shader;
+        executor->vertex_shaders[LocusVertexShader] = locus_vertex_shader;
+        executor->vertex_shaders[GridVertexShader] = grid_vertex_shader;
+        executor->vertex_shaders[GlyphVertexShader] = grid_numbers_vertex_shader;
+        executor->vertex_shaders[ColorbarVertexShader] = colorbar_vertex_shader;
+        executor->vertex_shaders[PlotVertexShader] = plot_vertex_shader;
+        executor->pixel_shaders[DensityPixelShader] = density_pixel_shader;
+        executor->pixel_shaders[DomainColoringPixelShader] = domain_coloring_pixel_shader;
+        executor->pixel_shaders[SolidPixelShader] = solid_pixel_shader;
+        executor->pixel_shaders[GlyphPixelShader] = font_pixel_shader;
+        executor->pixel_shaders[ColorbarMagnitudePixelShader] = colorbar_magnitude_pixel_shader;
+        executor->pixel_shaders[ColorbarColorwheelPixelShader] = colorbar_colorwheel_pixel_shader;
+        executor->input_layouts[NoInputLayout] = 0;
+        executor->input_layouts[CircleInputLayout] = circle_vertex_input_layout;
+        executor->input_layouts[ShapeInputLayout] = dynamic_vertex_input_layout;
+        executor->input_layouts[CurveInputLayout] = curve_vertex_input_layout;
+        executor->vertex_buffers[CircleVertexBuffer] = circle_vertex_buffer;
+        executor->vertex_buffers[MarkerVertexBuffer] = marker_vertex_buffer;
+        executor->vertex_buffers[ContourVertexBuffer] = contour_vertex_buffer;
+        executor->vertex_buffers[LocusVertexBuffer] = locus_vertex_buffer;
+        executor->vertex_buffers[TransientVertexBuffer] = transient_vertex_buffer;
+        executor->vertex_buffers[GlyphInstanceBuffer] = glyph_instance_buffer;
+        executor->index_buffers[CircleVertexBuffer] = circle_index_buffer;
+        executor->index_buffers[MarkerVertexBuffer] = marker_index_buffer;
+        executor->dynamic_constant_buffer = dynamic_constant_buffer;
+        executor->layout_constant_buffer = layout_constant_buffer;
+        executor->plot_constant_buffer = plot_constant_buffer;
+        executor->grid_constant_buffer = grid_constant_buffer;
+        executor->line_emphasis_buffer = line_emphasis_buffer;
+        executor->line_emphasis_buffer_srv = line_emphasis_buffer_srv;
+        executor->glyph_instance_buffer_srv = glyph_instance_buffer_srv;
+        executor->font_sampler_state = font_sampler_state;
+        executor->font_texture_srv = font_texture_srv;
+    }
+
+    // NOTE: nothing else is ever blended, so it's only set once
+    {
+        FLOAT* blend_factor = 0;
+        UINT sample_mask = 0xffffffff;
+        d3d_device_context->OMSetBlendState(blend_state, blend_factor, sample_mask);
+    }
     
     while( true )
     {
@@ -2377,7 +2495,64 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             if( should_exit )
                 break;
         }
+
+        if(Platform::got_pressed(&input_state.toggle_decibels))
+        {
+            magnitude_plot_decibels = !magnitude_plot_decibels;
+            plotviewport_unzoomed_y_dimension_plotdata[0] =
+                magnitude_plot_decibels ?
+                FramePasses::MAGNITUDE_PLOT_UNZOOMED_Y_DIMENSION_DECIBELS :
+                FramePasses::MAGNITUDE_PLOT_UNZOOMED_Y_DIMENSION_LINEAR;
+            plotviewport_center_y_plotdata[0] =
+                magnitude_plot_decibels ?
+                FramePasses::MAGNITUDE_PLOT_CENTER_Y_DECIBELS :
+                FramePasses::MAGNITUDE_PLOT_CENTER_Y_LINEAR;
+        }
+
+        if(Platform::got_pressed(&input_state.toggle_log_frequency))
+        {
+            log_frequency_axis = !log_frequency_axis;
+            for(int plot_idx=0; plot_idx < 2; plot_idx++)
+            {
+                plotviewport_unzoomed_x_dimension_plotdata[plot_idx] =
+                    log_frequency_axis ?
+                    FramePasses::FREQUENCY_PLOT_NUM_DECADES*FramePasses::FREQUENCY_PLOT_UNZOOMED_X_DIMENSION_LINEAR[plot_idx] :
+                    FramePasses::FREQUENCY_PLOT_UNZOOMED_X_DIMENSION_LINEAR[plot_idx];
+                plotviewport_center_x_plotdata[plot_idx] =
+                    log_frequency_axis ?
+                    -0.5f*FramePasses::FREQUENCY_PLOT_NUM_DECADES :
+                    FramePasses::FREQUENCY_PLOT_CENTER_X_LINEAR;
+            }
+        }
+
+        // NOTE: samples and fit target points are in frequency, the plots in its logarithm on a log axis
+        double const frequency_log_base_or_0 = log_frequency_axis ? double(grid_base) : 0.0;
+
+        if(Platform::got_pressed(&input_state.toggle_root_locus))
+        {
+            show_root_locus = !show_root_locus;
+        }
+
+        if(Platform::got_pressed(&input_state.toggle_contours))
+        {
+            show_contours = !show_contours;
+        }
+
+        if(Platform::got_pressed(&input_state.clear_fit_target))
+        {
+            Fit::clear_target(&fit_target);
+            Fit::reset_solver(&fit_solver);
+        }
         
+        g_num_draw_calls = 0;
+        for(int plot_idx=0; plot_idx < 2; plot_idx++)
+        {
+            for(int orientation_idx=0; orientation_idx < Grid::Orientation::NumOrientations; orientation_idx++)
+            {
+                Grid::Layout::reset_statistics(&grid_layouts[plot_idx][orientation_idx].stats);
+            }
+        }
+
         // Get work start time in counts
 #if IIR4_WIDGET_PERFORMANCE_SPAM_LEVEL > 0        
         Platform::TimeCount work_start_counts = Platform::time_get_count();
@@ -2494,14 +2669,14 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             float const cursor_y_position_plot =
                 cursor_y_position_viewport - plotviewport_center_y_viewport;
             
-            float const old_plot_x_unit_plotdata =
-                plotviewport_unzoomed_x_dimension_plotdata[zoomed_plot] * Numerics::power(float(grid_base), -prev_x_zoom_plotdata[zoomed_plot]) / plotviewport_x_dimension_viewport;
-            float const new_plot_x_unit_plotdata =
-                plotviewport_unzoomed_x_dimension_plotdata[zoomed_plot] * Numerics::power(float(grid_base), -x_zoom_plotdata[zoomed_plot]) / plotviewport_x_dimension_viewport;
-            float const old_plot_y_unit_plotdata =
-                plotviewport_unzoomed_y_dimension_plotdata[zoomed_plot] * Numerics::power(float(grid_base), -prev_y_zoom_plotdata[zoomed_plot]) / plotviewport_y_dimension_viewport;
-            float const new_plot_y_unit_plotdata =
-                plotviewport_unzoomed_y_dimension_plotdata[zoomed_plot] * Numerics::power(float(grid_base), -y_zoom_plotdata[zoomed_plot]) / plotviewport_y_dimension_viewport;
+            double const old_plot_x_unit_plotdata =
+                plotviewport_unzoomed_x_dimension_plotdata[zoomed_plot] * Numerics::power(double(grid_base), -double(prev_x_zoom_plotdata[zoomed_plot])) / plotviewport_x_dimension_viewport;
+            double const new_plot_x_unit_plotdata =
+                plotviewport_unzoomed_x_dimension_plotdata[zoomed_plot] * Numerics::power(double(grid_base), -double(x_zoom_plotdata[zoomed_plot])) / plotviewport_x_dimension_viewport;
+            double const old_plot_y_unit_plotdata =
+                plotviewport_unzoomed_y_dimension_plotdata[zoomed_plot] * Numerics::power(double(grid_base), -double(prev_y_zoom_plotdata[zoomed_plot])) / plotviewport_y_dimension_viewport;
+            double const new_plot_y_unit_plotdata =
+                plotviewport_unzoomed_y_dimension_plotdata[zoomed_plot] * Numerics::power(double(grid_base), -double(y_zoom_plotdata[zoomed_plot])) / plotviewport_y_dimension_viewport;
             
             plotviewport_center_x_plotdata[zoomed_plot] +=
                 cursor_x_position_plot*(old_plot_x_unit_plotdata - new_plot_x_unit_plotdata);
@@ -2520,25 +2695,25 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             plot_drag_start_y_viewport = cursor_y_position_viewport;
         }
 
-        float const viewport_x_unit_plotdata[2] =
+        double const viewport_x_unit_plotdata[2] =
             {
-                plotviewport_unzoomed_x_dimension_plotdata[0] * Numerics::power(float(grid_base), -x_zoom_plotdata[0]) / plotviewport_x_dimension_viewport,
-                plotviewport_unzoomed_x_dimension_plotdata[1] * Numerics::power(float(grid_base), -x_zoom_plotdata[1]) / plotviewport_x_dimension_viewport,
+                plotviewport_unzoomed_x_dimension_plotdata[0] * Numerics::power(double(grid_base), -double(x_zoom_plotdata[0])) / plotviewport_x_dimension_viewport,
+                plotviewport_unzoomed_x_dimension_plotdata[1] * Numerics::power(double(grid_base), -double(x_zoom_plotdata[1])) / plotviewport_x_dimension_viewport,
             };
         
-        float const viewport_y_unit_plotdata[2] =
+        double const viewport_y_unit_plotdata[2] =
             {
-                plotviewport_unzoomed_y_dimension_plotdata[0] * Numerics::power(float(grid_base), -y_zoom_plotdata[0]) / plotviewport_y_dimension_viewport,
-                plotviewport_unzoomed_y_dimension_plotdata[1] * Numerics::power(float(grid_base), -y_zoom_plotdata[1]) / plotviewport_y_dimension_viewport,
+                plotviewport_unzoomed_y_dimension_plotdata[0] * Numerics::power(double(grid_base), -double(y_zoom_plotdata[0])) / plotviewport_y_dimension_viewport,
+                plotviewport_unzoomed_y_dimension_plotdata[1] * Numerics::power(double(grid_base), -double(y_zoom_plotdata[1])) / plotviewport_y_dimension_viewport,
             };
         
-        float const drag_offset_x_plotdata[2] =
+        double const drag_offset_x_plotdata[2] =
         {
             (cursor_x_position_viewport - plot_drag_start_x_viewport) * viewport_x_unit_plotdata[0],
             (cursor_x_position_viewport - plot_drag_start_x_viewport) * viewport_x_unit_plotdata[1],
         };
         
-        float const drag_offset_y_plotdata[2] =
+        double const drag_offset_y_plotdata[2] =
         {
             (cursor_y_position_viewport - plot_drag_start_y_viewport) * viewport_y_unit_plotdata[0],
             (cursor_y_position_viewport - plot_drag_start_y_viewport) * viewport_y_unit_plotdata[1],
@@ -2551,6 +2726,47 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             plotviewport_center_y_plotdata[previously_dragged_plot] -= drag_offset_y_plotdata[previously_dragged_plot];
         }
 
+        // NOTE: draw the fit target, a new stroke replaces the old target
+        {
+            if(!drawing_fit_target && hovered_plotviewport == 0 && dragged_plot == -1 &&
+               Platform::got_pressed(&input_state.mouse_right))
+            {
+                drawing_fit_target = true;
+                Fit::clear_target(&fit_target);
+                Fit::reset_solver(&fit_solver);
+            }
+            else if(drawing_fit_target && !input_state.mouse_right.pressed)
+            {
+                drawing_fit_target = false;
+            }
+
+            if(drawing_fit_target)
+            {
+                float const plotviewport_center_y_viewport =
+                    (plotviewport_min_y_viewport[0] + plotviewport_max_y_viewport[0])*0.5f;
+                float const cursor_x_position_plotdata =
+                    float(
+                        plotviewport_center_x_plotdata[0] +
+                        (cursor_x_position_viewport - plotviewport_center_x_viewport)*viewport_x_unit_plotdata[0]
+                        );
+                float const cursor_y_position_plotdata =
+                    float(
+                        plotviewport_center_y_plotdata[0] +
+                        (cursor_y_position_viewport - plotviewport_center_y_viewport)*viewport_y_unit_plotdata[0]
+                        );
+
+                float const ln_magnitude =
+                    magnitude_plot_decibels ?
+                    cursor_y_position_plotdata/Response::DECIBELS_PER_LN :
+                    Numerics::logarithm(2.0f, Numerics::maximum(cursor_y_position_plotdata, 1.0E-6f))*Fit::LN_2;
+
+                bool const continue_stroke = fit_target.num_drawn > 0;
+                float const cursor_frequency =
+                    float(Response::sample_x(cursor_x_position_plotdata, frequency_log_base_or_0));
+                Fit::draw_target(&fit_target, cursor_frequency, ln_magnitude, continue_stroke);
+            }
+        }
+
         float const widgetviewport_x_unit_viewport =
             float(widgetviewport_x_dimension_screen)/viewport_x_dimension_screen;
 
@@ -2676,7 +2892,7 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             parameters.parameter.pole[1] = {0.35f*sinf(time*s), 0.25f*cosf(time*s*0.5f)};            
             
         }
-        else
+        else if(selected_parameter_idx != -1)
         {
 
             parameters.parameters[selected_parameter_idx] =
@@ -2686,615 +2902,139 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
                 };
             
         }
-
-        float const normalization_factor = normalization_constant_highpass(&parameters);
-        
-        // NOTE: set scissor rectangle to entire viewport
-        {
-            D3D11_RECT rectangles[1] = {};
-            rectangles[0].left = 0;
-            rectangles[0].top = 0;
-            rectangles[0].right = viewport_x_dimension_screen;
-            rectangles[0].bottom = viewport_y_dimension_screen;
-            uint const num_rectangles = ARRAY_LENGTH(rectangles);
-            d3d_device_context->RSSetScissorRects(
-                num_rectangles,
-                rectangles
-                );
-        }
-        
-        {
-            FLOAT* blend_factor = 0;
-            UINT sample_mask = 0xffffffff;
-            d3d_device_context->OMSetBlendState(blend_state, blend_factor, sample_mask);
-        }
-        
-        {
-            FLOAT const clear_color[4] = {0.0f, 0.2f, 0.3f, 0.0};
-            d3d_device_context->ClearRenderTargetView(render_target_view, clear_color);
-        }
-        
-        uint dynamic_cbuffer_slot = 0;
-        
-        {
-            uint const num_buffers = 1;
-            ID3D11Buffer* buffers[num_buffers] = {dynamic_constant_buffer};
-            uint start_slot = dynamic_cbuffer_slot;
-            d3d_device_context->PSSetConstantBuffers(
-                start_slot,
-                num_buffers,
-                buffers
-                );            
-            
-        }
-        
-        
-        {
-            uint const num_buffers = 2;
-            ID3D11Buffer* buffers[num_buffers] = {dynamic_constant_buffer, layout_constant_buffer};
-            d3d_device_context->VSSetConstantBuffers(
-                dynamic_cbuffer_slot,
-                num_buffers,
-                buffers
-                );
-        }        
-        
-        d3d_device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        
-        {
-            bool const success = 
-                update_parameters(
-                    d3d_device_context,
-                    dynamic_constant_buffer,
-                    &parameters,
-                    normalization_factor
-                    );
-            assert(success);
-        }        
-        
-        
-        // NOTE: update widget layout constants
-        {
-
-            WidgetLayoutConstants layout_constants = {};
-            layout_constants.center_x_position_viewport = widgetviewport_center_x_viewport;
-            layout_constants.center_y_position_viewport = top_widgetviewport_center_y_viewport;
-            layout_constants.data_x_unit_viewport = widgetdata_x_unit_viewport;
-            layout_constants.data_y_unit_viewport = widgetdata_y_unit_viewport;
-
-            bool const success =
-                update_layout_constants(
-                    d3d_device_context,
-                    layout_constant_buffer,
-                    &layout_constants
-                    );
-            assert(success);                    
-                    
-        }
-
-        // NOTE: draw magnitude density
+        else if(fit_target.num_drawn > 0)
         {
-            // NOTE: set the density pixel shader
-            {
-                uint num_class_instances = 0;
-                ID3D11ClassInstance** class_instances = 0;
-                d3d_device_context->PSSetShader(
-                    density_pixel_shader,
-                    class_instances,
-                    num_class_instances
-                    );            
-            }        
-        
-            draw_circle(
-                d3d_device_context,
-                circle_vertex_buffer,
-                circle_index_buffer,
-                circle_vertex_input_layout,
-                circle_vertex_shader
-                );
+            // NOTE: one iteration per frame, so the zeros and poles can be seen converging
+            Fit::iterate(&fit_target, &fit_solver, &parameters);
         }
-        
-        draw_markers(
-            d3d_device_context,
-            dynamic_vertex_input_layout,
-            dynamic_vertex_shader,
-            marker_vertex_buffer,
-            marker_index_buffer,
-            solid_pixel_shader
-            
-            );
 
-        // NOTE: update widget layout constants
+        // NOTE:
+        // The contours and the locus are rebuilt here, before the frame is recorded, since they are spread over the
+        // worker threads themselves, like the curves.
+        bool contours_changed = false;
+        if(show_contours)
         {
-
-            WidgetLayoutConstants layout_constants = {};
-            layout_constants.center_x_position_viewport = widgetviewport_center_x_viewport;
-            layout_constants.center_y_position_viewport = bottom_widgetviewport_center_y_viewport;
-            layout_constants.data_x_unit_viewport = widgetdata_x_unit_viewport;
-            layout_constants.data_y_unit_viewport = widgetdata_y_unit_viewport;
-
-            bool const success = update_layout_constants(
-                d3d_device_context,
-                layout_constant_buffer,
-                &layout_constants
-                );
-                
-            assert(success);
-                    
-                    
+            // NOTE: the contours are only rebuilt, and uploaded, when the parameters or the levels change
+            bool const rebuilt = Contour::update(&parameters, &contour_levels, &contours);
+            contours_changed = rebuilt || !contours_uploaded;
+            contours_uploaded = true;
         }
 
-        // NOTE: draw domain coloring
+        bool locus_changed = false;
+        if(show_root_locus)
         {
-            // NOTE: set the density pixel shader
+            locus_changed = !locus_uploaded || memcmp(&locus_parameters, &parameters, sizeof(parameters)) != 0;
+            if(locus_changed)
             {
-                uint num_class_instances = 0;
-                ID3D11ClassInstance** class_instances = 0;
-                d3d_device_context->PSSetShader(
-                    domain_coloring_pixel_shader,
-                    class_instances,
-                    num_class_instances
-                    );            
-            }        
-        
-            draw_circle(
-                d3d_device_context,
-                circle_vertex_buffer,
-                circle_index_buffer,
-                circle_vertex_input_layout,
-                circle_vertex_shader
-                );
+                RootLocus::sweep(&parameters, &locus);
+                locus_parameters = parameters;
+            }
+            locus_uploaded = true;
         }
 
-        draw_markers(
-            d3d_device_context,
-            dynamic_vertex_input_layout,
-            dynamic_vertex_shader,
-            marker_vertex_buffer,
-            marker_index_buffer,
-            solid_pixel_shader
-            );
-        
-        d3d_device_context->IASetInputLayout(dynamic_vertex_input_layout);
-
-        Grid::Transform plot_x_transform[2];
-        Grid::Transform plot_y_transform[2];
-
+        FramePasses::Plot plots[2];
         for(int plot_idx=0; plot_idx<2; plot_idx++)
         {
-            
-            float const smallest_visible_horizontal_level_spacing_screen = 10.0f;
-            float const smallest_visible_vertical_level_spacing_screen = 15.0f;
-            
-            float const smallest_visible_horizontal_level_spacing_viewport =
-                smallest_visible_horizontal_level_spacing_screen*screen_y_unit_viewport;
-            float const smallest_visible_vertical_level_spacing_viewport =
-                smallest_visible_vertical_level_spacing_screen*screen_x_unit_viewport;
-            
-
-            float const plotviewport_dragged_center_x_plotdata =
+            double const plotviewport_dragged_center_x_plotdata =
                 (dragged_plot == plot_idx) ?
                 plotviewport_center_x_plotdata[plot_idx] - drag_offset_x_plotdata[dragged_plot] :
                 plotviewport_center_x_plotdata[plot_idx];
-            float const plotviewport_dragged_center_y_plotdata =
+            double const plotviewport_dragged_center_y_plotdata =
                 (dragged_plot == plot_idx) ?
                 plotviewport_center_y_plotdata[plot_idx] - drag_offset_y_plotdata[dragged_plot] :
                 plotviewport_center_y_plotdata[plot_idx];
 
-            using namespace Numerics;
-
-            float const viewport_x_dimension_widgetdata =
-                viewport_x_unit_plotdata[plot_idx]*viewport_x_dimension_viewport;
-            
-            float const viewport_y_dimension_widgetdata =
-                power(float(grid_base), -y_zoom_plotdata[plot_idx])*viewport_y_dimension_viewport;
-
-            float const plotviewport_x_dimension_plotdata =
+            double const plotviewport_x_dimension_plotdata =
                 plotviewport_unzoomed_x_dimension_plotdata[plot_idx] *
-                Numerics::power(float(grid_base), -x_zoom_plotdata[plot_idx]);
+                Numerics::power(double(grid_base), -double(x_zoom_plotdata[plot_idx]));
 
-            float const plotviewport_y_dimension_plotdata =
+            double const plotviewport_y_dimension_plotdata =
                 plotviewport_unzoomed_y_dimension_plotdata[plot_idx] *
-                Numerics::power(float(grid_base), -y_zoom_plotdata[plot_idx]);
-            
-            plot_x_transform[plot_idx].viewport_min_data =
-                plotviewport_dragged_center_x_plotdata - plotviewport_x_dimension_plotdata*0.5f;
-            
-            plot_x_transform[plot_idx].viewport_max_data =
-                plotviewport_dragged_center_x_plotdata + plotviewport_x_dimension_plotdata*0.5f;
-
-            plot_y_transform[plot_idx].viewport_min_data =
-                plotviewport_dragged_center_y_plotdata - plotviewport_y_dimension_plotdata*0.5f;
-            
-            plot_y_transform[plot_idx].viewport_max_data =
-                plotviewport_dragged_center_y_plotdata + plotviewport_y_dimension_plotdata*0.5f;
-
-            float const text_end_x_viewport = plotviewport_min_x_viewport;
-            float const text_end_y_viewport = plotviewport_min_y_viewport[plot_idx];
-
-            Grid::draw_grid(
-                character_spacing_screen,
-                grid_base,
-                smallest_visible_horizontal_level_spacing_viewport,
-                smallest_visible_vertical_level_spacing_viewport,
-                plotviewport_min_x_viewport,
-                plotviewport_max_x_viewport,
-                plotviewport_min_y_viewport[plot_idx],
-                plotviewport_max_y_viewport[plot_idx],
-                viewport_x_dimension_screen,
-                viewport_y_dimension_screen,
-                text_end_x_viewport,
-                text_end_y_viewport,
-                &plot_y_transform[plot_idx],
-                &plot_x_transform[plot_idx],
-                d3d_device_context,
-                grid_vertex_shader,
-                solid_pixel_shader,
-                grid_constant_buffer,
-                grid_numbers_vertex_shader,
-                font_pixel_shader,
-                font_sampler_state,
-                font_texture_srv,
-                grid_numbers_constant_buffer
-                );
-
+                Numerics::power(double(grid_base), -double(y_zoom_plotdata[plot_idx]));
+
+            FramePasses::Plot *const plot = &plots[plot_idx];
+            plot->min_x_viewport = plotviewport_min_x_viewport;
+            plot->max_x_viewport = plotviewport_max_x_viewport;
+            plot->min_y_viewport = plotviewport_min_y_viewport[plot_idx];
+            plot->max_y_viewport = plotviewport_max_y_viewport[plot_idx];
+            plot->margin_x_dimension_viewport = plotviewportmargin_x_dimension_viewport;
+            
+            plot->x_transform.viewport_min_data =
+                plotviewport_dragged_center_x_plotdata - plotviewport_x_dimension_plotdata*0.5;
+            
+            plot->x_transform.viewport_max_data =
+                plotviewport_dragged_center_x_plotdata + plotviewport_x_dimension_plotdata*0.5;
+
+            plot->y_transform.viewport_min_data =
+                plotviewport_dragged_center_y_plotdata - plotviewport_y_dimension_plotdata*0.5;
+            
+            plot->y_transform.viewport_max_data =
+                plotviewport_dragged_center_y_plotdata + plotviewport_y_dimension_plotdata*0.5;
+
+            plot->curve =
+                plot_idx == 1 ? Response::PhaseTurns :
+                magnitude_plot_decibels ? Response::MagnitudeDecibels :
+                Response::Magnitude;
+            plot->fit_target_or_0 = plot_idx == 0 ? &fit_target : 0;
+            plot->dense_curve = &dense_curves[plot_idx];
+            plot->grid_layouts = grid_layouts[plot_idx];
+            plot->curve_vertices = curve_vertices[plot_idx];
+        }
+
+        FramePasses::Frame frame;
+        frame.viewport_x_dimension_screen = viewport_x_dimension_screen;
+        frame.viewport_y_dimension_screen = viewport_y_dimension_screen;
+        frame.parameters = &parameters;
+        for(int widget_idx=0; widget_idx < 2; widget_idx++)
+        {
+            WidgetLayoutConstants *const layout_constants = &frame.widget_layouts[widget_idx];
+            *layout_constants = {};
+            layout_constants->center_x_position_viewport = widgetviewport_center_x_viewport;
+            layout_constants->center_y_position_viewport =
+                widget_idx == 0 ? top_widgetviewport_center_y_viewport : bottom_widgetviewport_center_y_viewport;
+            layout_constants->data_x_unit_viewport = widgetdata_x_unit_viewport;
+            layout_constants->data_y_unit_viewport = widgetdata_y_unit_viewport;
+        }
+        frame.contours_or_0 = show_contours ? &contours : 0;
+        frame.contours_changed = contours_changed;
+        frame.locus_or_0 = show_root_locus ? &locus : 0;
+        frame.locus_changed = locus_changed;
+        frame.character_spacing_screen = character_spacing_screen;
+        frame.max_num_label_characters = int(plotviewportmargin_x_dimension_characters);
+        frame.grid_base = grid_base;
+        {
+            float const smallest_visible_horizontal_level_spacing_screen = 10.0f;
+            float const smallest_visible_vertical_level_spacing_screen = 15.0f;
+            frame.smallest_visible_horizontal_level_spacing_viewport =
+                smallest_visible_horizontal_level_spacing_screen*screen_y_unit_viewport;
+            frame.smallest_visible_vertical_level_spacing_viewport =
+                smallest_visible_vertical_level_spacing_screen*screen_x_unit_viewport;
         }
-        
-        // NOTE: draw ttf font
-        if(0)
-        {            
-            
-            // NOTE: set the pixel shader
-            {
-                uint num_class_instances = 0;
-                ID3D11ClassInstance** class_instances = 0;
-                d3d_device_context->PSSetShader(
-                    ttf_font_pixel_shader,
-                    class_instances,
-                    num_class_instances
-                    );
-            }
+        frame.label_cache = label_cache;
+        frame.glyph_batch = glyph_batch;
+        frame.plots = plots;
+        frame.num_plots = 2;
+        frame.log_frequency_axis = log_frequency_axis;
+        frame.frequency_plot_min_x_logarithmic = FramePasses::FREQUENCY_PLOT_MIN_X_LOGARITHMIC;
+        frame.frequency_log_base_or_0 = frequency_log_base_or_0;
+        frame.num_curve_slices = num_curve_slices;
 
-            // NOTE: set the vertex shader
-            {
-                uint num_class_instances = 0;
-                ID3D11ClassInstance** class_instances = 0;
-                d3d_device_context->VSSetShader(
-                    ttf_grid_numbers_vertex_shader,
-                    class_instances,
-                    num_class_instances
-                    );
-            }            
-
-            // NOTE: set ttf font sampler
-            {
-            
-                uint const start_slot = 1;
-                ID3D11SamplerState *const samplers[] = {ttf_font_sampler_state};
-                uint num_samplers = ARRAY_LENGTH(samplers); 
-            
-                d3d_device_context->PSSetSamplers(
-                    start_slot,
-                    num_samplers,
-                    samplers
-                    );
-            
-            }
-            
-            {
-
-                uint const start_slot = 1;
-                ID3D11ShaderResourceView *const shader_resource_views[] = {ttf_font_texture_srv};
-                uint const num_views = ARRAY_LENGTH(shader_resource_views);
-                
-                d3d_device_context->PSSetShaderResources(
-                    start_slot,
-                    num_views,
-                    shader_resource_views
-                    );
-                
-            }
-            
-            d3d_device_context->IASetInputLayout(0);
-            d3d_device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+        // NOTE: the curves are sampled a plot per worker thread, recording only takes microseconds after that
+        FramePasses::sample_curves(&frame, true);
+        FramePasses::record(&frame, &commands);
 
+        Grid::Layout::Statistics frame_grid_layout_stats;
+        Grid::Layout::reset_statistics(&frame_grid_layout_stats);
+        for(int plot_idx=0; plot_idx < 2; plot_idx++)
+        {
+            for(int orientation_idx=0; orientation_idx < Grid::Orientation::NumOrientations; orientation_idx++)
             {
-                uint const vertex_count = 4;
-                uint const start_vertex_location = 0;
-                
-                d3d_device_context->Draw(
-                    vertex_count,
-                    start_vertex_location
-                    );
+                Grid::Layout::merge(&grid_layouts[plot_idx][orientation_idx].stats, &frame_grid_layout_stats);
             }
-            
         }
+        Grid::Layout::merge(&frame_grid_layout_stats, &grid_layout_stats);
 
-        // NOTE: draw the plots
-        for(int plot_idx=0; plot_idx<2; plot_idx++)
-        {            
-            
-            {
-                uint input_slot = 0;
-                uint const num_buffers = 1;
-                ID3D11Buffer* buffers[num_buffers] = {curve_vertex_buffer};
-                uint strides[num_buffers] = {sizeof(float)};
-                uint offsets[num_buffers] = {0};
-                d3d_device_context->IASetVertexBuffers(
-                    input_slot,
-                    num_buffers,
-                    buffers,
-                    strides,
-                    offsets
-                    );
-            }
-            
-            uint plot_cbuffer_slot = 2;
-            {
-                uint const num_buffers = 1;
-                ID3D11Buffer* buffers[num_buffers] = {plot_constant_buffer};
-                d3d_device_context->VSSetConstantBuffers(
-                    plot_cbuffer_slot,
-                    num_buffers,
-                    buffers
-                    );
-            }
-
-            {
-
-                float const plot_viewport_x_dimension_viewport = plotviewport_x_dimension_viewport;
-                float const plot_viewport_y_dimension_viewport = plotviewport_y_dimension_viewport;
-                
-                float const min_x_plotdata = Numerics::maximum(0.0f, plot_x_transform[plot_idx].viewport_min_data);
-                float const max_x_plotdata = Numerics::minimum(1.0f, plot_x_transform[plot_idx].viewport_max_data);
-                
-                // NOTE: update the curve
-                if(plot_idx == 0)
-                {
-                    // NOTE: frequency response plot
-
-                    float vertices[num_curve_slices];
-                    for(int slice_idx=0; slice_idx < num_curve_slices; slice_idx++)
-                    {
-                        float const t = float(slice_idx)/float(num_curve_segments);
-                        float const angle = Numerics::lerp(min_x_plotdata, max_x_plotdata, t) * PI_FLOAT;
-                        Complex::C sample_point;
-                        Complex::unit_circle_point(angle, &sample_point);
-
-                        float a[2][2];
-                        for(int i=0; i<2; i++)
-                        {
-                            for(int j=0; j<2; j++)
-                            {
-                                Complex::C const*const p = &parameters.ator_factors[i][j];
-                                Complex::C p_conjugate;
-                                Complex::conjugate(p, &p_conjugate);
-                                a[i][j] =
-                                    Complex::distance(&sample_point, p)*Complex::distance(&sample_point, &p_conjugate);
-                            }
-                        }
-                        
-                        vertices[slice_idx] =
-                            normalization_factor*(a[0][0]*a[0][1])/(a[1][0]*a[1][1]);
-                    }
-            
-                    bool const success =
-                        try_upload_curve_vertices(
-                            num_curve_slices,
-                            vertices,
-                            d3d_device_context,
-                            curve_vertex_buffer
-                            );
-
-                    assert(success);
-            
-                }
-                else if(plot_idx == 1)
-                {
-                    // NOTE: frequency phase plot
-
-                    float vertices[num_curve_slices];
-                    for(int slice_idx=0; slice_idx < num_curve_slices; slice_idx++)
-                    {
-                        float const t = float(slice_idx)/float(num_curve_segments);
-                        float const angle = Numerics::lerp(min_x_plotdata, max_x_plotdata, t) * PI_FLOAT;
-                        Complex::C sample_point;
-                        Complex::unit_circle_point(angle, &sample_point);
-
-                        Complex::C ator[2];
-                        for(int i=0; i<2; i++)
-                        {
-                            Complex::unit(&ator[i]);
-                            for(int j=0; j<2; j++)
-                            {
-                                Complex::C const*const p = &parameters.ator_factors[i][j];
-                                Complex::C p_conjugate;
-                                Complex::conjugate(p, &p_conjugate);
-
-                                Complex::C d;
-                                Complex::difference(&sample_point, p, &d);
-                                
-                                Complex::C d_conjugate;
-                                Complex::difference(&sample_point, &p_conjugate, &d_conjugate);
-                                
-                                Complex::multiply(&d, &ator[i]);
-                                Complex::multiply(&d_conjugate, &ator[i]);
-                                
-                            }
-                        }
-
-                        Complex::C image;
-                        Complex::quotient(&ator[0], &ator[1], &image);
-                        float const phase = Complex::phase(&image);
-                        
-                        vertices[slice_idx] = 0.5f*phase/PI_FLOAT;
-                    }
-            
-                    bool const success =
-                        try_upload_curve_vertices(
-                            num_curve_slices,
-                            vertices,
-                            d3d_device_context,
-                            curve_vertex_buffer
-                            );
-
-                    assert(success);
-            
-                }
-
-                
-                PlotConstants constants;
-                float const rectangle_plotdata[4] =
-                    {
-                        plot_x_transform[plot_idx].viewport_min_data,
-                        plot_x_transform[plot_idx].viewport_max_data,
-                        plot_y_transform[plot_idx].viewport_min_data,
-                        plot_y_transform[plot_idx].viewport_max_data
-                    };
-                float const rectangle_viewport[4] =
-                    {
-                        plotviewport_min_x_viewport,
-                        plotviewport_max_x_viewport,
-                        plotviewport_min_y_viewport[plot_idx],
-                        plotviewport_max_y_viewport[plot_idx],
-                    };
-
-				memcpy(constants.plotviewport_data, rectangle_plotdata, sizeof(rectangle_plotdata));
-				memcpy(constants.plotviewport_viewport, rectangle_viewport, sizeof(rectangle_viewport));
-                constants.curve_interval_x_data[0] = min_x_plotdata;
-                constants.curve_interval_x_data[1] = max_x_plotdata;
-                constants.num_curve_slices = num_curve_slices;
-                constants.margin_x_dimension_viewport = plotviewportmargin_x_dimension_viewport;
-                
-                bool const success = 
-                    update_plot_constants(
-                        d3d_device_context,
-                        plot_constant_buffer,
-                        &constants
-                        );
-                assert(success);
-            }
-
-            // NOTE: set scissor rectangle to entire viewport
-            {
-                D3D11_RECT rectangles[1] = {};
-                rectangles[0].left = 0;
-                rectangles[0].top = 0;
-                rectangles[0].right = viewport_x_dimension_screen;
-                rectangles[0].bottom = viewport_y_dimension_screen;
-                uint const num_rectangles = ARRAY_LENGTH(rectangles);
-                d3d_device_context->RSSetScissorRects(
-                    num_rectangles,
-                    rectangles
-                    );
-            }
-            
-            // NOTE: draw color bars
-            {
-
-                // NOTE: set the vertex shader
-                {
-                    uint num_class_instances = 0;
-                    ID3D11ClassInstance** class_instances = 0;
-                    d3d_device_context->VSSetShader(
-                        colorbar_vertex_shader,
-                        class_instances,
-                        num_class_instances
-                        );
-                }
-                
-                // NOTE: set the pixel shader
-                {
-                    uint num_class_instances = 0;
-                    ID3D11ClassInstance** class_instances = 0;
-                    d3d_device_context->PSSetShader(
-                        plot_idx == 0 ? colorbar_magnitude_pixel_shader : colorbar_colorwheel_pixel_shader,
-                        class_instances,
-                        num_class_instances
-                        );
-                }
-                
-                d3d_device_context->IASetInputLayout(0);
-                d3d_device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
-
-                {
-                    uint const vertex_count = 4;
-                    uint const start_vertex_location = 0;
-                
-                    d3d_device_context->Draw(
-                        vertex_count,
-                        start_vertex_location
-                        );
-                }                
-                
-            }
-            
-            
-            d3d_device_context->IASetInputLayout(curve_vertex_input_layout);
-            d3d_device_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP);                
-
-            // NOTE: set the pixel shader
-            {
-                uint num_class_instances = 0;
-                ID3D11ClassInstance** class_instances = 0;
-                d3d_device_context->PSSetShader(
-                    solid_pixel_shader,
-                    class_instances,
-                    num_class_instances
-                    );
-            }
-
-            // NOTE: set the vertex shader
-            {
-                uint num_class_instances = 0;
-                ID3D11ClassInstance** class_instances = 0;
-                d3d_device_context->VSSetShader(
-                    plot_vertex_shader,
-                    class_instances,
-                    num_class_instances
-                    );
-            }
-            
-            // NOTE: set the clip rectangle
-            {
-                float const plotviewport_min_y_screen =
-                    (1.0f - plotviewport_max_y_viewport[plot_idx]) * viewport_y_unit_screen;
-                float const plotviewport_max_y_screen =
-                    (1.0f - plotviewport_min_y_viewport[plot_idx]) * viewport_y_unit_screen;
-                
-                
-                D3D11_RECT rectangles[1];
-				rectangles[0].left = LONG(plotviewport_min_x_screen);
-				rectangles[0].top = LONG(plotviewport_min_y_screen);
-				rectangles[0].right = LONG(plotviewport_max_x_screen);
-				rectangles[0].bottom = LONG(plotviewport_max_y_screen);
-                uint const num_rectangles = ARRAY_LENGTH(rectangles);
-                d3d_device_context->RSSetScissorRects(
-                    num_rectangles,
-                    rectangles
-                    );
-                    
-            }
-            
-            {
-                uint const vertex_count = num_curve_slices;
-                uint const start_vertex_location = 0;
-                
-                d3d_device_context->Draw(
-                    vertex_count,
-                    start_vertex_location
-                    );
-            }
-            
-        }
-        
-        
-        
-        {
-            FLOAT* blend_factor = 0;
-            UINT sample_mask = 0xffffffff;
-            d3d_device_context->OMSetBlendState(blend_state, blend_factor, sample_mask);
-        }        
+        RenderCommands::execute(&commands, &d3d11_executor, &command_stats);
 
         // TODO: unbind constant buffer? (so that it is not bound when updating it again next frame)
         
@@ -3361,6 +3101,21 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
             log_string("frame: ");
             logarithm(frame_total_duration*1.0E3f, num_decimal_places);
             log_string("ms");
+
+            log_string(", ");
+
+            log_string("draw calls: ");
+            log_uint32(g_num_draw_calls);
+
+            log_string(", ");
+
+            log_string("state changes: ");
+            log_uint32(command_stats.num_state_changes);
+
+            log_string(", ");
+
+            log_string("grid layout recomputes: ");
+            log_uint32(frame_grid_layout_stats.num_recomputes);
             
             log_string("\n");
             
@@ -3374,6 +3129,23 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
         
     }
 
+    GridBenchmark::log_label_cache_statistics(&label_cache->stats);
+    GridBenchmark::log_layout_statistics(&grid_layout_stats);
+
+    Platform::log_string("last frame: draw calls: ");
+    Platform::log_uint32(g_num_draw_calls);
+    Platform::log_string(", grid labels: ");
+    Platform::log_uint32(glyph_batch->num_labels);
+    Platform::log_string(", glyphs: ");
+    Platform::log_uint32(glyph_batch->num_glyphs);
+    Platform::log_string(", dropped glyphs: ");
+    Platform::log_uint32(glyph_batch->num_dropped_glyphs);
+    Platform::log_string(", culled labels: ");
+    Platform::log_uint32(glyph_batch->num_culled_labels);
+    Platform::log_line();
+    Platform::log_string("last frame commands: ");
+    RenderCommands::log_statistics(&command_stats);
+
     // NOTE:
     // Once the main loop has been entered, this is assumed to be the only valid exit point.
     // That is to say, it is not "allowed" to return from the main loop, only to break out of it.
@@ -3382,7 +3154,10 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
     // However, decrementing the refcounts here avoids spamming the output window with warnings
     // as the application exits.
     swap_chain->Release();
-    grid_numbers_constant_buffer->Release();
+    line_emphasis_buffer_srv->Release();
+    line_emphasis_buffer->Release();
+    glyph_instance_buffer_srv->Release();
+    glyph_instance_buffer->Release();
     font_texture->Release();
     font_texture_srv->Release();
     font_sampler_state->Release();
@@ -3400,6 +3175,10 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
     colorbar_magnitude_pixel_shader->Release();
     colorbar_colorwheel_pixel_shader->Release();
     dynamic_vertex_shader->Release();
+    locus_vertex_shader->Release();
+    locus_vertex_buffer->Release();
+    contour_vertex_shader->Release();
+    contour_vertex_buffer->Release();
     circle_vertex_input_layout->Release();    
     dynamic_vertex_input_layout->Release();
     render_target_view->Release();
@@ -3408,7 +3187,7 @@ WinMain(HINSTANCE instance, HINSTANCE prev_instance, LPSTR cmd_line, int num_cmd
     font_pixel_shader->Release();
     plot_vertex_shader->Release();
     plot_constant_buffer->Release();
-    curve_vertex_buffer->Release();
+    transient_vertex_buffer->Release();
     curve_vertex_input_layout->Release();
     colorbar_vertex_shader->Release();
     
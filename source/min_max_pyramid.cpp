@@ -0,0 +1,199 @@
+// NOTE:
+// Min/max decimation of a curve with far more samples than the plot has pixel columns.
+// The samples are built into a pyramid once, every level holding the minimum and the maximum of pairs of the level
+// below it. A column of the plot is then the minimum and the maximum of the few nodes that exactly cover its samples,
+// taken from the level that matches how many samples go to a column, and is drawn as two vertices. So the cost of
+// drawing the curve only depends on the number of columns, and a narrow peak between two columns still shows.
+namespace MinMaxPyramid
+{
+
+    uint const MAX_NUM_LEVELS = 32;
+
+    struct Pyramid
+    {
+        // NOTE: level_offsets[level_idx] + node_idx, level 0 is the samples themselves
+        float* mins;
+        float* maxs;
+        uint level_offsets[MAX_NUM_LEVELS];
+        uint level_num_nodes[MAX_NUM_LEVELS];
+        uint num_levels;
+        uint capacity;
+        // NOTE: x of the first and of the last sample, the samples are evenly spaced in between
+        double min_x;
+        double max_x;
+    };
+
+    void
+    initialize(Pyramid *const pyramid)
+    {
+        pyramid->mins = 0;
+        pyramid->maxs = 0;
+        pyramid->num_levels = 0;
+        pyramid->capacity = 0;
+        pyramid->min_x = 0.0;
+        pyramid->max_x = 0.0;
+    }
+
+    void
+    release(Pyramid *const pyramid)
+    {
+        // NOTE: the maxima share the allocation of the minima
+        if(pyramid->mins != 0)
+        {
+            Platform::free_memory(pyramid->mins);
+        }
+        initialize(pyramid);
+    }
+
+    // NOTE:
+    // Makes room for num_samples samples from min_x to max_x and returns where the caller writes them,
+    // then build_levels finishes the pyramid. Returns 0 if there is no memory for it.
+    float*
+    begin(uint const num_samples, double const min_x, double const max_x, Pyramid *const pyramid)
+    {
+        assert(num_samples >= 2);
+
+        uint num_levels = 1;
+        uint num_nodes = num_samples;
+        pyramid->level_offsets[0] = 0;
+        pyramid->level_num_nodes[0] = num_samples;
+        while(num_nodes > 1)
+        {
+            assert(num_levels < MAX_NUM_LEVELS);
+            pyramid->level_offsets[num_levels] = pyramid->level_offsets[num_levels - 1] + num_nodes;
+            num_nodes = (num_nodes + 1)/2;
+            pyramid->level_num_nodes[num_levels] = num_nodes;
+            num_levels++;
+        }
+        uint const total_num_nodes = pyramid->level_offsets[num_levels - 1] + 1;
+
+        if(total_num_nodes > pyramid->capacity)
+        {
+            if(pyramid->mins != 0)
+            {
+                Platform::free_memory(pyramid->mins);
+            }
+            pyramid->capacity = 0;
+            pyramid->mins = (float*)Platform::allocate_memory(sizeof(float)*2*total_num_nodes);
+            if(pyramid->mins == 0)
+            {
+                Platform::log_line_string("failed to allocate the min/max pyramid");
+                pyramid->num_levels = 0;
+                return 0;
+            }
+            pyramid->capacity = total_num_nodes;
+        }
+        pyramid->maxs = pyramid->mins + pyramid->capacity;
+        pyramid->num_levels = num_levels;
+        pyramid->min_x = min_x;
+        pyramid->max_x = max_x;
+        return pyramid->mins;
+    }
+
+    void
+    build_levels(Pyramid *const pyramid)
+    {
+        memcpy(pyramid->maxs, pyramid->mins, sizeof(float)*pyramid->level_num_nodes[0]);
+        for(uint level_idx=1; level_idx < pyramid->num_levels; level_idx++)
+        {
+            uint const num_children = pyramid->level_num_nodes[level_idx - 1];
+            float const*const child_mins = &pyramid->mins[pyramid->level_offsets[level_idx - 1]];
+            float const*const child_maxs = &pyramid->maxs[pyramid->level_offsets[level_idx - 1]];
+            float *const mins = &pyramid->mins[pyramid->level_offsets[level_idx]];
+            float *const maxs = &pyramid->maxs[pyramid->level_offsets[level_idx]];
+            for(uint node_idx=0; node_idx < pyramid->level_num_nodes[level_idx]; node_idx++)
+            {
+                // NOTE: the last node of a level with an odd number of children only has one
+                uint const first_child_idx = 2*node_idx;
+                uint const last_child_idx = Numerics::minimum(int(first_child_idx + 1), int(num_children - 1));
+                mins[node_idx] = Numerics::minimum(child_mins[first_child_idx], child_mins[last_child_idx]);
+                maxs[node_idx] = Numerics::maximum(child_maxs[first_child_idx], child_maxs[last_child_idx]);
+            }
+        }
+    }
+
+    // NOTE: fractional index of the sample at x
+    inline double
+    sample_position(Pyramid const*const pyramid, double const x)
+    {
+        return (x - pyramid->min_x)/(pyramid->max_x - pyramid->min_x)*double(pyramid->level_num_nodes[0] - 1);
+    }
+
+    // NOTE: whether the pyramid covers min_x to max_x with at least one sample to each of the columns
+    bool
+    resolves(Pyramid const*const pyramid, double const min_x, double const max_x, uint const num_columns)
+    {
+        if(pyramid->num_levels == 0 || min_x < pyramid->min_x || max_x > pyramid->max_x || max_x <= min_x)
+            return false;
+        return sample_position(pyramid, max_x) - sample_position(pyramid, min_x) >= double(num_columns);
+    }
+
+    // NOTE:
+    // The minimum and the maximum of the samples first_idx to last_idx. The range is split into the largest aligned
+    // nodes that fit in it, so it takes a couple of nodes of each level up to the one that matches its length.
+    void
+    range_min_max(
+        Pyramid const*const pyramid,
+        uint const first_idx,
+        uint const last_idx,
+        float *const min,
+        float *const max
+        )
+    {
+        *min = POSITIVE_INFINITY_FLOAT;
+        *max = NEGATIVE_INFINITY_FLOAT;
+        uint idx = first_idx;
+        while(idx <= last_idx)
+        {
+            uint level_idx = 0;
+            while(
+                level_idx + 1 < pyramid->num_levels &&
+                (idx & ((2u << level_idx) - 1)) == 0 &&
+                idx + (2u << level_idx) - 1 <= last_idx
+                )
+            {
+                level_idx++;
+            }
+            uint const node_idx = pyramid->level_offsets[level_idx] + (idx >> level_idx);
+            *min = Numerics::minimum(*min, pyramid->mins[node_idx]);
+            *max = Numerics::maximum(*max, pyramid->maxs[node_idx]);
+            idx += 1u << level_idx;
+        }
+    }
+
+    // NOTE:
+    // Two vertices per column from min_x to max_x, the minimum and the maximum of the samples in it.
+    // A column also takes the samples on its edges, so neighbouring columns connect. Each pair is ordered so that
+    // it starts with the extreme nearer to where the previous one ended.
+    void
+    decimate(
+        Pyramid const*const pyramid,
+        double const min_x,
+        double const max_x,
+        uint const num_columns,
+        float *const vertices
+        )
+    {
+        assert(resolves(pyramid, min_x, max_x, num_columns));
+
+        uint const last_sample_idx = pyramid->level_num_nodes[0] - 1;
+        double const first_position = sample_position(pyramid, min_x);
+        double const column_positions = (sample_position(pyramid, max_x) - first_position)/double(num_columns);
+        float previous = pyramid->mins[uint(Numerics::floor(first_position))];
+        for(uint column_idx=0; column_idx < num_columns; column_idx++)
+        {
+            double const column_first_position = first_position + double(column_idx)*column_positions;
+            uint const first_idx = uint(Numerics::floor(column_first_position));
+            uint const last_idx =
+                uint(Numerics::minimum(int(last_sample_idx), int(Numerics::ceiling(column_first_position + column_positions))));
+            float min;
+            float max;
+            range_min_max(pyramid, first_idx, last_idx, &min, &max);
+            bool const max_first = Numerics::absolute_value(max - previous) < Numerics::absolute_value(min - previous);
+            vertices[2*column_idx] = max_first ? max : min;
+            vertices[2*column_idx + 1] = max_first ? min : max;
+            previous = vertices[2*column_idx + 1];
+        }
+    }
+
+}
@@ -1,4 +1,5 @@
 #define PI_FLOAT ((float)M_PI)
+#define PI_DOUBLE (M_PI)
 // TODO: make sure in debugger that these represent inifinities
 #define POSITIVE_INFINITY_FLOAT ((float)(1e308 * 10))
 #define NEGATIVE_INFINITY_FLOAT ((float)(-1e308 * 10))
@@ -8,18 +8,36 @@ namespace Numerics
         return logf(x)/logf(base);
     }
 
+    inline double
+    logarithm(double const base, double const x)
+    {
+        return log(x)/log(base);
+    }
+
     inline float
     ceiling(float const x)
     {
         return ceilf(x);
     }
 
+    inline double
+    ceiling(double const x)
+    {
+        return ceil(x);
+    }
+
     inline float
     floor(float const x)
     {
         return floorf(x);
     }    
 
+    inline double
+    floor(double const x)
+    {
+        return ::floor(x);
+    }
+
     inline float
     arc_tangent(float const x, float const y)
     {
@@ -44,6 +62,12 @@ namespace Numerics
         // TODO: intrinsics?
         return sqrtf(a);
     }    
+
+    inline double
+    square_root(double const a)
+    {
+        return sqrt(a);
+    }
     
     inline float
     power(float x, float power)
@@ -52,14 +76,67 @@ namespace Numerics
         return powf(x, power);
     }
 
+    inline double
+    power(double x, double power)
+    {
+        return pow(x, power);
+    }
+
+    // NOTE:
+    // Exponentiation by squaring for compile time tables and checks. C++11 constexpr wants a single return
+    // statement, hence the recursion; the runtime overloads below loop instead.
+    constexpr uint64
+    constant_power(uint64 const x, uint const power)
+    {
+        return
+            power == 0 ? 1 :
+            (power % 2 == 1 ? x : 1) * constant_power(x*x, power/2);
+    }
+
+    // NOTE:
+    // Every power of ten that fits in a uint64, for the grid which almost always has base ten.
+    // The first NUM_UINT_POWERS_OF_TEN of them fit in a uint.
+    uint const NUM_POWERS_OF_TEN = 20;
+    uint const NUM_UINT_POWERS_OF_TEN = 10;
+    constexpr uint64 POWERS_OF_TEN[NUM_POWERS_OF_TEN] =
+    {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+        10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+        1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull,
+        10000000000000000000ull,
+    };
+
+    static_assert(constant_power(10, 0) == 1, "table needs to match");
+    static_assert(constant_power(10, 7) == 10000000, "table needs to match");
+    static_assert(
+        constant_power(10, NUM_POWERS_OF_TEN - 1) == POWERS_OF_TEN[NUM_POWERS_OF_TEN - 1],
+        "table needs to match"
+        );
+    static_assert(
+        POWERS_OF_TEN[NUM_UINT_POWERS_OF_TEN - 1] <= 0xFFFFFFFFu && POWERS_OF_TEN[NUM_UINT_POWERS_OF_TEN] > 0xFFFFFFFFu,
+        "the uint powers need to fit in a uint"
+        );
+    static_assert(
+        POWERS_OF_TEN[NUM_POWERS_OF_TEN - 1] > 0xFFFFFFFFFFFFFFFFull/10,
+        "table should have every power that fits"
+        );
+    static_assert(constant_power(3, 5) == 243, "odd exponents need the extra factor");
+
+    // NOTE:
+    // Exponentiation by squaring, so O(log(power)) multiplications instead of O(power).
+    // The base is only squared while there are exponent bits left, so it can't overflow
+    // unless the result does.
     inline int
     power(int x, int power)
     {
-        // TODO: intrinsics!
         int p = 1;
-        for(int i=0; i<power; i++)
+        while(power > 0)
         {
-            p *= x;
+            if(power & 1)
+                p *= x;
+            power >>= 1;
+            if(power > 0)
+                x *= x;
         }
         return p;
     }    
@@ -67,11 +144,14 @@ namespace Numerics
     inline int64
     power(int64 x, int64 power)
     {
-        // TODO: intrinsics!
         int64 p = 1;
-        for(int i=0; i<power; i++)
+        while(power > 0)
         {
-            p *= x;
+            if(power & 1)
+                p *= x;
+            power >>= 1;
+            if(power > 0)
+                x *= x;
         }
         return p;
     }
@@ -79,14 +159,43 @@ namespace Numerics
     inline uint
     power(uint x, uint power)
     {
-        // TODO: intrinsics!
+        // NOTE: the common grid bases are a lookup or a shift
+        if(x == 10 && power < NUM_UINT_POWERS_OF_TEN)
+            return uint(POWERS_OF_TEN[power]);
+        if(x == 2 && power < 32)
+            return 1u << power;
+
         uint p = 1;
-        for(uint i=0; i<power; i++)
+        while(power > 0)
         {
-            p *= x;
+            if(power & 1)
+                p *= x;
+            power >>= 1;
+            if(power > 0)
+                x *= x;
         }
         return p;
     }        
+
+    inline uint64
+    power(uint64 x, uint power)
+    {
+        if(x == 10 && power < NUM_POWERS_OF_TEN)
+            return POWERS_OF_TEN[power];
+        if(x == 2 && power < 64)
+            return 1ull << power;
+
+        uint64 p = 1;
+        while(power > 0)
+        {
+            if(power & 1)
+                p *= x;
+            power >>= 1;
+            if(power > 0)
+                x *= x;
+        }
+        return p;
+    }
     
     inline float
     sin(float x)
@@ -96,12 +205,24 @@ namespace Numerics
     }
 
 
+    inline double
+    sin(double x)
+    {
+        return ::sin(x);
+    }
+
     inline float
     cos(float x)
     {
         // TODO: intrinsics!
         return cosf(x);
     }
+
+    inline double
+    cos(double x)
+    {
+        return ::cos(x);
+    }
     
     inline float
     minimum(float x, float y)
@@ -113,6 +234,15 @@ namespace Numerics
             return y;
     }
 
+    inline double
+    minimum(double x, double y)
+    {
+        if( x < y )
+            return x;
+        else
+            return y;
+    }
+
     inline int
     minimum(int x, int y)
     {
@@ -133,6 +263,15 @@ namespace Numerics
             return y;
     }    
 
+    inline double
+    maximum(double x, double y)
+    {
+        if( x > y )
+            return x;
+        else
+            return y;
+    }
+
     inline int
     maximum(int x, int y)
     {
@@ -174,6 +313,12 @@ namespace Numerics
         return fabsf(x);
     }
 
+    inline double
+    absolute_value(double x)
+    {
+        return fabs(x);
+    }
+
     inline float
     sign(float x)
     {
@@ -1,6 +1,11 @@
 namespace Platform
 {
+#if defined(_WIN32)
     typedef LARGE_INTEGER TimeCount;
+#else
+    // NOTE: nanoseconds, see posix_platform.cpp
+    typedef uint64 TimeCount;
+#endif
     
     struct ReadFileResult
     {
@@ -36,6 +41,11 @@ namespace Platform
 
         ButtonState control;
         ButtonState quit;
+        ButtonState toggle_decibels;
+        ButtonState toggle_root_locus;
+        ButtonState clear_fit_target;
+        ButtonState toggle_log_frequency;
+        ButtonState toggle_contours;
         ButtonState mouse_left;
         ButtonState mouse_right;
         int mouse_wheel_delta;
@@ -59,6 +69,20 @@ namespace Platform
 {
     ReadFileResult read_file(char* file_name);
     void free_file_memory(void* address);
+    bool write_file(char* file_name, void const* contents, uint32 contents_size);
+    void* allocate_memory(size_t size);
+    void free_memory(void* address);
+};
+
+namespace Platform
+{
+    // NOTE: called once per task, possibly on another thread, possibly concurrently with other tasks
+    typedef void ParallelTaskCallback(void* data, uint task_idx);
+
+    // NOTE: runs all tasks on the worker threads (and the calling thread) and returns once all are done, any number of them.
+    // Tasks must not call parallel_for themselves, if one does its tasks just run one after the other on its thread.
+    void parallel_for(uint num_tasks, ParallelTaskCallback* callback, void* data);
+    uint num_worker_threads();
 };
 
 namespace Platform
@@ -68,5 +92,7 @@ namespace Platform
     void frame_start(FrameContext* ctx);
     void frame_end_sleep(FrameContext* ctx, float target_frame_duration);
     void get_input(InputContext* ctx, InputState* state);    
+    // NOTE: init_headless comes first, init then opens the window
+    bool init_headless();
     bool init(uint viewport_width_screen, uint viewport_height_screen, bool mouse_input_initially_enabled);
 };
@@ -0,0 +1,393 @@
+// NOTE:
+// Root finding for batches of real polynomials, using the Aberth-Ehrlich iteration
+// (the Durand-Kerner iteration with an extra correction term that gives cubic convergence).
+// Four polynomials of the same degree are iterated at once, one per SIMD lane,
+// and large batches are spread over the worker threads.
+namespace Polynomial
+{
+
+    uint const MAX_DEGREE = 8;
+
+    struct Settings
+    {
+        uint max_num_iterations;
+        // NOTE: a polynomial has converged once all its root corrections are smaller than this,
+        // relative to the root magnitudes (or absolute, for roots smaller than one)
+        float tolerance;
+    };
+
+    struct Statistics
+    {
+        uint num_polynomials;
+        uint num_converged;
+        uint num_iterations_total;
+        uint num_iterations_max;
+        // NOTE: the largest backward error |p(z)| / sum(|c_k||z|^k) of any root
+        float residual_max;
+    };
+
+    // NOTE:
+    // Four polynomials of the same degree, one per SIMD lane:
+    // p(z) = coefficients[0] + coefficients[1]*z + ... + coefficients[degree]*z^degree
+    struct Batch
+    {
+        float coefficients[MAX_DEGREE+1][Simd::NUM_LANES];
+        float roots_real[MAX_DEGREE][Simd::NUM_LANES];
+        float roots_imaginary[MAX_DEGREE][Simd::NUM_LANES];
+        uint num_iterations[Simd::NUM_LANES];
+        float residual[Simd::NUM_LANES];
+        bool converged[Simd::NUM_LANES];
+    };
+
+    inline Settings
+    default_settings()
+    {
+        Settings settings;
+        settings.max_num_iterations = 64;
+        settings.tolerance = 1.0E-6f;
+        return settings;
+    }
+
+    inline void
+    reset(Statistics *const stats)
+    {
+        stats->num_polynomials = 0;
+        stats->num_converged = 0;
+        stats->num_iterations_total = 0;
+        stats->num_iterations_max = 0;
+        stats->residual_max = 0.0f;
+    }
+
+    inline void
+    merge(Statistics const*const a, Statistics *const stats)
+    {
+        stats->num_polynomials += a->num_polynomials;
+        stats->num_converged += a->num_converged;
+        stats->num_iterations_total += a->num_iterations_total;
+        stats->num_iterations_max = (uint)Numerics::maximum((int)stats->num_iterations_max, (int)a->num_iterations_max);
+        stats->residual_max = Numerics::maximum(stats->residual_max, a->residual_max);
+    }
+
+    // NOTE: n/d, but with |d| clamped away from zero so that coinciding roots don't produce NaNs
+    inline Simd::Complex4
+    safe_quotient(Simd::Complex4 const n, Simd::Complex4 d)
+    {
+        using namespace Simd;
+        Float4 const tiny = set(1.0E-30f);
+        Float4 const degenerate = less_than(complex_magnitude_squared(d), tiny);
+        d.real = select(degenerate, set(1.0E-15f), d.real);
+        d.imaginary = select(degenerate, zero(), d.imaginary);
+        return complex_quotient(n, d);
+    }
+
+    // NOTE:
+    // Spreads the initial guesses on a circle around the centroid of the roots.
+    // The radius is half the Fujiwara bound on the root magnitudes, and the circle is rotated off the
+    // real axis, since guesses that are symmetric about the real axis stay symmetric for real polynomials.
+    void
+    initial_guess(uint const degree, Batch *const batch)
+    {
+        assert(degree >= 1);
+        assert(degree <= MAX_DEGREE);
+
+        for(uint lane_idx=0; lane_idx < Simd::NUM_LANES; lane_idx++)
+        {
+            float const leading = batch->coefficients[degree][lane_idx];
+            assert(leading != 0.0f);
+
+            float const center = -batch->coefficients[degree-1][lane_idx]/(float(degree)*leading);
+
+            float bound = 0.0f;
+            for(uint k=0; k < degree; k++)
+            {
+                float const c = Numerics::absolute_value(batch->coefficients[k][lane_idx]/leading);
+                float const r = Numerics::power(k == 0 ? c*0.5f : c, 1.0f/float(degree - k));
+                bound = Numerics::maximum(bound, r);
+            }
+            float const radius = Numerics::maximum(bound, 1.0E-3f);
+
+            for(uint root_idx=0; root_idx < degree; root_idx++)
+            {
+                float const angle = 2.0f*PI_FLOAT*float(root_idx)/float(degree) + 0.4f;
+                batch->roots_real[root_idx][lane_idx] = center + radius*Numerics::cos(angle);
+                batch->roots_imaginary[root_idx][lane_idx] = radius*Numerics::sin(angle);
+            }
+        }
+    }
+
+    // NOTE: evaluates p and its derivative at z, using Horner's scheme
+    inline void
+    evaluate(
+        uint const degree,
+        Simd::Float4 const*const c,
+        Simd::Complex4 const z,
+        Simd::Complex4 *const p,
+        Simd::Complex4 *const dp
+        )
+    {
+        using namespace Simd;
+        Complex4 value = complex(c[degree], zero());
+        Complex4 derivative = complex(zero(), zero());
+        for(int k=int(degree)-1; k >= 0; k--)
+        {
+            derivative = complex_add(complex_multiply(derivative, z), value);
+            value = complex_multiply(value, z);
+            value.real = add(value.real, c[k]);
+        }
+        *p = value;
+        *dp = derivative;
+    }
+
+    // NOTE:
+    // Iterates on the roots of the batch, starting from whatever is in roots_real/roots_imaginary,
+    // so the caller either calls initial_guess first or warm starts from the roots of a nearby polynomial.
+    void
+    iterate(uint const degree, Settings const*const settings, Batch *const batch)
+    {
+        using namespace Simd;
+
+        assert(degree >= 1);
+        assert(degree <= MAX_DEGREE);
+
+        Float4 c[MAX_DEGREE+1];
+        for(uint k=0; k <= degree; k++)
+        {
+            c[k] = load(batch->coefficients[k]);
+        }
+
+        Complex4 z[MAX_DEGREE];
+        for(uint i=0; i < degree; i++)
+        {
+            z[i] = complex(load(batch->roots_real[i]), load(batch->roots_imaginary[i]));
+        }
+
+        for(uint lane_idx=0; lane_idx < NUM_LANES; lane_idx++)
+        {
+            batch->num_iterations[lane_idx] = 0;
+        }
+
+        Float4 const one = set(1.0f);
+        Float4 const tolerance_sq = set(settings->tolerance*settings->tolerance);
+        Float4 active = less_than(zero(), one);
+
+        for(uint iteration_idx=0; iteration_idx < settings->max_num_iterations; iteration_idx++)
+        {
+
+            Float4 correction_max_sq = zero();
+
+            for(uint i=0; i < degree; i++)
+            {
+                Complex4 p;
+                Complex4 dp;
+                evaluate(degree, c, z[i], &p, &dp);
+                Complex4 const newton = safe_quotient(p, dp);
+
+                Complex4 repulsion = complex(zero(), zero());
+                for(uint j=0; j < degree; j++)
+                {
+                    if(j == i)
+                        continue;
+                    repulsion = complex_add(repulsion, safe_quotient(complex(one, zero()), complex_subtract(z[i], z[j])));
+                }
+
+                Complex4 const denominator = complex_subtract(complex(one, zero()), complex_multiply(newton, repulsion));
+                Complex4 w = safe_quotient(newton, denominator);
+
+                // NOTE: NaN is the only value that doesn't compare equal to itself
+                Float4 const finite =
+                    mask_and(_mm_cmpeq_ps(w.real, w.real), _mm_cmpeq_ps(w.imaginary, w.imaginary));
+                w = complex_select(mask_and(active, finite), w, complex(zero(), zero()));
+
+                z[i] = complex_subtract(z[i], w);
+
+                Float4 const scale_sq = maximum(one, complex_magnitude_squared(z[i]));
+                correction_max_sq = maximum(correction_max_sq, divide(complex_magnitude_squared(w), scale_sq));
+            }
+
+            {
+                int const active_lanes = _mm_movemask_ps(active);
+                for(uint lane_idx=0; lane_idx < NUM_LANES; lane_idx++)
+                {
+                    if(active_lanes & (1 << lane_idx))
+                        batch->num_iterations[lane_idx]++;
+                }
+            }
+
+            active = mask_and(active, mask_not(less_than(correction_max_sq, tolerance_sq)));
+            if(!any(active))
+                break;
+        }
+
+        // NOTE: backward error of each root
+        Float4 residual_max = zero();
+        for(uint i=0; i < degree; i++)
+        {
+            Complex4 p;
+            Complex4 dp;
+            evaluate(degree, c, z[i], &p, &dp);
+
+            Float4 const z_magnitude = square_root(complex_magnitude_squared(z[i]));
+            Float4 scale = absolute_value(c[degree]);
+            for(int k=int(degree)-1; k >= 0; k--)
+            {
+                scale = add(multiply(scale, z_magnitude), absolute_value(c[k]));
+            }
+            Float4 const residual = divide(square_root(complex_magnitude_squared(p)), maximum(scale, set(1.0E-30f)));
+            residual_max = maximum(residual_max, residual);
+
+            store(z[i].real, batch->roots_real[i]);
+            store(z[i].imaginary, batch->roots_imaginary[i]);
+        }
+        store(residual_max, batch->residual);
+
+        {
+            int const active_lanes = _mm_movemask_ps(active);
+            for(uint lane_idx=0; lane_idx < NUM_LANES; lane_idx++)
+            {
+                batch->converged[lane_idx] = (active_lanes & (1 << lane_idx)) == 0;
+            }
+        }
+
+    }
+
+    void
+    accumulate_statistics(Batch const*const batch, uint const num_valid_lanes, Statistics *const stats)
+    {
+        assert(num_valid_lanes <= Simd::NUM_LANES);
+        for(uint lane_idx=0; lane_idx < num_valid_lanes; lane_idx++)
+        {
+            stats->num_polynomials++;
+            if(batch->converged[lane_idx])
+                stats->num_converged++;
+            stats->num_iterations_total += batch->num_iterations[lane_idx];
+            stats->num_iterations_max =
+                (uint)Numerics::maximum((int)stats->num_iterations_max, (int)batch->num_iterations[lane_idx]);
+            stats->residual_max = Numerics::maximum(stats->residual_max, batch->residual[lane_idx]);
+        }
+    }
+
+    // NOTE:
+    // Many polynomials of the same degree, stored one after the other:
+    // coefficients has num_polynomials*(degree+1) entries, lowest power first,
+    // roots_real and roots_imaginary have num_polynomials*degree entries.
+    struct Job
+    {
+        uint degree;
+        uint num_polynomials;
+        float const* coefficients;
+        float* roots_real;
+        float* roots_imaginary;
+        bool warm_start;
+        Settings settings;
+        uint num_polynomials_per_task;
+        Statistics* task_statistics;
+    };
+
+    void
+    find_roots_task(void* data, uint task_idx)
+    {
+        Job const*const job = (Job*)data;
+        uint const degree = job->degree;
+        uint const first_idx = task_idx*job->num_polynomials_per_task;
+        uint const end_idx =
+            (uint)Numerics::minimum(int(first_idx + job->num_polynomials_per_task), int(job->num_polynomials));
+
+        Statistics *const stats = &job->task_statistics[task_idx];
+        reset(stats);
+
+        for(uint batch_first_idx = first_idx; batch_first_idx < end_idx; batch_first_idx += Simd::NUM_LANES)
+        {
+            uint const num_valid_lanes = (uint)Numerics::minimum(int(Simd::NUM_LANES), int(end_idx - batch_first_idx));
+
+            // NOTE: unused lanes repeat the last polynomial, so that they converge along with it
+            Batch batch;
+            for(uint lane_idx=0; lane_idx < Simd::NUM_LANES; lane_idx++)
+            {
+                uint const polynomial_idx = batch_first_idx + (uint)Numerics::minimum(int(lane_idx), int(num_valid_lanes) - 1);
+                for(uint k=0; k <= degree; k++)
+                {
+                    batch.coefficients[k][lane_idx] = job->coefficients[polynomial_idx*(degree+1) + k];
+                }
+                if(job->warm_start)
+                {
+                    for(uint i=0; i < degree; i++)
+                    {
+                        batch.roots_real[i][lane_idx] = job->roots_real[polynomial_idx*degree + i];
+                        batch.roots_imaginary[i][lane_idx] = job->roots_imaginary[polynomial_idx*degree + i];
+                    }
+                }
+            }
+
+            if(!job->warm_start)
+            {
+                initial_guess(degree, &batch);
+            }
+
+            iterate(degree, &job->settings, &batch);
+            accumulate_statistics(&batch, num_valid_lanes, stats);
+
+            for(uint lane_idx=0; lane_idx < num_valid_lanes; lane_idx++)
+            {
+                uint const polynomial_idx = batch_first_idx + lane_idx;
+                for(uint i=0; i < degree; i++)
+                {
+                    job->roots_real[polynomial_idx*degree + i] = batch.roots_real[i][lane_idx];
+                    job->roots_imaginary[polynomial_idx*degree + i] = batch.roots_imaginary[i][lane_idx];
+                }
+            }
+        }
+    }
+
+    // NOTE:
+    // Finds the roots of num_polynomials polynomials of the same degree, see Job for the memory layout.
+    // The leading coefficients must be non-zero.
+    // If warm_start is set, the iteration starts from the roots that are passed in.
+    void
+    find_roots(
+        uint const degree,
+        uint const num_polynomials,
+        float const*const coefficients,
+        Settings const*const settings,
+        bool const warm_start,
+        float *const roots_real,
+        float *const roots_imaginary,
+        Statistics *const stats
+        )
+    {
+        uint const max_num_tasks = 256;
+        // NOTE: small enough to balance the load, large enough to amortize the task overhead
+        uint const min_num_polynomials_per_task = 16*Simd::NUM_LANES;
+
+        Statistics task_statistics[max_num_tasks];
+
+        Job job;
+        job.degree = degree;
+        job.num_polynomials = num_polynomials;
+        job.coefficients = coefficients;
+        job.roots_real = roots_real;
+        job.roots_imaginary = roots_imaginary;
+        job.warm_start = warm_start;
+        job.settings = *settings;
+        job.task_statistics = task_statistics;
+
+        uint num_tasks = (num_polynomials + min_num_polynomials_per_task - 1)/min_num_polynomials_per_task;
+        num_tasks = (uint)Numerics::clamp(1, int(max_num_tasks), int(num_tasks));
+        job.num_polynomials_per_task = (num_polynomials + num_tasks - 1)/num_tasks;
+
+        if(num_tasks == 1)
+        {
+            find_roots_task(&job, 0);
+        }
+        else
+        {
+            Platform::parallel_for(num_tasks, find_roots_task, &job);
+        }
+
+        reset(stats);
+        for(uint task_idx=0; task_idx < num_tasks; task_idx++)
+        {
+            merge(&task_statistics[task_idx], stats);
+        }
+    }
+
+}
@@ -0,0 +1,362 @@
+// NOTE:
+// What the command line modes need of the platform, on top of POSIX, so they build with g++ or clang away from
+// Windows, see iir4_headless.cpp. There's no window, and no input, just memory, files, time, logging and threads.
+
+// NOTE: the file names of the command line are at most this long
+#define MAX_PATH PATH_MAX
+
+namespace Platform
+{
+    inline void
+    log_string(char const*const msg)
+    {
+        fputs(msg, stdout);
+        fflush(stdout);
+    }
+
+    inline void log_line(void)
+    {
+        log_string("\n");
+    }
+    
+    inline void
+    log_line_string(char const*const msg)
+    {
+        log_string(msg);
+        log_string("\n");
+    }
+
+    void
+    log_uint32(int const n)
+    {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u", (uint32)n);
+        log_string(buffer);
+    }
+
+    void
+    log_int(int const n)
+    {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%d", n);
+        log_string(buffer);
+    }
+
+    void
+    log_float32(float const x)
+    {
+        // NOTE: the largest float written out with %f is 39 integer digits, a sign, a point and 6 decimals
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%f", x);
+        log_string(buffer);
+    }
+
+    inline void
+    log_float(float x)
+    {
+        log_float32(x);
+    }
+    
+};
+
+namespace Platform
+{
+
+    void free_file_memory(void* address)
+    {
+        free(address);
+    }
+
+    // NOTE: caller gets to free the file using free_file_memory
+    ReadFileResult read_file(char* file_name)
+    {
+        Platform::ReadFileResult result = {};
+
+        FILE *const file = fopen(file_name, "rb");
+        if(file == 0)
+            return result;
+
+        // NOTE: to simplify things, we require that the file be less than 4 Gb in size.
+        uint32 file_size = 0;
+        {
+            struct stat file_status;
+            if(fstat(fileno(file), &file_status) != 0)
+            {
+                Platform::log_line_string("failed to get file size");
+                fclose(file);
+                return result;
+            }
+            else if(uint64(file_status.st_size) >= UINT32_MAX)
+            {
+                Platform::log_line_string("file size is too large");
+                fclose(file);
+                return result;
+            }
+            file_size = (uint32)file_status.st_size;
+        }
+
+        // NOTE: at least one byte, so an empty file still reads as a file
+        result.contents = malloc(file_size > 0 ? file_size : 1);
+        if(result.contents == 0)
+        {
+            Platform::log_line_string("not enough memory");
+            fclose(file);
+            return result;
+        }
+        result.contents_size = file_size;
+
+        if(fread(result.contents, 1, file_size, file) != file_size)
+        {
+            Platform::log_line_string("reading file failed");
+            free_file_memory(result.contents);
+            result.contents = 0;
+            result.contents_size = 0;
+        }
+
+        fclose(file);
+        return result;
+    }
+
+    // NOTE: replaces the file if it exists
+    bool write_file(char* file_name, void const* contents, uint32 contents_size)
+    {
+        FILE *const file = fopen(file_name, "wb");
+        if(file == 0)
+        {
+            Platform::log_string("failed to create file ");
+            Platform::log_line_string(file_name);
+            return false;
+        }
+
+        bool written = true;
+        if(fwrite(contents, 1, contents_size, file) != contents_size)
+        {
+            Platform::log_line_string("writing file failed");
+            written = false;
+        }
+        if(fclose(file) != 0)
+        {
+            Platform::log_line_string("closing file failed");
+            written = false;
+        }
+
+        return written;
+    }
+
+    // NOTE: caller gets to free the memory using free_memory, memory is zero initialized
+    void* allocate_memory(size_t size)
+    {
+        void *const memory = calloc(1, size);
+        if(memory == 0)
+        {
+            Platform::log_line_string("not enough memory");
+        }
+        return memory;
+    }
+
+    void free_memory(void* address)
+    {
+        free(address);
+    }
+
+};
+
+#define WORK_QUEUE_MAX_NUM_THREADS 16
+
+// NOTE:
+// One parallel_for at a time, its tasks are handed out one index after the other under the mutex. The tasks are
+// coarse (a plot, a band of rows), so the lock is cheap next to them.
+struct WorkQueue
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t work_available;
+    pthread_cond_t work_done;
+    Platform::ParallelTaskCallback* callback;
+    void* data;
+    uint num_tasks;
+    uint next_task_idx;
+    uint num_completed_tasks;
+    // NOTE: set while a parallel_for has tasks in the queue
+    bool busy;
+    uint num_threads;
+};
+
+static WorkQueue g_work_queue;
+static bool g_work_queue_initialized = false;
+
+void*
+work_queue_thread_procedure(void* parameter)
+{
+    WorkQueue *const queue = (WorkQueue*)parameter;
+    pthread_mutex_lock(&queue->mutex);
+    while(true)
+    {
+        while(queue->next_task_idx == queue->num_tasks)
+        {
+            pthread_cond_wait(&queue->work_available, &queue->mutex);
+        }
+
+        uint const task_idx = queue->next_task_idx++;
+        Platform::ParallelTaskCallback *const callback = queue->callback;
+        void *const data = queue->data;
+        pthread_mutex_unlock(&queue->mutex);
+
+        callback(data, task_idx);
+
+        pthread_mutex_lock(&queue->mutex);
+        queue->num_completed_tasks++;
+        if(queue->num_completed_tasks == queue->num_tasks)
+        {
+            pthread_cond_signal(&queue->work_done);
+        }
+    }
+    return 0;
+}
+
+bool
+work_queue_initialize(WorkQueue *const queue)
+{
+    // NOTE: the calling thread works too, so leave one processor for it
+    long const num_processors = sysconf(_SC_NPROCESSORS_ONLN);
+    uint const num_threads =
+        num_processors > 1 ? (uint)Numerics::minimum(int(num_processors) - 1, WORK_QUEUE_MAX_NUM_THREADS) : 0;
+
+    queue->callback = 0;
+    queue->data = 0;
+    queue->num_tasks = 0;
+    queue->next_task_idx = 0;
+    queue->num_completed_tasks = 0;
+    queue->busy = false;
+    queue->num_threads = 0;
+
+    if(
+        pthread_mutex_init(&queue->mutex, 0) != 0 ||
+        pthread_cond_init(&queue->work_available, 0) != 0 ||
+        pthread_cond_init(&queue->work_done, 0) != 0
+        )
+    {
+        Platform::log_line_string("failed to create the work queue mutex");
+        return false;
+    }
+
+    for(uint thread_idx=0; thread_idx < num_threads; thread_idx++)
+    {
+        pthread_t thread;
+        if(pthread_create(&thread, 0, work_queue_thread_procedure, queue) != 0)
+        {
+            // NOTE: not fatal, the calling thread will simply do more of the work
+            Platform::log_line_string("failed to create a worker thread");
+            break;
+        }
+        pthread_detach(thread);
+        queue->num_threads++;
+    }
+
+    return true;
+}
+
+namespace Platform
+{
+
+    // NOTE:
+    // A task must not call parallel_for, the queue only tracks one call at a time. If one does anyway, or the queue is
+    // in use for any other reason, the tasks of the second call are simply run one after the other on its thread.
+    void
+    parallel_for(uint num_tasks, ParallelTaskCallback* callback, void* data)
+    {
+
+        WorkQueue *const queue = &g_work_queue;
+        if(!g_work_queue_initialized)
+        {
+            g_work_queue_initialized = work_queue_initialize(queue);
+        }
+
+        bool acquired = false;
+        if(g_work_queue_initialized && queue->num_threads > 0)
+        {
+            pthread_mutex_lock(&queue->mutex);
+            acquired = !queue->busy;
+            queue->busy = true;
+            if(!acquired)
+            {
+                pthread_mutex_unlock(&queue->mutex);
+            }
+        }
+        if(!acquired)
+        {
+            for(uint task_idx=0; task_idx < num_tasks; task_idx++)
+            {
+                callback(data, task_idx);
+            }
+            return;
+        }
+
+        queue->callback = callback;
+        queue->data = data;
+        queue->num_tasks = num_tasks;
+        queue->next_task_idx = 0;
+        queue->num_completed_tasks = 0;
+        pthread_cond_broadcast(&queue->work_available);
+
+        while(queue->next_task_idx < queue->num_tasks)
+        {
+            uint const task_idx = queue->next_task_idx++;
+            pthread_mutex_unlock(&queue->mutex);
+            callback(data, task_idx);
+            pthread_mutex_lock(&queue->mutex);
+            queue->num_completed_tasks++;
+        }
+        while(queue->num_completed_tasks < queue->num_tasks)
+        {
+            pthread_cond_wait(&queue->work_done, &queue->mutex);
+        }
+
+        queue->num_tasks = 0;
+        queue->next_task_idx = 0;
+        queue->busy = false;
+        pthread_mutex_unlock(&queue->mutex);
+
+    }
+
+    uint
+    num_worker_threads()
+    {
+        if(!g_work_queue_initialized)
+        {
+            g_work_queue_initialized = work_queue_initialize(&g_work_queue);
+        }
+        return g_work_queue.num_threads;
+    }
+
+};
+
+namespace Platform
+{
+
+    inline float
+    time_duration_seconds(TimeCount start, TimeCount end)
+    {
+        return (float)(end - start)*1.0e-9f;
+    }    
+
+    inline TimeCount
+    time_get_count()
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (TimeCount)now.tv_sec*1000000000ull + (TimeCount)now.tv_nsec;
+    }
+
+    // NOTE: there is no window here, this is all there is to initialize
+    bool init_headless()
+    {
+        if(!g_work_queue_initialized)
+        {
+            // NOTE: not fatal, parallel_for then runs the tasks on the calling thread
+            g_work_queue_initialized = work_queue_initialize(&g_work_queue);
+        }
+
+        return true;
+    }
+
+};
@@ -0,0 +1,1079 @@
+// NOTE:
+// A frame recorded as a list of draw packets, rather than drawn with calls straight into D3D11.
+// Every packet names the whole state it is drawn with: a pipeline (shaders, input layout and topology), a scissor
+// rectangle, the constants its pipeline reads and a vertex buffer. Its sort key puts the layers of the frame in order,
+// and within a layer groups the packets by pipeline, then constants and then scissor rectangle. The pipelines are
+// numbered in the order they have to be drawn in where they overlap, so a layer only has to end where a pipeline is
+// drawn both under and over another one.
+// The list is executed by D3D11 (see render_commands_d3d11.cpp) or by SoftwareRender, and both go through the same
+// filter, which only sets the state a packet needs that isn't set already, and counts the state it sets and skips.
+namespace RenderCommands
+{
+
+    // NOTE: the order they are drawn in, the widgets don't overlap so each is drawn whole before the next
+    enum Layer
+    {
+        TopWidgetLayer,
+        BottomWidgetLayer,
+        PlotLayer,
+        NumLayers
+    };
+
+    // NOTE: in the order they have to be drawn in where they overlap
+    enum Pipeline
+    {
+        DensityCircle,
+        DomainColoringCircle,
+        ContourLines,
+        MarkerShapes,
+        LocusLines,
+        GridLines,
+        GlyphQuads,
+        MagnitudeColorbar,
+        PhaseColorbar,
+        CurveLines,
+        NumPipelines
+    };
+
+    enum VertexShader
+    {
+        CircleVertexShader,
+        MarkerVertexShader,
+        ContourVertexShader,
+        LocusVertexShader,
+        GridVertexShader,
+        GlyphVertexShader,
+        ColorbarVertexShader,
+        PlotVertexShader,
+        NumVertexShaders
+    };
+
+    enum PixelShader
+    {
+        DensityPixelShader,
+        DomainColoringPixelShader,
+        SolidPixelShader,
+        GlyphPixelShader,
+        ColorbarMagnitudePixelShader,
+        ColorbarColorwheelPixelShader,
+        NumPixelShaders
+    };
+
+    enum InputLayout
+    {
+        NoInputLayout,
+        CircleInputLayout,
+        ShapeInputLayout,
+        CurveInputLayout,
+        NumInputLayouts
+    };
+
+    enum Topology
+    {
+        TriangleList,
+        TriangleStrip,
+        LineList,
+        LineStrip,
+        NumTopologies
+    };
+
+    // NOTE: the constants a pipeline reads besides the parameters, which every widget pipeline reads
+    enum ConstantBuffer
+    {
+        NoConstantBuffer,
+        LayoutConstantBuffer,
+        PlotConstantBuffer,
+        GridConstantBuffer,
+        NumConstantBuffers
+    };
+
+    // NOTE:
+    // The transient buffer holds the vertices recorded with the list, the contour and locus buffers keep theirs
+    // from frame to frame, and the glyph instances are the glyph batch of the list.
+    enum VertexBuffer
+    {
+        NoVertexBuffer,
+        CircleVertexBuffer,
+        MarkerVertexBuffer,
+        ContourVertexBuffer,
+        LocusVertexBuffer,
+        TransientVertexBuffer,
+        GlyphInstanceBuffer,
+        NumVertexBuffers
+    };
+
+    struct PipelineDescription
+    {
+        VertexShader vertex_shader;
+        PixelShader pixel_shader;
+        InputLayout input_layout;
+        Topology topology;
+        ConstantBuffer constant_buffer;
+        bool indexed;
+    };
+
+    PipelineDescription const PIPELINES[NumPipelines] =
+        {
+            {CircleVertexShader, DensityPixelShader, CircleInputLayout, TriangleList, LayoutConstantBuffer, true},
+            {CircleVertexShader, DomainColoringPixelShader, CircleInputLayout, TriangleList, LayoutConstantBuffer, true},
+            {ContourVertexShader, SolidPixelShader, ShapeInputLayout, LineStrip, LayoutConstantBuffer, false},
+            {MarkerVertexShader, SolidPixelShader, ShapeInputLayout, TriangleList, LayoutConstantBuffer, true},
+            {LocusVertexShader, SolidPixelShader, ShapeInputLayout, LineStrip, LayoutConstantBuffer, false},
+            {GridVertexShader, SolidPixelShader, NoInputLayout, LineList, GridConstantBuffer, false},
+            {GlyphVertexShader, GlyphPixelShader, NoInputLayout, TriangleStrip, NoConstantBuffer, false},
+            {ColorbarVertexShader, ColorbarMagnitudePixelShader, NoInputLayout, TriangleStrip, PlotConstantBuffer, false},
+            {ColorbarVertexShader, ColorbarColorwheelPixelShader, NoInputLayout, TriangleStrip, PlotConstantBuffer, false},
+            {PlotVertexShader, SolidPixelShader, CurveInputLayout, LineStrip, PlotConstantBuffer, false},
+        };
+
+    uint const VERTEX_STRIDES[NumVertexBuffers] =
+        {
+            0,
+            sizeof(WidgetVertex),
+            sizeof(ShapeVertex),
+            sizeof(ShapeVertex),
+            sizeof(ShapeVertex),
+            sizeof(float),
+            0,
+        };
+
+    uint const MAX_NUM_PACKETS = 1 << 14;
+    uint const MAX_NUM_SCISSORS = 256;
+    uint const MAX_NUM_LAYOUTS = 16;
+    uint const MAX_NUM_PLOTS = 256;
+    uint const MAX_NUM_GRID_LINES = 256;
+    uint const MAX_NUM_TRANSIENT_FLOATS = 1 << 16;
+    uint const NO_IDX = 0xffffffff;
+
+    struct Packet
+    {
+        uint64 sort_key;
+        uint8 pipeline;
+        uint8 vertex_buffer;
+        uint16 scissor_idx;
+        // NOTE: into the constants of the pipeline's constant buffer
+        uint32 constants_idx;
+        // NOTE: in bytes, where the vertex buffer is bound from
+        uint32 vertex_offset;
+        // NOTE: the first index of an indexed pipeline, and the index count
+        uint32 first_vertex;
+        uint32 num_vertices;
+        // NOTE: zero when the draw isn't instanced
+        uint32 num_instances;
+    };
+
+    // NOTE: like a D3D11_RECT, in pixels from the top left corner, right and bottom are one past the last pixel
+    struct Scissor
+    {
+        int left;
+        int top;
+        int right;
+        int bottom;
+    };
+
+    struct GridLinesConstants
+    {
+        Grid::GridLinesContext context;
+        uint8 const* emphasis;
+    };
+
+    // NOTE: the vertices behind a vertex buffer, the executor uploads them before drawing if they changed
+    struct VertexData
+    {
+        void const* data;
+        uint num_bytes;
+        bool changed;
+    };
+
+    struct CommandList
+    {
+        Packet* packets;
+        uint num_packets;
+        // NOTE: the packets in the order of their sort keys, filled by sort
+        uint32* order;
+        uint32* order_scratch;
+        bool sorted;
+        Scissor scissors[MAX_NUM_SCISSORS];
+        uint num_scissors;
+        WidgetLayoutConstants layouts[MAX_NUM_LAYOUTS];
+        uint num_layouts;
+        PlotConstants plots[MAX_NUM_PLOTS];
+        uint num_plots;
+        GridLinesConstants grid_lines[MAX_NUM_GRID_LINES];
+        uint num_grid_lines;
+        float* transient_vertices;
+        uint num_transient_floats;
+        VertexData vertex_data[NumVertexBuffers];
+        Grid::GlyphBatch::Batch const* glyph_batch;
+        // NOTE: what every widget pipeline reads
+        Parameters parameters;
+        float normalization_factor;
+        float clear_color[4];
+        uint num_dropped_packets;
+    };
+
+    struct Statistics
+    {
+        uint num_packets;
+        uint num_draws;
+        // NOTE: the state set between the draws, and the state a packet needed that was already set
+        uint num_state_changes;
+        uint num_redundant_state_changes;
+        uint num_uploads;
+        uint num_dropped_packets;
+    };
+
+    bool
+    initialize(CommandList *const list)
+    {
+        list->packets = (Packet*)Platform::allocate_memory(sizeof(Packet)*MAX_NUM_PACKETS);
+        list->order = (uint32*)Platform::allocate_memory(sizeof(uint32)*2*MAX_NUM_PACKETS);
+        list->transient_vertices = (float*)Platform::allocate_memory(sizeof(float)*MAX_NUM_TRANSIENT_FLOATS);
+        if(list->packets == 0 || list->order == 0 || list->transient_vertices == 0)
+        {
+            Platform::log_line_string("failed to allocate the render command list");
+            if(list->packets != 0)
+            {
+                Platform::free_memory(list->packets);
+            }
+            if(list->order != 0)
+            {
+                Platform::free_memory(list->order);
+            }
+            if(list->transient_vertices != 0)
+            {
+                Platform::free_memory(list->transient_vertices);
+            }
+            list->packets = 0;
+            list->order = 0;
+            list->transient_vertices = 0;
+            return false;
+        }
+        list->order_scratch = list->order + MAX_NUM_PACKETS;
+        list->num_packets = 0;
+        list->sorted = false;
+        return true;
+    }
+
+    void
+    release(CommandList *const list)
+    {
+        Platform::free_memory(list->packets);
+        Platform::free_memory(list->order);
+        Platform::free_memory(list->transient_vertices);
+        list->packets = 0;
+        list->order = 0;
+        list->order_scratch = 0;
+        list->transient_vertices = 0;
+    }
+
+    // NOTE: starts recording a new frame, the parameters are the ones every widget pipeline reads
+    void
+    begin(
+        Parameters const*const parameters,
+        float const normalization_factor,
+        float const clear_color[4],
+        CommandList *const list
+        )
+    {
+        list->num_packets = 0;
+        list->sorted = false;
+        list->num_scissors = 0;
+        list->num_layouts = 0;
+        list->num_plots = 0;
+        list->num_grid_lines = 0;
+        list->num_transient_floats = 0;
+        for(uint buffer_idx=0; buffer_idx < NumVertexBuffers; buffer_idx++)
+        {
+            list->vertex_data[buffer_idx].data = 0;
+            list->vertex_data[buffer_idx].num_bytes = 0;
+            list->vertex_data[buffer_idx].changed = false;
+        }
+        list->vertex_data[TransientVertexBuffer].data = list->transient_vertices;
+        list->glyph_batch = 0;
+        list->parameters = *parameters;
+        list->normalization_factor = normalization_factor;
+        memcpy(list->clear_color, clear_color, sizeof(list->clear_color));
+        list->num_dropped_packets = 0;
+    }
+
+    // NOTE: returns the index of the scissor rectangle, the same rectangle always gets the same index
+    uint
+    scissor(int const left, int const top, int const right, int const bottom, CommandList *const list)
+    {
+        for(uint scissor_idx=0; scissor_idx < list->num_scissors; scissor_idx++)
+        {
+            Scissor const*const s = &list->scissors[scissor_idx];
+            if(s->left == left && s->top == top && s->right == right && s->bottom == bottom)
+                return scissor_idx;
+        }
+        if(list->num_scissors == MAX_NUM_SCISSORS)
+            return NO_IDX;
+        Scissor *const s = &list->scissors[list->num_scissors];
+        s->left = left;
+        s->top = top;
+        s->right = right;
+        s->bottom = bottom;
+        return list->num_scissors++;
+    }
+
+    uint
+    widget_layout(WidgetLayoutConstants const*const layout, CommandList *const list)
+    {
+        if(list->num_layouts == MAX_NUM_LAYOUTS)
+            return NO_IDX;
+        list->layouts[list->num_layouts] = *layout;
+        return list->num_layouts++;
+    }
+
+    uint
+    plot(PlotConstants const*const constants, CommandList *const list)
+    {
+        if(list->num_plots == MAX_NUM_PLOTS)
+            return NO_IDX;
+        list->plots[list->num_plots] = *constants;
+        return list->num_plots++;
+    }
+
+    // NOTE: the emphasis has to stay as it is until the list has been executed
+    uint
+    grid_lines(Grid::GridLinesContext const*const context, uint8 const*const emphasis, CommandList *const list)
+    {
+        if(list->num_grid_lines == MAX_NUM_GRID_LINES)
+            return NO_IDX;
+        list->grid_lines[list->num_grid_lines].context = *context;
+        list->grid_lines[list->num_grid_lines].emphasis = emphasis;
+        return list->num_grid_lines++;
+    }
+
+    // NOTE:
+    // Room for num_floats floats of the transient vertex buffer, and where they are bound from in offset.
+    // Returns 0 if the buffer is full.
+    float*
+    transient_vertices(uint const num_floats, CommandList *const list, uint *const offset)
+    {
+        if(list->num_transient_floats + num_floats > MAX_NUM_TRANSIENT_FLOATS)
+            return 0;
+        float *const vertices = &list->transient_vertices[list->num_transient_floats];
+        *offset = uint(sizeof(float))*list->num_transient_floats;
+        list->num_transient_floats += num_floats;
+        list->vertex_data[TransientVertexBuffer].num_bytes = uint(sizeof(float))*list->num_transient_floats;
+        list->vertex_data[TransientVertexBuffer].changed = true;
+        return vertices;
+    }
+
+    // NOTE: the vertices have to stay as they are until the list has been executed
+    void
+    set_vertex_data(
+        VertexBuffer const buffer,
+        void const*const data,
+        uint const num_bytes,
+        bool const changed,
+        CommandList *const list
+        )
+    {
+        assert(buffer != TransientVertexBuffer && buffer != GlyphInstanceBuffer);
+        list->vertex_data[buffer].data = data;
+        list->vertex_data[buffer].num_bytes = num_bytes;
+        list->vertex_data[buffer].changed = changed;
+    }
+
+    // NOTE: the batch has to stay as it is until the list has been executed
+    void
+    set_glyph_batch(Grid::GlyphBatch::Batch const*const batch, CommandList *const list)
+    {
+        list->glyph_batch = batch;
+        list->vertex_data[GlyphInstanceBuffer].data = batch;
+        list->vertex_data[GlyphInstanceBuffer].num_bytes = uint(sizeof(Grid::GlyphBatch::GlyphInstance))*batch->num_glyphs;
+        list->vertex_data[GlyphInstanceBuffer].changed = true;
+    }
+
+    // NOTE: layer, pipeline, constants, scissor rectangle, and the order the packets were recorded in
+    inline uint64
+    sort_key(
+        Layer const layer,
+        Pipeline const pipeline,
+        uint const constants_idx,
+        uint const scissor_idx,
+        uint const packet_idx
+        )
+    {
+        assert(constants_idx < (1u << 16) && scissor_idx < (1u << 8) && packet_idx < (1u << 24));
+        return
+            (uint64(layer) << 56) |
+            (uint64(pipeline) << 48) |
+            (uint64(constants_idx) << 32) |
+            (uint64(scissor_idx) << 24) |
+            uint64(packet_idx);
+    }
+
+    // NOTE: a packet that references anything the list had no room for is dropped
+    void
+    draw(
+        Layer const layer,
+        Pipeline const pipeline,
+        uint const constants_idx,
+        uint const scissor_idx,
+        VertexBuffer const vertex_buffer,
+        uint const vertex_offset,
+        uint const first_vertex,
+        uint const num_vertices,
+        uint const num_instances,
+        CommandList *const list
+        )
+    {
+        bool const needs_constants = PIPELINES[pipeline].constant_buffer != NoConstantBuffer;
+        if(list->num_packets == MAX_NUM_PACKETS || scissor_idx == NO_IDX || (needs_constants && constants_idx == NO_IDX))
+        {
+            list->num_dropped_packets++;
+            return;
+        }
+        uint const packet_idx = list->num_packets++;
+        Packet *const packet = &list->packets[packet_idx];
+        uint const key_constants_idx = needs_constants ? constants_idx : 0;
+        packet->sort_key = sort_key(layer, pipeline, key_constants_idx, scissor_idx, packet_idx);
+        packet->pipeline = uint8(pipeline);
+        packet->vertex_buffer = uint8(vertex_buffer);
+        packet->scissor_idx = uint16(scissor_idx);
+        packet->constants_idx = key_constants_idx;
+        packet->vertex_offset = vertex_offset;
+        packet->first_vertex = first_vertex;
+        packet->num_vertices = num_vertices;
+        packet->num_instances = num_instances;
+        list->sorted = false;
+    }
+
+    // NOTE:
+    // Orders the packets by their sort keys, a byte at a time from the lowest, keeping the order of equal bytes.
+    // A byte that is the same in every key is skipped, which are most of them for a frame.
+    void
+    sort(CommandList *const list)
+    {
+        uint const num_packets = list->num_packets;
+        uint32* order = list->order;
+        uint32* scratch = list->order_scratch;
+        for(uint packet_idx=0; packet_idx < num_packets; packet_idx++)
+        {
+            order[packet_idx] = packet_idx;
+        }
+
+        for(uint byte_idx=0; byte_idx < 8 && num_packets > 1; byte_idx++)
+        {
+            uint const shift = 8*byte_idx;
+            uint counts[256] = {};
+            for(uint idx=0; idx < num_packets; idx++)
+            {
+                counts[uint(list->packets[order[idx]].sort_key >> shift) & 0xff]++;
+            }
+            if(counts[uint(list->packets[order[0]].sort_key >> shift) & 0xff] == num_packets)
+                continue;
+
+            uint starts[256];
+            uint start = 0;
+            for(uint value=0; value < 256; value++)
+            {
+                starts[value] = start;
+                start += counts[value];
+            }
+            for(uint idx=0; idx < num_packets; idx++)
+            {
+                uint const value = uint(list->packets[order[idx]].sort_key >> shift) & 0xff;
+                scratch[starts[value]++] = order[idx];
+            }
+            uint32 *const swapped = order;
+            order = scratch;
+            scratch = swapped;
+        }
+
+        if(order != list->order)
+        {
+            memcpy(list->order, order, sizeof(uint32)*num_packets);
+        }
+        list->sorted = true;
+    }
+
+    // NOTE: the packet executed at position idx, in the order of the sort keys once the list has been sorted
+    inline Packet const*
+    packet_at(CommandList const*const list, uint const idx)
+    {
+        return &list->packets[list->sorted ? list->order[idx] : idx];
+    }
+
+    uint const NO_STATE = 0xffffffff;
+
+    uint const VERTEX_SHADER_CHANGED = 1 << 0;
+    uint const PIXEL_SHADER_CHANGED = 1 << 1;
+    uint const INPUT_LAYOUT_CHANGED = 1 << 2;
+    uint const TOPOLOGY_CHANGED = 1 << 3;
+    uint const SCISSOR_CHANGED = 1 << 4;
+    // NOTE: which constant buffers are bound, and then what is in them
+    uint const CONSTANT_BUFFER_CHANGED = 1 << 5;
+    uint const CONSTANTS_CHANGED = 1 << 6;
+    uint const VERTEX_BUFFER_CHANGED = 1 << 7;
+
+    // NOTE: what an executor has set, NO_STATE where it hasn't set anything yet
+    struct State
+    {
+        uint vertex_shader;
+        uint pixel_shader;
+        uint input_layout;
+        uint topology;
+        uint scissor_idx;
+        uint constant_buffer;
+        uint constants_idx[NumConstantBuffers];
+        uint vertex_buffer;
+        uint vertex_offset;
+    };
+
+    void
+    reset(State *const state)
+    {
+        state->vertex_shader = NO_STATE;
+        state->pixel_shader = NO_STATE;
+        state->input_layout = NO_STATE;
+        state->topology = NO_STATE;
+        state->scissor_idx = NO_STATE;
+        state->constant_buffer = NO_STATE;
+        for(uint buffer_idx=0; buffer_idx < NumConstantBuffers; buffer_idx++)
+        {
+            state->constants_idx[buffer_idx] = NO_STATE;
+        }
+        state->vertex_buffer = NO_STATE;
+        state->vertex_offset = NO_STATE;
+    }
+
+    inline uint
+    filter(uint const value, uint const changed_bit, uint *const current, Statistics *const stats)
+    {
+        if(*current == value)
+        {
+            stats->num_redundant_state_changes++;
+            return 0;
+        }
+        *current = value;
+        stats->num_state_changes++;
+        return changed_bit;
+    }
+
+    // NOTE: the state the packet needs that isn't set already, which is then taken as set
+    uint
+    filter(Packet const*const packet, State *const state, Statistics *const stats)
+    {
+        PipelineDescription const*const pipeline = &PIPELINES[packet->pipeline];
+        uint changed = 0;
+        changed |= filter(uint(pipeline->vertex_shader), VERTEX_SHADER_CHANGED, &state->vertex_shader, stats);
+        changed |= filter(uint(pipeline->pixel_shader), PIXEL_SHADER_CHANGED, &state->pixel_shader, stats);
+        changed |= filter(uint(pipeline->input_layout), INPUT_LAYOUT_CHANGED, &state->input_layout, stats);
+        changed |= filter(uint(pipeline->topology), TOPOLOGY_CHANGED, &state->topology, stats);
+        changed |= filter(packet->scissor_idx, SCISSOR_CHANGED, &state->scissor_idx, stats);
+        if(pipeline->constant_buffer != NoConstantBuffer)
+        {
+            changed |= filter(uint(pipeline->constant_buffer), CONSTANT_BUFFER_CHANGED, &state->constant_buffer, stats);
+            changed |=
+                filter(packet->constants_idx, CONSTANTS_CHANGED, &state->constants_idx[pipeline->constant_buffer], stats);
+        }
+        if(packet->vertex_buffer != NoVertexBuffer)
+        {
+            // NOTE: the same buffer bound from somewhere else is bound again
+            if(state->vertex_buffer == packet->vertex_buffer && state->vertex_offset == packet->vertex_offset)
+            {
+                stats->num_redundant_state_changes++;
+            }
+            else
+            {
+                state->vertex_buffer = packet->vertex_buffer;
+                state->vertex_offset = packet->vertex_offset;
+                stats->num_state_changes++;
+                changed |= VERTEX_BUFFER_CHANGED;
+            }
+        }
+        return changed;
+    }
+
+    void
+    reset_statistics(Statistics *const stats)
+    {
+        stats->num_packets = 0;
+        stats->num_draws = 0;
+        stats->num_state_changes = 0;
+        stats->num_redundant_state_changes = 0;
+        stats->num_uploads = 0;
+        stats->num_dropped_packets = 0;
+    }
+
+    void
+    log_statistics(Statistics const*const stats)
+    {
+        Platform::log_string("packets: ");
+        Platform::log_uint32(stats->num_packets);
+        Platform::log_string(", draws: ");
+        Platform::log_uint32(stats->num_draws);
+        Platform::log_string(", state changes: ");
+        Platform::log_uint32(stats->num_state_changes);
+        Platform::log_string(", redundant state changes skipped: ");
+        Platform::log_uint32(stats->num_redundant_state_changes);
+        Platform::log_string(", uploads: ");
+        Platform::log_uint32(stats->num_uploads);
+        Platform::log_string(", dropped packets: ");
+        Platform::log_uint32(stats->num_dropped_packets);
+        Platform::log_line();
+    }
+
+    // NOTE:
+    // The grid lines of a plot as one instanced draw per orientation, and its labels added to the glyph batch. The
+    // layouts are only recomputed when their arguments change, and have to stay as they are until the list has been executed.
+    void
+    record_grid(
+        uint const character_spacing_screen,
+        uint const base,
+        float const smallest_visible_horizontal_level_spacing_viewport,
+        float const smallest_visible_vertical_level_spacing_viewport,
+        float const min_x_viewport,
+        float const max_x_viewport,
+        float const min_y_viewport,
+        float const max_y_viewport,
+        uint const viewport_width_pixels,
+        uint const viewport_height_pixels,
+        float const horizontal_text_end_position_viewport,
+        float const vertical_text_end_position_viewport,
+        Grid::Transform const*const horizontal_transform,
+        Grid::Transform const*const vertical_transform,
+        Grid::Scale const horizontal_scale,
+        Grid::Scale const vertical_scale,
+        int const max_num_label_characters,
+        uint const scissor_idx,
+        Grid::Layout::Axis *const horizontal_layout,
+        Grid::Layout::Axis *const vertical_layout,
+        Grid::LabelCache::Cache *const label_cache,
+        Grid::GlyphBatch::Batch *const glyph_batch,
+        CommandList *const list
+        )
+    {
+        using namespace Grid;
+
+        Layout::update(
+            base,
+            smallest_visible_horizontal_level_spacing_viewport,
+            Orientation::Horizontal,
+            horizontal_scale,
+            min_y_viewport,
+            max_y_viewport,
+            min_x_viewport,
+            max_x_viewport,
+            horizontal_transform,
+            max_num_label_characters,
+            horizontal_layout
+            );
+        Layout::update(
+            base,
+            smallest_visible_vertical_level_spacing_viewport,
+            Orientation::Vertical,
+            vertical_scale,
+            min_x_viewport,
+            max_x_viewport,
+            min_y_viewport,
+            max_y_viewport,
+            vertical_transform,
+            max_num_label_characters,
+            vertical_layout
+            );
+
+        Layout::Axis const*const layouts[2] = {horizontal_layout, vertical_layout};
+        for(uint orientation_idx=0; orientation_idx < Orientation::NumOrientations; orientation_idx++)
+        {
+            GridLinesContext const*const context = &layouts[orientation_idx]->lines;
+            if(context->num_visible_lines == 0)
+                continue;
+            uint const constants_idx = grid_lines(context, layouts[orientation_idx]->emphasis, list);
+            draw(PlotLayer, GridLines, constants_idx, scissor_idx, NoVertexBuffer, 0, 0, 2, context->num_visible_lines, list);
+        }
+
+        GlyphBatch::add_grid_labels(
+            character_spacing_screen,
+            viewport_width_pixels,
+            viewport_height_pixels,
+            Orientation::Horizontal, // NOTE: text goes horizontally
+            horizontal_layout,
+            horizontal_text_end_position_viewport,
+            label_cache,
+            glyph_batch
+            );
+        GlyphBatch::add_grid_labels(
+            character_spacing_screen,
+            viewport_width_pixels,
+            viewport_height_pixels,
+            Orientation::Vertical, // NOTE: text goes vertically
+            vertical_layout,
+            vertical_text_end_position_viewport,
+            label_cache,
+            glyph_batch
+            );
+    }
+
+    // NOTE: all glyphs of the batch in one instanced draw, recorded once all labels of the frame are in the batch
+    void
+    record_glyph_batch(Grid::GlyphBatch::Batch const*const batch, uint const scissor_idx, CommandList *const list)
+    {
+        set_glyph_batch(batch, list);
+        if(batch->num_glyphs == 0)
+            return;
+        draw(PlotLayer, GlyphQuads, 0, scissor_idx, GlyphInstanceBuffer, 0, 0, 4, batch->num_glyphs, list);
+    }
+
+    // NOTE:
+    // Executes a list on the CPU with the SoftwareRender functions, into a framebuffer of the size of the viewport.
+    // Each pipeline is drawn by the function that does what its shaders do.
+    struct SoftwareExecutor
+    {
+        SoftwareRender::DensityCache density_cache;
+        SoftwareRender::CoverageBuffer coverage;
+        uint32 const* font_pixels;
+    };
+
+    void
+    initialize(uint32 const*const font_pixels, SoftwareExecutor *const executor)
+    {
+        SoftwareRender::initialize(&executor->density_cache);
+        SoftwareRender::initialize(&executor->coverage);
+        executor->font_pixels = font_pixels;
+    }
+
+    void
+    release(SoftwareExecutor *const executor)
+    {
+        SoftwareRender::release(&executor->coverage);
+        SoftwareRender::release(&executor->density_cache);
+    }
+
+    // NOTE: the circle markers of the zeros (white) and poles (black) and their conjugates, as dynamic_transform places them
+    void
+    draw_markers(
+        WidgetLayoutConstants const*const layout,
+        Parameters const*const parameters,
+        SoftwareRender::ClipRectangle const*const clip,
+        SoftwareRender::Framebuffer *const framebuffer
+        )
+    {
+        using namespace SoftwareRender;
+
+        uint const num_corners = 5;
+        float const marker_scale = 0.04f;
+
+        for(uint instance_idx=0; instance_idx < 8; instance_idx++)
+        {
+            uint const numden_idx = instance_idx / 4;
+            uint const conjugate_idx = instance_idx % 2;
+            uint const leftright_idx = (instance_idx / 2) % 2;
+            Complex::C const*const p = &parameters->ator_factors[numden_idx][leftright_idx];
+            float const center_x_data = p->component.real;
+            float const center_y_data = conjugate_idx == 1 ? -p->component.imaginary : p->component.imaginary;
+
+            float x[num_corners];
+            float y[num_corners];
+            for(uint corner_idx=0; corner_idx < num_corners; corner_idx++)
+            {
+                float const angle = 2.0f*PI_FLOAT*float(corner_idx)/float(num_corners);
+                float const x_data = center_x_data + marker_scale*0.5f*Numerics::cos(angle);
+                float const y_data = center_y_data + marker_scale*0.5f*Numerics::sin(angle);
+                x[corner_idx] =
+                    x_screen(framebuffer->x_dimension, layout->center_x_position_viewport + x_data*layout->data_x_unit_viewport);
+                y[corner_idx] =
+                    y_screen(framebuffer->y_dimension, layout->center_y_position_viewport + y_data*layout->data_y_unit_viewport);
+            }
+
+            float const color[4] =
+                {
+                    numden_idx == 0 ? 1.0f : 0.0f,
+                    numden_idx == 0 ? 1.0f : 0.0f,
+                    numden_idx == 0 ? 1.0f : 0.0f,
+                    1.0f
+                };
+            fill_convex_polygon(num_corners, x, y, color, clip, framebuffer);
+        }
+    }
+
+    // NOTE: a line strip of ShapeVertex in widget data coordinates, as locus_transform and contour_transform place it
+    void
+    draw_shape_lines(
+        WidgetLayoutConstants const*const layout,
+        float const*const vertices,
+        uint const num_vertices,
+        float const color[4],
+        SoftwareRender::ClipRectangle const*const clip,
+        SoftwareRender::Framebuffer *const framebuffer
+        )
+    {
+        using namespace SoftwareRender;
+
+        for(uint vertex_idx=1; vertex_idx < num_vertices; vertex_idx++)
+        {
+            float const*const v0 = &vertices[2*(vertex_idx - 1)];
+            float const*const v1 = &vertices[2*vertex_idx];
+            draw_line(
+                x_screen(framebuffer->x_dimension, layout->center_x_position_viewport + v0[0]*layout->data_x_unit_viewport),
+                y_screen(framebuffer->y_dimension, layout->center_y_position_viewport + v0[1]*layout->data_y_unit_viewport),
+                x_screen(framebuffer->x_dimension, layout->center_x_position_viewport + v1[0]*layout->data_x_unit_viewport),
+                y_screen(framebuffer->y_dimension, layout->center_y_position_viewport + v1[1]*layout->data_y_unit_viewport),
+                color,
+                clip,
+                framebuffer
+                );
+        }
+    }
+
+    void
+    draw_grid_lines(
+        Grid::GridLinesContext const*const ctx,
+        uint8 const*const emphasis,
+        SoftwareRender::ClipRectangle const*const clip,
+        SoftwareRender::Framebuffer *const framebuffer
+        )
+    {
+        using namespace SoftwareRender;
+
+        bool const horizontal = ctx->orientation == uint(Grid::Orientation::Horizontal);
+        for(uint line_idx=0; line_idx < ctx->num_visible_lines; line_idx++)
+        {
+            float const position_viewport = Grid::line_position_viewport(ctx, int(line_idx));
+            float const color[4] = {1.0f, 1.0f, 1.0f, Grid::line_alpha(ctx, emphasis[line_idx])};
+            if(horizontal)
+            {
+                float const y = y_screen(framebuffer->y_dimension, position_viewport);
+                draw_line(
+                    x_screen(framebuffer->x_dimension, ctx->lo), y,
+                    x_screen(framebuffer->x_dimension, ctx->hi), y,
+                    color, clip, framebuffer
+                    );
+            }
+            else
+            {
+                float const x = x_screen(framebuffer->x_dimension, position_viewport);
+                draw_line(
+                    x, y_screen(framebuffer->y_dimension, ctx->lo),
+                    x, y_screen(framebuffer->y_dimension, ctx->hi),
+                    color, clip, framebuffer
+                    );
+            }
+        }
+    }
+
+    // NOTE: the colorbar_magnitude pixel shader, which is clamp(0, 1, a) there, so a is only clamped from above
+    void
+    colorbar_magnitude_color(float const a, float color[4])
+    {
+        if(a > 1.0f)
+        {
+            color[0] = 1.0f; color[1] = 1.0f; color[2] = 1.0f; color[3] = 1.0f;
+            return;
+        }
+        float const g = Numerics::floor(Numerics::minimum(a, 1.0f)*10.0f)/10.0f;
+        color[0] = g*0.8f; color[1] = g*0.95f; color[2] = g*0.8f; color[3] = 1.0f;
+    }
+
+    // NOTE: the bar left of the plot margin, colored by the plot's y at each pixel, see colorbar_transform
+    void
+    draw_colorbar(
+        bool const magnitude,
+        PlotConstants const*const constants,
+        SoftwareRender::ClipRectangle const*const clip,
+        SoftwareRender::Framebuffer *const framebuffer
+        )
+    {
+        using namespace SoftwareRender;
+
+        float const min_x_viewport = constants->plotviewport_viewport[0];
+        float const min_y_viewport = constants->plotviewport_viewport[2];
+        float const max_y_viewport = constants->plotviewport_viewport[3];
+        float const min_y_data = constants->plotviewport_data[2];
+        float const max_y_data = constants->plotviewport_data[3];
+        float const bar_min_x_viewport = min_x_viewport - 1.3f*constants->margin_x_dimension_viewport;
+        float const bar_max_x_viewport = min_x_viewport - 1.0f*constants->margin_x_dimension_viewport;
+
+        int const first_x = int(Numerics::ceiling(x_screen(framebuffer->x_dimension, bar_min_x_viewport) - 0.5f));
+        int const end_x = int(Numerics::ceiling(x_screen(framebuffer->x_dimension, bar_max_x_viewport) - 0.5f));
+        int const first_y = int(Numerics::ceiling(y_screen(framebuffer->y_dimension, max_y_viewport) - 0.5f));
+        int const end_y = int(Numerics::ceiling(y_screen(framebuffer->y_dimension, min_y_viewport) - 0.5f));
+        for(int y=Numerics::maximum(first_y, clip->min_y); y < Numerics::minimum(end_y, clip->end_y); y++)
+        {
+            float const y_pixel_viewport = y_viewport(framebuffer->y_dimension, float(y) + 0.5f);
+            float const y_data =
+                min_y_data + (y_pixel_viewport - min_y_viewport)/(max_y_viewport - min_y_viewport)*(max_y_data - min_y_data);
+
+            float color[4];
+            if(magnitude)
+            {
+                colorbar_magnitude_color(y_data, color);
+            }
+            else
+            {
+                // NOTE: transparent outside of a turn
+                if(y_data < -0.5f || y_data > 0.5f)
+                    continue;
+                float const normalized_phase = y_data - Numerics::floor(y_data);
+                uint const sector_idx =
+                    (uint)Numerics::minimum(int(normalized_phase*float(NUM_DOMAIN_COLORING_SECTORS)), int(NUM_DOMAIN_COLORING_SECTORS) - 1);
+                domain_coloring_sector_color(sector_idx, color);
+            }
+
+            for(int x=Numerics::maximum(first_x, clip->min_x); x < Numerics::minimum(end_x, clip->end_x); x++)
+            {
+                blend_pixel(framebuffer, x, y, color);
+            }
+        }
+    }
+
+    // NOTE: the curve as plot_transform places it, which spreads the vertices evenly over the curve interval
+    bool
+    draw_curve(
+        PlotConstants const*const constants,
+        float const*const vertices,
+        uint const num_vertices,
+        SoftwareRender::ClipRectangle const*const clip,
+        SoftwareRender::CoverageBuffer *const coverage,
+        SoftwareRender::Framebuffer *const framebuffer
+        )
+    {
+        using namespace SoftwareRender;
+
+        float const*const data = constants->plotviewport_data;
+        float const*const viewport = constants->plotviewport_viewport;
+        float const x_scale = (viewport[1] - viewport[0])/(data[1] - data[0]);
+        float const y_scale = (viewport[3] - viewport[2])/(data[3] - data[2]);
+        float const num_segments = float(constants->num_curve_slices - 1);
+
+        uint const MAX_NUM_VERTICES_PER_CHUNK = 512;
+        float x[MAX_NUM_VERTICES_PER_CHUNK];
+        float y[MAX_NUM_VERTICES_PER_CHUNK];
+        bool success = true;
+        // NOTE: chunks overlap by a vertex so the strip stays connected
+        for(uint first_idx=0; first_idx + 1 < num_vertices; first_idx += MAX_NUM_VERTICES_PER_CHUNK - 1)
+        {
+            uint const num_chunk_vertices =
+                uint(Numerics::minimum(int(MAX_NUM_VERTICES_PER_CHUNK), int(num_vertices - first_idx)));
+            for(uint chunk_idx=0; chunk_idx < num_chunk_vertices; chunk_idx++)
+            {
+                uint const vertex_idx = first_idx + chunk_idx;
+                float const t = float(vertex_idx)/num_segments;
+                float const x_data =
+                    constants->curve_interval_x_data[0] + (constants->curve_interval_x_data[1] - constants->curve_interval_x_data[0])*t;
+                x[chunk_idx] = x_screen(framebuffer->x_dimension, viewport[0] + (x_data - data[0])*x_scale);
+                y[chunk_idx] = y_screen(framebuffer->y_dimension, viewport[2] + (vertices[vertex_idx] - data[2])*y_scale);
+            }
+            float const*const color = constants->curve_color;
+            success = draw_polyline_antialiased(x, y, num_chunk_vertices, color, clip, coverage, framebuffer) && success;
+        }
+        return success;
+    }
+
+    void
+    execute(
+        CommandList const*const list,
+        SoftwareExecutor *const executor,
+        SoftwareRender::Framebuffer *const framebuffer,
+        Statistics *const stats
+        )
+    {
+        using namespace SoftwareRender;
+
+        reset_statistics(stats);
+        stats->num_packets = list->num_packets;
+        stats->num_dropped_packets = list->num_dropped_packets;
+
+        clear(framebuffer, list->clear_color);
+
+        State state;
+        reset(&state);
+        for(uint idx=0; idx < list->num_packets; idx++)
+        {
+            Packet const*const packet = packet_at(list, idx);
+            // NOTE: nothing to set on the CPU, but counted the same way as on the GPU
+            filter(packet, &state, stats);
+
+            Scissor const*const scissor = &list->scissors[packet->scissor_idx];
+            ClipRectangle clip;
+            clip.min_x = Numerics::maximum(scissor->left, 0);
+            clip.min_y = Numerics::maximum(scissor->top, 0);
+            clip.end_x = Numerics::minimum(scissor->right, int(framebuffer->x_dimension));
+            clip.end_y = Numerics::minimum(scissor->bottom, int(framebuffer->y_dimension));
+
+            uint8 const*const vertex_bytes =
+                (uint8 const*)list->vertex_data[packet->vertex_buffer].data + packet->vertex_offset;
+
+            switch(packet->pipeline)
+            {
+                case DensityCircle:
+                {
+                    draw_density_cached(
+                        &list->layouts[packet->constants_idx],
+                        &list->parameters,
+                        list->normalization_factor,
+                        &executor->density_cache,
+                        framebuffer
+                        );
+                } break;
+                case DomainColoringCircle:
+                {
+                    draw_widget(
+                        Shader::DomainColoring,
+                        &list->layouts[packet->constants_idx],
+                        &list->parameters,
+                        list->normalization_factor,
+                        framebuffer
+                        );
+                } break;
+                case ContourLines:
+                case LocusLines:
+                {
+                    // NOTE: the colors of contour_transform and locus_transform
+                    float const contour_color[4] = {0.2f, 0.6f, 1.0f, 1.0f};
+                    float const locus_color[4] = {1.0f, 0.5f, 0.0f, 1.0f};
+                    draw_shape_lines(
+                        &list->layouts[packet->constants_idx],
+                        (float const*)vertex_bytes + 2*packet->first_vertex,
+                        packet->num_vertices,
+                        packet->pipeline == ContourLines ? contour_color : locus_color,
+                        &clip,
+                        framebuffer
+                        );
+                } break;
+                case MarkerShapes:
+                {
+                    draw_markers(&list->layouts[packet->constants_idx], &list->parameters, &clip, framebuffer);
+                } break;
+                case GridLines:
+                {
+                    GridLinesConstants const*const lines = &list->grid_lines[packet->constants_idx];
+                    draw_grid_lines(&lines->context, lines->emphasis, &clip, framebuffer);
+                } break;
+                case GlyphQuads:
+                {
+                    draw_glyph_batch(list->glyph_batch, executor->font_pixels, framebuffer);
+                } break;
+                case MagnitudeColorbar:
+                case PhaseColorbar:
+                {
+                    draw_colorbar(packet->pipeline == MagnitudeColorbar, &list->plots[packet->constants_idx], &clip, framebuffer);
+                } break;
+                case CurveLines:
+                {
+                    bool const success =
+                        draw_curve(
+                            &list->plots[packet->constants_idx],
+                            (float const*)vertex_bytes + packet->first_vertex,
+                            packet->num_vertices,
+                            &clip,
+                            &executor->coverage,
+                            framebuffer
+                            );
+                    assert(success);
+                } break;
+                default:
+                {
+                    assert(false);
+                } break;
+            }
+            stats->num_draws++;
+        }
+    }
+
+}
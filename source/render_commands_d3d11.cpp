@@ -0,0 +1,351 @@
+namespace RenderCommands
+{
+
+    // NOTE: what the ids of a command list stand for on the GPU, a null index buffer for a vertex buffer that has none
+    struct D3D11Executor
+    {
+        ID3D11DeviceContext* d3d_device_context;
+        ID3D11RenderTargetView* render_target_view;
+        ID3D11VertexShader* vertex_shaders[NumVertexShaders];
+        ID3D11PixelShader* pixel_shaders[NumPixelShaders];
+        ID3D11InputLayout* input_layouts[NumInputLayouts];
+        ID3D11Buffer* vertex_buffers[NumVertexBuffers];
+        ID3D11Buffer* index_buffers[NumVertexBuffers];
+        ID3D11Buffer* dynamic_constant_buffer;
+        ID3D11Buffer* layout_constant_buffer;
+        ID3D11Buffer* plot_constant_buffer;
+        ID3D11Buffer* grid_constant_buffer;
+        ID3D11Buffer* line_emphasis_buffer;
+        ID3D11ShaderResourceView* line_emphasis_buffer_srv;
+        ID3D11ShaderResourceView* glyph_instance_buffer_srv;
+        ID3D11SamplerState* font_sampler_state;
+        ID3D11ShaderResourceView* font_texture_srv;
+    };
+
+    D3D11_PRIMITIVE_TOPOLOGY const D3D11_TOPOLOGIES[NumTopologies] =
+        {
+            D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+            D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP,
+            D3D11_PRIMITIVE_TOPOLOGY_LINELIST,
+            D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP,
+        };
+
+    // NOTE: the vertices that changed since the list was last executed, before anything is drawn
+    bool
+    upload_vertex_data(CommandList const*const list, D3D11Executor const*const executor, Statistics *const stats)
+    {
+        ID3D11DeviceContext *const d3d_device_context = executor->d3d_device_context;
+        bool success = true;
+        for(uint buffer_idx=0; buffer_idx < NumVertexBuffers; buffer_idx++)
+        {
+            VertexData const*const vertex_data = &list->vertex_data[buffer_idx];
+            if(!vertex_data->changed || vertex_data->num_bytes == 0)
+                continue;
+
+            if(buffer_idx == GlyphInstanceBuffer)
+            {
+                success =
+                    Grid::try_update_glyph_instances(
+                        d3d_device_context,
+                        executor->vertex_buffers[buffer_idx],
+                        list->glyph_batch
+                        ) && success;
+            }
+            else
+            {
+                // NOTE: every vertex is made of floats
+                success =
+                    try_upload_curve_vertices(
+                        vertex_data->num_bytes/uint(sizeof(float)),
+                        (float const*)vertex_data->data,
+                        d3d_device_context,
+                        executor->vertex_buffers[buffer_idx]
+                        ) && success;
+            }
+            stats->num_uploads++;
+        }
+        return success;
+    }
+
+    // NOTE: the constant buffers the pipelines of a kind read, the widget ones also read the parameters
+    void
+    bind_constant_buffer(ConstantBuffer const constant_buffer, D3D11Executor const*const executor)
+    {
+        ID3D11DeviceContext *const d3d_device_context = executor->d3d_device_context;
+        switch(constant_buffer)
+        {
+            case LayoutConstantBuffer:
+            {
+                uint const start_slot = 0;
+                uint const num_buffers = 2;
+                ID3D11Buffer* buffers[num_buffers] = {executor->dynamic_constant_buffer, executor->layout_constant_buffer};
+                d3d_device_context->VSSetConstantBuffers(start_slot, num_buffers, buffers);
+            } break;
+            case PlotConstantBuffer:
+            {
+                uint const start_slot = 2;
+                uint const num_buffers = 1;
+                ID3D11Buffer* buffers[num_buffers] = {executor->plot_constant_buffer};
+                d3d_device_context->VSSetConstantBuffers(start_slot, num_buffers, buffers);
+            } break;
+            case GridConstantBuffer:
+            {
+                {
+                    uint const start_slot = Grid::ShaderConstants::GRID_CONSTANT_BUFFER_SLOT;
+                    uint const num_buffers = 1;
+                    ID3D11Buffer* buffers[num_buffers] = {executor->grid_constant_buffer};
+                    d3d_device_context->VSSetConstantBuffers(start_slot, num_buffers, buffers);
+                }
+                {
+                    uint const start_slot = Grid::ShaderConstants::LINE_EMPHASIS_BUFFER_SLOT;
+                    ID3D11ShaderResourceView *const shader_resource_views[] = {executor->line_emphasis_buffer_srv};
+                    uint const num_views = ARRAY_LENGTH(shader_resource_views);
+                    d3d_device_context->VSSetShaderResources(start_slot, num_views, shader_resource_views);
+                }
+            } break;
+            default:
+            {
+                assert(false);
+            } break;
+        }
+    }
+
+    bool
+    update_constants(
+        CommandList const*const list,
+        ConstantBuffer const constant_buffer,
+        uint const constants_idx,
+        D3D11Executor const*const executor
+        )
+    {
+        ID3D11DeviceContext *const d3d_device_context = executor->d3d_device_context;
+        switch(constant_buffer)
+        {
+            case LayoutConstantBuffer:
+            {
+                return update_layout_constants(d3d_device_context, executor->layout_constant_buffer, &list->layouts[constants_idx]);
+            }
+            case PlotConstantBuffer:
+            {
+                return update_plot_constants(d3d_device_context, executor->plot_constant_buffer, &list->plots[constants_idx]);
+            }
+            case GridConstantBuffer:
+            {
+                GridLinesConstants const*const lines = &list->grid_lines[constants_idx];
+                Grid::GridLinesShaderConstants constants;
+                Grid::grid_lines_shader_constants(&lines->context, &constants);
+                return
+                    Grid::try_update_line_emphasis(
+                        d3d_device_context,
+                        executor->line_emphasis_buffer,
+                        lines->emphasis,
+                        lines->context.num_visible_lines
+                        ) &&
+                    Grid::try_update_grid_constants(d3d_device_context, executor->grid_constant_buffer, &constants);
+            }
+            default:
+            {
+                assert(false);
+                return false;
+            }
+        }
+    }
+
+    void
+    bind_vertex_buffer(VertexBuffer const vertex_buffer, uint const vertex_offset, D3D11Executor const*const executor)
+    {
+        ID3D11DeviceContext *const d3d_device_context = executor->d3d_device_context;
+
+        // NOTE: the glyph instances are read by the vertex shader
+        if(vertex_buffer == GlyphInstanceBuffer)
+        {
+            uint const start_slot = Grid::ShaderConstants::GLYPH_INSTANCE_BUFFER_SLOT;
+            ID3D11ShaderResourceView *const shader_resource_views[] = {executor->glyph_instance_buffer_srv};
+            uint const num_views = ARRAY_LENGTH(shader_resource_views);
+            d3d_device_context->VSSetShaderResources(start_slot, num_views, shader_resource_views);
+            return;
+        }
+
+        {
+            uint const input_slot = 0;
+            uint const num_buffers = 1;
+            ID3D11Buffer* buffers[num_buffers] = {executor->vertex_buffers[vertex_buffer]};
+            uint strides[num_buffers] = {VERTEX_STRIDES[vertex_buffer]};
+            uint offsets[num_buffers] = {vertex_offset};
+            d3d_device_context->IASetVertexBuffers(input_slot, num_buffers, buffers, strides, offsets);
+        }
+
+        if(executor->index_buffers[vertex_buffer] != 0)
+        {
+            DXGI_FORMAT const format = DXGI_FORMAT_R32_UINT;
+            uint const offset = 0;
+            d3d_device_context->IASetIndexBuffer(executor->index_buffers[vertex_buffer], format, offset);
+        }
+    }
+
+    // NOTE: clears the render target and draws the packets, in the order of their keys once the list has been sorted
+    void
+    execute(CommandList const*const list, D3D11Executor const*const executor, Statistics *const stats)
+    {
+        ID3D11DeviceContext *const d3d_device_context = executor->d3d_device_context;
+
+        reset_statistics(stats);
+        stats->num_packets = list->num_packets;
+        stats->num_dropped_packets = list->num_dropped_packets;
+
+        d3d_device_context->ClearRenderTargetView(executor->render_target_view, list->clear_color);
+
+        {
+            bool const success = upload_vertex_data(list, executor, stats);
+            assert(success);
+        }
+
+        // NOTE: the parameters are read by the widget pixel shaders, and stay bound the whole frame
+        {
+            bool const success =
+                update_parameters(
+                    d3d_device_context,
+                    executor->dynamic_constant_buffer,
+                    &list->parameters,
+                    list->normalization_factor
+                    );
+            assert(success);
+            stats->num_uploads++;
+
+            uint const start_slot = 0;
+            uint const num_buffers = 1;
+            ID3D11Buffer* buffers[num_buffers] = {executor->dynamic_constant_buffer};
+            d3d_device_context->PSSetConstantBuffers(start_slot, num_buffers, buffers);
+            stats->num_state_changes++;
+        }
+
+        State state;
+        reset(&state);
+        for(uint idx=0; idx < list->num_packets; idx++)
+        {
+            Packet const*const packet = packet_at(list, idx);
+            PipelineDescription const*const pipeline = &PIPELINES[packet->pipeline];
+            uint const changed = filter(packet, &state, stats);
+
+            if(changed & VERTEX_SHADER_CHANGED)
+            {
+                uint num_class_instances = 0;
+                ID3D11ClassInstance** class_instances = 0;
+                d3d_device_context->VSSetShader(
+                    executor->vertex_shaders[pipeline->vertex_shader],
+                    class_instances,
+                    num_class_instances
+                    );
+            }
+
+            if(changed & PIXEL_SHADER_CHANGED)
+            {
+                uint num_class_instances = 0;
+                ID3D11ClassInstance** class_instances = 0;
+                d3d_device_context->PSSetShader(
+                    executor->pixel_shaders[pipeline->pixel_shader],
+                    class_instances,
+                    num_class_instances
+                    );
+
+                // NOTE: the font is only read by the glyph pixel shader, the slots are its own
+                if(pipeline->pixel_shader == GlyphPixelShader)
+                {
+                    {
+                        uint const start_slot = Grid::ShaderConstants::TEXT_SAMPLER_SLOT;
+                        ID3D11SamplerState *const samplers[] = {executor->font_sampler_state};
+                        uint const num_samplers = ARRAY_LENGTH(samplers);
+                        d3d_device_context->PSSetSamplers(start_slot, num_samplers, samplers);
+                    }
+                    {
+                        uint const start_slot = Grid::ShaderConstants::FONT_TEXTURE_SLOT;
+                        ID3D11ShaderResourceView *const shader_resource_views[] = {executor->font_texture_srv};
+                        uint const num_views = ARRAY_LENGTH(shader_resource_views);
+                        d3d_device_context->PSSetShaderResources(start_slot, num_views, shader_resource_views);
+                    }
+                }
+            }
+
+            if(changed & INPUT_LAYOUT_CHANGED)
+            {
+                d3d_device_context->IASetInputLayout(executor->input_layouts[pipeline->input_layout]);
+            }
+
+            if(changed & TOPOLOGY_CHANGED)
+            {
+                d3d_device_context->IASetPrimitiveTopology(D3D11_TOPOLOGIES[pipeline->topology]);
+            }
+
+            if(changed & SCISSOR_CHANGED)
+            {
+                Scissor const*const scissor = &list->scissors[packet->scissor_idx];
+                D3D11_RECT rectangles[1];
+                rectangles[0].left = LONG(scissor->left);
+                rectangles[0].top = LONG(scissor->top);
+                rectangles[0].right = LONG(scissor->right);
+                rectangles[0].bottom = LONG(scissor->bottom);
+                uint const num_rectangles = ARRAY_LENGTH(rectangles);
+                d3d_device_context->RSSetScissorRects(num_rectangles, rectangles);
+            }
+
+            if(changed & CONSTANT_BUFFER_CHANGED)
+            {
+                bind_constant_buffer(pipeline->constant_buffer, executor);
+            }
+
+            if(changed & CONSTANTS_CHANGED)
+            {
+                bool const success = update_constants(list, pipeline->constant_buffer, packet->constants_idx, executor);
+                assert(success);
+                stats->num_uploads++;
+            }
+
+            if(changed & VERTEX_BUFFER_CHANGED)
+            {
+                bind_vertex_buffer(VertexBuffer(packet->vertex_buffer), packet->vertex_offset, executor);
+            }
+
+            if(pipeline->indexed && packet->num_instances > 0)
+            {
+                int const base_vertex_location = 0;
+                uint const start_instance_location = 0;
+                d3d_device_context->DrawIndexedInstanced(
+                    packet->num_vertices,
+                    packet->num_instances,
+                    packet->first_vertex,
+                    base_vertex_location,
+                    start_instance_location
+                    );
+            }
+            else if(pipeline->indexed)
+            {
+                int const base_vertex_location = 0;
+                d3d_device_context->DrawIndexed(
+                    packet->num_vertices,
+                    packet->first_vertex,
+                    base_vertex_location
+                    );
+            }
+            else if(packet->num_instances > 0)
+            {
+                uint const start_instance_location = 0;
+                d3d_device_context->DrawInstanced(
+                    packet->num_vertices,
+                    packet->num_instances,
+                    packet->first_vertex,
+                    start_instance_location
+                    );
+            }
+            else
+            {
+                d3d_device_context->Draw(
+                    packet->num_vertices,
+                    packet->first_vertex
+                    );
+            }
+            stats->num_draws++;
+            g_num_draw_calls++;
+        }
+    }
+
+}
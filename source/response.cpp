@@ -0,0 +1,348 @@
+// NOTE:
+// Frequency response evaluation in the log domain.
+// Rather than multiplying four distances and dividing by four more, which overflows or underflows for zeros and
+// poles far from (or right on) the unit circle, the logarithms of the squared distances are summed.
+// Working with squared distances also saves the square roots.
+namespace Response
+{
+
+    // NOTE: 20*log10(2), converts log2 of a magnitude to decibels
+    float const DECIBELS_PER_LOG2 = 6.02059991f;
+    // NOTE: 20/ln(10), converts the natural logarithm of a magnitude to decibels
+    float const DECIBELS_PER_LN = 8.68588964f;
+
+    // NOTE: squared distances are clamped to this before taking the logarithm,
+    // so zeros right on the unit circle give a large but finite attenuation
+    float const MIN_DISTANCE_SQUARED = 1.0E-30f;
+
+    // NOTE: log2 of normalization_constant_highpass, without the overflow
+    inline float
+    log2_normalization_constant_highpass(Parameters const*const parameters)
+    {
+        float log2_normalization = 0.0f;
+        for(int i=0; i<2; i++)
+        {
+            for(int j=0; j<2; j++)
+            {
+                Complex::C const*const p = &parameters->ator_factors[i][j];
+                float const distance_squared =
+                    Numerics::square(-1.0f - p->component.real) + Numerics::square(p->component.imaginary);
+                float const log2_distance_squared =
+                    Numerics::logarithm(2.0f, Numerics::maximum(distance_squared, MIN_DISTANCE_SQUARED));
+                // NOTE: the conjugate is equally far from -1, so the squared distance accounts for both
+                log2_normalization += i == 0 ? -log2_distance_squared : log2_distance_squared;
+            }
+        }
+        return log2_normalization;
+    }
+
+    // NOTE: x of a sample given its coordinate on the plot axis, which is a logarithm of x if there is a log_base
+    inline double
+    sample_x(double const axis_x, double const log_base_or_0)
+    {
+        return log_base_or_0 != 0.0 ? Numerics::power(log_base_or_0, axis_x) : axis_x;
+    }
+
+    // NOTE:
+    // log2 of the normalized magnitude response at num_samples evenly spaced points e^(i*pi*x),
+    // x going from min_x to max_x (so x is in the units of the plot data).
+    // The sample points and their squared distances are computed in double, so that a plot zoomed in far enough
+    // for the samples to be closer together than a float resolves still gets distinct values.
+    // Only the logarithms, which no longer need the precision, are taken in floats.
+    // With a log_base, min_x and max_x are logarithms of x in that base, and the samples are evenly spaced in them,
+    // which is what a logarithmic frequency axis needs.
+    void
+    log2_magnitude(
+        Parameters const*const parameters,
+        double const min_x,
+        double const max_x,
+        double const log_base_or_0,
+        uint const num_samples,
+        float *const log2_magnitudes
+        )
+    {
+        using namespace Simd;
+
+        assert(num_samples >= 2);
+
+        Float4 const log2_normalization = set(log2_normalization_constant_highpass(parameters));
+        Float4 const min_distance_squared = set(MIN_DISTANCE_SQUARED);
+        double const x_step = (max_x - min_x)/double(num_samples - 1);
+
+        for(uint first_idx=0; first_idx < num_samples; first_idx += NUM_LANES)
+        {
+            double sample_real[NUM_LANES];
+            double sample_imaginary[NUM_LANES];
+            for(uint lane_idx=0; lane_idx < NUM_LANES; lane_idx++)
+            {
+                double const angle = sample_x(min_x + double(first_idx + lane_idx)*x_step, log_base_or_0)*PI_DOUBLE;
+                sample_real[lane_idx] = Numerics::cos(angle);
+                sample_imaginary[lane_idx] = Numerics::sin(angle);
+            }
+
+            // NOTE: the numerator adds, the denominator subtracts, and the logarithm takes care of the division
+            Float4 sum[2] = {zero(), zero()};
+            for(int i=0; i<2; i++)
+            {
+                for(int j=0; j<2; j++)
+                {
+                    Complex::C const*const p = &parameters->ator_factors[i][j];
+                    float distance_squared[NUM_LANES];
+                    float distance_squared_conjugate[NUM_LANES];
+                    for(uint lane_idx=0; lane_idx < NUM_LANES; lane_idx++)
+                    {
+                        double const dx = sample_real[lane_idx] - double(p->component.real);
+                        double const dy = sample_imaginary[lane_idx] - double(p->component.imaginary);
+                        double const dy_conjugate = sample_imaginary[lane_idx] + double(p->component.imaginary);
+                        distance_squared[lane_idx] = float(dx*dx + dy*dy);
+                        distance_squared_conjugate[lane_idx] = float(dx*dx + dy_conjugate*dy_conjugate);
+                    }
+                    sum[i] = add(sum[i], logarithm2(maximum(load(distance_squared), min_distance_squared)));
+                    sum[i] = add(sum[i], logarithm2(maximum(load(distance_squared_conjugate), min_distance_squared)));
+                }
+            }
+
+            // NOTE: halved, since the distances were squared
+            Float4 const result = add(multiply(set(0.5f), subtract(sum[0], sum[1])), log2_normalization);
+
+            if(first_idx + NUM_LANES <= num_samples)
+            {
+                store(result, &log2_magnitudes[first_idx]);
+            }
+            else
+            {
+                float tail[NUM_LANES];
+                store(result, tail);
+                for(uint idx=first_idx; idx < num_samples; idx++)
+                {
+                    log2_magnitudes[idx] = tail[idx - first_idx];
+                }
+            }
+        }
+    }
+
+    void
+    magnitude_decibels(
+        Parameters const*const parameters,
+        double const min_x,
+        double const max_x,
+        double const log_base_or_0,
+        uint const num_samples,
+        float *const magnitudes_decibels
+        )
+    {
+        using namespace Simd;
+
+        log2_magnitude(parameters, min_x, max_x, log_base_or_0, num_samples, magnitudes_decibels);
+
+        Float4 const scale = set(DECIBELS_PER_LOG2);
+        uint const num_whole = num_samples - num_samples % NUM_LANES;
+        for(uint idx=0; idx < num_whole; idx += NUM_LANES)
+        {
+            store(multiply(load(&magnitudes_decibels[idx]), scale), &magnitudes_decibels[idx]);
+        }
+        for(uint idx=num_whole; idx < num_samples; idx++)
+        {
+            magnitudes_decibels[idx] *= DECIBELS_PER_LOG2;
+        }
+    }
+
+    // NOTE:
+    // Phase of the frequency response at the same sample points as log2_magnitude, in turns (so in [-1/2, 1/2]).
+    // The differences to the zeros and poles are taken in double, since near a zero or pole on the unit
+    // circle they are what a deep zoom is looking at.
+    void
+    phase_turns(
+        Parameters const*const parameters,
+        double const min_x,
+        double const max_x,
+        double const log_base_or_0,
+        uint const num_samples,
+        float *const phases_turns
+        )
+    {
+        assert(num_samples >= 2);
+
+        for(uint sample_idx=0; sample_idx < num_samples; sample_idx++)
+        {
+            double const t = double(sample_idx)/double(num_samples - 1);
+            double const angle = sample_x(min_x + (max_x - min_x)*t, log_base_or_0)*PI_DOUBLE;
+            double const sample_real = Numerics::cos(angle);
+            double const sample_imaginary = Numerics::sin(angle);
+
+            Complex::C ator[2];
+            for(int i=0; i<2; i++)
+            {
+                Complex::unit(&ator[i]);
+                for(int j=0; j<2; j++)
+                {
+                    Complex::C const*const p = &parameters->ator_factors[i][j];
+
+                    Complex::C d;
+                    d.component.real = float(sample_real - p->component.real);
+                    d.component.imaginary = float(sample_imaginary - p->component.imaginary);
+
+                    Complex::C d_conjugate;
+                    d_conjugate.component.real = d.component.real;
+                    d_conjugate.component.imaginary = float(sample_imaginary + p->component.imaginary);
+
+                    Complex::multiply(&d, &ator[i]);
+                    Complex::multiply(&d_conjugate, &ator[i]);
+                }
+            }
+
+            Complex::C image;
+            Complex::quotient(&ator[0], &ator[1], &image);
+            phases_turns[sample_idx] = 0.5f*Complex::phase(&image)/PI_FLOAT;
+        }
+    }
+
+    // NOTE: linear magnitude, but still evaluated in the log domain so intermediate products can't overflow
+    void
+    magnitude(
+        Parameters const*const parameters,
+        double const min_x,
+        double const max_x,
+        double const log_base_or_0,
+        uint const num_samples,
+        float *const magnitudes
+        )
+    {
+        using namespace Simd;
+
+        log2_magnitude(parameters, min_x, max_x, log_base_or_0, num_samples, magnitudes);
+
+        uint const num_whole = num_samples - num_samples % NUM_LANES;
+        for(uint idx=0; idx < num_whole; idx += NUM_LANES)
+        {
+            store(exponential2(load(&magnitudes[idx])), &magnitudes[idx]);
+        }
+        if(num_whole < num_samples)
+        {
+            float tail[NUM_LANES] = {};
+            for(uint idx=num_whole; idx < num_samples; idx++)
+            {
+                tail[idx - num_whole] = magnitudes[idx];
+            }
+            store(exponential2(load(tail)), tail);
+            for(uint idx=num_whole; idx < num_samples; idx++)
+            {
+                magnitudes[idx] = tail[idx - num_whole];
+            }
+        }
+    }
+
+    enum Curve
+    {
+        Magnitude,
+        MagnitudeDecibels,
+        PhaseTurns,
+    };
+
+    void
+    sample(
+        Parameters const*const parameters,
+        Curve const curve,
+        double const min_x,
+        double const max_x,
+        double const log_base_or_0,
+        uint const num_samples,
+        float *const samples
+        )
+    {
+        switch(curve)
+        {
+        case Magnitude: magnitude(parameters, min_x, max_x, log_base_or_0, num_samples, samples); break;
+        case MagnitudeDecibels: magnitude_decibels(parameters, min_x, max_x, log_base_or_0, num_samples, samples); break;
+        case PhaseTurns: phase_turns(parameters, min_x, max_x, log_base_or_0, num_samples, samples); break;
+        }
+    }
+
+    // NOTE: a few dozen samples to a column of the unzoomed plot, so a narrow peak between two columns isn't missed
+    uint const DENSE_CURVE_NUM_SAMPLES = 1 << 14;
+
+    // NOTE: a curve over the whole plot, sampled far finer than it is drawn, see curve_vertices
+    struct DenseCurve
+    {
+        MinMaxPyramid::Pyramid pyramid;
+        // NOTE: what the pyramid was built for
+        bool built;
+        Parameters parameters;
+        Curve curve;
+        double min_x;
+        double max_x;
+        double log_base_or_0;
+        uint num_builds;
+    };
+
+    void
+    initialize(DenseCurve *const dense)
+    {
+        MinMaxPyramid::initialize(&dense->pyramid);
+        dense->built = false;
+        dense->num_builds = 0;
+    }
+
+    void
+    release(DenseCurve *const dense)
+    {
+        MinMaxPyramid::release(&dense->pyramid);
+        dense->built = false;
+    }
+
+    // NOTE:
+    // Two vertices for each of num_columns columns from min_x to max_x, the minimum and the maximum of the curve there.
+    // They are decimated from a pyramid of the curve sampled from whole_min_x to whole_max_x, which is only sampled
+    // again when the parameters, the curve or the axis change, not when the plot is panned or zoomed.
+    // Zoomed in so far that the pyramid has fewer samples than there are columns, the curve is sampled directly,
+    // at evenly spaced points so the vertices are laid out the same.
+    void
+    curve_vertices(
+        Parameters const*const parameters,
+        Curve const curve,
+        double const whole_min_x,
+        double const whole_max_x,
+        double const min_x,
+        double const max_x,
+        double const log_base_or_0,
+        uint const num_columns,
+        DenseCurve *const dense,
+        float *const vertices
+        )
+    {
+        bool const up_to_date =
+            dense->built &&
+            dense->curve == curve &&
+            dense->min_x == whole_min_x &&
+            dense->max_x == whole_max_x &&
+            dense->log_base_or_0 == log_base_or_0 &&
+            memcmp(&dense->parameters, parameters, sizeof(*parameters)) == 0;
+        if(!up_to_date)
+        {
+            dense->built = false;
+            float *const samples = MinMaxPyramid::begin(DENSE_CURVE_NUM_SAMPLES, whole_min_x, whole_max_x, &dense->pyramid);
+            if(samples != 0)
+            {
+                sample(parameters, curve, whole_min_x, whole_max_x, log_base_or_0, DENSE_CURVE_NUM_SAMPLES, samples);
+                MinMaxPyramid::build_levels(&dense->pyramid);
+                dense->built = true;
+                dense->parameters = *parameters;
+                dense->curve = curve;
+                dense->min_x = whole_min_x;
+                dense->max_x = whole_max_x;
+                dense->log_base_or_0 = log_base_or_0;
+                dense->num_builds++;
+            }
+        }
+
+        if(dense->built && MinMaxPyramid::resolves(&dense->pyramid, min_x, max_x, num_columns))
+        {
+            MinMaxPyramid::decimate(&dense->pyramid, min_x, max_x, num_columns, vertices);
+        }
+        else
+        {
+            sample(parameters, curve, min_x, max_x, log_base_or_0, 2*num_columns, vertices);
+        }
+    }
+
+}
@@ -0,0 +1,244 @@
+// NOTE:
+// Root locus: the closed loop poles of the filter under a feedback gain K, that is the roots of den(z) + K num(z).
+// Instead of sweeping K over [0, infinity) we sweep t over [0, 1] in (1 - t) den(z) + t num(z), which has the
+// same roots for K = t/(1 - t), stays monic, and ends exactly on the zeros.
+//
+// The sweep is cut into chunks of consecutive gain steps. Each chunk runs in one SIMD lane, warm starting every
+// root solve from the roots of the previous step, and the chunks are spread over the worker threads.
+// The first step of a chunk warm starts from the previous sweep instead, if there is one, since the parameters
+// only move a little between frames while dragging.
+// Warm starting keeps the root order within a chunk, and the chunks are stitched together afterwards
+// so that every root traces one unbroken trajectory.
+namespace RootLocus
+{
+
+    uint const ORDER = 4;
+    uint const NUM_STEPS_PER_CHUNK = 64;
+    uint const NUM_CHUNKS = 32;
+    uint const NUM_STEPS = NUM_STEPS_PER_CHUNK*NUM_CHUNKS;
+    // NOTE: one line strip of NUM_STEPS vertices per root
+    uint const NUM_VERTICES = ORDER*NUM_STEPS;
+
+    static_assert(NUM_CHUNKS % Simd::NUM_LANES == 0, "every task must fill all SIMD lanes");
+
+    struct Locus
+    {
+        // NOTE: step_idx*ORDER + root_idx
+        float* roots_real;
+        float* roots_imaginary;
+        // NOTE: (root_idx*NUM_STEPS + step_idx)*2, x and y of each vertex, ready for upload
+        float* vertices;
+        // NOTE: the roots are from a previous sweep and can be used as a starting point
+        bool has_roots;
+        Polynomial::Statistics stats;
+    };
+
+    bool
+    initialize(Locus *const locus)
+    {
+        size_t const num_floats = 2*size_t(NUM_VERTICES) + 2*size_t(NUM_VERTICES);
+        float *const memory = (float*)Platform::allocate_memory(sizeof(float)*num_floats);
+        if(memory == 0)
+            return false;
+        locus->roots_real = memory;
+        locus->roots_imaginary = locus->roots_real + NUM_VERTICES;
+        locus->vertices = locus->roots_imaginary + NUM_VERTICES;
+        locus->has_roots = false;
+        Polynomial::reset(&locus->stats);
+        return true;
+    }
+
+    // NOTE: multiplies out (z - p)(z - conj(p))(z - q)(z - conj(q)), lowest power first
+    void
+    expand(Complex::C const*const factors, float *const coefficients)
+    {
+        float quadratic[2][3];
+        for(int i=0; i<2; i++)
+        {
+            float const re = factors[i].component.real;
+            float const im = factors[i].component.imaginary;
+            quadratic[i][0] = re*re + im*im;
+            quadratic[i][1] = -2.0f*re;
+            quadratic[i][2] = 1.0f;
+        }
+        for(int k=0; k <= int(ORDER); k++)
+        {
+            coefficients[k] = 0.0f;
+            for(int a=0; a <= 2; a++)
+            {
+                int const b = k - a;
+                if(b >= 0 && b <= 2)
+                    coefficients[k] += quadratic[0][a]*quadratic[1][b];
+            }
+        }
+    }
+
+    struct SweepJob
+    {
+        float numerator[ORDER+1];
+        float denominator[ORDER+1];
+        Polynomial::Settings settings;
+        Locus* locus;
+        Polynomial::Statistics task_statistics[NUM_CHUNKS/Simd::NUM_LANES];
+    };
+
+    void
+    sweep_task(void* data, uint task_idx)
+    {
+        SweepJob *const job = (SweepJob*)data;
+        Locus *const locus = job->locus;
+        Polynomial::Statistics *const stats = &job->task_statistics[task_idx];
+        Polynomial::reset(stats);
+
+        Polynomial::Batch batch;
+        for(uint step_in_chunk_idx=0; step_in_chunk_idx < NUM_STEPS_PER_CHUNK; step_in_chunk_idx++)
+        {
+            for(uint lane_idx=0; lane_idx < Simd::NUM_LANES; lane_idx++)
+            {
+                uint const chunk_idx = task_idx*Simd::NUM_LANES + lane_idx;
+                uint const step_idx = chunk_idx*NUM_STEPS_PER_CHUNK + step_in_chunk_idx;
+                float const t = float(step_idx)/float(NUM_STEPS - 1);
+                for(uint k=0; k <= ORDER; k++)
+                {
+                    batch.coefficients[k][lane_idx] = Numerics::lerp(job->denominator[k], job->numerator[k], t);
+                }
+            }
+
+            // NOTE: past the first step, the roots are still in the batch from the previous step
+            if(step_in_chunk_idx == 0)
+            {
+                if(locus->has_roots)
+                {
+                    for(uint lane_idx=0; lane_idx < Simd::NUM_LANES; lane_idx++)
+                    {
+                        uint const step_idx = (task_idx*Simd::NUM_LANES + lane_idx)*NUM_STEPS_PER_CHUNK;
+                        for(uint root_idx=0; root_idx < ORDER; root_idx++)
+                        {
+                            batch.roots_real[root_idx][lane_idx] = locus->roots_real[step_idx*ORDER + root_idx];
+                            batch.roots_imaginary[root_idx][lane_idx] = locus->roots_imaginary[step_idx*ORDER + root_idx];
+                        }
+                    }
+                }
+                else
+                {
+                    Polynomial::initial_guess(ORDER, &batch);
+                }
+            }
+
+            Polynomial::iterate(ORDER, &job->settings, &batch);
+            Polynomial::accumulate_statistics(&batch, Simd::NUM_LANES, stats);
+
+            for(uint lane_idx=0; lane_idx < Simd::NUM_LANES; lane_idx++)
+            {
+                uint const chunk_idx = task_idx*Simd::NUM_LANES + lane_idx;
+                uint const step_idx = chunk_idx*NUM_STEPS_PER_CHUNK + step_in_chunk_idx;
+                for(uint root_idx=0; root_idx < ORDER; root_idx++)
+                {
+                    locus->roots_real[step_idx*ORDER + root_idx] = batch.roots_real[root_idx][lane_idx];
+                    locus->roots_imaginary[step_idx*ORDER + root_idx] = batch.roots_imaginary[root_idx][lane_idx];
+                }
+            }
+        }
+    }
+
+    // NOTE:
+    // Reorders the roots of every step of the chunk with the permutation that best continues the last step of the
+    // previous chunk. There are only 24 permutations of four roots, so all of them are tried.
+    void
+    stitch_chunk(uint const chunk_idx, Locus *const locus)
+    {
+        assert(chunk_idx > 0);
+        uint const previous_step_idx = chunk_idx*NUM_STEPS_PER_CHUNK - 1;
+        uint const first_step_idx = chunk_idx*NUM_STEPS_PER_CHUNK;
+
+        float distance_squared[ORDER][ORDER];
+        for(uint i=0; i < ORDER; i++)
+        {
+            for(uint j=0; j < ORDER; j++)
+            {
+                distance_squared[i][j] =
+                    Numerics::square(locus->roots_real[previous_step_idx*ORDER + i] - locus->roots_real[first_step_idx*ORDER + j]) +
+                    Numerics::square(locus->roots_imaginary[previous_step_idx*ORDER + i] - locus->roots_imaginary[first_step_idx*ORDER + j]);
+            }
+        }
+
+        uint best_permutation[ORDER] = {0, 1, 2, 3};
+        float best_cost = POSITIVE_INFINITY_FLOAT;
+        uint permutation[ORDER];
+        for(permutation[0]=0; permutation[0] < ORDER; permutation[0]++)
+        {
+            for(permutation[1]=0; permutation[1] < ORDER; permutation[1]++)
+            {
+                if(permutation[1] == permutation[0])
+                    continue;
+                for(permutation[2]=0; permutation[2] < ORDER; permutation[2]++)
+                {
+                    if(permutation[2] == permutation[0] || permutation[2] == permutation[1])
+                        continue;
+                    permutation[3] = 0+1+2+3 - permutation[0] - permutation[1] - permutation[2];
+
+                    float cost = 0.0f;
+                    for(uint i=0; i < ORDER; i++)
+                    {
+                        cost += distance_squared[i][permutation[i]];
+                    }
+                    if(cost < best_cost)
+                    {
+                        best_cost = cost;
+                        memcpy(best_permutation, permutation, sizeof(permutation));
+                    }
+                }
+            }
+        }
+
+        for(uint step_idx=first_step_idx; step_idx < first_step_idx + NUM_STEPS_PER_CHUNK; step_idx++)
+        {
+            float re[ORDER];
+            float im[ORDER];
+            for(uint i=0; i < ORDER; i++)
+            {
+                re[i] = locus->roots_real[step_idx*ORDER + best_permutation[i]];
+                im[i] = locus->roots_imaginary[step_idx*ORDER + best_permutation[i]];
+            }
+            memcpy(&locus->roots_real[step_idx*ORDER], re, sizeof(re));
+            memcpy(&locus->roots_imaginary[step_idx*ORDER], im, sizeof(im));
+        }
+    }
+
+    void
+    sweep(Parameters const*const parameters, Locus *const locus)
+    {
+        SweepJob job;
+        expand(parameters->ator_factors[0], job.numerator);
+        expand(parameters->ator_factors[1], job.denominator);
+        job.settings = Polynomial::default_settings();
+        job.locus = locus;
+
+        uint const num_tasks = NUM_CHUNKS/Simd::NUM_LANES;
+        Platform::parallel_for(num_tasks, sweep_task, &job);
+
+        Polynomial::reset(&locus->stats);
+        for(uint task_idx=0; task_idx < num_tasks; task_idx++)
+        {
+            Polynomial::merge(&job.task_statistics[task_idx], &locus->stats);
+        }
+
+        // NOTE: each chunk continues the already stitched one before it, so this has to go in order
+        for(uint chunk_idx=1; chunk_idx < NUM_CHUNKS; chunk_idx++)
+        {
+            stitch_chunk(chunk_idx, locus);
+        }
+        locus->has_roots = true;
+
+        for(uint root_idx=0; root_idx < ORDER; root_idx++)
+        {
+            for(uint step_idx=0; step_idx < NUM_STEPS; step_idx++)
+            {
+                float *const vertex = &locus->vertices[(root_idx*NUM_STEPS + step_idx)*2];
+                vertex[0] = locus->roots_real[step_idx*ORDER + root_idx];
+                vertex[1] = locus->roots_imaginary[step_idx*ORDER + root_idx];
+            }
+        }
+    }
+
+}
@@ -12,12 +12,13 @@ cbuffer Layout : register(b1)
 
 cbuffer Plot : register(b2)
 {
-    // NOTE: rectangle giving the visible portion of the data
+    // NOTE: rectangle giving the visible portion of the data, x is relative to the left edge (so x lo is zero)
     float4 plotviewport_lo_x_hi_x_lo_y_hi_y_data;
     // NOTE: rectanle giving the plot rectangle on the viewport
     float4 plotviewport_lo_x_hi_x_lo_y_hi_y_viewport;
     float4 curve_interval_x_data_margin_x_dimension_viewport_unused;
     uint num_curve_slices;
+    float4 curve_color;
 };
 
 
@@ -146,7 +147,7 @@ ScreenVertex plot_transform(float curve_y_data : POSITION, uint vertex_idx: SV_V
     vs.position_screen.y = curve_y_viewport;
     vs.position_screen.z = 0.0f;
     vs.position_screen.w = 1.0f;
-    vs.color = float4(1.0f, 1.0f, 0.0f, 1.0f);
+    vs.color = curve_color;
     
     return vs;    
 
@@ -218,6 +219,40 @@ ScreenVertex dynamic_transform(Vertex v, uint instance : SV_InstanceID)
     return vs;
 }
 
+// NOTE: root locus vertices are in data coordinates, like the marker centers
+ScreenVertex locus_transform(Vertex v)
+{
+    ScreenVertex vs;
+
+    float2 center = center_scale.xy;
+    float scale_x = center_scale.z;
+    float scale_y = center_scale.w;
+
+    vs.color = float4(1.0f, 0.5f, 0.0f, 1.0f);
+    vs.position_screen.xy = center + v.position*float2(scale_x, scale_y);
+    vs.position_screen.z = 0.0f;
+    vs.position_screen.w = 1.0f;
+
+    return vs;
+}
+
+// NOTE: contour vertices are in data coordinates too
+ScreenVertex contour_transform(Vertex v)
+{
+    ScreenVertex vs;
+
+    float2 center = center_scale.xy;
+    float scale_x = center_scale.z;
+    float scale_y = center_scale.w;
+
+    vs.color = float4(0.2f, 0.6f, 1.0f, 1.0f);
+    vs.position_screen.xy = center + v.position*float2(scale_x, scale_y);
+    vs.position_screen.z = 0.0f;
+    vs.position_screen.w = 1.0f;
+
+    return vs;
+}
+
 float2 conjugate(float2 p)
 {
     p.y = -p.y;
@@ -0,0 +1,287 @@
+// NOTE: four-wide float operations on SSE2, which every x64 target has.
+// Loads and stores are unaligned, so plain float[4] arrays can be used as lanes.
+namespace Simd
+{
+
+    typedef __m128 Float4;
+
+    uint const NUM_LANES = 4;
+
+    struct Complex4
+    {
+        Float4 real;
+        Float4 imaginary;
+    };
+
+    inline Float4
+    set(float const x)
+    {
+        return _mm_set1_ps(x);
+    }
+
+    inline Float4
+    set(float const x0, float const x1, float const x2, float const x3)
+    {
+        return _mm_setr_ps(x0, x1, x2, x3);
+    }
+
+    inline Float4
+    zero()
+    {
+        return _mm_setzero_ps();
+    }
+
+    inline Float4
+    load(float const*const x)
+    {
+        return _mm_loadu_ps(x);
+    }
+
+    inline void
+    store(Float4 const a, float *const x)
+    {
+        _mm_storeu_ps(x, a);
+    }
+
+    inline Float4
+    add(Float4 const a, Float4 const b)
+    {
+        return _mm_add_ps(a, b);
+    }
+
+    inline Float4
+    subtract(Float4 const a, Float4 const b)
+    {
+        return _mm_sub_ps(a, b);
+    }
+
+    inline Float4
+    multiply(Float4 const a, Float4 const b)
+    {
+        return _mm_mul_ps(a, b);
+    }
+
+    inline Float4
+    divide(Float4 const a, Float4 const b)
+    {
+        return _mm_div_ps(a, b);
+    }
+
+    inline Float4
+    minimum(Float4 const a, Float4 const b)
+    {
+        return _mm_min_ps(a, b);
+    }
+
+    inline Float4
+    maximum(Float4 const a, Float4 const b)
+    {
+        return _mm_max_ps(a, b);
+    }
+
+    inline Float4
+    square_root(Float4 const a)
+    {
+        return _mm_sqrt_ps(a);
+    }
+
+    inline Float4
+    absolute_value(Float4 const a)
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+    }
+
+    // NOTE: comparisons give a mask, all bits set in a lane where the comparison holds
+    inline Float4
+    less_than(Float4 const a, Float4 const b)
+    {
+        return _mm_cmplt_ps(a, b);
+    }
+
+    inline Float4
+    greater_than(Float4 const a, Float4 const b)
+    {
+        return _mm_cmpgt_ps(a, b);
+    }
+
+    inline Float4
+    mask_and(Float4 const a, Float4 const b)
+    {
+        return _mm_and_ps(a, b);
+    }
+
+    inline Float4
+    mask_or(Float4 const a, Float4 const b)
+    {
+        return _mm_or_ps(a, b);
+    }
+
+    inline Float4
+    mask_not(Float4 const a)
+    {
+        return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+    }
+
+    // NOTE: picks a where the mask is set and b elsewhere
+    inline Float4
+    select(Float4 const mask, Float4 const a, Float4 const b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // NOTE:
+    // SSE2 has no rounding instructions, so this truncates and steps down for negative non-integers.
+    // Only meant for magnitudes that fit in an int.
+    inline Float4
+    floor(Float4 const x)
+    {
+        Float4 const truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        return subtract(truncated, mask_and(greater_than(truncated, x), set(1.0f)));
+    }
+
+    inline bool
+    any(Float4 const mask)
+    {
+        return _mm_movemask_ps(mask) != 0;
+    }
+
+    inline bool
+    all(Float4 const mask)
+    {
+        return _mm_movemask_ps(mask) == 0xf;
+    }
+
+    // NOTE: bit i is set if lane i of the mask is
+    inline uint
+    mask_bits(Float4 const mask)
+    {
+        return (uint)_mm_movemask_ps(mask);
+    }
+
+    // NOTE: truncates towards zero, like a cast to int
+    inline void
+    store_truncated(Float4 const a, int32 *const x)
+    {
+        _mm_storeu_si128((__m128i*)x, _mm_cvttps_epi32(a));
+    }
+
+    inline float
+    lane(Float4 const a, uint const lane_idx)
+    {
+        assert(lane_idx < NUM_LANES);
+        float x[NUM_LANES];
+        store(a, x);
+        return x[lane_idx];
+    }
+
+    inline float
+    horizontal_maximum(Float4 const a)
+    {
+        float x[NUM_LANES];
+        store(a, x);
+        return Numerics::maximum(Numerics::maximum(x[0], x[1]), Numerics::maximum(x[2], x[3]));
+    }
+
+    // NOTE:
+    // Base 2 logarithm: the exponent is read off the float bits, and the logarithm of the mantissa (in [1, 2))
+    // comes from a polynomial fit, good to about 3E-6. Only meant for positive normal numbers.
+    inline Float4
+    logarithm2(Float4 const x)
+    {
+        __m128i const bits = _mm_castps_si128(x);
+        __m128i const exponent = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+        Float4 const mantissa =
+            _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+
+        Float4 const t = subtract(mantissa, set(1.0f));
+        Float4 p = set(-0.025792345f);
+        p = add(multiply(p, t), set(0.121472948f));
+        p = add(multiply(p, t), set(-0.277341646f));
+        p = add(multiply(p, t), set(0.457158121f));
+        p = add(multiply(p, t), set(-0.71803359f));
+        p = add(multiply(p, t), set(1.44253478f));
+        p = multiply(p, t);
+
+        return add(_mm_cvtepi32_ps(exponent), p);
+    }
+
+    // NOTE:
+    // Base 2 exponential: the integer part of x goes into the exponent bits, the fractional part through a
+    // polynomial fit, good to about 1E-7 relative. x is clamped so that the result stays a normal number.
+    inline Float4
+    exponential2(Float4 x)
+    {
+        x = minimum(maximum(x, set(-126.0f)), set(126.0f));
+
+        // NOTE: truncation rounds towards zero, so step down for negative non-integers to get the floor
+        __m128i integer = _mm_cvttps_epi32(x);
+        Float4 integer_float = _mm_cvtepi32_ps(integer);
+        Float4 const too_large = greater_than(integer_float, x);
+        integer = _mm_add_epi32(integer, _mm_castps_si128(too_large));
+        integer_float = subtract(integer_float, mask_and(too_large, set(1.0f)));
+
+        Float4 const t = subtract(x, integer_float);
+        Float4 p = set(0.00189510729f);
+        p = add(multiply(p, t), set(0.00894621467f));
+        p = add(multiply(p, t), set(0.0558632827f));
+        p = add(multiply(p, t), set(0.24014077f));
+        p = add(multiply(p, t), set(0.69315462f));
+        p = add(multiply(p, t), set(0.999999896f));
+
+        return _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(p), _mm_slli_epi32(integer, 23)));
+    }
+
+    inline Complex4
+    complex(Float4 const real, Float4 const imaginary)
+    {
+        Complex4 z;
+        z.real = real;
+        z.imaginary = imaginary;
+        return z;
+    }
+
+    inline Complex4
+    complex_add(Complex4 const a, Complex4 const b)
+    {
+        return complex(add(a.real, b.real), add(a.imaginary, b.imaginary));
+    }
+
+    inline Complex4
+    complex_subtract(Complex4 const a, Complex4 const b)
+    {
+        return complex(subtract(a.real, b.real), subtract(a.imaginary, b.imaginary));
+    }
+
+    inline Complex4
+    complex_multiply(Complex4 const a, Complex4 const b)
+    {
+        return complex(
+            subtract(multiply(a.real, b.real), multiply(a.imaginary, b.imaginary)),
+            add(multiply(a.real, b.imaginary), multiply(a.imaginary, b.real))
+            );
+    }
+
+    inline Float4
+    complex_magnitude_squared(Complex4 const a)
+    {
+        return add(multiply(a.real, a.real), multiply(a.imaginary, a.imaginary));
+    }
+
+    // NOTE: n/d, the caller is responsible for d being non-zero
+    inline Complex4
+    complex_quotient(Complex4 const n, Complex4 const d)
+    {
+        Float4 const d_sq = complex_magnitude_squared(d);
+        return complex(
+            divide(add(multiply(n.real, d.real), multiply(n.imaginary, d.imaginary)), d_sq),
+            divide(subtract(multiply(n.imaginary, d.real), multiply(n.real, d.imaginary)), d_sq)
+            );
+    }
+
+    inline Complex4
+    complex_select(Float4 const mask, Complex4 const a, Complex4 const b)
+    {
+        return complex(select(mask, a.real, b.real), select(mask, a.imaginary, b.imaginary));
+    }
+
+}
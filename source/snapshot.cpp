@@ -0,0 +1,839 @@
+// NOTE:
+// Renders the whole window on the CPU and writes it out as a binary PPM, for making thumbnails without a GPU or a
+// window. That is both widget circles with their markers, the grids with their labels, both curves and both
+// color bars, laid out like the application does it, recorded by FramePasses like the application records it and
+// executed with SoftwareRender.
+// "-snapshot <view_file>" runs a view file, a small script of settings where every "snapshot <file>" writes out
+// the frame as set up so far, so a single run can make any number of images. See run_view_file for the format.
+// "-benchmark_frame_recording <num_frames>" times sampling the curves of a frame on the worker threads against one
+// after the other, and recording it, on walls of more and more plots.
+namespace Snapshot
+{
+
+    uint const MAX_DOWNSAMPLING = 16;
+
+    struct View
+    {
+        Parameters parameters;
+        bool magnitude_plot_decibels;
+        bool log_frequency_axis;
+        int widget_zoom;
+        // NOTE: per plot, the magnitude plot first
+        double plotviewport_center_x_plotdata[2];
+        double plotviewport_center_y_plotdata[2];
+        int x_zoom_level_plotdata[2];
+        int y_zoom_level_plotdata[2];
+        // NOTE: the image is this many times smaller than the window, each of its pixels the average of a block
+        uint downsampling;
+    };
+
+    void
+    set_magnitude_plot_decibels(bool const decibels, View *const view)
+    {
+        view->magnitude_plot_decibels = decibels;
+        view->plotviewport_center_y_plotdata[0] =
+            decibels ? FramePasses::MAGNITUDE_PLOT_CENTER_Y_DECIBELS : FramePasses::MAGNITUDE_PLOT_CENTER_Y_LINEAR;
+    }
+
+    void
+    set_log_frequency_axis(bool const logarithmic, View *const view)
+    {
+        view->log_frequency_axis = logarithmic;
+        for(uint plot_idx=0; plot_idx < 2; plot_idx++)
+        {
+            view->plotviewport_center_x_plotdata[plot_idx] =
+                logarithmic ? -0.5f*FramePasses::FREQUENCY_PLOT_NUM_DECADES : FramePasses::FREQUENCY_PLOT_CENTER_X_LINEAR;
+        }
+    }
+
+    // NOTE: what the application starts up with
+    void
+    initialize(View *const view)
+    {
+        Parameters parameters = {};
+        Complex::set_polar(0.25f, PI_FLOAT*0.25f, &parameters.parameter.zero[0]);
+        Complex::set_polar(0.75f, PI_FLOAT*0.5f, &parameters.parameter.zero[1]);
+        Complex::set_polar(0.25f, PI_FLOAT*0.1f, &parameters.parameter.pole[0]);
+        Complex::set_polar(0.75f, PI_FLOAT*0.75f, &parameters.parameter.pole[1]);
+        view->parameters = parameters;
+        view->widget_zoom = 0;
+        for(uint plot_idx=0; plot_idx < 2; plot_idx++)
+        {
+            view->x_zoom_level_plotdata[plot_idx] = 0;
+            view->y_zoom_level_plotdata[plot_idx] = 0;
+        }
+        view->plotviewport_center_y_plotdata[1] = FramePasses::PHASE_PLOT_CENTER_Y;
+        set_magnitude_plot_decibels(false, view);
+        set_log_frequency_axis(false, view);
+        view->downsampling = 1;
+    }
+
+    // NOTE: the most plots a frame can have, a whole wall of them for the frame benchmark
+    uint const MAX_NUM_PLOTS = 64;
+
+    struct Renderer
+    {
+        SoftwareRender::Framebuffer framebuffer;
+        RenderCommands::CommandList commands;
+        // NOTE: its density cache pays off since snapshots of a view file tend to differ in a zero or pole at a time
+        RenderCommands::SoftwareExecutor executor;
+        // NOTE: of the last snapshot
+        RenderCommands::Statistics command_stats;
+        // NOTE: of the frame being recorded
+        FramePasses::Plot plots[MAX_NUM_PLOTS];
+        // NOTE: of each plot, rebuilt when the next snapshot changes what it shows
+        Response::DenseCurve dense_curves[MAX_NUM_PLOTS];
+        float curve_vertices[MAX_NUM_PLOTS][FramePasses::NUM_CURVE_VERTICES];
+        Grid::LabelCache::Cache label_cache;
+        Grid::GlyphBatch::Batch glyph_batch;
+        Grid::Layout::Axis grid_layouts[MAX_NUM_PLOTS][Grid::Orientation::NumOrientations];
+        uint32 font_pixels[Grid::FONT_TEXTURE_X_DIMENSION_SCREEN*Grid::FONT_TEXTURE_Y_DIMENSION_SCREEN];
+        // NOTE: room for the largest image, header included
+        uint8* image;
+        uint image_capacity;
+    };
+
+    uint const PPM_MAX_HEADER_SIZE = 32;
+
+    // NOTE: the caller frees the renderer with release, and then Platform::free_memory
+    Renderer*
+    create_renderer()
+    {
+        Renderer *const renderer = (Renderer*)Platform::allocate_memory(sizeof(Renderer));
+        if(renderer == 0)
+        {
+            Platform::log_line_string("failed to allocate the snapshot renderer");
+            return 0;
+        }
+
+        uint const x_dimension = FramePasses::VIEWPORT_X_DIMENSION_SCREEN;
+        uint const y_dimension = FramePasses::VIEWPORT_Y_DIMENSION_SCREEN;
+        if(!SoftwareRender::initialize(x_dimension, y_dimension, &renderer->framebuffer))
+        {
+            Platform::free_memory(renderer);
+            return 0;
+        }
+
+        renderer->image_capacity = PPM_MAX_HEADER_SIZE + 3*x_dimension*y_dimension;
+        renderer->image = (uint8*)Platform::allocate_memory(renderer->image_capacity);
+        if(renderer->image == 0)
+        {
+            Platform::log_line_string("failed to allocate the snapshot image");
+            SoftwareRender::release(&renderer->framebuffer);
+            Platform::free_memory(renderer);
+            return 0;
+        }
+
+        if(!RenderCommands::initialize(&renderer->commands))
+        {
+            Platform::free_memory(renderer->image);
+            SoftwareRender::release(&renderer->framebuffer);
+            Platform::free_memory(renderer);
+            return 0;
+        }
+
+        RenderCommands::initialize(renderer->font_pixels, &renderer->executor);
+        RenderCommands::reset_statistics(&renderer->command_stats);
+        for(uint plot_idx=0; plot_idx < MAX_NUM_PLOTS; plot_idx++)
+        {
+            Response::initialize(&renderer->dense_curves[plot_idx]);
+        }
+        Grid::LabelCache::initialize(&renderer->label_cache);
+        Grid::GlyphBatch::initialize(1.0f, &renderer->glyph_batch);
+        for(uint plot_idx=0; plot_idx < MAX_NUM_PLOTS; plot_idx++)
+        {
+            for(uint orientation_idx=0; orientation_idx < Grid::Orientation::NumOrientations; orientation_idx++)
+            {
+                Grid::Layout::initialize(&renderer->grid_layouts[plot_idx][orientation_idx]);
+            }
+        }
+        Grid::font_texture(renderer->font_pixels);
+        return renderer;
+    }
+
+    void
+    release(Renderer *const renderer)
+    {
+        Platform::free_memory(renderer->image);
+        for(uint plot_idx=0; plot_idx < MAX_NUM_PLOTS; plot_idx++)
+        {
+            Response::release(&renderer->dense_curves[plot_idx]);
+        }
+        RenderCommands::release(&renderer->executor);
+        RenderCommands::release(&renderer->commands);
+        SoftwareRender::release(&renderer->framebuffer);
+    }
+
+    // NOTE: what both kinds of frame share, the window, the widgets and the caches of the renderer
+    void
+    begin_frame(View const*const view, Renderer *const renderer, FramePasses::Frame *const frame)
+    {
+        SoftwareRender::Framebuffer const*const framebuffer = &renderer->framebuffer;
+        frame->viewport_x_dimension_screen = framebuffer->x_dimension;
+        frame->viewport_y_dimension_screen = framebuffer->y_dimension;
+        frame->parameters = &view->parameters;
+
+        float const widgetdata_unit_widgetviewport = Numerics::power(1.1f, float(view->widget_zoom));
+        for(uint widget_idx=0; widget_idx < 2; widget_idx++)
+        {
+            WidgetLayoutConstants *const layout = &frame->widget_layouts[widget_idx];
+            *layout = {};
+            layout->center_x_position_viewport =
+                -1.0f + float(FramePasses::WIDGETVIEWPORT_X_DIMENSION_SCREEN)/float(FramePasses::VIEWPORT_X_DIMENSION_SCREEN);
+            layout->center_y_position_viewport = widget_idx == 0 ? +0.5f : -0.5f;
+            layout->data_x_unit_viewport =
+                widgetdata_unit_widgetviewport*
+                float(FramePasses::WIDGETVIEWPORT_X_DIMENSION_SCREEN)/float(FramePasses::VIEWPORT_X_DIMENSION_SCREEN);
+            layout->data_y_unit_viewport =
+                widgetdata_unit_widgetviewport*
+                float(FramePasses::WIDGETVIEWPORT_Y_DIMENSION_SCREEN)/float(FramePasses::VIEWPORT_Y_DIMENSION_SCREEN);
+        }
+        frame->contours_or_0 = 0;
+        frame->contours_changed = false;
+        frame->locus_or_0 = 0;
+        frame->locus_changed = false;
+
+        frame->character_spacing_screen = FramePasses::CHARACTER_SPACING_SCREEN;
+        frame->max_num_label_characters = int(FramePasses::PLOTVIEWPORTMARGIN_DIMENSION_CHARACTERS);
+        frame->grid_base = FramePasses::GRID_BASE;
+        frame->smallest_visible_horizontal_level_spacing_viewport = 10.0f*2.0f/float(framebuffer->y_dimension);
+        frame->smallest_visible_vertical_level_spacing_viewport = 15.0f*2.0f/float(framebuffer->x_dimension);
+        frame->label_cache = &renderer->label_cache;
+        frame->glyph_batch = &renderer->glyph_batch;
+
+        frame->plots = renderer->plots;
+        frame->num_plots = 0;
+        frame->log_frequency_axis = view->log_frequency_axis;
+        frame->frequency_plot_min_x_logarithmic = FramePasses::FREQUENCY_PLOT_MIN_X_LOGARITHMIC;
+        frame->frequency_log_base_or_0 = view->log_frequency_axis ? double(FramePasses::GRID_BASE) : 0.0;
+        frame->num_curve_slices = FramePasses::NUM_CURVE_SLICES;
+    }
+
+    // NOTE: the plot's caches in the renderer, and no fit target, a view file can't draw one
+    void
+    begin_plot(Renderer *const renderer, uint const plot_idx, FramePasses::Plot *const plot)
+    {
+        plot->fit_target_or_0 = 0;
+        plot->dense_curve = &renderer->dense_curves[plot_idx];
+        plot->grid_layouts = renderer->grid_layouts[plot_idx];
+        plot->curve_vertices = renderer->curve_vertices[plot_idx];
+    }
+
+    // NOTE: see the top of WinMain
+    void
+    view_frame(View const*const view, Renderer *const renderer, FramePasses::Frame *const frame)
+    {
+        uint const plotviewportmargin_dimension_screen =
+            Grid::message_width_screen(
+                FramePasses::CHARACTER_SPACING_SCREEN,
+                FramePasses::PLOTVIEWPORTMARGIN_DIMENSION_CHARACTERS
+                );
+        float const plotviewport_x_dimension_screen =
+            0.7f*(FramePasses::VIEWPORT_X_DIMENSION_SCREEN - FramePasses::WIDGETVIEWPORT_X_DIMENSION_SCREEN);
+        float const plotviewport_y_dimension_screen =
+            float(FramePasses::WIDGETVIEWPORT_Y_DIMENSION_SCREEN) - float(plotviewportmargin_dimension_screen);
+        float const screen_x_unit_viewport = 2.0f/float(FramePasses::VIEWPORT_X_DIMENSION_SCREEN);
+        float const screen_y_unit_viewport = 2.0f/float(FramePasses::VIEWPORT_Y_DIMENSION_SCREEN);
+        float const plotviewport_x_dimension_viewport = plotviewport_x_dimension_screen*screen_x_unit_viewport;
+        float const plotviewport_y_dimension_viewport = plotviewport_y_dimension_screen*screen_y_unit_viewport;
+        float const plotviewportmargin_x_dimension_viewport = float(plotviewportmargin_dimension_screen)*screen_x_unit_viewport;
+        float const widgetviewport_x_dimension_viewport =
+            float(FramePasses::WIDGETVIEWPORT_X_DIMENSION_SCREEN)*screen_x_unit_viewport;
+        float const plotviewport_center_x_viewport =
+            -1.0f + widgetviewport_x_dimension_viewport + (2.0f - widgetviewport_x_dimension_viewport)/2.0f;
+        float const plotviewport_max_y_viewport[2] = {+1.0f, 0.0f};
+
+        begin_frame(view, renderer, frame);
+        frame->num_plots = 2;
+        for(uint plot_idx=0; plot_idx < 2; plot_idx++)
+        {
+            float const plotviewport_unzoomed_x_dimension_plotdata =
+                view->log_frequency_axis ?
+                FramePasses::FREQUENCY_PLOT_NUM_DECADES*FramePasses::FREQUENCY_PLOT_UNZOOMED_X_DIMENSION_LINEAR[plot_idx] :
+                FramePasses::FREQUENCY_PLOT_UNZOOMED_X_DIMENSION_LINEAR[plot_idx];
+            float const plotviewport_unzoomed_y_dimension_plotdata =
+                plot_idx == 1 ? FramePasses::PHASE_PLOT_UNZOOMED_Y_DIMENSION :
+                view->magnitude_plot_decibels ? FramePasses::MAGNITUDE_PLOT_UNZOOMED_Y_DIMENSION_DECIBELS :
+                FramePasses::MAGNITUDE_PLOT_UNZOOMED_Y_DIMENSION_LINEAR;
+            float const x_zoom_plotdata = float(view->x_zoom_level_plotdata[plot_idx])*FramePasses::ZOOM_STEP_SIZE;
+            float const y_zoom_plotdata = float(view->y_zoom_level_plotdata[plot_idx])*FramePasses::ZOOM_STEP_SIZE;
+            double const plotviewport_x_dimension_plotdata =
+                plotviewport_unzoomed_x_dimension_plotdata*
+                Numerics::power(double(FramePasses::GRID_BASE), -double(x_zoom_plotdata));
+            double const plotviewport_y_dimension_plotdata =
+                plotviewport_unzoomed_y_dimension_plotdata*
+                Numerics::power(double(FramePasses::GRID_BASE), -double(y_zoom_plotdata));
+
+            FramePasses::Plot *const plot = &frame->plots[plot_idx];
+            begin_plot(renderer, plot_idx, plot);
+            plot->min_x_viewport = plotviewport_center_x_viewport - plotviewport_x_dimension_viewport/2.0f;
+            plot->max_x_viewport = plotviewport_center_x_viewport + plotviewport_x_dimension_viewport/2.0f;
+            plot->min_y_viewport = plotviewport_max_y_viewport[plot_idx] - plotviewport_y_dimension_viewport;
+            plot->max_y_viewport = plotviewport_max_y_viewport[plot_idx];
+            plot->margin_x_dimension_viewport = plotviewportmargin_x_dimension_viewport;
+            plot->x_transform.viewport_min_data =
+                view->plotviewport_center_x_plotdata[plot_idx] - plotviewport_x_dimension_plotdata*0.5;
+            plot->x_transform.viewport_max_data =
+                view->plotviewport_center_x_plotdata[plot_idx] + plotviewport_x_dimension_plotdata*0.5;
+            plot->y_transform.viewport_min_data =
+                view->plotviewport_center_y_plotdata[plot_idx] - plotviewport_y_dimension_plotdata*0.5;
+            plot->y_transform.viewport_max_data =
+                view->plotviewport_center_y_plotdata[plot_idx] + plotviewport_y_dimension_plotdata*0.5;
+            plot->curve =
+                plot_idx == 1 ? Response::PhaseTurns :
+                view->magnitude_plot_decibels ? Response::MagnitudeDecibels :
+                Response::Magnitude;
+        }
+    }
+
+    void
+    execute(Renderer *const renderer)
+    {
+        RenderCommands::execute(&renderer->commands, &renderer->executor, &renderer->framebuffer, &renderer->command_stats);
+    }
+
+    // NOTE: the whole window, recorded like the application records it and executed on the CPU
+    void
+    render(View const*const view, Renderer *const renderer)
+    {
+        FramePasses::Frame frame;
+        view_frame(view, renderer, &frame);
+        FramePasses::sample_curves(&frame, true);
+        FramePasses::record(&frame, &renderer->commands);
+        execute(renderer);
+    }
+
+    // NOTE: writes the digits of x to string, returns how many
+    uint
+    decimal(uint x, uint8 *const string)
+    {
+        uint8 digits[10];
+        uint num_digits = 0;
+        do
+        {
+            digits[num_digits++] = uint8('0' + x % 10);
+            x /= 10;
+        }
+        while(x != 0);
+        for(uint digit_idx=0; digit_idx < num_digits; digit_idx++)
+        {
+            string[digit_idx] = digits[num_digits - 1 - digit_idx];
+        }
+        return num_digits;
+    }
+
+    // NOTE: binary PPM, the framebuffer shrunk by the view's downsampling, alpha is left out
+    bool
+    write_ppm(char *const file_name, uint const downsampling, Renderer *const renderer)
+    {
+        SoftwareRender::Framebuffer const*const framebuffer = &renderer->framebuffer;
+        uint const x_dimension = framebuffer->x_dimension/downsampling;
+        uint const y_dimension = framebuffer->y_dimension/downsampling;
+
+        uint8 *const image = renderer->image;
+        uint size = 0;
+        image[size++] = 'P';
+        image[size++] = '6';
+        image[size++] = '\n';
+        size += decimal(x_dimension, &image[size]);
+        image[size++] = ' ';
+        size += decimal(y_dimension, &image[size]);
+        image[size++] = '\n';
+        size += decimal(255, &image[size]);
+        image[size++] = '\n';
+        assert(size <= PPM_MAX_HEADER_SIZE);
+
+        uint const num_block_pixels = downsampling*downsampling;
+        for(uint y=0; y < y_dimension; y++)
+        {
+            for(uint x=0; x < x_dimension; x++)
+            {
+                uint sums[3] = {};
+                for(uint block_y=0; block_y < downsampling; block_y++)
+                {
+                    uint32 const*const row = &framebuffer->pixels[(y*downsampling + block_y)*framebuffer->x_dimension];
+                    for(uint block_x=0; block_x < downsampling; block_x++)
+                    {
+                        uint32 const pixel = row[x*downsampling + block_x];
+                        for(uint channel_idx=0; channel_idx < 3; channel_idx++)
+                        {
+                            sums[channel_idx] += (pixel >> (8*channel_idx)) & 0xff;
+                        }
+                    }
+                }
+                for(uint channel_idx=0; channel_idx < 3; channel_idx++)
+                {
+                    image[size++] = uint8((sums[channel_idx] + num_block_pixels/2)/num_block_pixels);
+                }
+            }
+        }
+        assert(size <= renderer->image_capacity);
+
+        return Platform::write_file(file_name, image, size);
+    }
+
+    struct Statistics
+    {
+        uint num_snapshots;
+        float render_seconds;
+        float write_seconds;
+        // NOTE: what executing the commands of the last snapshot took
+        RenderCommands::Statistics last_commands;
+    };
+
+    // NOTE: copies the next token, separated by whitespace, skipping '#' comments. Returns false at the end of the text.
+    bool
+    next_token(
+        char const*const text,
+        uint const text_size,
+        uint *const idx,
+        char *const token,
+        uint const token_capacity,
+        bool *const too_long
+        )
+    {
+        *too_long = false;
+        while(*idx < text_size)
+        {
+            char const c = text[*idx];
+            if(c == '#')
+            {
+                while(*idx < text_size && text[*idx] != '\n')
+                    (*idx)++;
+                continue;
+            }
+            if(c == ' ' || c == '\t' || c == '\r' || c == '\n')
+            {
+                (*idx)++;
+                continue;
+            }
+            break;
+        }
+        if(*idx >= text_size)
+            return false;
+
+        uint token_length = 0;
+        while(*idx < text_size)
+        {
+            char const c = text[*idx];
+            if(c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '#')
+                break;
+            if(token_length + 1 >= token_capacity)
+            {
+                *too_long = true;
+                return false;
+            }
+            token[token_length++] = c;
+            (*idx)++;
+        }
+        token[token_length] = 0;
+        return true;
+    }
+
+    // NOTE: the next token as a number, logs what went wrong otherwise
+    bool
+    next_number(char const*const text, uint const text_size, uint *const idx, char const*const keyword, double *const x)
+    {
+        char token[64];
+        bool too_long;
+        if(!next_token(text, text_size, idx, token, (uint)ARRAY_LENGTH(token), &too_long))
+        {
+            Platform::log_string("error: missing number after '");
+            Platform::log_string(keyword);
+            Platform::log_line_string("' in view file");
+            return false;
+        }
+        char* token_end = 0;
+        *x = strtod(token, &token_end);
+        if(*token == 0 || *token_end != 0)
+        {
+            Platform::log_string("error: could not parse '");
+            Platform::log_string(token);
+            Platform::log_string("' after '");
+            Platform::log_string(keyword);
+            Platform::log_line_string("' in view file");
+            return false;
+        }
+        return true;
+    }
+
+    inline bool
+    plot_idx_valid(double const plot_idx)
+    {
+        if(plot_idx == 0.0 || plot_idx == 1.0)
+            return true;
+        Platform::log_line_string("error: the plot index in a view file is 0 (magnitude) or 1 (phase)");
+        return false;
+    }
+
+    // NOTE:
+    // View file format, one setting per line, everything from a '#' to the end of the line is ignored:
+    //   zero <real> <imaginary>       the zeros, one of each conjugate pair, every two replace the previous two
+    //   pole <real> <imaginary>       the poles, the same way
+    //   decibels <0 or 1>             magnitude in decibels, recenters the magnitude plot like F2 does
+    //   log_frequency <0 or 1>        logarithmic frequency axis, recenters the plots like F5 does
+    //   widget_zoom <steps>           zoom of the widgets, in mouse wheel steps
+    //   zoom <plot> <x steps> <y steps>   zoom of a plot (0 magnitude, 1 phase), in mouse wheel steps
+    //   center <plot> <x> <y>         center of a plot, in its data coordinates
+    //   downsampling <factor>         the images are this many times smaller than the window
+    //   snapshot <file name>          renders everything set so far and writes it to the file
+    // Settings stay in effect for the following snapshots, which start out from what the application starts up with.
+    bool
+    run_view_file(char *const file_name, Statistics *const stats)
+    {
+        stats->num_snapshots = 0;
+        stats->render_seconds = 0.0f;
+        stats->write_seconds = 0.0f;
+        RenderCommands::reset_statistics(&stats->last_commands);
+
+        Platform::ReadFileResult const file = Platform::read_file(file_name);
+        if(file.contents == 0)
+        {
+            Platform::log_string("error: could not read view file ");
+            Platform::log_line_string(file_name);
+            return false;
+        }
+
+        Renderer *const renderer = create_renderer();
+        if(renderer == 0)
+        {
+            Platform::free_file_memory(file.contents);
+            return false;
+        }
+
+        View view;
+        initialize(&view);
+        uint num_zeros = 0;
+        uint num_poles = 0;
+
+        char const*const text = (char*)file.contents;
+        uint const text_size = file.contents_size;
+        uint idx = 0;
+        bool ok = true;
+        char keyword[32];
+        bool too_long = false;
+        while(ok && next_token(text, text_size, &idx, keyword, (uint)ARRAY_LENGTH(keyword), &too_long))
+        {
+            if(strcmp(keyword, "zero") == 0 || strcmp(keyword, "pole") == 0)
+            {
+                double real;
+                double imaginary;
+                ok = next_number(text, text_size, &idx, keyword, &real) && next_number(text, text_size, &idx, keyword, &imaginary);
+                if(ok)
+                {
+                    bool const zero = keyword[0] == 'z';
+                    uint *const num = zero ? &num_zeros : &num_poles;
+                    Complex::C *const p = zero ? &view.parameters.parameter.zero[*num % 2] : &view.parameters.parameter.pole[*num % 2];
+                    p->component.real = float(real);
+                    p->component.imaginary = float(imaginary);
+                    (*num)++;
+                }
+            }
+            else if(strcmp(keyword, "decibels") == 0)
+            {
+                double x;
+                ok = next_number(text, text_size, &idx, keyword, &x);
+                if(ok)
+                    set_magnitude_plot_decibels(x != 0.0, &view);
+            }
+            else if(strcmp(keyword, "log_frequency") == 0)
+            {
+                double x;
+                ok = next_number(text, text_size, &idx, keyword, &x);
+                if(ok)
+                    set_log_frequency_axis(x != 0.0, &view);
+            }
+            else if(strcmp(keyword, "widget_zoom") == 0)
+            {
+                double x;
+                ok = next_number(text, text_size, &idx, keyword, &x);
+                if(ok)
+                    view.widget_zoom = int(x);
+            }
+            else if(strcmp(keyword, "zoom") == 0)
+            {
+                double plot_idx;
+                double x;
+                double y;
+                ok =
+                    next_number(text, text_size, &idx, keyword, &plot_idx) &&
+                    next_number(text, text_size, &idx, keyword, &x) &&
+                    next_number(text, text_size, &idx, keyword, &y) &&
+                    plot_idx_valid(plot_idx);
+                if(ok)
+                {
+                    view.x_zoom_level_plotdata[int(plot_idx)] = int(x);
+                    view.y_zoom_level_plotdata[int(plot_idx)] = int(y);
+                }
+            }
+            else if(strcmp(keyword, "center") == 0)
+            {
+                double plot_idx;
+                double x;
+                double y;
+                ok =
+                    next_number(text, text_size, &idx, keyword, &plot_idx) &&
+                    next_number(text, text_size, &idx, keyword, &x) &&
+                    next_number(text, text_size, &idx, keyword, &y) &&
+                    plot_idx_valid(plot_idx);
+                if(ok)
+                {
+                    view.plotviewport_center_x_plotdata[int(plot_idx)] = x;
+                    view.plotviewport_center_y_plotdata[int(plot_idx)] = y;
+                }
+            }
+            else if(strcmp(keyword, "downsampling") == 0)
+            {
+                double x;
+                ok = next_number(text, text_size, &idx, keyword, &x);
+                if(ok && (x < 1.0 || x > double(MAX_DOWNSAMPLING)))
+                {
+                    Platform::log_line_string("error: downsampling in a view file goes from 1 to 16");
+                    ok = false;
+                }
+                if(ok)
+                    view.downsampling = uint(x);
+            }
+            else if(strcmp(keyword, "snapshot") == 0)
+            {
+                char image_file_name[MAX_PATH];
+                ok = next_token(text, text_size, &idx, image_file_name, (uint)ARRAY_LENGTH(image_file_name), &too_long);
+                if(!ok)
+                {
+                    Platform::log_line_string("error: missing file name after 'snapshot' in view file");
+                    break;
+                }
+
+                Platform::TimeCount const render_start = Platform::time_get_count();
+                render(&view, renderer);
+                Platform::TimeCount const write_start = Platform::time_get_count();
+                ok = write_ppm(image_file_name, view.downsampling, renderer);
+                Platform::TimeCount const write_end = Platform::time_get_count();
+
+                stats->render_seconds += Platform::time_duration_seconds(render_start, write_start);
+                stats->write_seconds += Platform::time_duration_seconds(write_start, write_end);
+                stats->last_commands = renderer->command_stats;
+                if(ok)
+                    stats->num_snapshots++;
+            }
+            else
+            {
+                Platform::log_string("error: unknown setting '");
+                Platform::log_string(keyword);
+                Platform::log_line_string("' in view file");
+                ok = false;
+            }
+        }
+        if(too_long)
+        {
+            Platform::log_line_string("error: setting too long in view file");
+            ok = false;
+        }
+
+        release(renderer);
+        Platform::free_memory(renderer);
+        Platform::free_file_memory(file.contents);
+        return ok;
+    }
+
+    void
+    log_statistics(Statistics const*const stats)
+    {
+        Platform::log_string("snapshots: ");
+        Platform::log_uint32(stats->num_snapshots);
+        Platform::log_string(", render seconds: ");
+        Platform::log_float(stats->render_seconds);
+        Platform::log_string(", write seconds: ");
+        Platform::log_float(stats->write_seconds);
+        Platform::log_string(", snapshots per second: ");
+        float const seconds = stats->render_seconds + stats->write_seconds;
+        Platform::log_float(seconds > 0.0f ? float(stats->num_snapshots)/seconds : 0.0f);
+        Platform::log_line();
+        Platform::log_string("last snapshot: ");
+        RenderCommands::log_statistics(&stats->last_commands);
+    }
+
+
+    // NOTE:
+    // A wall of num_plots plots right of the widgets, magnitude and phase in turn, each zoomed and panned a little
+    // differently every frame, like a drag, so the grids lay out and label again every frame.
+    void
+    wall_frame(
+        View const*const view,
+        uint const num_plots,
+        uint const frame_idx,
+        Renderer *const renderer,
+        FramePasses::Frame *const frame
+        )
+    {
+        assert(num_plots > 0 && num_plots <= MAX_NUM_PLOTS);
+
+        uint num_columns = 1;
+        while(num_columns*num_columns < num_plots)
+        {
+            num_columns++;
+        }
+        uint const num_rows = (num_plots + num_columns - 1)/num_columns;
+        float const min_x_viewport =
+            -1.0f + 2.0f*float(FramePasses::WIDGETVIEWPORT_X_DIMENSION_SCREEN)/float(FramePasses::VIEWPORT_X_DIMENSION_SCREEN);
+        float const cell_x_dimension_viewport = (1.0f - min_x_viewport)/float(num_columns);
+        float const cell_y_dimension_viewport = 2.0f/float(num_rows);
+
+        begin_frame(view, renderer, frame);
+        frame->num_plots = num_plots;
+        for(uint plot_idx=0; plot_idx < num_plots; plot_idx++)
+        {
+            float const cell_min_x_viewport = min_x_viewport + float(plot_idx % num_columns)*cell_x_dimension_viewport;
+            float const cell_max_y_viewport = 1.0f - float(plot_idx / num_columns)*cell_y_dimension_viewport;
+
+            // NOTE: the labels and the color bar go left of the plot, and below it
+            FramePasses::Plot *const plot = &frame->plots[plot_idx];
+            begin_plot(renderer, plot_idx, plot);
+            plot->min_x_viewport = cell_min_x_viewport + 0.3f*cell_x_dimension_viewport;
+            plot->max_x_viewport = cell_min_x_viewport + 0.95f*cell_x_dimension_viewport;
+            plot->min_y_viewport = cell_max_y_viewport - 0.8f*cell_y_dimension_viewport;
+            plot->max_y_viewport = cell_max_y_viewport - 0.05f*cell_y_dimension_viewport;
+            plot->margin_x_dimension_viewport = 0.25f*cell_x_dimension_viewport;
+
+            uint const curve_idx = plot_idx % 2;
+            double const x_dimension_plotdata =
+                FramePasses::FREQUENCY_PLOT_UNZOOMED_X_DIMENSION_LINEAR[curve_idx]*
+                Numerics::power(double(FramePasses::GRID_BASE), -0.05*double((frame_idx + plot_idx) % 32));
+            double const center_x_plotdata =
+                FramePasses::FREQUENCY_PLOT_CENTER_X_LINEAR + 0.01*double((frame_idx + 3*plot_idx) % 16);
+            double const y_dimension_plotdata =
+                curve_idx == 1 ? FramePasses::PHASE_PLOT_UNZOOMED_Y_DIMENSION : FramePasses::MAGNITUDE_PLOT_UNZOOMED_Y_DIMENSION_LINEAR;
+            double const center_y_plotdata =
+                curve_idx == 1 ? FramePasses::PHASE_PLOT_CENTER_Y : FramePasses::MAGNITUDE_PLOT_CENTER_Y_LINEAR;
+            plot->x_transform.viewport_min_data = center_x_plotdata - 0.5*x_dimension_plotdata;
+            plot->x_transform.viewport_max_data = center_x_plotdata + 0.5*x_dimension_plotdata;
+            plot->y_transform.viewport_min_data = center_y_plotdata - 0.5*y_dimension_plotdata;
+            plot->y_transform.viewport_max_data = center_y_plotdata + 0.5*y_dimension_plotdata;
+            plot->curve = curve_idx == 1 ? Response::PhaseTurns : Response::Magnitude;
+        }
+    }
+
+    struct FrameBenchmarkResult
+    {
+        uint num_plots;
+        uint num_worker_threads;
+        uint num_frames;
+        // NOTE: of the last frame
+        uint num_packets;
+        uint num_dropped_packets;
+        // NOTE: pixels where the frames done on the worker threads differ from the ones done one task after the other
+        uint num_mismatches;
+        float serial_sample_seconds;
+        float parallel_sample_seconds;
+        float record_seconds;
+        float execute_seconds;
+    };
+
+    // NOTE:
+    // Times the frames of a wall of plots while the zeros and poles move, so every curve is sampled again every frame,
+    // sampling the curves one after the other against at the same time on the worker threads.
+    // Each way has its own renderer, so neither finds what the other already cached.
+    bool
+    run_frame_benchmark(uint const num_frames, uint const num_plots, FrameBenchmarkResult *const result)
+    {
+        result->num_plots = num_plots;
+        result->num_worker_threads = Platform::num_worker_threads();
+        result->num_frames = 0;
+        result->num_packets = 0;
+        result->num_dropped_packets = 0;
+        result->num_mismatches = 0;
+        result->serial_sample_seconds = 0.0f;
+        result->parallel_sample_seconds = 0.0f;
+        result->record_seconds = 0.0f;
+        result->execute_seconds = 0.0f;
+
+        Renderer *const serial = create_renderer();
+        if(serial == 0)
+        {
+            return false;
+        }
+        Renderer *const parallel = create_renderer();
+        if(parallel == 0)
+        {
+            release(serial);
+            Platform::free_memory(serial);
+            return false;
+        }
+
+        View view;
+        initialize(&view);
+        for(uint frame_idx=0; frame_idx < num_frames; frame_idx++)
+        {
+            SoftwareRender::benchmark_parameters(frame_idx, &view.parameters);
+            FramePasses::Frame serial_frame;
+            wall_frame(&view, num_plots, frame_idx, serial, &serial_frame);
+            FramePasses::Frame parallel_frame;
+            wall_frame(&view, num_plots, frame_idx, parallel, &parallel_frame);
+
+            Platform::TimeCount const serial_start = Platform::time_get_count();
+            FramePasses::sample_curves(&serial_frame, false);
+            Platform::TimeCount const parallel_start = Platform::time_get_count();
+            FramePasses::sample_curves(&parallel_frame, true);
+            Platform::TimeCount const parallel_sampled = Platform::time_get_count();
+            FramePasses::record(&parallel_frame, &parallel->commands);
+            Platform::TimeCount const parallel_end = Platform::time_get_count();
+            execute(parallel);
+            Platform::TimeCount const execute_end = Platform::time_get_count();
+            FramePasses::record(&serial_frame, &serial->commands);
+            execute(serial);
+
+            result->serial_sample_seconds += Platform::time_duration_seconds(serial_start, parallel_start);
+            result->parallel_sample_seconds += Platform::time_duration_seconds(parallel_start, parallel_sampled);
+            result->record_seconds += Platform::time_duration_seconds(parallel_sampled, parallel_end);
+            result->execute_seconds += Platform::time_duration_seconds(parallel_end, execute_end);
+            result->num_frames++;
+            result->num_packets = parallel->command_stats.num_packets;
+            result->num_dropped_packets = parallel->command_stats.num_dropped_packets;
+
+            uint const num_pixels = parallel->framebuffer.x_dimension*parallel->framebuffer.y_dimension;
+            for(uint pixel_idx=0; pixel_idx < num_pixels; pixel_idx++)
+            {
+                if(parallel->framebuffer.pixels[pixel_idx] != serial->framebuffer.pixels[pixel_idx])
+                {
+                    result->num_mismatches++;
+                }
+            }
+        }
+
+        release(parallel);
+        Platform::free_memory(parallel);
+        release(serial);
+        Platform::free_memory(serial);
+        return true;
+    }
+
+    void
+    log_frame_benchmark_result(FrameBenchmarkResult const*const result)
+    {
+        float const frames = float(Numerics::maximum(1, int(result->num_frames)));
+        Platform::log_string("frame recording: plots: ");
+        Platform::log_uint32(result->num_plots);
+        Platform::log_string(", worker threads: ");
+        Platform::log_uint32(result->num_worker_threads);
+        Platform::log_string(", frames: ");
+        Platform::log_uint32(result->num_frames);
+        Platform::log_line();
+        Platform::log_string("  ms per frame, sampling one after the other ");
+        Platform::log_float(1.0E3f*result->serial_sample_seconds/frames);
+        Platform::log_string(", sampling on the worker threads ");
+        Platform::log_float(1.0E3f*result->parallel_sample_seconds/frames);
+        Platform::log_string(", recording ");
+        Platform::log_float(1.0E3f*result->record_seconds/frames);
+        Platform::log_string(", execute ");
+        Platform::log_float(1.0E3f*result->execute_seconds/frames);
+        Platform::log_line();
+        Platform::log_string("  packets: ");
+        Platform::log_uint32(result->num_packets);
+        Platform::log_string(", dropped packets: ");
+        Platform::log_uint32(result->num_dropped_packets);
+        Platform::log_string(", mismatched pixels: ");
+        Platform::log_uint32(result->num_mismatches);
+        Platform::log_line();
+    }
+
+}
@@ -0,0 +1,2214 @@
+// NOTE:
+// Draws the widget circles on the CPU, for machines without D3D11.
+// The density and domain_coloring pixel shaders of shaders.hlsl are evaluated four pixels of a row at a time,
+// and the part of the framebuffer covered by the circle is split into tiles that are shaded in parallel.
+// The circle is placed by the same WidgetLayoutConstants as on the GPU, in viewport coordinates.
+// Both shaders only ever output a handful of colors, so the kernels compute an index into a palette
+// and the palette holds the colors already packed.
+// Away from a DensityCache, density tiles are walked as a quadtree: a node whose distances to the zeros and poles
+// bound the density to a single band is filled without evaluating any of its pixels.
+// "-benchmark_software_render <num_frames>" times it and compares every pixel against a straight scalar port
+// of the shaders, and times dragging a pole with and without a DensityCache, and with a ProgressiveImage.
+// There are also lines, convex polygons and the glyph batch of the grid labels, which is all the snapshots need
+// to draw the rest of the window, and antialiased polylines for the curves, which the benchmark also times.
+namespace SoftwareRender
+{
+
+    uint const TILE_DIMENSION = 64;
+    uint const MAX_NUM_TASKS = 256;
+
+    // NOTE: the density shader quantizes to tenths, and everything above one is white
+    uint const NUM_DENSITY_LEVELS = 11;
+    uint const DENSITY_WHITE_IDX = NUM_DENSITY_LEVELS;
+    uint const NUM_DOMAIN_COLORING_SECTORS = 12;
+
+    // NOTE: 8 bits per channel with red in the lowest byte, rows go from the top of the viewport down
+    struct Framebuffer
+    {
+        uint x_dimension;
+        uint y_dimension;
+        uint32* pixels;
+    };
+
+    enum Shader
+    {
+        Density,
+        DomainColoring,
+        NumShaders
+    };
+
+    bool
+    initialize(uint const x_dimension, uint const y_dimension, Framebuffer *const framebuffer)
+    {
+        framebuffer->x_dimension = x_dimension;
+        framebuffer->y_dimension = y_dimension;
+        framebuffer->pixels = (uint32*)Platform::allocate_memory(sizeof(uint32)*x_dimension*y_dimension);
+        if(framebuffer->pixels == 0)
+        {
+            Platform::log_line_string("failed to allocate the software framebuffer");
+            return false;
+        }
+        return true;
+    }
+
+    void
+    release(Framebuffer *const framebuffer)
+    {
+        Platform::free_memory(framebuffer->pixels);
+        framebuffer->pixels = 0;
+    }
+
+    // NOTE: rounds to nearest, like writing to a UNORM render target
+    uint32
+    pack_color(float const r, float const g, float const b, float const a)
+    {
+        float const channels[4] = {r, g, b, a};
+        uint32 packed = 0;
+        for(uint channel_idx=0; channel_idx < 4; channel_idx++)
+        {
+            uint32 const value = uint32(Numerics::clamp(0.0f, 1.0f, channels[channel_idx])*255.0f + 0.5f);
+            packed |= value << (8*channel_idx);
+        }
+        return packed;
+    }
+
+    void
+    clear(Framebuffer *const framebuffer, float const color[4])
+    {
+        uint32 const packed = pack_color(color[0], color[1], color[2], color[3]);
+        uint const num_pixels = framebuffer->x_dimension*framebuffer->y_dimension;
+        for(uint pixel_idx=0; pixel_idx < num_pixels; pixel_idx++)
+        {
+            framebuffer->pixels[pixel_idx] = packed;
+        }
+    }
+
+    // NOTE: the color of the g'th tenth, straight from the shader
+    void
+    density_level_color(uint const level_idx, float color[4])
+    {
+        if(level_idx == DENSITY_WHITE_IDX)
+        {
+            color[0] = 1.0f; color[1] = 1.0f; color[2] = 1.0f; color[3] = 1.0f;
+            return;
+        }
+        float const g = float(level_idx)/10.0f;
+        color[0] = g*0.8f; color[1] = g*0.95f; color[2] = g*0.8f; color[3] = 1.0f;
+    }
+
+    void
+    domain_coloring_sector_color(uint const sector_idx, float color[4])
+    {
+        float const colors[NUM_DOMAIN_COLORING_SECTORS][3] =
+            {
+                {   1,    0,    0},
+                {   1, 0.5f,    0},
+                {   1,    1,    0},
+                {0.5f,    1,    0},
+                {   0,    1,    0},
+                {   0,    1, 0.5f},
+                {   0,    1,    1},
+                {   0, 0.5f,    1},
+                {   0,    0,    1},
+                {0.5f,    0,    1},
+                {   1,    0,    1},
+                {   1,    0, 0.5f},
+            };
+        for(uint channel_idx=0; channel_idx < 3; channel_idx++)
+        {
+            color[channel_idx] = 0.5f*colors[sector_idx][channel_idx];
+        }
+        color[3] = 1.0f;
+    }
+
+    // NOTE: viewport coordinate of a pixel center, same as the rasterizer
+    inline float
+    x_viewport(uint const x_dimension, float const x_pixel_center)
+    {
+        return -1.0f + 2.0f*x_pixel_center/float(x_dimension);
+    }
+
+    inline float
+    y_viewport(uint const y_dimension, float const y_pixel_center)
+    {
+        return 1.0f - 2.0f*y_pixel_center/float(y_dimension);
+    }
+
+    // NOTE: one field per zero and pole, in the order of Parameters::parameters, each covering the conjugate too
+    uint const NUM_FACTORS = 4;
+
+    // NOTE:
+    // The density widget kept as one field per factor, the product of the distances to the factor and to its
+    // conjugate at every pixel (they always move together), plus the ratio of all the factors but one.
+    // The displayed magnitude is the normalization times that ratio and the one factor left out, so while that
+    // zero or pole is dragged a frame only computes its distances, instead of those of all four.
+    // Once another factor moves, the fields that went stale are brought up to date and the ratio is taken anew.
+    struct DensityCache
+    {
+        // NOTE: what the fields were computed for, a change to any of these recomputes all of them
+        WidgetLayoutConstants layout;
+        uint framebuffer_x_dimension;
+        uint framebuffer_y_dimension;
+        bool valid;
+        Complex::C factors[NUM_FACTORS];
+        // NOTE: the factor left out of the ratio, or NUM_FACTORS. Its own field is out of date.
+        uint dragged_factor_idx;
+        // NOTE: each covers the pixel bounds of the circle, rows padded to whole lanes
+        float* fields[NUM_FACTORS];
+        float* ratio_without_dragged;
+        uint row_stride;
+        uint field_capacity;
+        uint num_draws;
+        uint num_drag_draws;
+        uint num_field_updates;
+    };
+
+    // NOTE: the coarsest pass of a ProgressiveImage evaluates one pixel out of every 4 by 4
+    uint const PROGRESSIVE_COARSEST_BLOCK_DIMENSION = 4;
+    static_assert(TILE_DIMENSION % PROGRESSIVE_COARSEST_BLOCK_DIMENSION == 0, "blocks must not straddle tiles");
+    uint8 const UNCOVERED_PALETTE_IDX = 0xff;
+
+    // NOTE:
+    // The domain coloring widget drawn in passes, coarsest first: a pass with block dimension b evaluates the top
+    // left pixel of every b by b block that the pass before did not, and fills the block with its palette index.
+    // So the passes together evaluate every pixel exactly once, and the last one leaves the same image draw_widget
+    // gives. The coarsest pass is always done at once, the finer ones as far as the time budget of a frame goes.
+    struct ProgressiveImage
+    {
+        // NOTE: what the image is of, a change to any of these starts over from the coarsest pass
+        WidgetLayoutConstants layout;
+        uint framebuffer_x_dimension;
+        uint framebuffer_y_dimension;
+        bool valid;
+        Complex::C factors[NUM_FACTORS];
+        // NOTE: one per pixel of the circle bounds, UNCOVERED_PALETTE_IDX outside of the circle
+        uint8* palette_indices;
+        // NOTE: which pixels are covered only changes with the layout, the next coarsest pass marks them
+        bool coverage_stale;
+        uint row_stride;
+        uint capacity;
+        // NOTE: of the pass in progress, 0 once the image is complete
+        uint block_dimension;
+        uint next_tile_idx;
+    };
+
+    struct Job
+    {
+        Framebuffer* framebuffer;
+        Shader shader;
+        WidgetLayoutConstants layout;
+        // NOTE: real and imaginary parts of the zeros (first index 0) and the poles (first index 1)
+        float points_real[2][2];
+        float points_imaginary[2][2];
+        float normalization_factor;
+        // NOTE:
+        // Only set when the density is drawn from a cache. Either dragged_factor_idx is the one factor to compute,
+        // or the fields with a bit in stale_factors are recomputed and, unless ratio_factor_idx is NUM_FACTORS,
+        // the ratio without that factor is taken.
+        DensityCache* density_cache;
+        uint dragged_factor_idx;
+        uint stale_factors;
+        uint ratio_factor_idx;
+        // NOTE: only set when a pass of a progressive image is drawn, over the tiles from first to end
+        ProgressiveImage* progressive_image;
+        uint block_dimension;
+        uint first_tile_idx;
+        uint end_tile_idx;
+        uint32 palette[NUM_DOMAIN_COLORING_SECTORS];
+        // NOTE: how many pixels each task shaded one by one, the rest was filled by the density quadtree
+        uint task_num_shaded_pixels[MAX_NUM_TASKS];
+        // NOTE: the pixels that might be covered by the circle, ends are one past the last pixel
+        uint min_x_pixel;
+        uint min_y_pixel;
+        uint end_x_pixel;
+        uint end_y_pixel;
+        uint num_x_tiles;
+        uint num_tiles;
+        uint num_tasks;
+    };
+    static_assert(NUM_DENSITY_LEVELS + 1 <= NUM_DOMAIN_COLORING_SECTORS, "the palette needs to fit both shaders");
+
+    // NOTE: |x - p|*|x - conjugate(p)|, one square root for both
+    inline Simd::Float4
+    distance_product(Simd::Complex4 const x, float const real, float const imaginary)
+    {
+        using namespace Simd;
+        Float4 const dx = subtract(x.real, set(real));
+        Float4 const dy = subtract(x.imaginary, set(imaginary));
+        Float4 const dy_conjugate = add(x.imaginary, set(imaginary));
+        Float4 const dx_squared = multiply(dx, dx);
+        return square_root(
+            multiply(add(dx_squared, multiply(dy, dy)), add(dx_squared, multiply(dy_conjugate, dy_conjugate)))
+            );
+    }
+
+    inline Simd::Float4
+    density_level_idx(Simd::Float4 const a)
+    {
+        using namespace Simd;
+        // NOTE: a is never negative, so clamping is just the minimum
+        Float4 const level_idx = floor(multiply(minimum(a, set(1.0f)), set(10.0f)));
+        return select(greater_than(a, set(1.0f)), set(float(DENSITY_WHITE_IDX)), level_idx);
+    }
+
+    inline Simd::Float4
+    density_palette_idx(Job const*const job, Simd::Complex4 const x)
+    {
+        using namespace Simd;
+        Float4 const num =
+            multiply(
+                distance_product(x, job->points_real[0][0], job->points_imaginary[0][0]),
+                distance_product(x, job->points_real[0][1], job->points_imaginary[0][1])
+                );
+        Float4 const den =
+            multiply(
+                distance_product(x, job->points_real[1][0], job->points_imaginary[1][0]),
+                distance_product(x, job->points_real[1][1], job->points_imaginary[1][1])
+                );
+        return density_level_idx(multiply(set(job->normalization_factor), divide(num, den)));
+    }
+
+    inline Simd::Float4
+    cached_density_palette_idx(Job const*const job, Simd::Complex4 const x, uint const field_idx)
+    {
+        using namespace Simd;
+        DensityCache *const cache = job->density_cache;
+        Float4 const normalization_factor = set(job->normalization_factor);
+        float *const ratio_without_dragged = &cache->ratio_without_dragged[field_idx];
+
+        if(job->dragged_factor_idx < NUM_FACTORS)
+        {
+            uint const factor_idx = job->dragged_factor_idx;
+            Float4 const d =
+                distance_product(x, job->points_real[factor_idx/2][factor_idx%2], job->points_imaginary[factor_idx/2][factor_idx%2]);
+            // NOTE: the first two factors are the zeros
+            Float4 const ratio =
+                factor_idx < 2 ? multiply(load(ratio_without_dragged), d) : divide(load(ratio_without_dragged), d);
+            return density_level_idx(multiply(normalization_factor, ratio));
+        }
+
+        Float4 d[NUM_FACTORS];
+        for(uint factor_idx=0; factor_idx < NUM_FACTORS; factor_idx++)
+        {
+            float *const field = &cache->fields[factor_idx][field_idx];
+            if(job->stale_factors & (1u << factor_idx))
+            {
+                d[factor_idx] =
+                    distance_product(x, job->points_real[factor_idx/2][factor_idx%2], job->points_imaginary[factor_idx/2][factor_idx%2]);
+                store(d[factor_idx], field);
+            }
+            else
+            {
+                d[factor_idx] = load(field);
+            }
+        }
+
+        if(job->ratio_factor_idx < NUM_FACTORS)
+        {
+            Float4 num = set(1.0f);
+            Float4 den = set(1.0f);
+            for(uint factor_idx=0; factor_idx < NUM_FACTORS; factor_idx++)
+            {
+                if(factor_idx == job->ratio_factor_idx)
+                    continue;
+                if(factor_idx < 2)
+                    num = multiply(num, d[factor_idx]);
+                else
+                    den = multiply(den, d[factor_idx]);
+            }
+            store(divide(num, den), ratio_without_dragged);
+        }
+
+        // NOTE: grouped like density_palette_idx, so a draw without a dragged factor gives the same pixels
+        return density_level_idx(multiply(normalization_factor, divide(multiply(d[0], d[1]), multiply(d[2], d[3]))));
+    }
+
+    inline Simd::Complex4
+    factor_product(Job const*const job, uint const ator_idx, Simd::Complex4 const x)
+    {
+        using namespace Simd;
+        Complex4 factors[4];
+        for(uint j=0; j<2; j++)
+        {
+            Float4 const real = subtract(x.real, set(job->points_real[ator_idx][j]));
+            factors[2*j + 0] = complex(real, subtract(x.imaginary, set(job->points_imaginary[ator_idx][j])));
+            factors[2*j + 1] = complex(real, add(x.imaginary, set(job->points_imaginary[ator_idx][j])));
+        }
+        return complex_multiply(complex_multiply(factors[0], factors[1]), complex_multiply(factors[2], factors[3]));
+    }
+
+    // NOTE:
+    // The shader takes the phase of num/den with atan2 and picks one of twelve 30 degree sectors.
+    // num*conjugate(den) has the same phase, and the sector follows from comparisons against
+    // tan(30) and tan(60) once the point is turned into the first quadrant, so no division or arctangent is needed.
+    inline Simd::Float4
+    domain_coloring_palette_idx(Job const*const job, Simd::Complex4 const x)
+    {
+        using namespace Simd;
+        Complex4 const num = factor_product(job, 0, x);
+        Complex4 const den = factor_product(job, 1, x);
+        Complex4 const den_conjugate = complex(den.real, subtract(zero(), den.imaginary));
+        Complex4 q = complex_multiply(num, den_conjugate);
+
+        Float4 const zeros = zero();
+        Float4 sector_idx = zeros;
+
+        // NOTE: lower half plane (and the negative real axis, which atan2 puts at +pi) turns by 180 degrees
+        Float4 const lower =
+            mask_or(less_than(q.imaginary, zeros), mask_and(mask_not(greater_than(q.imaginary, zeros)), less_than(q.real, zeros)));
+        q = complex_select(lower, complex(subtract(zeros, q.real), subtract(zeros, q.imaginary)), q);
+        sector_idx = add(sector_idx, mask_and(lower, set(6.0f)));
+
+        // NOTE: second quadrant (and the positive imaginary axis) turns by -90 degrees
+        Float4 const left =
+            mask_or(less_than(q.real, zeros), mask_and(mask_not(greater_than(q.real, zeros)), greater_than(q.imaginary, zeros)));
+        q = complex_select(left, complex(q.imaginary, subtract(zeros, q.real)), q);
+        sector_idx = add(sector_idx, mask_and(left, set(3.0f)));
+
+        Float4 const square_root_3 = set(1.73205081f);
+        Float4 const above_30 = mask_not(less_than(multiply(q.imaginary, square_root_3), q.real));
+        Float4 const above_60 = mask_not(less_than(q.imaginary, multiply(q.real, square_root_3)));
+        sector_idx = add(sector_idx, mask_and(above_30, set(1.0f)));
+        sector_idx = add(sector_idx, mask_and(above_60, set(1.0f)));
+        return sector_idx;
+    }
+
+    // NOTE: the pixels of a tile, ends are one past the last pixel
+    struct Tile
+    {
+        uint min_x_pixel;
+        uint min_y_pixel;
+        uint end_x_pixel;
+        uint end_y_pixel;
+    };
+
+    inline Tile
+    job_tile(Job const*const job, uint const tile_idx)
+    {
+        Tile tile;
+        tile.min_x_pixel = job->min_x_pixel + (tile_idx % job->num_x_tiles)*TILE_DIMENSION;
+        tile.min_y_pixel = job->min_y_pixel + (tile_idx / job->num_x_tiles)*TILE_DIMENSION;
+        tile.end_x_pixel = (uint)Numerics::minimum(int(tile.min_x_pixel + TILE_DIMENSION), int(job->end_x_pixel));
+        tile.end_y_pixel = (uint)Numerics::minimum(int(tile.min_y_pixel + TILE_DIMENSION), int(job->end_y_pixel));
+        return tile;
+    }
+
+    // NOTE:
+    // Widget data x of the pixel centers of a tile's columns, which is the same for every row.
+    // Same operations as x_viewport, so the reference gets the same coordinates.
+    void
+    tile_x_data(Job const*const job, Tile const*const tile, float x_data[TILE_DIMENSION])
+    {
+        using namespace Simd;
+
+        Float4 const lane_offsets = set(0.5f, 1.5f, 2.5f, 3.5f);
+        Float4 const two = set(2.0f);
+        Float4 const x_dimension = set(float(job->framebuffer->x_dimension));
+        Float4 const center_x_viewport = set(job->layout.center_x_position_viewport);
+        Float4 const data_x_unit_viewport = set(job->layout.data_x_unit_viewport);
+        for(uint first_x_pixel=tile->min_x_pixel; first_x_pixel < tile->end_x_pixel; first_x_pixel += NUM_LANES)
+        {
+            Float4 const x_pixel_center = add(set(float(first_x_pixel)), lane_offsets);
+            Float4 const x =
+                divide(
+                    subtract(add(set(-1.0f), divide(multiply(two, x_pixel_center), x_dimension)), center_x_viewport),
+                    data_x_unit_viewport
+                    );
+            store(x, &x_data[first_x_pixel - tile->min_x_pixel]);
+        }
+    }
+
+    inline float
+    row_y_data(Job const*const job, uint const y_pixel)
+    {
+        return
+            (y_viewport(job->framebuffer->y_dimension, float(y_pixel) + 0.5f) - job->layout.center_y_position_viewport)/
+            job->layout.data_y_unit_viewport;
+    }
+
+    // NOTE:
+    // Shades a rectangle of pixels of a tile one by one, x_data is that of the tile, see tile_x_data.
+    // The rectangle starts at a whole lane from the start of the tile. Returns how many pixels were shaded.
+    uint
+    shade_rectangle(
+        Job const*const job,
+        Tile const*const tile,
+        float const x_data[TILE_DIMENSION],
+        uint const min_x_pixel,
+        uint const min_y_pixel,
+        uint const end_x_pixel,
+        uint const end_y_pixel
+        )
+    {
+        using namespace Simd;
+
+        Framebuffer *const framebuffer = job->framebuffer;
+        Float4 const one = set(1.0f);
+        uint num_shaded_pixels = 0;
+
+        for(uint y_pixel=min_y_pixel; y_pixel < end_y_pixel; y_pixel++)
+        {
+            Float4 const y = set(row_y_data(job, y_pixel));
+            Float4 const y_squared = multiply(y, y);
+            uint32 *const row = &framebuffer->pixels[y_pixel*framebuffer->x_dimension];
+
+            for(uint first_x_pixel=min_x_pixel; first_x_pixel < end_x_pixel; first_x_pixel += NUM_LANES)
+            {
+                Float4 const x = load(&x_data[first_x_pixel - tile->min_x_pixel]);
+                uint covered = mask_bits(mask_not(greater_than(add(multiply(x, x), y_squared), one)));
+                uint const num_valid_lanes = end_x_pixel - first_x_pixel;
+                if(num_valid_lanes < NUM_LANES)
+                {
+                    covered &= (1u << num_valid_lanes) - 1;
+                }
+                if(covered == 0)
+                {
+                    continue;
+                }
+
+                Complex4 const position = complex(x, y);
+                Float4 palette_idx;
+                if(job->density_cache != 0)
+                {
+                    uint const field_idx =
+                        (y_pixel - job->min_y_pixel)*job->density_cache->row_stride + (first_x_pixel - job->min_x_pixel);
+                    palette_idx = cached_density_palette_idx(job, position, field_idx);
+                }
+                else if(job->shader == Shader::Density)
+                {
+                    palette_idx = density_palette_idx(job, position);
+                }
+                else
+                {
+                    palette_idx = domain_coloring_palette_idx(job, position);
+                }
+
+                int32 palette_indices[NUM_LANES];
+                store_truncated(palette_idx, palette_indices);
+                uint32 *const pixels = &row[first_x_pixel];
+                // NOTE: inside the circle all four are, and that is most of the time
+                if(covered == 0xf)
+                {
+                    pixels[0] = job->palette[palette_indices[0]];
+                    pixels[1] = job->palette[palette_indices[1]];
+                    pixels[2] = job->palette[palette_indices[2]];
+                    pixels[3] = job->palette[palette_indices[3]];
+                    num_shaded_pixels += NUM_LANES;
+                    continue;
+                }
+                for(uint lane_idx=0; lane_idx < NUM_LANES; lane_idx++)
+                {
+                    if(covered & (1u << lane_idx))
+                    {
+                        pixels[lane_idx] = job->palette[palette_indices[lane_idx]];
+                        num_shaded_pixels++;
+                    }
+                }
+            }
+        }
+        return num_shaded_pixels;
+    }
+
+    // NOTE: quadtree nodes this small are shaded pixel by pixel, a whole number of lanes so they start at one
+    uint const QUADTREE_MIN_DIMENSION = 4;
+    static_assert(QUADTREE_MIN_DIMENSION % Simd::NUM_LANES == 0, "quadtree leaves need to start at whole lanes");
+
+    // NOTE:
+    // The bounds of the density are loosened by this much on either side, which is far more than the rounding of
+    // the shader's few float operations, so a node that is proven to be in one band really is, pixel for pixel.
+    double const DENSITY_BOUND_RELATIVE_MARGIN = 1.0E-5;
+
+    // NOTE: the density band of a magnitude, the same as density_level_idx
+    inline uint
+    density_band(double const a)
+    {
+        return a > 1.0 ? DENSITY_WHITE_IDX : uint(Numerics::floor(Numerics::minimum(a, 1.0)*10.0));
+    }
+
+    // NOTE: nearest and farthest distance of an interval to a point, along one axis
+    inline void
+    interval_distance(double const lo, double const hi, double const p, double *const nearest, double *const farthest)
+    {
+        *nearest = p < lo ? lo - p : p > hi ? p - hi : 0.0;
+        *farthest = Numerics::maximum(Numerics::absolute_value(lo - p), Numerics::absolute_value(hi - p));
+    }
+
+    // NOTE:
+    // Bounds the density over the rectangle of pixel centers [min_x, max_x] by [min_y, max_y] in widget data,
+    // from the nearest and farthest distance to every zero and pole and their conjugates.
+    // Sets the band and returns true if the whole rectangle is proven to be in it.
+    bool
+    density_band_of_rectangle(
+        Job const*const job,
+        double const min_x,
+        double const max_x,
+        double const min_y,
+        double const max_y,
+        uint *const band
+        )
+    {
+        // NOTE: of the zeros (index 0) and the poles (index 1)
+        double nearest_product[2] = {1.0, 1.0};
+        double farthest_product[2] = {1.0, 1.0};
+        for(uint i=0; i<2; i++)
+        {
+            for(uint j=0; j<2; j++)
+            {
+                double x_nearest;
+                double x_farthest;
+                interval_distance(min_x, max_x, double(job->points_real[i][j]), &x_nearest, &x_farthest);
+                for(uint conjugate_idx=0; conjugate_idx < 2; conjugate_idx++)
+                {
+                    double const imaginary =
+                        conjugate_idx == 0 ? double(job->points_imaginary[i][j]) : -double(job->points_imaginary[i][j]);
+                    double y_nearest;
+                    double y_farthest;
+                    interval_distance(min_y, max_y, imaginary, &y_nearest, &y_farthest);
+                    nearest_product[i] *= Numerics::square_root(x_nearest*x_nearest + y_nearest*y_nearest);
+                    farthest_product[i] *= Numerics::square_root(x_farthest*x_farthest + y_farthest*y_farthest);
+                }
+            }
+        }
+
+        // NOTE: right on a pole the density is unbounded, and then only white can be proven
+        double const normalization_factor = double(job->normalization_factor);
+        double const lo = normalization_factor*nearest_product[0]/farthest_product[1];
+        if(nearest_product[1] == 0.0)
+        {
+            *band = DENSITY_WHITE_IDX;
+            return lo*(1.0 - DENSITY_BOUND_RELATIVE_MARGIN) > 1.0;
+        }
+        double const hi = normalization_factor*farthest_product[0]/nearest_product[1];
+        *band = density_band(lo*(1.0 - DENSITY_BOUND_RELATIVE_MARGIN));
+        return density_band(hi*(1.0 + DENSITY_BOUND_RELATIVE_MARGIN)) == *band;
+    }
+
+    // NOTE:
+    // A node of the quadtree a density tile is shaded with, dimension pixels on a side from min_x_pixel, min_y_pixel.
+    // A node that is all inside the circle and proven to be in one band is filled with it, otherwise it is split.
+    uint
+    shade_density_node(
+        Job const*const job,
+        Tile const*const tile,
+        float const x_data[TILE_DIMENSION],
+        uint const min_x_pixel,
+        uint const min_y_pixel,
+        uint const dimension
+        )
+    {
+        uint const end_x_pixel = (uint)Numerics::minimum(int(min_x_pixel + dimension), int(tile->end_x_pixel));
+        uint const end_y_pixel = (uint)Numerics::minimum(int(min_y_pixel + dimension), int(tile->end_y_pixel));
+        if(min_x_pixel >= end_x_pixel || min_y_pixel >= end_y_pixel)
+        {
+            return 0;
+        }
+        if(dimension <= QUADTREE_MIN_DIMENSION)
+        {
+            return shade_rectangle(job, tile, x_data, min_x_pixel, min_y_pixel, end_x_pixel, end_y_pixel);
+        }
+
+        // NOTE: exactly the pixel centers' coordinates, in whichever order the layout puts them
+        float const first_x = x_data[min_x_pixel - tile->min_x_pixel];
+        float const last_x = x_data[end_x_pixel - 1 - tile->min_x_pixel];
+        float const first_y = row_y_data(job, min_y_pixel);
+        float const last_y = row_y_data(job, end_y_pixel - 1);
+        float const min_x = Numerics::minimum(first_x, last_x);
+        float const max_x = Numerics::maximum(first_x, last_x);
+        float const min_y = Numerics::minimum(first_y, last_y);
+        float const max_y = Numerics::maximum(first_y, last_y);
+
+        // NOTE:
+        // Rounded squares and sums only grow with their arguments, so if the pixel center farthest from the
+        // middle passes shade_rectangle's test, all of them do, and if the nearest one fails, all of them do.
+        float const far_x = Numerics::maximum(-min_x, max_x);
+        float const far_y = Numerics::maximum(-min_y, max_y);
+        float const near_x = min_x > 0.0f ? min_x : max_x < 0.0f ? -max_x : 0.0f;
+        float const near_y = min_y > 0.0f ? min_y : max_y < 0.0f ? -max_y : 0.0f;
+        if(near_x*near_x + near_y*near_y > 1.0f)
+        {
+            return 0;
+        }
+
+        uint band;
+        if(
+            far_x*far_x + far_y*far_y <= 1.0f &&
+            density_band_of_rectangle(job, double(min_x), double(max_x), double(min_y), double(max_y), &band)
+            )
+        {
+            Framebuffer *const framebuffer = job->framebuffer;
+            uint32 const color = job->palette[band];
+            for(uint y_pixel=min_y_pixel; y_pixel < end_y_pixel; y_pixel++)
+            {
+                uint32 *const row = &framebuffer->pixels[y_pixel*framebuffer->x_dimension];
+                for(uint x_pixel=min_x_pixel; x_pixel < end_x_pixel; x_pixel++)
+                {
+                    row[x_pixel] = color;
+                }
+            }
+            return 0;
+        }
+
+        uint const half = dimension/2;
+        return
+            shade_density_node(job, tile, x_data, min_x_pixel, min_y_pixel, half) +
+            shade_density_node(job, tile, x_data, min_x_pixel + half, min_y_pixel, half) +
+            shade_density_node(job, tile, x_data, min_x_pixel, min_y_pixel + half, half) +
+            shade_density_node(job, tile, x_data, min_x_pixel + half, min_y_pixel + half, half);
+    }
+
+    // NOTE: returns how many pixels were shaded one by one
+    uint
+    shade_tile(Job const*const job, uint const tile_idx)
+    {
+        Tile const tile = job_tile(job, tile_idx);
+        float x_data[TILE_DIMENSION];
+        tile_x_data(job, &tile, x_data);
+
+        if(job->shader == Shader::Density && job->density_cache == 0)
+        {
+            return shade_density_node(job, &tile, x_data, tile.min_x_pixel, tile.min_y_pixel, TILE_DIMENSION);
+        }
+        return shade_rectangle(job, &tile, x_data, tile.min_x_pixel, tile.min_y_pixel, tile.end_x_pixel, tile.end_y_pixel);
+    }
+
+    void
+    draw_widget_task(void* data, uint task_idx)
+    {
+        Job *const job = (Job*)data;
+        uint num_shaded_pixels = 0;
+        for(uint tile_idx=task_idx; tile_idx < job->num_tiles; tile_idx += job->num_tasks)
+        {
+            num_shaded_pixels += shade_tile(job, tile_idx);
+        }
+        job->task_num_shaded_pixels[task_idx] = num_shaded_pixels;
+    }
+
+    // NOTE: first pixel whose center is at or past the viewport coordinate, clamped to the framebuffer
+    inline uint
+    first_pixel_at(float const pixel_center, uint const dimension)
+    {
+        return (uint)Numerics::clamp(0, int(dimension), int(Numerics::ceiling(pixel_center - 0.5f)));
+    }
+
+    // NOTE: everything about a job but the pixels it covers
+    void
+    set_up_job(
+        Shader const shader,
+        WidgetLayoutConstants const*const layout,
+        Parameters const*const parameters,
+        float const normalization_factor,
+        Framebuffer *const framebuffer,
+        Job *const job
+        )
+    {
+        job->framebuffer = framebuffer;
+        job->shader = shader;
+        job->layout = *layout;
+        for(uint i=0; i<2; i++)
+        {
+            for(uint j=0; j<2; j++)
+            {
+                job->points_real[i][j] = parameters->ator_factors[i][j].component.real;
+                job->points_imaginary[i][j] = parameters->ator_factors[i][j].component.imaginary;
+            }
+        }
+        job->normalization_factor = normalization_factor;
+        job->density_cache = 0;
+        job->dragged_factor_idx = NUM_FACTORS;
+        job->stale_factors = 0;
+        job->ratio_factor_idx = NUM_FACTORS;
+        job->progressive_image = 0;
+        job->block_dimension = 0;
+        job->first_tile_idx = 0;
+        job->end_tile_idx = 0;
+
+        uint const num_colors = shader == Shader::Density ? NUM_DENSITY_LEVELS + 1 : NUM_DOMAIN_COLORING_SECTORS;
+        for(uint color_idx=0; color_idx < num_colors; color_idx++)
+        {
+            float color[4];
+            if(shader == Shader::Density)
+                density_level_color(color_idx, color);
+            else
+                domain_coloring_sector_color(color_idx, color);
+            job->palette[color_idx] = pack_color(color[0], color[1], color[2], color[3]);
+        }
+    }
+
+    // NOTE: the pixels that might be covered by the circle of the job's layout, and the tiles they split into.
+    // Returns false if none are in the framebuffer.
+    bool
+    place_job(Job *const job)
+    {
+        WidgetLayoutConstants const*const layout = &job->layout;
+        Framebuffer const*const framebuffer = job->framebuffer;
+
+        // NOTE: pixel center p is at viewport coordinate -1 + 2*p/dimension (y flipped), see x_viewport
+        float const x_radius_viewport = Numerics::absolute_value(layout->data_x_unit_viewport);
+        float const y_radius_viewport = Numerics::absolute_value(layout->data_y_unit_viewport);
+        float const x_pixels_per_viewport = 0.5f*float(framebuffer->x_dimension);
+        float const y_pixels_per_viewport = 0.5f*float(framebuffer->y_dimension);
+        job->min_x_pixel =
+            first_pixel_at((layout->center_x_position_viewport - x_radius_viewport + 1.0f)*x_pixels_per_viewport, framebuffer->x_dimension);
+        job->end_x_pixel =
+            first_pixel_at((layout->center_x_position_viewport + x_radius_viewport + 1.0f)*x_pixels_per_viewport, framebuffer->x_dimension) + 1;
+        job->min_y_pixel =
+            first_pixel_at((1.0f - layout->center_y_position_viewport - y_radius_viewport)*y_pixels_per_viewport, framebuffer->y_dimension);
+        job->end_y_pixel =
+            first_pixel_at((1.0f - layout->center_y_position_viewport + y_radius_viewport)*y_pixels_per_viewport, framebuffer->y_dimension) + 1;
+        job->end_x_pixel = (uint)Numerics::minimum(int(job->end_x_pixel), int(framebuffer->x_dimension));
+        job->end_y_pixel = (uint)Numerics::minimum(int(job->end_y_pixel), int(framebuffer->y_dimension));
+        if(job->min_x_pixel >= job->end_x_pixel || job->min_y_pixel >= job->end_y_pixel)
+        {
+            return false;
+        }
+
+        job->num_x_tiles = (job->end_x_pixel - job->min_x_pixel + TILE_DIMENSION - 1)/TILE_DIMENSION;
+        uint const num_y_tiles = (job->end_y_pixel - job->min_y_pixel + TILE_DIMENSION - 1)/TILE_DIMENSION;
+        job->num_tiles = job->num_x_tiles*num_y_tiles;
+        job->num_tasks = (uint)Numerics::minimum(int(job->num_tiles), int(MAX_NUM_TASKS));
+        return true;
+    }
+
+    uint
+    run_job(Job *const job)
+    {
+        if(job->num_tasks == 1)
+        {
+            draw_widget_task(job, 0);
+        }
+        else
+        {
+            Platform::parallel_for(job->num_tasks, draw_widget_task, job);
+        }
+
+        uint num_shaded_pixels = 0;
+        for(uint task_idx=0; task_idx < job->num_tasks; task_idx++)
+        {
+            num_shaded_pixels += job->task_num_shaded_pixels[task_idx];
+        }
+        return num_shaded_pixels;
+    }
+
+    // NOTE:
+    // The circle of a widget, shaded like the GPU does with either of the widget pixel shaders.
+    // Returns how many pixels were shaded one by one, which for the density is less than all of them.
+    uint
+    draw_widget(
+        Shader const shader,
+        WidgetLayoutConstants const*const layout,
+        Parameters const*const parameters,
+        float const normalization_factor,
+        Framebuffer *const framebuffer
+        )
+    {
+        Job job;
+        set_up_job(shader, layout, parameters, normalization_factor, framebuffer, &job);
+        if(!place_job(&job))
+        {
+            return 0;
+        }
+        return run_job(&job);
+    }
+
+    void
+    initialize(DensityCache *const cache)
+    {
+        cache->valid = false;
+        cache->dragged_factor_idx = NUM_FACTORS;
+        for(uint factor_idx=0; factor_idx < NUM_FACTORS; factor_idx++)
+        {
+            cache->fields[factor_idx] = 0;
+        }
+        cache->ratio_without_dragged = 0;
+        cache->row_stride = 0;
+        cache->field_capacity = 0;
+        cache->num_draws = 0;
+        cache->num_drag_draws = 0;
+        cache->num_field_updates = 0;
+    }
+
+    void
+    release(DensityCache *const cache)
+    {
+        // NOTE: the fields share one allocation
+        if(cache->fields[0] != 0)
+        {
+            Platform::free_memory(cache->fields[0]);
+        }
+        initialize(cache);
+    }
+
+    inline bool
+    layouts_equal(WidgetLayoutConstants const*const a, WidgetLayoutConstants const*const b)
+    {
+        return
+            a->center_x_position_viewport == b->center_x_position_viewport &&
+            a->center_y_position_viewport == b->center_y_position_viewport &&
+            a->data_x_unit_viewport == b->data_x_unit_viewport &&
+            a->data_y_unit_viewport == b->data_y_unit_viewport;
+    }
+
+    // NOTE: makes the fields cover the pixels of the job, returns false if there is no memory for them
+    bool
+    place_density_cache(Job const*const job, DensityCache *const cache)
+    {
+        Framebuffer const*const framebuffer = job->framebuffer;
+        if(
+            cache->valid &&
+            layouts_equal(&cache->layout, &job->layout) &&
+            cache->framebuffer_x_dimension == framebuffer->x_dimension &&
+            cache->framebuffer_y_dimension == framebuffer->y_dimension
+            )
+        {
+            return true;
+        }
+
+        cache->valid = false;
+        cache->dragged_factor_idx = NUM_FACTORS;
+        uint const row_stride =
+            (job->end_x_pixel - job->min_x_pixel + Simd::NUM_LANES - 1)/Simd::NUM_LANES*Simd::NUM_LANES;
+        uint const field_size = row_stride*(job->end_y_pixel - job->min_y_pixel);
+        if(field_size > cache->field_capacity)
+        {
+            if(cache->fields[0] != 0)
+            {
+                Platform::free_memory(cache->fields[0]);
+            }
+            cache->fields[0] = 0;
+            cache->field_capacity = 0;
+            float *const fields = (float*)Platform::allocate_memory(sizeof(float)*(NUM_FACTORS + 1)*field_size);
+            if(fields == 0)
+            {
+                Platform::log_line_string("failed to allocate the density cache");
+                return false;
+            }
+            for(uint factor_idx=0; factor_idx < NUM_FACTORS; factor_idx++)
+            {
+                cache->fields[factor_idx] = &fields[factor_idx*field_size];
+            }
+            cache->ratio_without_dragged = &fields[NUM_FACTORS*field_size];
+            cache->field_capacity = field_size;
+        }
+        cache->row_stride = row_stride;
+        cache->layout = job->layout;
+        cache->framebuffer_x_dimension = framebuffer->x_dimension;
+        cache->framebuffer_y_dimension = framebuffer->y_dimension;
+        return true;
+    }
+
+    // NOTE:
+    // The density widget like draw_widget draws it, but from the fields of the cache.
+    // A frame where only the zero or pole moves that moved last time computes just that factor.
+    // A frame where a single other factor moves recomputes the fields that are out of date, and leaves out the
+    // factor that moved from the ratio, guessing that it is going to be dragged further.
+    // Any other frame recomputes the fields that are out of date.
+    void
+    draw_density_cached(
+        WidgetLayoutConstants const*const layout,
+        Parameters const*const parameters,
+        float const normalization_factor,
+        DensityCache *const cache,
+        Framebuffer *const framebuffer
+        )
+    {
+        Job job;
+        set_up_job(Shader::Density, layout, parameters, normalization_factor, framebuffer, &job);
+        if(!place_job(&job))
+        {
+            return;
+        }
+        if(!place_density_cache(&job, cache))
+        {
+            run_job(&job);
+            return;
+        }
+
+        uint moved_factors = 0;
+        for(uint factor_idx=0; factor_idx < NUM_FACTORS; factor_idx++)
+        {
+            Complex::C const*const p = &parameters->parameters[factor_idx];
+            Complex::C *const cached = &cache->factors[factor_idx];
+            if(
+                !cache->valid ||
+                cached->component.real != p->component.real ||
+                cached->component.imaginary != p->component.imaginary
+                )
+            {
+                moved_factors |= 1u << factor_idx;
+                *cached = *p;
+            }
+        }
+
+        bool const single_factor_moved = moved_factors != 0 && (moved_factors & (moved_factors - 1)) == 0;
+        uint moved_factor_idx = 0;
+        while(single_factor_moved && (moved_factors >> moved_factor_idx) != 1)
+        {
+            moved_factor_idx++;
+        }
+
+        uint const dragged_factor_idx = cache->dragged_factor_idx;
+        bool const still_dragged =
+            dragged_factor_idx < NUM_FACTORS &&
+            (moved_factors == 0 || (single_factor_moved && moved_factor_idx == dragged_factor_idx));
+        if(still_dragged)
+        {
+            job.dragged_factor_idx = dragged_factor_idx;
+            cache->num_drag_draws++;
+        }
+        else
+        {
+            job.stale_factors = moved_factors;
+            if(dragged_factor_idx < NUM_FACTORS)
+            {
+                job.stale_factors |= 1u << dragged_factor_idx;
+            }
+            job.ratio_factor_idx = single_factor_moved ? moved_factor_idx : NUM_FACTORS;
+            cache->dragged_factor_idx = job.ratio_factor_idx;
+            for(uint factor_idx=0; factor_idx < NUM_FACTORS; factor_idx++)
+            {
+                if(job.stale_factors & (1u << factor_idx))
+                    cache->num_field_updates++;
+            }
+        }
+        cache->valid = true;
+        cache->num_draws++;
+
+        job.density_cache = cache;
+        run_job(&job);
+    }
+
+    void
+    initialize(ProgressiveImage *const image)
+    {
+        image->valid = false;
+        image->palette_indices = 0;
+        image->coverage_stale = true;
+        image->row_stride = 0;
+        image->capacity = 0;
+        image->block_dimension = 0;
+        image->next_tile_idx = 0;
+    }
+
+    void
+    release(ProgressiveImage *const image)
+    {
+        if(image->palette_indices != 0)
+        {
+            Platform::free_memory(image->palette_indices);
+        }
+        initialize(image);
+    }
+
+    // NOTE: makes the image cover the pixels of the job, returns false if there is no memory for it
+    bool
+    place_progressive_image(Job const*const job, ProgressiveImage *const image)
+    {
+        Framebuffer const*const framebuffer = job->framebuffer;
+        if(
+            image->valid &&
+            layouts_equal(&image->layout, &job->layout) &&
+            image->framebuffer_x_dimension == framebuffer->x_dimension &&
+            image->framebuffer_y_dimension == framebuffer->y_dimension
+            )
+        {
+            return true;
+        }
+
+        image->valid = false;
+        uint const row_stride = job->end_x_pixel - job->min_x_pixel;
+        uint const size = row_stride*(job->end_y_pixel - job->min_y_pixel);
+        if(size > image->capacity)
+        {
+            if(image->palette_indices != 0)
+            {
+                Platform::free_memory(image->palette_indices);
+            }
+            image->capacity = 0;
+            image->palette_indices = (uint8*)Platform::allocate_memory(size);
+            if(image->palette_indices == 0)
+            {
+                Platform::log_line_string("failed to allocate the progressive image");
+                return false;
+            }
+            image->capacity = size;
+        }
+        image->row_stride = row_stride;
+        image->coverage_stale = true;
+        image->layout = job->layout;
+        image->framebuffer_x_dimension = framebuffer->x_dimension;
+        image->framebuffer_y_dimension = framebuffer->y_dimension;
+        return true;
+    }
+
+    // NOTE: one pass over a tile, see ProgressiveImage. The coarsest pass also marks which pixels are covered if needed.
+    void
+    refine_tile(Job const*const job, uint const tile_idx)
+    {
+        using namespace Simd;
+
+        ProgressiveImage *const image = job->progressive_image;
+        uint const block_dimension = job->block_dimension;
+        bool const coarsest = block_dimension == PROGRESSIVE_COARSEST_BLOCK_DIMENSION;
+        Tile const tile = job_tile(job, tile_idx);
+
+        float x_data[TILE_DIMENSION];
+        tile_x_data(job, &tile, x_data);
+
+        if(coarsest && image->coverage_stale)
+        {
+            // NOTE: the same test as shade_tile
+            Float4 const one = set(1.0f);
+            for(uint y_pixel=tile.min_y_pixel; y_pixel < tile.end_y_pixel; y_pixel++)
+            {
+                Float4 const y = set(row_y_data(job, y_pixel));
+                Float4 const y_squared = multiply(y, y);
+                uint8 *const row = &image->palette_indices[(y_pixel - job->min_y_pixel)*image->row_stride];
+                for(uint first_x_pixel=tile.min_x_pixel; first_x_pixel < tile.end_x_pixel; first_x_pixel += NUM_LANES)
+                {
+                    Float4 const x = load(&x_data[first_x_pixel - tile.min_x_pixel]);
+                    uint const covered = mask_bits(mask_not(greater_than(add(multiply(x, x), y_squared), one)));
+                    uint const num_lanes = (uint)Numerics::minimum(int(NUM_LANES), int(tile.end_x_pixel - first_x_pixel));
+                    for(uint lane_idx=0; lane_idx < num_lanes; lane_idx++)
+                    {
+                        row[first_x_pixel + lane_idx - job->min_x_pixel] = (covered & (1u << lane_idx)) ? 0 : UNCOVERED_PALETTE_IDX;
+                    }
+                }
+            }
+        }
+
+        for(uint y_pixel=tile.min_y_pixel; y_pixel < tile.end_y_pixel; y_pixel += block_dimension)
+        {
+            // NOTE: on the rows of the pass before, every other block was evaluated already
+            bool const row_of_coarser_pass = !coarsest && (y_pixel - tile.min_y_pixel) % (2*block_dimension) == 0;
+            uint const column_step = row_of_coarser_pass ? 2*block_dimension : block_dimension;
+            uint const first_column = tile.min_x_pixel + (row_of_coarser_pass ? block_dimension : 0);
+            uint const end_y_block = (uint)Numerics::minimum(int(y_pixel + block_dimension), int(tile.end_y_pixel));
+            Float4 const y = set(row_y_data(job, y_pixel));
+
+            for(uint first_x_pixel=first_column; first_x_pixel < tile.end_x_pixel; first_x_pixel += NUM_LANES*column_step)
+            {
+                float x_lanes[NUM_LANES];
+                uint num_lanes = 0;
+                for(uint lane_idx=0; lane_idx < NUM_LANES; lane_idx++)
+                {
+                    uint const x_pixel = first_x_pixel + lane_idx*column_step;
+                    // NOTE: lanes past the end of the tile repeat the last one
+                    if(x_pixel < tile.end_x_pixel)
+                    {
+                        num_lanes++;
+                    }
+                    x_lanes[lane_idx] = x_data[first_x_pixel + (num_lanes - 1)*column_step - tile.min_x_pixel];
+                }
+
+                int32 palette_indices[NUM_LANES];
+                store_truncated(domain_coloring_palette_idx(job, complex(load(x_lanes), y)), palette_indices);
+
+                for(uint lane_idx=0; lane_idx < num_lanes; lane_idx++)
+                {
+                    uint const x_pixel = first_x_pixel + lane_idx*column_step;
+                    uint const end_x_block = (uint)Numerics::minimum(int(x_pixel + block_dimension), int(tile.end_x_pixel));
+                    for(uint block_y=y_pixel; block_y < end_y_block; block_y++)
+                    {
+                        uint8 *const row = &image->palette_indices[(block_y - job->min_y_pixel)*image->row_stride];
+                        for(uint block_x=x_pixel - job->min_x_pixel; block_x < end_x_block - job->min_x_pixel; block_x++)
+                        {
+                            if(row[block_x] != UNCOVERED_PALETTE_IDX)
+                            {
+                                row[block_x] = uint8(palette_indices[lane_idx]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+    }
+
+    void
+    refine_task(void* data, uint task_idx)
+    {
+        Job const*const job = (Job*)data;
+        for(uint tile_idx=job->first_tile_idx + task_idx; tile_idx < job->end_tile_idx; tile_idx += job->num_tasks)
+        {
+            refine_tile(job, tile_idx);
+        }
+    }
+
+    void
+    run_pass(uint const block_dimension, uint const first_tile_idx, uint const end_tile_idx, Job *const job)
+    {
+        job->block_dimension = block_dimension;
+        job->first_tile_idx = first_tile_idx;
+        job->end_tile_idx = end_tile_idx;
+        job->num_tasks = (uint)Numerics::minimum(int(end_tile_idx - first_tile_idx), int(MAX_NUM_TASKS));
+        if(job->num_tasks == 1)
+        {
+            refine_task(job, 0);
+        }
+        else
+        {
+            Platform::parallel_for(job->num_tasks, refine_task, job);
+        }
+    }
+
+    // NOTE:
+    // The domain coloring widget, drawn from a progressive image. When the parameters or the layout change the image
+    // starts over with the coarsest pass, and on the following frames where they don't, as many tiles of the finer
+    // passes are evaluated as fit in the time budget. Returns true once the image is complete, from then on a frame
+    // only copies it.
+    bool
+    draw_domain_coloring_progressive(
+        WidgetLayoutConstants const*const layout,
+        Parameters const*const parameters,
+        float const budget_seconds,
+        ProgressiveImage *const image,
+        Framebuffer *const framebuffer
+        )
+    {
+        Platform::TimeCount const start = Platform::time_get_count();
+
+        Job job;
+        set_up_job(Shader::DomainColoring, layout, parameters, 0.0f, framebuffer, &job);
+        if(!place_job(&job))
+        {
+            return true;
+        }
+        if(!place_progressive_image(&job, image))
+        {
+            run_job(&job);
+            return true;
+        }
+
+        bool restart = !image->valid;
+        for(uint factor_idx=0; factor_idx < NUM_FACTORS; factor_idx++)
+        {
+            Complex::C const*const p = &parameters->parameters[factor_idx];
+            Complex::C *const f = &image->factors[factor_idx];
+            if(f->component.real != p->component.real || f->component.imaginary != p->component.imaginary)
+            {
+                restart = true;
+                *f = *p;
+            }
+        }
+        image->valid = true;
+
+        job.progressive_image = image;
+        if(restart)
+        {
+            run_pass(PROGRESSIVE_COARSEST_BLOCK_DIMENSION, 0, job.num_tiles, &job);
+            image->coverage_stale = false;
+            image->block_dimension = PROGRESSIVE_COARSEST_BLOCK_DIMENSION/2;
+            image->next_tile_idx = 0;
+        }
+
+        // NOTE:
+        // Refining only starts on the first frame where nothing changed, while dragging it would be thrown away.
+        // A batch of tiles per worker at a time, so the budget is checked often enough, and at least one batch a
+        // frame, so the image gets completed however small the budget.
+        uint const batch_size = (uint)Numerics::maximum(1, int(Platform::num_worker_threads()));
+        bool first_batch = true;
+        while(
+            !restart &&
+            image->block_dimension > 0 &&
+            (first_batch || Platform::time_duration_seconds(start, Platform::time_get_count()) < budget_seconds)
+            )
+        {
+            first_batch = false;
+            uint const end_tile_idx = (uint)Numerics::minimum(int(image->next_tile_idx + batch_size), int(job.num_tiles));
+            run_pass(image->block_dimension, image->next_tile_idx, end_tile_idx, &job);
+            image->next_tile_idx = end_tile_idx;
+            if(image->next_tile_idx == job.num_tiles)
+            {
+                image->block_dimension /= 2;
+                image->next_tile_idx = 0;
+            }
+        }
+
+        for(uint y_pixel=job.min_y_pixel; y_pixel < job.end_y_pixel; y_pixel++)
+        {
+            uint8 const*const indices = &image->palette_indices[(y_pixel - job.min_y_pixel)*image->row_stride];
+            uint32 *const row = &framebuffer->pixels[y_pixel*framebuffer->x_dimension + job.min_x_pixel];
+            for(uint x_idx=0; x_idx < job.end_x_pixel - job.min_x_pixel; x_idx++)
+            {
+                if(indices[x_idx] != UNCOVERED_PALETTE_IDX)
+                {
+                    row[x_idx] = job.palette[indices[x_idx]];
+                }
+            }
+        }
+
+        return image->block_dimension == 0;
+    }
+
+    // NOTE: the pixels drawing is limited to, like a scissor rectangle, ends are one past the last pixel
+    struct ClipRectangle
+    {
+        int min_x;
+        int min_y;
+        int end_x;
+        int end_y;
+    };
+
+    inline ClipRectangle
+    whole_framebuffer(Framebuffer const*const framebuffer)
+    {
+        ClipRectangle clip;
+        clip.min_x = 0;
+        clip.min_y = 0;
+        clip.end_x = int(framebuffer->x_dimension);
+        clip.end_y = int(framebuffer->y_dimension);
+        return clip;
+    }
+
+    // NOTE: the inverses of x_viewport and y_viewport, in pixels from the top left corner of the framebuffer
+    inline float
+    x_screen(uint const x_dimension, float const x_viewport)
+    {
+        return (x_viewport + 1.0f)*0.5f*float(x_dimension);
+    }
+
+    inline float
+    y_screen(uint const y_dimension, float const y_viewport)
+    {
+        return (1.0f - y_viewport)*0.5f*float(y_dimension);
+    }
+
+    // NOTE: the blend state of the application, the color is blended by the source alpha and the alpha is replaced
+    inline void
+    blend_pixel(Framebuffer *const framebuffer, int const x, int const y, float const color[4])
+    {
+        uint32 *const pixel = &framebuffer->pixels[uint(y)*framebuffer->x_dimension + uint(x)];
+        float const alpha = color[3];
+        float blended[3];
+        for(uint channel_idx=0; channel_idx < 3; channel_idx++)
+        {
+            float const destination = float((*pixel >> (8*channel_idx)) & 0xff)/255.0f;
+            blended[channel_idx] = color[channel_idx]*alpha + destination*(1.0f - alpha);
+        }
+        *pixel = pack_color(blended[0], blended[1], blended[2], alpha);
+    }
+
+    // NOTE:
+    // A one pixel wide line without antialiasing, in screen pixels. Steps along the longer axis and lights the pixel
+    // the line crosses at each pixel center, leaving out the last one so the segments of a strip don't overlap.
+    void
+    draw_line(
+        float const x0_screen,
+        float const y0_screen,
+        float const x1_screen,
+        float const y1_screen,
+        float const color[4],
+        ClipRectangle const*const clip,
+        Framebuffer *const framebuffer
+        )
+    {
+        float const dx = x1_screen - x0_screen;
+        float const dy = y1_screen - y0_screen;
+        bool const x_major = Numerics::absolute_value(dx) >= Numerics::absolute_value(dy);
+
+        float const major_start = x_major ? Numerics::minimum(x0_screen, x1_screen) : Numerics::minimum(y0_screen, y1_screen);
+        float const major_end = x_major ? Numerics::maximum(x0_screen, x1_screen) : Numerics::maximum(y0_screen, y1_screen);
+        float const major_length = major_end - major_start;
+        if(major_length <= 0.0f)
+        {
+            return;
+        }
+        float const slope = x_major ? dy/dx : dx/dy;
+        float const minor_start = x_major ? y0_screen + (major_start - x0_screen)*slope : x0_screen + (major_start - y0_screen)*slope;
+
+        int const first_idx = int(Numerics::ceiling(major_start - 0.5f));
+        int const end_idx = int(Numerics::ceiling(major_end - 0.5f));
+        for(int major_idx=first_idx; major_idx < end_idx; major_idx++)
+        {
+            float const minor = minor_start + (float(major_idx) + 0.5f - major_start)*slope;
+            int const minor_idx = int(Numerics::floor(minor));
+            int const x = x_major ? major_idx : minor_idx;
+            int const y = x_major ? minor_idx : major_idx;
+            if(x >= clip->min_x && x < clip->end_x && y >= clip->min_y && y < clip->end_y)
+            {
+                blend_pixel(framebuffer, x, y, color);
+            }
+        }
+    }
+
+    // NOTE: the pixels whose centers are inside a convex polygon given in screen pixels, either winding works
+    void
+    fill_convex_polygon(
+        uint const num_vertices,
+        float const*const x_screen,
+        float const*const y_screen,
+        float const color[4],
+        ClipRectangle const*const clip,
+        Framebuffer *const framebuffer
+        )
+    {
+        float min_x = x_screen[0];
+        float max_x = x_screen[0];
+        float min_y = y_screen[0];
+        float max_y = y_screen[0];
+        float twice_area = 0.0f;
+        for(uint vertex_idx=0; vertex_idx < num_vertices; vertex_idx++)
+        {
+            uint const next_idx = (vertex_idx + 1) % num_vertices;
+            min_x = Numerics::minimum(min_x, x_screen[vertex_idx]);
+            max_x = Numerics::maximum(max_x, x_screen[vertex_idx]);
+            min_y = Numerics::minimum(min_y, y_screen[vertex_idx]);
+            max_y = Numerics::maximum(max_y, y_screen[vertex_idx]);
+            twice_area += x_screen[vertex_idx]*y_screen[next_idx] - x_screen[next_idx]*y_screen[vertex_idx];
+        }
+        float const winding = twice_area < 0.0f ? -1.0f : 1.0f;
+
+        int const first_x = Numerics::maximum(clip->min_x, int(Numerics::ceiling(min_x - 0.5f)));
+        int const end_x = Numerics::minimum(clip->end_x, int(Numerics::ceiling(max_x - 0.5f)));
+        int const first_y = Numerics::maximum(clip->min_y, int(Numerics::ceiling(min_y - 0.5f)));
+        int const end_y = Numerics::minimum(clip->end_y, int(Numerics::ceiling(max_y - 0.5f)));
+        for(int y=first_y; y < end_y; y++)
+        {
+            for(int x=first_x; x < end_x; x++)
+            {
+                float const px = float(x) + 0.5f;
+                float const py = float(y) + 0.5f;
+                bool inside = true;
+                for(uint vertex_idx=0; vertex_idx < num_vertices && inside; vertex_idx++)
+                {
+                    uint const next_idx = (vertex_idx + 1) % num_vertices;
+                    float const edge =
+                        (x_screen[next_idx] - x_screen[vertex_idx])*(py - y_screen[vertex_idx]) -
+                        (y_screen[next_idx] - y_screen[vertex_idx])*(px - x_screen[vertex_idx]);
+                    inside = edge*winding >= 0.0f;
+                }
+                if(inside)
+                {
+                    blend_pixel(framebuffer, x, y, color);
+                }
+            }
+        }
+    }
+
+    // NOTE:
+    // The glyphs of a batch, laid out the way the font vertex shader does it, but read straight from the bitmap font
+    // rather than the distance field. Fine for the glyph scales the application uses, which are whole numbers.
+    void
+    draw_glyph_batch(
+        Grid::GlyphBatch::Batch const*const batch,
+        uint32 const*const font_pixels,
+        Framebuffer *const framebuffer
+        )
+    {
+        using namespace Grid;
+
+        for(uint glyph_idx=0; glyph_idx < batch->num_glyphs; glyph_idx++)
+        {
+            GlyphBatch::GlyphInstance const*const glyph = &batch->glyphs[glyph_idx];
+            bool const vertical = glyph->orientation == uint(Orientation::Vertical);
+
+            // NOTE: the quad, and the direction of the glyph's u (along the text) and v (down the glyph) in it
+            float min_x_viewport;
+            float max_x_viewport;
+            float min_y_viewport;
+            float max_y_viewport;
+            if(vertical)
+            {
+                min_x_viewport = glyph->position[0] - glyph->extent[0];
+                max_x_viewport = glyph->position[0] + glyph->extent[0];
+                min_y_viewport = glyph->position[1];
+                max_y_viewport = glyph->position[1] + glyph->extent[1];
+            }
+            else
+            {
+                min_x_viewport = glyph->position[0];
+                max_x_viewport = glyph->position[0] + glyph->extent[0];
+                min_y_viewport = glyph->position[1] - glyph->extent[1];
+                max_y_viewport = glyph->position[1] + glyph->extent[1];
+            }
+
+            float const color[4] = {1.0f, 1.0f, 1.0f, glyph->alpha};
+            int const first_x =
+                Numerics::maximum(0, int(Numerics::ceiling(x_screen(framebuffer->x_dimension, min_x_viewport) - 0.5f)));
+            int const end_x =
+                Numerics::minimum(int(framebuffer->x_dimension), int(Numerics::ceiling(x_screen(framebuffer->x_dimension, max_x_viewport) - 0.5f)));
+            int const first_y =
+                Numerics::maximum(0, int(Numerics::ceiling(y_screen(framebuffer->y_dimension, max_y_viewport) - 0.5f)));
+            int const end_y =
+                Numerics::minimum(int(framebuffer->y_dimension), int(Numerics::ceiling(y_screen(framebuffer->y_dimension, min_y_viewport) - 0.5f)));
+            for(int y=first_y; y < end_y; y++)
+            {
+                float const y_pixel_viewport = y_viewport(framebuffer->y_dimension, float(y) + 0.5f);
+                for(int x=first_x; x < end_x; x++)
+                {
+                    float const x_pixel_viewport = x_viewport(framebuffer->x_dimension, float(x) + 0.5f);
+                    float u;
+                    float v;
+                    if(vertical)
+                    {
+                        u = (y_pixel_viewport - glyph->position[1])/glyph->extent[1];
+                        v = (x_pixel_viewport - glyph->position[0] + glyph->extent[0])/(2.0f*glyph->extent[0]);
+                    }
+                    else
+                    {
+                        u = (x_pixel_viewport - glyph->position[0])/glyph->extent[0];
+                        v = (glyph->position[1] + glyph->extent[1] - y_pixel_viewport)/(2.0f*glyph->extent[1]);
+                    }
+                    bool const lit =
+                        font_pixel_lit(
+                            font_pixels,
+                            glyph->glyph_idx,
+                            int(Numerics::floor(u*float(FONT_CHARACTER_X_DIMENSION_SCREEN))),
+                            int(Numerics::floor(v*float(FONT_CHARACTER_Y_DIMENSION_SCREEN)))
+                            );
+                    if(lit)
+                    {
+                        blend_pixel(framebuffer, x, y, color);
+                    }
+                }
+            }
+        }
+    }
+
+    // NOTE:
+    // The coverage of an antialiased polyline in a clip rectangle. Segments are combined by keeping the larger
+    // coverage, so a curve with many vertices to a pixel blends into it once, not once per segment.
+    // Every row remembers the span it touched, so only that is blended and cleared afterwards.
+    struct CoverageBuffer
+    {
+        // NOTE: (y - clip.min_y)*x_dimension + x - clip.min_x, zero outside the touched spans
+        float* coverage;
+        int* row_min_x;
+        int* row_end_x;
+        uint pixel_capacity;
+        uint row_capacity;
+        ClipRectangle clip;
+        uint x_dimension;
+        // NOTE: every pixel a segment covered, counting the ones already covered by another
+        uint64 num_covered_pixels;
+    };
+
+    void
+    initialize(CoverageBuffer *const buffer)
+    {
+        buffer->coverage = 0;
+        buffer->row_min_x = 0;
+        buffer->row_end_x = 0;
+        buffer->pixel_capacity = 0;
+        buffer->row_capacity = 0;
+        buffer->x_dimension = 0;
+        buffer->num_covered_pixels = 0;
+    }
+
+    void
+    release(CoverageBuffer *const buffer)
+    {
+        if(buffer->coverage != 0)
+        {
+            Platform::free_memory(buffer->coverage);
+        }
+        if(buffer->row_min_x != 0)
+        {
+            Platform::free_memory(buffer->row_min_x);
+        }
+        initialize(buffer);
+    }
+
+    // NOTE: makes the buffer cover the clip rectangle with nothing touched, returns false if there is no memory for it
+    bool
+    prepare(ClipRectangle const*const clip, CoverageBuffer *const buffer)
+    {
+        uint const x_dimension = uint(clip->end_x - clip->min_x);
+        uint const y_dimension = uint(clip->end_y - clip->min_y);
+        if(x_dimension*y_dimension > buffer->pixel_capacity)
+        {
+            if(buffer->coverage != 0)
+            {
+                Platform::free_memory(buffer->coverage);
+            }
+            buffer->pixel_capacity = 0;
+            buffer->coverage = (float*)Platform::allocate_memory(sizeof(float)*x_dimension*y_dimension);
+            if(buffer->coverage == 0)
+            {
+                Platform::log_line_string("failed to allocate the coverage buffer");
+                return false;
+            }
+            memset(buffer->coverage, 0, sizeof(float)*x_dimension*y_dimension);
+            buffer->pixel_capacity = x_dimension*y_dimension;
+        }
+        if(y_dimension > buffer->row_capacity)
+        {
+            // NOTE: both span arrays share an allocation
+            if(buffer->row_min_x != 0)
+            {
+                Platform::free_memory(buffer->row_min_x);
+            }
+            buffer->row_capacity = 0;
+            buffer->row_min_x = (int*)Platform::allocate_memory(sizeof(int)*2*y_dimension);
+            if(buffer->row_min_x == 0)
+            {
+                Platform::log_line_string("failed to allocate the coverage buffer rows");
+                return false;
+            }
+            buffer->row_end_x = buffer->row_min_x + y_dimension;
+            buffer->row_capacity = y_dimension;
+        }
+
+        buffer->clip = *clip;
+        buffer->x_dimension = x_dimension;
+        for(uint row_idx=0; row_idx < y_dimension; row_idx++)
+        {
+            buffer->row_min_x[row_idx] = clip->end_x;
+            buffer->row_end_x[row_idx] = clip->min_x;
+        }
+        return true;
+    }
+
+    // NOTE: the caller makes sure the pixel is in the clip rectangle
+    inline void
+    cover_pixel(int const x, int const y, float const coverage, CoverageBuffer *const buffer)
+    {
+        uint const row_idx = uint(y - buffer->clip.min_y);
+        float *const pixel = &buffer->coverage[row_idx*buffer->x_dimension + uint(x - buffer->clip.min_x)];
+        *pixel = Numerics::maximum(*pixel, coverage);
+        buffer->row_min_x[row_idx] = Numerics::minimum(buffer->row_min_x[row_idx], x);
+        buffer->row_end_x[row_idx] = Numerics::maximum(buffer->row_end_x[row_idx], x + 1);
+        buffer->num_covered_pixels++;
+    }
+
+    // NOTE:
+    // A one pixel wide segment, in screen pixels. Like draw_line it steps along the longer axis, and covers the pixel
+    // centers there with one minus their distance to the line. A one pixel wide line reaches at most three pixels
+    // across the shorter axis, so one four lane vector takes a whole step.
+    // Only the steps inside the clip rectangle are taken, so a long segment mostly outside of it costs nothing.
+    void
+    cover_segment(
+        float const x0_screen,
+        float const y0_screen,
+        float const x1_screen,
+        float const y1_screen,
+        CoverageBuffer *const buffer
+        )
+    {
+        using namespace Simd;
+
+        ClipRectangle const*const clip = &buffer->clip;
+        float const dx = x1_screen - x0_screen;
+        float const dy = y1_screen - y0_screen;
+        bool const x_major = Numerics::absolute_value(dx) >= Numerics::absolute_value(dy);
+
+        float const major0 = x_major ? x0_screen : y0_screen;
+        float const major1 = x_major ? x1_screen : y1_screen;
+        float const minor0 = x_major ? y0_screen : x0_screen;
+        float const minor1 = x_major ? y1_screen : x1_screen;
+        int const clip_min_major = x_major ? clip->min_x : clip->min_y;
+        int const clip_end_major = x_major ? clip->end_x : clip->end_y;
+        int const clip_min_minor = x_major ? clip->min_y : clip->min_x;
+        int const clip_end_minor = x_major ? clip->end_y : clip->end_x;
+
+        float const major_start = Numerics::minimum(major0, major1);
+        float const major_end = Numerics::maximum(major0, major1);
+        if(major_end <= major_start)
+        {
+            return;
+        }
+        // NOTE: the coverage reaches less than two pixels past the clip rectangle on the shorter axis
+        if(
+            Numerics::maximum(minor0, minor1) < float(clip_min_minor) - 2.0f ||
+            Numerics::minimum(minor0, minor1) > float(clip_end_minor) + 2.0f
+            )
+        {
+            return;
+        }
+
+        float const slope = (minor1 - minor0)/(major1 - major0);
+        // NOTE: the distance from the line across the shorter axis shrinks by this across the line
+        float const cosine = 1.0f/Numerics::square_root(1.0f + slope*slope);
+        float const reach = 1.0f/cosine;
+
+        // NOTE: clamped before rounding, so vertices far outside the clip rectangle can't overflow an int
+        int const first_idx = int(Numerics::ceiling(Numerics::maximum(major_start, float(clip_min_major)) - 0.5f));
+        int const end_idx = int(Numerics::ceiling(Numerics::minimum(major_end, float(clip_end_major)) - 0.5f));
+        Float4 const lane_offsets = set(0.5f, 1.5f, 2.5f, 3.5f);
+        Float4 const one = set(1.0f);
+        for(int major_idx=first_idx; major_idx < end_idx; major_idx++)
+        {
+            float const minor = minor0 + (float(major_idx) + 0.5f - major0)*slope;
+            if(minor < float(clip_min_minor) - 2.0f || minor > float(clip_end_minor) + 2.0f)
+                continue;
+            int const first_minor_idx = int(Numerics::ceiling(minor - reach - 0.5f));
+
+            Float4 const distance =
+                multiply(subtract(add(set(float(first_minor_idx)), lane_offsets), set(minor)), set(cosine));
+            Float4 const coverage = maximum(subtract(one, absolute_value(distance)), zero());
+            float lane_coverage[NUM_LANES];
+            store(coverage, lane_coverage);
+
+            for(uint lane_idx=0; lane_idx < NUM_LANES; lane_idx++)
+            {
+                int const minor_idx = first_minor_idx + int(lane_idx);
+                if(lane_coverage[lane_idx] > 0.0f && minor_idx >= clip_min_minor && minor_idx < clip_end_minor)
+                {
+                    cover_pixel(x_major ? major_idx : minor_idx, x_major ? minor_idx : major_idx, lane_coverage[lane_idx], buffer);
+                }
+            }
+        }
+    }
+
+    // NOTE: blends the color into the touched pixels by their coverage, and clears them for the next polyline
+    void
+    resolve(float const color[4], CoverageBuffer *const buffer, Framebuffer *const framebuffer)
+    {
+        uint const y_dimension = uint(buffer->clip.end_y - buffer->clip.min_y);
+        for(uint row_idx=0; row_idx < y_dimension; row_idx++)
+        {
+            int const y = buffer->clip.min_y + int(row_idx);
+            float *const row = &buffer->coverage[row_idx*buffer->x_dimension];
+            for(int x=buffer->row_min_x[row_idx]; x < buffer->row_end_x[row_idx]; x++)
+            {
+                float *const coverage = &row[x - buffer->clip.min_x];
+                if(*coverage > 0.0f)
+                {
+                    float const covered_color[4] = {color[0], color[1], color[2], color[3]*(*coverage)};
+                    blend_pixel(framebuffer, x, y, covered_color);
+                    *coverage = 0.0f;
+                }
+            }
+        }
+    }
+
+    inline bool
+    is_finite(float const x)
+    {
+        return Numerics::absolute_value(x) < POSITIVE_INFINITY_FLOAT;
+    }
+
+    // NOTE:
+    // An antialiased one pixel wide line strip through the vertices, given in screen pixels, clipped to the clip
+    // rectangle like a scissor rectangle would. Segments with a vertex that isn't finite are left out.
+    // Returns false if there was no memory for the coverage.
+    bool
+    draw_polyline_antialiased(
+        float const*const x_screen,
+        float const*const y_screen,
+        uint const num_vertices,
+        float const color[4],
+        ClipRectangle const*const clip,
+        CoverageBuffer *const buffer,
+        Framebuffer *const framebuffer
+        )
+    {
+        if(clip->end_x <= clip->min_x || clip->end_y <= clip->min_y)
+        {
+            return true;
+        }
+        if(!prepare(clip, buffer))
+        {
+            return false;
+        }
+        for(uint vertex_idx=1; vertex_idx < num_vertices; vertex_idx++)
+        {
+            float const x0 = x_screen[vertex_idx - 1];
+            float const y0 = y_screen[vertex_idx - 1];
+            float const x1 = x_screen[vertex_idx];
+            float const y1 = y_screen[vertex_idx];
+            if(is_finite(x0) && is_finite(y0) && is_finite(x1) && is_finite(y1))
+            {
+                cover_segment(x0, y0, x1, y1, buffer);
+            }
+        }
+        resolve(color, buffer, framebuffer);
+        return true;
+    }
+
+    // NOTE: the pixel shaders line by line, in floats, for checking draw_widget against
+    uint32
+    reference_pixel(
+        Shader const shader,
+        Parameters const*const parameters,
+        float const normalization_factor,
+        float const x_data,
+        float const y_data
+        )
+    {
+        using namespace Complex;
+
+        C x;
+        x.component.real = x_data;
+        x.component.imaginary = y_data;
+
+        float color[4];
+        if(shader == Shader::Density)
+        {
+            float lengths[2] = {1.0f, 1.0f};
+            for(int i=0; i<2; i++)
+            {
+                for(int j=0; j<2; j++)
+                {
+                    Complex::C const*const p = &parameters->ator_factors[i][j];
+                    float const dx = x_data - p->component.real;
+                    lengths[i] *= Numerics::square_root(Numerics::square(dx) + Numerics::square(y_data - p->component.imaginary));
+                    lengths[i] *= Numerics::square_root(Numerics::square(dx) + Numerics::square(y_data + p->component.imaginary));
+                }
+            }
+            float const a = normalization_factor*lengths[0]/lengths[1];
+            uint const level_idx =
+                a > 1.0f ? DENSITY_WHITE_IDX : uint(Numerics::floor(Numerics::minimum(a, 1.0f)*10.0f));
+            density_level_color(level_idx, color);
+        }
+        else
+        {
+            C products[2];
+            for(int i=0; i<2; i++)
+            {
+                C factors[4];
+                for(int j=0; j<2; j++)
+                {
+                    C p_conjugate;
+                    conjugate(&parameters->ator_factors[i][j], &p_conjugate);
+                    difference(&x, &parameters->ator_factors[i][j], &factors[2*j + 0]);
+                    difference(&x, &p_conjugate, &factors[2*j + 1]);
+                }
+                // NOTE: grouped like complex_product_4
+                multiply(&factors[0], &factors[1]);
+                multiply(&factors[2], &factors[3]);
+                multiply(&factors[1], &factors[3]);
+                products[i] = factors[3];
+            }
+            C q;
+            quotient(&products[0], &products[1], &q);
+            float const turns = 0.5f*phase(&q)/PI_FLOAT;
+            float const normalized_phase = turns - Numerics::floor(turns);
+            uint const sector_idx =
+                (uint)Numerics::minimum(int(normalized_phase*12.0f), int(NUM_DOMAIN_COLORING_SECTORS) - 1);
+            domain_coloring_sector_color(sector_idx, color);
+        }
+        return pack_color(color[0], color[1], color[2], color[3]);
+    }
+
+    struct BenchmarkResult
+    {
+        uint num_frames;
+        float duration_seconds;
+        uint num_compared_pixels;
+        uint num_mismatches;
+        uint checksum;
+        // NOTE: over all frames, pixels the density quadtree filled are not counted
+        uint64 num_shaded_pixels;
+    };
+
+    // NOTE: the two widgets of the application, one above the other, each a circle of 200 pixels radius
+    uint const BENCHMARK_X_DIMENSION = 400;
+    uint const BENCHMARK_Y_DIMENSION = 800;
+
+    void
+    benchmark_layouts(WidgetLayoutConstants layouts[NumShaders])
+    {
+        for(uint shader_idx=0; shader_idx < NumShaders; shader_idx++)
+        {
+            layouts[shader_idx].center_x_position_viewport = 0.0f;
+            layouts[shader_idx].center_y_position_viewport = shader_idx == Shader::Density ? +0.5f : -0.5f;
+            layouts[shader_idx].data_x_unit_viewport = 1.0f;
+            layouts[shader_idx].data_y_unit_viewport = 0.5f;
+        }
+    }
+
+    // NOTE: zeros and poles going round at different speeds, so every frame is different
+    void
+    benchmark_parameters(uint const frame_idx, Parameters *const parameters)
+    {
+        float const t = float(frame_idx)/60.0f;
+        Complex::set_polar(0.25f, PI_FLOAT*0.25f + t, &parameters->parameter.zero[0]);
+        Complex::set_polar(1.25f, PI_FLOAT*0.5f - 0.7f*t, &parameters->parameter.zero[1]);
+        Complex::set_polar(0.25f + 0.2f*Numerics::sin(t), PI_FLOAT*0.1f + 1.3f*t, &parameters->parameter.pole[0]);
+        Complex::set_polar(0.75f, PI_FLOAT*0.75f - 0.4f*t, &parameters->parameter.pole[1]);
+    }
+
+    // NOTE: every pixel against the reference, with the widgets of the first num_shaders layouts drawn over the clear color
+    void
+    compare_with_reference(
+        Framebuffer const*const framebuffer,
+        WidgetLayoutConstants const*const layouts,
+        uint const num_shaders,
+        Parameters const*const parameters,
+        float const clear_color[4],
+        BenchmarkResult *const result
+        )
+    {
+        float const normalization_factor = normalization_constant_highpass(parameters);
+        uint32 const background = pack_color(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
+        for(uint y_pixel=0; y_pixel < framebuffer->y_dimension; y_pixel++)
+        {
+            for(uint x_pixel=0; x_pixel < framebuffer->x_dimension; x_pixel++)
+            {
+                uint32 expected = background;
+                for(uint shader_idx=0; shader_idx < num_shaders; shader_idx++)
+                {
+                    WidgetLayoutConstants const*const layout = &layouts[shader_idx];
+                    float const x_data =
+                        (x_viewport(framebuffer->x_dimension, float(x_pixel) + 0.5f) - layout->center_x_position_viewport)/
+                        layout->data_x_unit_viewport;
+                    float const y_data =
+                        (y_viewport(framebuffer->y_dimension, float(y_pixel) + 0.5f) - layout->center_y_position_viewport)/
+                        layout->data_y_unit_viewport;
+                    if(x_data*x_data + y_data*y_data <= 1.0f)
+                    {
+                        expected = reference_pixel(Shader(shader_idx), parameters, normalization_factor, x_data, y_data);
+                    }
+                }
+
+                uint32 const pixel = framebuffer->pixels[y_pixel*framebuffer->x_dimension + x_pixel];
+                result->num_compared_pixels++;
+                if(pixel != expected)
+                {
+                    result->num_mismatches++;
+                }
+                // NOTE: kept below 2^31, so it logs the same everywhere
+                result->checksum = uint((uint64(result->checksum)*31 + pixel) % 2147483647u);
+            }
+        }
+    }
+
+    void
+    run_benchmark(uint const num_frames, BenchmarkResult *const result)
+    {
+        result->num_frames = 0;
+        result->duration_seconds = 0.0f;
+        result->num_compared_pixels = 0;
+        result->num_mismatches = 0;
+        result->checksum = 0;
+        result->num_shaded_pixels = 0;
+
+        Framebuffer framebuffer;
+        if(!initialize(BENCHMARK_X_DIMENSION, BENCHMARK_Y_DIMENSION, &framebuffer))
+        {
+            return;
+        }
+
+        WidgetLayoutConstants layouts[NumShaders];
+        benchmark_layouts(layouts);
+        float const clear_color[4] = {0.0f, 0.2f, 0.3f, 0.0f};
+
+        Parameters parameters = {};
+        Platform::TimeCount const start = Platform::time_get_count();
+        for(uint frame_idx=0; frame_idx < num_frames; frame_idx++)
+        {
+            benchmark_parameters(frame_idx, &parameters);
+            float const normalization_factor = normalization_constant_highpass(&parameters);
+            clear(&framebuffer, clear_color);
+            for(uint shader_idx=0; shader_idx < NumShaders; shader_idx++)
+            {
+                result->num_shaded_pixels +=
+                    draw_widget(Shader(shader_idx), &layouts[shader_idx], &parameters, normalization_factor, &framebuffer);
+            }
+            result->num_frames++;
+        }
+        result->duration_seconds = Platform::time_duration_seconds(start, Platform::time_get_count());
+
+        // NOTE: the last frame is checked pixel by pixel, and left out if there were no frames
+        if(num_frames > 0)
+        {
+            compare_with_reference(&framebuffer, layouts, NumShaders, &parameters, clear_color, result);
+        }
+
+        release(&framebuffer);
+    }
+
+    // NOTE:
+    // Like the application while a pole is dragged: only the density widget, with one pole moving and everything
+    // else still, drawn either from scratch or from a DensityCache.
+    void
+    run_drag_benchmark(uint const num_frames, bool const cached, BenchmarkResult *const result)
+    {
+        result->num_frames = 0;
+        result->duration_seconds = 0.0f;
+        result->num_compared_pixels = 0;
+        result->num_mismatches = 0;
+        result->checksum = 0;
+        result->num_shaded_pixels = 0;
+
+        Framebuffer framebuffer;
+        if(!initialize(BENCHMARK_X_DIMENSION, BENCHMARK_Y_DIMENSION, &framebuffer))
+        {
+            return;
+        }
+        DensityCache cache;
+        initialize(&cache);
+
+        WidgetLayoutConstants layouts[NumShaders];
+        benchmark_layouts(layouts);
+        float const clear_color[4] = {0.0f, 0.2f, 0.3f, 0.0f};
+
+        Parameters parameters = {};
+        benchmark_parameters(0, &parameters);
+        Platform::TimeCount const start = Platform::time_get_count();
+        for(uint frame_idx=0; frame_idx < num_frames; frame_idx++)
+        {
+            float const t = float(frame_idx)/60.0f;
+            Complex::set_polar(0.25f + 0.2f*Numerics::sin(t), PI_FLOAT*0.1f + 1.3f*t, &parameters.parameter.pole[0]);
+            float const normalization_factor = normalization_constant_highpass(&parameters);
+            clear(&framebuffer, clear_color);
+            if(cached)
+            {
+                draw_density_cached(&layouts[Shader::Density], &parameters, normalization_factor, &cache, &framebuffer);
+            }
+            else
+            {
+                result->num_shaded_pixels +=
+                    draw_widget(Shader::Density, &layouts[Shader::Density], &parameters, normalization_factor, &framebuffer);
+            }
+            result->num_frames++;
+        }
+        result->duration_seconds = Platform::time_duration_seconds(start, Platform::time_get_count());
+
+        if(num_frames > 0)
+        {
+            compare_with_reference(&framebuffer, layouts, 1, &parameters, clear_color, result);
+        }
+
+        release(&cache);
+        release(&framebuffer);
+    }
+
+    // NOTE: a budget that leaves most of a 60 Hz frame for the rest of the window
+    float const PROGRESSIVE_BENCHMARK_BUDGET_SECONDS = 0.002f;
+
+    struct ProgressiveBenchmarkResult
+    {
+        // NOTE: the frames of the drag, and how the complete image compares to draw_widget
+        BenchmarkResult drag;
+        uint num_refine_frames;
+        float refine_duration_seconds;
+    };
+
+    // NOTE:
+    // The domain coloring widget while a pole is dragged, drawn progressively, and then the idle frames it takes
+    // to get to the full image. That image has to be exactly what draw_widget gives.
+    void
+    run_progressive_benchmark(uint const num_frames, ProgressiveBenchmarkResult *const result)
+    {
+        BenchmarkResult *const drag = &result->drag;
+        drag->num_frames = 0;
+        drag->duration_seconds = 0.0f;
+        drag->num_compared_pixels = 0;
+        drag->num_mismatches = 0;
+        drag->checksum = 0;
+        drag->num_shaded_pixels = 0;
+        result->num_refine_frames = 0;
+        result->refine_duration_seconds = 0.0f;
+
+        Framebuffer framebuffer;
+        if(!initialize(BENCHMARK_X_DIMENSION, BENCHMARK_Y_DIMENSION, &framebuffer))
+        {
+            return;
+        }
+        Framebuffer expected;
+        if(!initialize(BENCHMARK_X_DIMENSION, BENCHMARK_Y_DIMENSION, &expected))
+        {
+            release(&framebuffer);
+            return;
+        }
+        ProgressiveImage image;
+        initialize(&image);
+
+        WidgetLayoutConstants layouts[NumShaders];
+        benchmark_layouts(layouts);
+        WidgetLayoutConstants const*const layout = &layouts[Shader::DomainColoring];
+        float const clear_color[4] = {0.0f, 0.2f, 0.3f, 0.0f};
+
+        Parameters parameters = {};
+        benchmark_parameters(0, &parameters);
+        Platform::TimeCount const drag_start = Platform::time_get_count();
+        for(uint frame_idx=0; frame_idx < num_frames; frame_idx++)
+        {
+            float const t = float(frame_idx)/60.0f;
+            Complex::set_polar(0.25f + 0.2f*Numerics::sin(t), PI_FLOAT*0.1f + 1.3f*t, &parameters.parameter.pole[0]);
+            clear(&framebuffer, clear_color);
+            draw_domain_coloring_progressive(layout, &parameters, PROGRESSIVE_BENCHMARK_BUDGET_SECONDS, &image, &framebuffer);
+            drag->num_frames++;
+        }
+        Platform::TimeCount const refine_start = Platform::time_get_count();
+        drag->duration_seconds = Platform::time_duration_seconds(drag_start, refine_start);
+
+        // NOTE: there is always something left to refine after a drag frame, unless there were none
+        bool complete = num_frames == 0;
+        while(!complete)
+        {
+            clear(&framebuffer, clear_color);
+            complete =
+                draw_domain_coloring_progressive(layout, &parameters, PROGRESSIVE_BENCHMARK_BUDGET_SECONDS, &image, &framebuffer);
+            result->num_refine_frames++;
+        }
+        result->refine_duration_seconds = Platform::time_duration_seconds(refine_start, Platform::time_get_count());
+
+        if(num_frames > 0)
+        {
+            clear(&expected, clear_color);
+            draw_widget(Shader::DomainColoring, layout, &parameters, 0.0f, &expected);
+            uint const num_pixels = framebuffer.x_dimension*framebuffer.y_dimension;
+            for(uint pixel_idx=0; pixel_idx < num_pixels; pixel_idx++)
+            {
+                uint32 const pixel = framebuffer.pixels[pixel_idx];
+                drag->num_compared_pixels++;
+                if(pixel != expected.pixels[pixel_idx])
+                {
+                    drag->num_mismatches++;
+                }
+                drag->checksum = uint((uint64(drag->checksum)*31 + pixel) % 2147483647u);
+            }
+        }
+
+        release(&image);
+        release(&expected);
+        release(&framebuffer);
+    }
+
+    // NOTE: a curve with thousands of vertices to a pixel column, like a response sampled far finer than the plot
+    uint const POLYLINE_BENCHMARK_NUM_VERTICES = 1 << 20;
+
+    struct PolylineBenchmarkResult
+    {
+        uint num_rounds;
+        uint64 num_vertices;
+        float duration_seconds;
+        // NOTE: over all rounds, see CoverageBuffer
+        uint64 num_covered_pixels;
+        // NOTE: of the last round, should be zero
+        uint num_pixels_outside_clip;
+        uint checksum;
+    };
+
+    // NOTE: draws a wiggly curve that runs past its clip rectangle on every side, num_rounds times
+    void
+    run_polyline_benchmark(uint const num_rounds, PolylineBenchmarkResult *const result)
+    {
+        result->num_rounds = 0;
+        result->num_vertices = 0;
+        result->duration_seconds = 0.0f;
+        result->num_covered_pixels = 0;
+        result->num_pixels_outside_clip = 0;
+        result->checksum = 0;
+
+        Framebuffer framebuffer;
+        if(!initialize(BENCHMARK_X_DIMENSION, BENCHMARK_Y_DIMENSION, &framebuffer))
+        {
+            return;
+        }
+        // NOTE: both coordinates share an allocation
+        float *const x_screen = (float*)Platform::allocate_memory(sizeof(float)*2*POLYLINE_BENCHMARK_NUM_VERTICES);
+        if(x_screen == 0)
+        {
+            Platform::log_line_string("failed to allocate the polyline benchmark vertices");
+            release(&framebuffer);
+            return;
+        }
+        float *const y_screen = x_screen + POLYLINE_BENCHMARK_NUM_VERTICES;
+        CoverageBuffer coverage;
+        initialize(&coverage);
+
+        ClipRectangle clip;
+        clip.min_x = 20;
+        clip.end_x = int(BENCHMARK_X_DIMENSION) - 20;
+        clip.min_y = int(BENCHMARK_Y_DIMENSION)/2 + 20;
+        clip.end_y = int(BENCHMARK_Y_DIMENSION) - 20;
+        float const middle_y = 0.5f*float(clip.min_y + clip.end_y);
+        float const amplitude = 0.5f*float(clip.end_y - clip.min_y);
+        for(uint vertex_idx=0; vertex_idx < POLYLINE_BENCHMARK_NUM_VERTICES; vertex_idx++)
+        {
+            float const t = float(vertex_idx)/float(POLYLINE_BENCHMARK_NUM_VERTICES - 1);
+            x_screen[vertex_idx] = t*float(BENCHMARK_X_DIMENSION);
+            y_screen[vertex_idx] =
+                middle_y +
+                0.9f*amplitude*Numerics::sin(2.0f*PI_FLOAT*3.0f*t) +
+                0.2f*amplitude*Numerics::sin(2.0f*PI_FLOAT*997.0f*t);
+        }
+
+        float const clear_color[4] = {0.0f, 0.2f, 0.3f, 0.0f};
+        float const curve_color[4] = {1.0f, 1.0f, 0.0f, 1.0f};
+        Platform::TimeCount const start = Platform::time_get_count();
+        for(uint round_idx=0; round_idx < num_rounds; round_idx++)
+        {
+            clear(&framebuffer, clear_color);
+            if(!draw_polyline_antialiased(x_screen, y_screen, POLYLINE_BENCHMARK_NUM_VERTICES, curve_color, &clip, &coverage, &framebuffer))
+            {
+                break;
+            }
+            result->num_rounds++;
+            result->num_vertices += POLYLINE_BENCHMARK_NUM_VERTICES;
+        }
+        result->duration_seconds = Platform::time_duration_seconds(start, Platform::time_get_count());
+        result->num_covered_pixels = coverage.num_covered_pixels;
+
+        if(result->num_rounds > 0)
+        {
+            uint32 const clear_pixel = pack_color(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
+            for(int y=0; y < int(framebuffer.y_dimension); y++)
+            {
+                for(int x=0; x < int(framebuffer.x_dimension); x++)
+                {
+                    uint32 const pixel = framebuffer.pixels[uint(y)*framebuffer.x_dimension + uint(x)];
+                    bool const inside = x >= clip.min_x && x < clip.end_x && y >= clip.min_y && y < clip.end_y;
+                    if(!inside && pixel != clear_pixel)
+                    {
+                        result->num_pixels_outside_clip++;
+                    }
+                    result->checksum = uint((uint64(result->checksum)*31 + pixel) % 2147483647u);
+                }
+            }
+        }
+
+        release(&coverage);
+        Platform::free_memory(x_screen);
+        release(&framebuffer);
+    }
+
+    void
+    log_benchmark_result(char const*const name, BenchmarkResult const*const result)
+    {
+        Platform::log_string(name);
+        Platform::log_string(": frames: ");
+        Platform::log_uint32(result->num_frames);
+        Platform::log_string(", seconds: ");
+        Platform::log_float(result->duration_seconds);
+        Platform::log_string(", frames per second: ");
+        Platform::log_float(
+            result->duration_seconds > 0.0f ? float(result->num_frames)/result->duration_seconds : 0.0f
+            );
+        Platform::log_string(", compared pixels: ");
+        Platform::log_uint32(result->num_compared_pixels);
+        Platform::log_string(", mismatches: ");
+        Platform::log_uint32(result->num_mismatches);
+        Platform::log_string(", checksum: ");
+        Platform::log_uint32(result->checksum);
+        Platform::log_string(", pixels shaded one by one per frame: ");
+        Platform::log_uint32(result->num_frames > 0 ? uint(result->num_shaded_pixels/result->num_frames) : 0);
+        Platform::log_line();
+    }
+
+    void
+    log_progressive_benchmark_result(ProgressiveBenchmarkResult const*const result)
+    {
+        log_benchmark_result("software render progressive drag", &result->drag);
+        Platform::log_string("software render progressive refinement: frames: ");
+        Platform::log_uint32(result->num_refine_frames);
+        Platform::log_string(", seconds: ");
+        Platform::log_float(result->refine_duration_seconds);
+        Platform::log_line();
+    }
+
+    void
+    log_polyline_benchmark_result(PolylineBenchmarkResult const*const result)
+    {
+        Platform::log_string("software render antialiased polyline: rounds: ");
+        Platform::log_uint32(result->num_rounds);
+        Platform::log_string(", seconds: ");
+        Platform::log_float(result->duration_seconds);
+        Platform::log_string(", million vertices per second: ");
+        Platform::log_float(
+            result->duration_seconds > 0.0f ? float(double(result->num_vertices)/double(result->duration_seconds)*1.0e-6) : 0.0f
+            );
+        Platform::log_string(", covered pixels per vertex: ");
+        Platform::log_float(result->num_vertices > 0 ? float(double(result->num_covered_pixels)/double(result->num_vertices)) : 0.0f);
+        Platform::log_string(", pixels outside the clip rectangle: ");
+        Platform::log_uint32(result->num_pixels_outside_clip);
+        Platform::log_string(", checksum: ");
+        Platform::log_uint32(result->checksum);
+        Platform::log_line();
+    }
+
+}
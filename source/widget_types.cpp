@@ -0,0 +1,101 @@
+// NOTE:
+// The widget's parameters, and the vertex and constant layouts the renderers share. Nothing in here needs D3D,
+// so both entry points include it, see iir4_input.cpp and iir4_headless.cpp.
+
+int const NUM_RADIAL_SEGMENTS = 100;
+
+// NOTE: This is must match vertex input layout
+struct ShapeVertex
+{
+    Vec2::Vec2 position;
+};
+
+// NOTE: This is must match vertex input layout
+// NOTE: This is the type of vertex used for triangles displaying the widget.
+struct WidgetVertex
+{
+    Vec2::Vec2 position_screen;
+    Vec2::Vec2 position_data;
+};
+
+struct WidgetLayoutConstants
+{
+    float center_x_position_viewport;
+    float center_y_position_viewport;
+    float data_x_unit_viewport; 
+    float data_y_unit_viewport;
+};
+
+// NOTE: This must match the constant buffer in the shader, be careful about padding!
+struct PlotConstants
+{
+    float plotviewport_data[4]; // x lo, x hi, y lo, y hi (x relative to the plot origin, see below)
+    float plotviewport_viewport[4]; // x lo, x hi, y lo, y hi
+    float curve_interval_x_data[2]; float margin_x_dimension_viewport; float __padding_1[1];
+    uint num_curve_slices; float __padding_2[3];
+    float curve_color[4];
+};
+static_assert(sizeof(PlotConstants) == sizeof(float[4])*5, "stuff");
+
+union Parameters
+{
+    struct
+    {
+        Complex::C zero[2];
+        Complex::C pole[2];
+    } parameter;
+
+    Complex::C parameters[4];
+
+    // Cheesy name: numerATOR, denumiarATOR -- these are the 'factors' of the 'ators' of the transfer function!
+    Complex::C ator_factors[2][2];
+    
+};
+
+// NOTE: normalization constant suitable for lowpass filters
+inline float
+normalization_constant_lowpass(Parameters const*const parameters)
+{
+    using namespace Complex;
+
+    C unit;
+    unit.component.real = 1.0f;
+    unit.component.imaginary = 0.0f;
+
+    C d[2][2];
+    for(int i=0; i<2; i++)
+    {
+        for(int j=0; j<2; j++)
+        {
+            difference(&unit, &parameters->ator_factors[i][j], &d[i][j]);
+        }
+    }
+    
+    return
+        (magnitude_squared(&d[1][0])*magnitude_squared(&d[1][1]))/
+        (magnitude_squared(&d[0][0])*magnitude_squared(&d[0][1]));
+}
+
+// NOTE: normalization constant suitable for highpass
+inline float
+normalization_constant_highpass(Parameters const*const parameters)
+{
+    using namespace Complex;
+
+    C negative_unit;
+    negative_unit.component.real = -1.0f;
+    negative_unit.component.imaginary = 0.0f;
+
+    C d[2][2];
+    for(int i=0; i<2; i++)
+    {
+        for(int j=0; j<2; j++)
+        {
+            difference(&negative_unit, &parameters->ator_factors[i][j], &d[i][j]);
+        }
+    }
+    
+    return
+        (magnitude_squared(&d[1][0])*magnitude_squared(&d[1][1]))/
+        (magnitude_squared(&d[0][0])*magnitude_squared(&d[0][1]));
+}
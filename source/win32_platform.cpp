@@ -12,6 +12,11 @@ void clear_transient_input_state(Platform::InputState* input)
 {
     input->control.changed_state = false;
     input->quit.changed_state = false;
+    input->toggle_decibels.changed_state = false;
+    input->toggle_root_locus.changed_state = false;
+    input->clear_fit_target.changed_state = false;
+    input->toggle_log_frequency.changed_state = false;
+    input->toggle_contours.changed_state = false;
     
     input->mouse_left.changed_state = false;
     input->mouse_right.changed_state = false;
@@ -194,6 +199,16 @@ void process_pending_messages(
                         button = &input->quit;
                     else if(vk_code == VK_CONTROL)
                         button = &input->control;
+                    else if(vk_code == VK_F2)
+                        button = &input->toggle_decibels;
+                    else if(vk_code == VK_F3)
+                        button = &input->toggle_root_locus;
+                    else if(vk_code == VK_F4)
+                        button = &input->clear_fit_target;
+                    else if(vk_code == VK_F5)
+                        button = &input->toggle_log_frequency;
+                    else if(vk_code == VK_F6)
+                        button = &input->toggle_contours;
                     
                     
                     if(button != 0)
@@ -542,13 +557,302 @@ namespace Platform
 
         return result;
     }
-    
-    
+
+    // NOTE: replaces the file if it exists
+    bool write_file(char* file_name, void const* contents, uint32 contents_size)
+    {
+        HANDLE file_handle = 0;
+        {
+            DWORD desired_access = GENERIC_WRITE;
+            DWORD share_mode = 0; // NOTE: nobody else gets to see a half written file
+            LPSECURITY_ATTRIBUTES security_attributes = 0;
+            DWORD creation_disposition = CREATE_ALWAYS;
+            DWORD flags_and_attributes = FILE_ATTRIBUTE_NORMAL;
+            HANDLE template_file_handle = 0;
+
+            file_handle = CreateFile(file_name,
+                                     desired_access,
+                                     share_mode,
+                                     security_attributes,
+                                     creation_disposition,
+                                     flags_and_attributes,
+                                     template_file_handle);
+
+            if(file_handle == INVALID_HANDLE_VALUE)
+            {
+                Platform::log_string("failed to create file ");
+                Platform::log_line_string(file_name);
+                return false;
+            }
+        }
+
+        bool written = true;
+        { // write the buffer to the file
+            DWORD num_bytes_written = 0;
+            LPOVERLAPPED overlapped = 0;
+
+            BOOL success = WriteFile(file_handle,
+                                     contents,
+                                     contents_size,
+                                     &num_bytes_written,
+                                     overlapped);
+
+            if( !success || num_bytes_written != contents_size )
+            {
+                Platform::log_line_string("writing file failed");
+                written = false;
+            }
+        }
+
+        { // close the file
+            BOOL success = CloseHandle(file_handle);
+            if( !success )
+            {
+                Platform::log_line_string("closing file failed");
+                written = false;
+            }
+        }
+
+        return written;
+    }
+
+    // NOTE: caller gets to free the memory using free_memory, memory is zero initialized
+    void* allocate_memory(size_t size)
+    {
+        LPVOID address = 0; // zero means windows decides
+        DWORD allocation_type = MEM_RESERVE | MEM_COMMIT;
+        DWORD protection = PAGE_READWRITE;
+        void *const memory = VirtualAlloc(address, size, allocation_type, protection);
+        if(memory == 0)
+        {
+            Platform::log_line_string("not enough memory");
+        }
+        return memory;
+    }
+
+    void free_memory(void* address)
+    {
+        SIZE_T size = 0;
+        DWORD free_type = MEM_RELEASE;
+        BOOL success = VirtualFree(address, size, free_type);
+        if(!success)
+            Platform::log_line_string("freeing memory failed");
+        assert(success);
+    }
+
+};
+
+#define WORK_QUEUE_MAX_NUM_ENTRIES 1024
+#define WORK_QUEUE_MAX_NUM_THREADS 16
+
+struct WorkQueueEntry
+{
+    Platform::ParallelTaskCallback* callback;
+    void* data;
+    uint task_idx;
+};
+
+// NOTE:
+// Only the main thread adds entries, any thread may take them.
+// An entry is taken by moving next_entry_to_read past it with a compare-exchange, so each entry is run exactly once.
+struct WorkQueue
+{
+    LONG volatile completion_goal;
+    LONG volatile completion_count;
+    LONG volatile next_entry_to_write;
+    LONG volatile next_entry_to_read;
+    // NOTE: set while a parallel_for has tasks in the queue
+    LONG volatile busy;
+    HANDLE semaphore;
+    uint num_threads;
+    WorkQueueEntry entries[WORK_QUEUE_MAX_NUM_ENTRIES];
+};
+
+static WorkQueue g_work_queue;
+static bool g_work_queue_initialized = false;
+
+// NOTE: returns true if there was nothing to do
+bool
+work_queue_do_next_entry(WorkQueue *const queue)
+{
+    LONG const original_next_entry_to_read = queue->next_entry_to_read;
+    LONG const new_next_entry_to_read = (original_next_entry_to_read + 1) % WORK_QUEUE_MAX_NUM_ENTRIES;
+    if(original_next_entry_to_read == queue->next_entry_to_write)
+    {
+        return true;
+    }
+
+    LONG const entry_idx =
+        InterlockedCompareExchange(
+            &queue->next_entry_to_read,
+            new_next_entry_to_read,
+            original_next_entry_to_read
+            );
+    if(entry_idx == original_next_entry_to_read)
+    {
+        WorkQueueEntry const entry = queue->entries[entry_idx];
+        entry.callback(entry.data, entry.task_idx);
+        InterlockedIncrement(&queue->completion_count);
+    }
+    return false;
+}
+
+DWORD WINAPI
+work_queue_thread_procedure(LPVOID parameter)
+{
+    WorkQueue *const queue = (WorkQueue*)parameter;
+    while(true)
+    {
+        bool const idle = work_queue_do_next_entry(queue);
+        if(idle)
+        {
+            WaitForSingleObjectEx(queue->semaphore, INFINITE, FALSE);
+        }
+    }
+}
+
+bool
+work_queue_initialize(WorkQueue *const queue)
+{
+    SYSTEM_INFO system_info = {};
+    GetSystemInfo(&system_info);
+    // NOTE: the calling thread works too, so leave one processor for it
+    uint const num_processors = system_info.dwNumberOfProcessors;
+    uint const num_threads =
+        num_processors > 1 ? (uint)Numerics::minimum(int(num_processors) - 1, WORK_QUEUE_MAX_NUM_THREADS) : 0;
+
+    queue->completion_goal = 0;
+    queue->completion_count = 0;
+    queue->next_entry_to_write = 0;
+    queue->next_entry_to_read = 0;
+    queue->busy = 0;
+    queue->num_threads = 0;
+
+    LPSECURITY_ATTRIBUTES security_attributes = 0;
+    LONG const initial_count = 0;
+    LONG const maximum_count = WORK_QUEUE_MAX_NUM_ENTRIES;
+    LPCSTR const name = 0;
+    DWORD const flags = 0;
+    DWORD const desired_access = SEMAPHORE_ALL_ACCESS;
+    queue->semaphore =
+        CreateSemaphoreExA(security_attributes, initial_count, maximum_count, name, flags, desired_access);
+    if(queue->semaphore == 0)
+    {
+        Platform::log_line_string("failed to create the work queue semaphore");
+        return false;
+    }
+
+    for(uint thread_idx=0; thread_idx < num_threads; thread_idx++)
+    {
+        SIZE_T const stack_size = 0; // NOTE: zero means default
+        DWORD const creation_flags = 0;
+        DWORD thread_id = 0;
+        HANDLE const thread_handle =
+            CreateThread(
+                security_attributes,
+                stack_size,
+                work_queue_thread_procedure,
+                queue,
+                creation_flags,
+                &thread_id
+                );
+        if(thread_handle == 0)
+        {
+            // NOTE: not fatal, the calling thread will simply do more of the work
+            Platform::log_line_string("failed to create a worker thread");
+            break;
+        }
+        CloseHandle(thread_handle);
+        queue->num_threads++;
+    }
+
+    return true;
+}
+
+namespace Platform
+{
+
+    // NOTE:
+    // The tasks go into the queue at most WORK_QUEUE_MAX_NUM_ENTRIES - 1 at a time, since a full ring would overwrite
+    // entries that haven't run yet, and each chunk is waited for before the next one goes in.
+    // A task must not call parallel_for, the queue only tracks one call at a time. If one does anyway, or the queue is
+    // in use for any other reason, the tasks of the second call are simply run one after the other on its thread.
+    void
+    parallel_for(uint num_tasks, ParallelTaskCallback* callback, void* data)
+    {
+
+        WorkQueue *const queue = &g_work_queue;
+        if(!g_work_queue_initialized)
+        {
+            g_work_queue_initialized = work_queue_initialize(queue);
+        }
+
+        bool const acquired =
+            g_work_queue_initialized &&
+            queue->num_threads > 0 &&
+            InterlockedCompareExchange(&queue->busy, 1, 0) == 0;
+        if(!acquired)
+        {
+            for(uint task_idx=0; task_idx < num_tasks; task_idx++)
+            {
+                callback(data, task_idx);
+            }
+            return;
+        }
+
+        assert(queue->completion_goal == queue->completion_count);
+
+        uint const max_num_chunk_tasks = WORK_QUEUE_MAX_NUM_ENTRIES - 1;
+        for(uint first_task_idx=0; first_task_idx < num_tasks; first_task_idx += max_num_chunk_tasks)
+        {
+            uint const end_task_idx = (uint)Numerics::minimum(int(num_tasks), int(first_task_idx + max_num_chunk_tasks));
+            for(uint task_idx=first_task_idx; task_idx < end_task_idx; task_idx++)
+            {
+                LONG const entry_idx = queue->next_entry_to_write;
+                WorkQueueEntry *const entry = &queue->entries[entry_idx];
+                entry->callback = callback;
+                entry->data = data;
+                entry->task_idx = task_idx;
+                queue->completion_goal++;
+                // NOTE: the entry has to be visible before the write index is
+                _WriteBarrier();
+                queue->next_entry_to_write = (entry_idx + 1) % WORK_QUEUE_MAX_NUM_ENTRIES;
+            }
+            {
+                LONG const release_count =
+                    (LONG)Numerics::minimum(int(end_task_idx - first_task_idx), (int)queue->num_threads);
+                LONG* previous_count = 0;
+                ReleaseSemaphore(queue->semaphore, release_count, previous_count);
+            }
+
+            while(queue->completion_goal != queue->completion_count)
+            {
+                work_queue_do_next_entry(queue);
+            }
+
+            queue->completion_goal = 0;
+            queue->completion_count = 0;
+        }
+
+        InterlockedExchange(&queue->busy, 0);
+
+    }
+
+    uint
+    num_worker_threads()
+    {
+        if(!g_work_queue_initialized)
+        {
+            g_work_queue_initialized = work_queue_initialize(&g_work_queue);
+        }
+        return g_work_queue.num_threads;
+    }
+
 };
 
 namespace Platform
-{    
-    
+{
+
     inline float
     time_duration_seconds(TimeCount start, TimeCount end)
     {
@@ -727,6 +1031,30 @@ namespace Platform
         
     }
 
+    // NOTE: no window, so the command line modes can run without one
+    bool init_headless()
+    {
+
+        // NOTE:
+        // This frequency is consistent across reboots and processors,
+        // so it only needs to be queried this one time at startup.
+        global_perfcounter_frequency = 0;
+        {
+            LARGE_INTEGER result;
+            QueryPerformanceFrequency(&result);
+            global_perfcounter_frequency = result.QuadPart;
+        }
+        assert( global_perfcounter_frequency > 0 );
+
+        if(!g_work_queue_initialized)
+        {
+            // NOTE: not fatal, parallel_for then runs the tasks on the calling thread
+            g_work_queue_initialized = work_queue_initialize(&g_work_queue);
+        }
+
+        return true;
+    }
+
     bool init(uint viewport_width_screen, uint viewport_height_screen, bool mouse_input_initially_enabled)
     {
 
@@ -776,16 +1104,7 @@ namespace Platform
                 g_sleep_is_granular = true;
             }
         }    
-    
-        // NOTE:
-        // This frequency is consistent across reboots and processors,
-        // so it only needs to be queried this one time at startup.
-        global_perfcounter_frequency = 0;
-        {
-            LARGE_INTEGER result;
-            QueryPerformanceFrequency(&result);
-            global_perfcounter_frequency = result.QuadPart;
-        }
+
         assert( global_perfcounter_frequency > 0 );
 
         {